@@ -0,0 +1,227 @@
+import json
+import os
+import threading
+import time
+import zlib
+from typing import Any, Dict, Optional
+
+def atomic_write_json(filename: str, data: Any) -> bool:
+    """
+    Schreibt JSON absturzsicher: temporäre Datei, fsync, atomares Umbenennen.
+    Nach einem Absturz existiert entweder die alte oder die neue Datei, nie eine halbe.
+    """
+    tmp = f"{filename}.tmp"
+    try:
+        with open(tmp, 'w') as f:
+            json.dump(data, f)
+            f.flush()
+            os.fsync(f.fileno())
+        os.replace(tmp, filename)
+        return True
+    except (OSError, TypeError, ValueError) as e:
+        print(f"Checkpoint: Schreiben von {filename} fehlgeschlagen: {e}")
+        try:
+            os.remove(tmp)
+        except OSError:
+            pass
+        return False
+
+class CheckpointManager:
+    """
+    Periodischer Checkpoint des wiederherstellbaren Laufzeitzustands für den Warmstart.
+    Komponenten implementieren checkpoint_state() -> Dict und restore_checkpoint(state).
+    Komponenten mit großem, unveränderlich veröffentlichtem Zustand (Planer) bieten
+    zusätzlich checkpoint_capture() -> Referenz und checkpoint_encode(Referenz) -> Dict:
+    capture() in der Regelschleife hält dann nur die Referenz auf den Snapshot fest,
+    Umwandlung, Serialisierung und Schreiben übernimmt der Hintergrund-Thread.
+    Verwendung:
+      checkpoints = CheckpointManager('checkpoint.json', interval=2.0)
+      checkpoints.register('estimator', estimator)
+      checkpoints.restore()          # beim Start
+      checkpoints.maybe_capture(extra={'operation': ...})  # in der Regelschleife
+    """
+    def __init__(self, filename: str = 'checkpoint.json', interval: float = 2.0,
+                 max_age: float = 600.0):
+        self.filename = filename
+        self.backup_filename = f"{filename}.bak"
+        self.interval = interval
+        self.max_age = max_age
+        self.components: Dict[str, Any] = {}
+        self.sequence = 0
+        self._last_capture = 0.0
+        self._pending: Optional[Dict] = None
+        self._busy = False
+        self._cond = threading.Condition()
+        self._writer: Optional[threading.Thread] = None
+        self._running = False
+        self.writes = 0
+        self.write_errors = 0
+
+    def register(self, name: str, component: Any) -> None:
+        """Registriert eine Komponente mit checkpoint_state()/restore_checkpoint()."""
+        self.components[name] = component
+
+    def unregister(self, name: str) -> None:
+        self.components.pop(name, None)
+
+    def capture(self, extra: Optional[Dict] = None) -> Dict:
+        """
+        Erzeugt einen Snapshot aller Komponenten und übergibt ihn dem Schreib-Thread.
+        Ältere, noch nicht geschriebene Snapshots werden verworfen.
+        """
+        state = {}
+        deferred = {}
+        for name, component in self.components.items():
+            try:
+                if hasattr(component, 'checkpoint_capture'):
+                    # Nur die Referenz auf den unveränderlichen Snapshot festhalten
+                    deferred[name] = (component, component.checkpoint_capture())
+                else:
+                    state[name] = component.checkpoint_state()
+            except Exception as e:
+                print(f"Checkpoint: Zustand von {name} nicht verfügbar: {e}")
+        if extra:
+            state.update(extra)
+        self.sequence += 1
+        snapshot = {'sequence': self.sequence, 'time': time.time(), 'state': state}
+        if deferred:
+            snapshot['deferred'] = deferred
+        self._last_capture = time.monotonic()
+        self._ensure_writer()
+        with self._cond:
+            self._pending = snapshot
+            self._cond.notify()
+        return snapshot
+
+    def maybe_capture(self, extra: Optional[Dict] = None) -> bool:
+        """Wie capture(), aber höchstens einmal pro Intervall."""
+        if time.monotonic() - self._last_capture < self.interval:
+            return False
+        self.capture(extra)
+        return True
+
+    def _ensure_writer(self) -> None:
+        if self._writer is None or not self._writer.is_alive():
+            self._running = True
+            self._writer = threading.Thread(target=self._write_loop, name="checkpoint-writer",
+                                            daemon=True)
+            self._writer.start()
+
+    def _write_loop(self) -> None:
+        while True:
+            with self._cond:
+                while self._pending is None and self._running:
+                    self._cond.wait()
+                snapshot = self._pending
+                self._pending = None
+                if snapshot is None:
+                    return
+                self._busy = True
+            try:
+                self.write(snapshot)
+            finally:
+                with self._cond:
+                    self._busy = False
+
+    def _encode(self, snapshot: Dict) -> Dict:
+        """Wandelt festgehaltene Referenzen in serialisierbaren Zustand um (Schreib-Thread)."""
+        state = dict(snapshot['state'])
+        for name, (component, captured) in snapshot.get('deferred', {}).items():
+            try:
+                state[name] = component.checkpoint_encode(captured)
+            except Exception as e:
+                print(f"Checkpoint: Zustand von {name} nicht verfügbar: {e}")
+        record = {key: value for key, value in snapshot.items() if key != 'deferred'}
+        record['state'] = state
+        return record
+
+    def write(self, snapshot: Dict) -> bool:
+        """Schreibt einen Snapshot mit Prüfsumme; der vorherige bleibt als Backup."""
+        snapshot = self._encode(snapshot)
+        body = json.dumps(snapshot['state'], sort_keys=True)
+        record = dict(snapshot, crc=zlib.crc32(body.encode('utf-8')))
+        if os.path.exists(self.filename):
+            try:
+                os.replace(self.filename, self.backup_filename)
+            except OSError:
+                pass
+        if atomic_write_json(self.filename, record):
+            self.writes += 1
+            return True
+        self.write_errors += 1
+        return False
+
+    def flush(self, timeout: float = 2.0) -> None:
+        """Wartet, bis der letzte Snapshot geschrieben wurde."""
+        deadline = time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            with self._cond:
+                if self._pending is None and not self._busy:
+                    break
+            time.sleep(0.01)
+
+    def stop(self) -> None:
+        """Schreibt ausstehende Snapshots und beendet den Schreib-Thread."""
+        self.flush()
+        with self._cond:
+            self._running = False
+            self._cond.notify()
+        if self._writer is not None:
+            self._writer.join(timeout=2.0)
+
+    def _read(self, filename: str) -> Optional[Dict]:
+        try:
+            with open(filename, 'r') as f:
+                record = json.load(f)
+            body = json.dumps(record['state'], sort_keys=True)
+            if zlib.crc32(body.encode('utf-8')) != record.get('crc'):
+                print(f"Checkpoint: Prüfsumme von {filename} ungültig")
+                return None
+            return record
+        except (OSError, ValueError, KeyError, TypeError):
+            return None
+
+    def load(self) -> Optional[Dict]:
+        """
+        Gibt den letzten konsistenten Checkpoint zurück (Hauptdatei, sonst Backup).
+        Zu alte Checkpoints werden ignoriert, da sich die Umgebung geändert haben kann.
+        """
+        for filename in (self.filename, self.backup_filename):
+            record = self._read(filename)
+            if record is None:
+                continue
+            age = time.time() - record.get('time', 0)
+            if self.max_age and age > self.max_age:
+                print(f"Checkpoint: {filename} ist {age:.0f}s alt, kein Warmstart")
+                return None
+            self.sequence = record.get('sequence', 0)
+            return record
+        return None
+
+    def restore(self) -> Dict:
+        """
+        Stellt alle registrierten Komponenten aus dem letzten Checkpoint wieder her.
+        Gibt den gesamten gespeicherten Zustand zurück (leer, wenn kein Warmstart möglich).
+        """
+        record = self.load()
+        if not record:
+            return {}
+        state = record['state']
+        for name, component in self.components.items():
+            if name not in state:
+                continue
+            try:
+                component.restore_checkpoint(state[name])
+            except Exception as e:
+                print(f"Checkpoint: Wiederherstellung von {name} fehlgeschlagen: {e}")
+        print(f"Checkpoint: Warmstart aus Checkpoint #{record['sequence']} "
+              f"({time.time() - record['time']:.1f}s alt)")
+        return state
+
+    def clear(self) -> None:
+        """Entfernt alle Checkpoints (z.B. nach regulärem Missionsende)."""
+        for filename in (self.filename, self.backup_filename):
+            try:
+                os.remove(filename)
+            except OSError:
+                pass
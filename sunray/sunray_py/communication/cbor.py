@@ -0,0 +1,132 @@
+"""
+Minimaler CBOR-Kodierer/-Dekodierer (RFC 8949) für Telemetriedaten.
+Unterstützt: int, float (float32 wenn verlustfrei, sonst float64), str, bytes,
+bool, None, list/tuple und dict. Keine Tags, keine Streaming-Längen.
+"""
+
+import struct
+from typing import Any, Tuple
+
+_FLOAT32 = struct.Struct('>f')
+_FLOAT64 = struct.Struct('>d')
+
+def _head(major: int, value: int, out: bytearray) -> None:
+    if value < 24:
+        out.append((major << 5) | value)
+    elif value < 0x100:
+        out.append((major << 5) | 24)
+        out.append(value)
+    elif value < 0x10000:
+        out.append((major << 5) | 25)
+        out += value.to_bytes(2, 'big')
+    elif value < 0x100000000:
+        out.append((major << 5) | 26)
+        out += value.to_bytes(4, 'big')
+    else:
+        out.append((major << 5) | 27)
+        out += value.to_bytes(8, 'big')
+
+def _encode(obj: Any, out: bytearray) -> None:
+    if obj is None:
+        out.append(0xF6)
+    elif obj is True:
+        out.append(0xF5)
+    elif obj is False:
+        out.append(0xF4)
+    elif isinstance(obj, int):
+        if obj >= 0:
+            _head(0, obj, out)
+        else:
+            _head(1, -1 - obj, out)
+    elif isinstance(obj, float):
+        packed = _FLOAT32.pack(obj) if abs(obj) < 3.4e38 else None
+        if packed is not None and _FLOAT32.unpack(packed)[0] == obj:
+            out.append(0xFA)
+            out += packed
+        else:
+            out.append(0xFB)
+            out += _FLOAT64.pack(obj)
+    elif isinstance(obj, str):
+        data = obj.encode('utf-8')
+        _head(3, len(data), out)
+        out += data
+    elif isinstance(obj, (bytes, bytearray)):
+        _head(2, len(obj), out)
+        out += obj
+    elif isinstance(obj, (list, tuple)):
+        _head(4, len(obj), out)
+        for item in obj:
+            _encode(item, out)
+    elif isinstance(obj, dict):
+        _head(5, len(obj), out)
+        for key, value in obj.items():
+            _encode(key, out)
+            _encode(value, out)
+    else:
+        # Enums und ähnliche Typen als Text übertragen
+        _encode(str(getattr(obj, 'value', obj)), out)
+
+def dumps(obj: Any) -> bytes:
+    """Kodiert ein Python-Objekt als CBOR."""
+    out = bytearray()
+    _encode(obj, out)
+    return bytes(out)
+
+def _decode(data: bytes, pos: int) -> Tuple[Any, int]:
+    initial = data[pos]
+    pos += 1
+    major = initial >> 5
+    info = initial & 0x1F
+
+    if major == 7:
+        if info == 20:
+            return False, pos
+        if info == 21:
+            return True, pos
+        if info in (22, 23):
+            return None, pos
+        if info == 25:
+            return struct.unpack('>e', data[pos:pos + 2])[0], pos + 2
+        if info == 26:
+            return _FLOAT32.unpack(data[pos:pos + 4])[0], pos + 4
+        if info == 27:
+            return _FLOAT64.unpack(data[pos:pos + 8])[0], pos + 8
+        raise ValueError(f"CBOR: nicht unterstützter einfacher Wert {info}")
+
+    if info < 24:
+        value = info
+    elif info in (24, 25, 26, 27):
+        size = 1 << (info - 24)
+        value = int.from_bytes(data[pos:pos + size], 'big')
+        pos += size
+    else:
+        raise ValueError("CBOR: unbestimmte Längen werden nicht unterstützt")
+
+    if major == 0:
+        return value, pos
+    if major == 1:
+        return -1 - value, pos
+    if major == 2:
+        return bytes(data[pos:pos + value]), pos + value
+    if major == 3:
+        return data[pos:pos + value].decode('utf-8'), pos + value
+    if major == 4:
+        items = []
+        for _ in range(value):
+            item, pos = _decode(data, pos)
+            items.append(item)
+        return items, pos
+    if major == 5:
+        result = {}
+        for _ in range(value):
+            key, pos = _decode(data, pos)
+            result[key], pos = _decode(data, pos)
+        return result, pos
+    raise ValueError(f"CBOR: nicht unterstützter Typ {major}")
+
+def loads(data: bytes) -> Any:
+    """Dekodiert CBOR-Daten."""
+    obj, pos = _decode(data, 0)
+    if pos != len(data):
+        raise ValueError("CBOR: zusätzliche Daten am Ende")
+    return obj
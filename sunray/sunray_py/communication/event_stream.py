@@ -0,0 +1,255 @@
+"""
+Server-Sent-Events-Kanal für die Web-Oberfläche.
+
+Statt dass jede geöffnete Seite REST-Endpunkte per setInterval abfragt, wird
+jedes Ereignis genau einmal zu SSE-Bytes kodiert und an alle Abonnenten
+verteilt. Jeder Client hat eine eigene, begrenzte Warteschlange:
+- Zustandsereignisse (z.B. 'telemetry') werden zusammengefasst: ein langsamer
+  Client erhält nur den jeweils neuesten Snapshot, höchstens im Takt seines
+  Rate-Limits.
+- Änderungsereignisse (z.B. 'plan', 'zones') werden in Reihenfolge zugestellt.
+  Läuft die Warteschlange über, werden sie verworfen und der Client erhält ein
+  'resync'-Ereignis, auf das er den vollständigen Zustand per REST nachlädt.
+
+Verwendung (Flask):
+  hub = get_event_hub()
+  hub.publish('telemetry', snapshot, coalesce=True)
+  hub.publish('plan', {'status': ...})
+
+  @app.route('/api/stream')
+  def api_stream():
+      client = subscribe_from_args(hub, request.args)
+      return Response(hub.stream(client), mimetype='text/event-stream',
+                      headers=SSE_HEADERS)
+"""
+
+import itertools
+import json
+import threading
+import time
+from collections import OrderedDict, deque
+from typing import Any, Dict, Iterable, Iterator, List, Optional
+from utils.metrics import get_metrics
+
+SSE_HEADERS = {'Cache-Control': 'no-cache', 'X-Accel-Buffering': 'no'}
+
+def encode_event(event: str, data: Any, event_id: Optional[int] = None) -> bytes:
+    """Kodiert ein Ereignis im SSE-Format (eine data-Zeile, da JSON keine Zeilenumbrüche enthält)."""
+    body = json.dumps(data, separators=(',', ':'), default=str)
+    head = f"id: {event_id}\n" if event_id is not None else ""
+    return f"{head}event: {event}\ndata: {body}\n\n".encode('utf-8')
+
+class StreamClient:
+    """Zustand eines Abonnenten (Warteschlange, Rate-Limits, Statistik)."""
+    def __init__(self, client_id: int, events: Optional[Iterable[str]],
+                 rate_caps: Dict[str, float], max_queue: int):
+        self.client_id = client_id
+        self.events = set(events) if events else None
+        self.rate_caps = rate_caps
+        self.max_queue = max_queue
+        self.latest: 'OrderedDict[str, bytes]' = OrderedDict()
+        self.queue: deque = deque()
+        self.last_sent: Dict[str, float] = {}
+        self.needs_resync = False
+        self.closed = False
+        self.connected_at = time.time()
+        self.messages_sent = 0
+        self.bytes_sent = 0
+        self.dropped = 0
+
+    def wants(self, event: str) -> bool:
+        return self.events is None or event in self.events
+
+    def offer(self, event: str, payload: bytes, coalesce: bool) -> None:
+        if coalesce:
+            if event in self.latest:
+                self.dropped += 1
+            self.latest[event] = payload
+            return
+        if len(self.queue) >= self.max_queue:
+            # Client kommt nicht hinterher: Änderungen verwerfen, vollständig neu laden lassen
+            self.dropped += len(self.queue) + 1
+            self.queue.clear()
+            self.needs_resync = True
+            return
+        self.queue.append(payload)
+
+    def take(self, now: float) -> List[bytes]:
+        """Entnimmt alle jetzt zustellbaren Nachrichten."""
+        messages = []
+        if self.needs_resync:
+            self.needs_resync = False
+            messages.append(encode_event('resync', {'reason': 'queue_overflow'}))
+        while self.queue:
+            messages.append(self.queue.popleft())
+        for event in list(self.latest):
+            cap = self.rate_caps.get(event, 0.0)
+            if now - self.last_sent.get(event, float('-inf')) >= cap * 0.95:
+                messages.append(self.latest.pop(event))
+                self.last_sent[event] = now
+        return messages
+
+    def next_due(self, now: float) -> Optional[float]:
+        """Sekunden bis zum nächsten zustellbaren zusammengefassten Ereignis."""
+        waits = [self.last_sent.get(event, now) + self.rate_caps.get(event, 0.0) - now
+                 for event in self.latest]
+        return max(0.0, min(waits)) if waits else None
+
+class EventHub:
+    """
+    Verteilt Ereignisse an alle SSE-Abonnenten.
+    rate_caps: minimaler Abstand in Sekunden je zusammengefasstem Ereignistyp,
+      z.B. {'telemetry': 0.5}. Clients können nur langsamere Raten anfordern.
+    max_queue: maximale Anzahl wartender Änderungsereignisse je Client.
+    """
+    def __init__(self, rate_caps: Optional[Dict[str, float]] = None, max_queue: int = 100,
+                 heartbeat: float = 15.0, max_clients: int = 16):
+        self.rate_caps = dict(rate_caps or {'telemetry': 0.5})
+        self.max_queue = max_queue
+        self.heartbeat = heartbeat
+        self.max_clients = max_clients
+        self._clients: Dict[int, StreamClient] = {}
+        self._cond = threading.Condition()
+        self._ids = itertools.count(1)
+        self._event_id = 0
+        self.events_published = 0
+        self.encode_count = 0
+        get_metrics().gauge('sunray_sse_clients', 'Verbundene SSE-Clients', fn=lambda: len(self._clients))
+
+    def has_subscribers(self, event: Optional[str] = None) -> bool:
+        with self._cond:
+            return any(c.wants(event) for c in self._clients.values()) if event else bool(self._clients)
+
+    def publish(self, event: str, data: Any, coalesce: bool = False) -> int:
+        """
+        Kodiert ein Ereignis einmal und stellt es allen interessierten Clients zu.
+        coalesce=True für Zustands-Snapshots (nur der neueste zählt).
+        Gibt die Anzahl der erreichten Clients zurück; ohne Abonnenten fällt
+        keine Kodierarbeit an.
+        """
+        with self._cond:
+            targets = [c for c in self._clients.values() if c.wants(event)]
+            if not targets:
+                return 0
+            self._event_id += 1
+            event_id = self._event_id
+        payload = encode_event(event, data, event_id)
+        with self._cond:
+            self.encode_count += 1
+            self.events_published += 1
+            for client in targets:
+                if not client.closed:
+                    client.offer(event, payload, coalesce)
+            self._cond.notify_all()
+        return len(targets)
+
+    def subscribe(self, events: Optional[Iterable[str]] = None,
+                  rate_caps: Optional[Dict[str, float]] = None) -> Optional[StreamClient]:
+        """
+        Registriert einen neuen Client. Angeforderte Raten unterhalb des
+        serverseitigen Limits werden auf dieses angehoben.
+        Gibt None zurück, wenn die maximale Anzahl Clients erreicht ist.
+        """
+        caps = dict(self.rate_caps)
+        for event, interval in (rate_caps or {}).items():
+            caps[event] = max(float(interval), self.rate_caps.get(event, 0.0))
+        with self._cond:
+            if len(self._clients) >= self.max_clients:
+                print(f"EventHub: maximale Anzahl Clients ({self.max_clients}) erreicht")
+                return None
+            client = StreamClient(next(self._ids), events, caps, self.max_queue)
+            self._clients[client.client_id] = client
+        return client
+
+    def unsubscribe(self, client: StreamClient) -> None:
+        with self._cond:
+            client.closed = True
+            self._clients.pop(client.client_id, None)
+            self._cond.notify_all()
+
+    def poll(self, client: StreamClient, timeout: float) -> List[bytes]:
+        """Wartet höchstens timeout Sekunden auf zustellbare Nachrichten."""
+        deadline = time.monotonic() + timeout
+        with self._cond:
+            while not client.closed:
+                now = time.monotonic()
+                messages = client.take(now)
+                if messages:
+                    return messages
+                remaining = deadline - now
+                if remaining <= 0:
+                    return []
+                due = client.next_due(now)
+                self._cond.wait(remaining if due is None else min(remaining, max(due, 0.005)))
+        return []
+
+    def stream(self, client: StreamClient) -> Iterator[bytes]:
+        """
+        Generator für die Flask-Response. Blockiert das Schreiben an einen
+        langsamen Client, sammeln sich dessen Ereignisse in seiner eigenen
+        Warteschlange; andere Clients sind nicht betroffen.
+        """
+        try:
+            yield f"retry: 3000\n: client {client.client_id}\n\n".encode('utf-8')
+            while not client.closed:
+                messages = self.poll(client, self.heartbeat)
+                if not messages:
+                    yield b": ping\n\n"
+                    continue
+                chunk = b"".join(messages)
+                client.messages_sent += len(messages)
+                client.bytes_sent += len(chunk)
+                yield chunk
+        finally:
+            self.unsubscribe(client)
+
+    def get_statistics(self) -> Dict:
+        with self._cond:
+            clients = [{
+                'id': c.client_id,
+                'events': sorted(c.events) if c.events else 'all',
+                'connected_for': time.time() - c.connected_at,
+                'messages_sent': c.messages_sent,
+                'bytes_sent': c.bytes_sent,
+                'dropped': c.dropped,
+                'queued': len(c.queue) + len(c.latest)
+            } for c in self._clients.values()]
+        return {
+            'clients': clients,
+            'events_published': self.events_published,
+            'encode_count': self.encode_count,
+            'rate_caps': self.rate_caps
+        }
+
+def subscribe_from_args(hub: EventHub, args) -> Optional[StreamClient]:
+    """
+    Erzeugt einen Client aus Query-Parametern:
+      ?events=telemetry,plan        nur diese Ereignistypen
+      ?telemetry_interval=1.0       langsamere Rate für einen Ereignistyp
+    """
+    events = [e for e in args.get('events', '').split(',') if e] or None
+    caps = {}
+    for key, value in args.items():
+        if key.endswith('_interval'):
+            try:
+                caps[key[:-len('_interval')]] = float(value)
+            except ValueError:
+                pass
+    return hub.subscribe(events, caps)
+
+_event_hub: Optional[EventHub] = None
+
+def get_event_hub(config: Optional[Dict] = None) -> EventHub:
+    """
+    Gibt die globale EventHub-Instanz zurück.
+    config (nur beim ersten Aufruf): {'rate_caps': {...}, 'max_queue': n,
+    'heartbeat': s, 'max_clients': n}
+    """
+    global _event_hub
+    if _event_hub is None:
+        config = config or {}
+        _event_hub = EventHub(rate_caps=config.get('rate_caps'),
+                              max_queue=config.get('max_queue', 100),
+                              heartbeat=config.get('heartbeat', 15.0),
+                              max_clients=config.get('max_clients', 16))
+    return _event_hub
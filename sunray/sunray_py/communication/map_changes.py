@@ -0,0 +1,235 @@
+"""
+Inkrementelle Karten- und Planänderungen für verbundene Clients.
+
+Statt nach jeder Zonenänderung oder jedem Hindernis /api/zones und den ganzen
+Plan neu zu laden, erhalten Clients versionierte Diffs und patchen ihre lokale
+Kopie. Je Inhaltsart ('zones', 'obstacles', 'plan') führt MapChangeLog:
+- den zuletzt gemeldeten Zustand und eine fortlaufende Version,
+- einen kurzen Verlauf der letzten Diffs, damit ein Client nach einem
+  Verbindungsabbruch (oder einem 'resync' des Push-Kanals) aufholen kann.
+
+Diff-Arten:
+- collection: Polygone mit Schlüssel ('id' oder Listenindex)
+    {'type': 'collection', 'added': [{'key', 'item'}], 'removed': [key],
+     'modified': [{'key', 'item'}]}
+- sequence: Plansegmente, ein zusammenhängender ersetzter Bereich
+    {'type': 'sequence', 'start': i, 'remove': n, 'insert': [item], 'length': neue Länge}
+
+Jede Änderung wird als '<art>_diff' über den Push-Kanal verteilt:
+  {'kind', 'epoch', 'base', 'version', 'diff'}
+Ein Client wendet sie an, wenn 'base' seiner Version entspricht; sonst holt er
+GET /api/changes/<art>?since=<version>&epoch=<epoch>. Reicht der Verlauf nicht
+(oder der Server wurde neu gestartet, neue 'epoch'), lautet die Antwort
+{'full_reload': true} und der Client lädt /api/changes/<art>/state.
+
+Verwendung:
+  changes = get_map_changes(config.get('map_changes', {}))
+  changes.track('plan', mode='sequence', encode=AdvancedPathPlanner.export_segment)
+  changes.update('plan', planner.snapshot().plan)
+"""
+
+import threading
+import time
+from collections import deque
+from typing import Any, Callable, Dict, List, Optional, Sequence, Tuple
+
+def _item_key(item: Any, index: int) -> Any:
+    """Schlüssel eines Polygons: 'id' wenn vorhanden, sonst die Position in der Liste."""
+    if isinstance(item, dict) and item.get('id') is not None:
+        return item['id']
+    return index
+
+def diff_collection(old: Sequence[Any], new: Sequence[Any]) -> Optional[Dict]:
+    """Vergleicht zwei kodierte Polygonlisten; None wenn unverändert."""
+    old_items = {_item_key(item, i): item for i, item in enumerate(old)}
+    new_items = {_item_key(item, i): item for i, item in enumerate(new)}
+    added = [{'key': key, 'item': item} for key, item in new_items.items() if key not in old_items]
+    removed = [key for key in old_items if key not in new_items]
+    modified = [{'key': key, 'item': item} for key, item in new_items.items()
+                if key in old_items and old_items[key] != item]
+    if not (added or removed or modified):
+        return None
+    return {'type': 'collection', 'added': added, 'removed': removed, 'modified': modified}
+
+def diff_sequence(old: Sequence[Any], new: Sequence[Any]) -> Optional[Dict]:
+    """
+    Ersetzter Bereich zwischen gemeinsamem Anfang und gemeinsamem Ende.
+    Eine Neuplanung ab der aktuellen Position ändert typischerweise nur einen
+    Teil des Plans; unveränderte Segmente werden nicht übertragen.
+    """
+    limit = min(len(old), len(new))
+    start = 0
+    while start < limit and old[start] == new[start]:
+        start += 1
+    if start == len(old) == len(new):
+        return None
+    end = 0
+    while end < limit - start and old[len(old) - 1 - end] == new[len(new) - 1 - end]:
+        end += 1
+    return {'type': 'sequence', 'start': start, 'remove': len(old) - start - end,
+            'insert': list(new[start:len(new) - end]), 'length': len(new)}
+
+def apply_diff(items: List[Any], diff: Dict) -> List[Any]:
+    """Wendet einen Diff auf eine kodierte Liste an (Gegenstück zu static/js/map_changes.js)."""
+    if diff['type'] == 'sequence':
+        return items[:diff['start']] + diff['insert'] + items[diff['start'] + diff['remove']:]
+    removed = set(diff['removed'])
+    modified = {entry['key']: entry['item'] for entry in diff['modified']}
+    result = []
+    for i, item in enumerate(items):
+        key = _item_key(item, i)
+        if key not in removed:
+            result.append(modified.get(key, item))
+    return result + [entry['item'] for entry in diff['added']]
+
+class _Tracked:
+    """Zustand einer Inhaltsart: Rohobjekte, kodierte Form, Version und Verlauf."""
+    def __init__(self, mode: str, encode: Optional[Callable[[Any], Any]], history: int):
+        self.mode = mode
+        self.encode = encode
+        self.raw: Tuple[Any, ...] = ()
+        self.encoded: List[Any] = []
+        self.version = 0
+        self.history: deque = deque(maxlen=history)
+
+class MapChangeLog:
+    """Versionierte Diffs je Inhaltsart mit kurzem Verlauf zum Aufholen."""
+    def __init__(self, history: int = 64, hub=None):
+        self.history_size = history
+        self.hub = hub
+        # Neuer Wert bei jedem Serverstart: Versionen älterer Epochen sind ungültig
+        self.epoch = format(int(time.time() * 1000), 'x')
+        self._kinds: Dict[str, _Tracked] = {}
+        self._lock = threading.Lock()
+
+    def track(self, kind: str, mode: str = 'collection',
+              encode: Optional[Callable[[Any], Any]] = None) -> None:
+        """Meldet eine Inhaltsart an; encode wandelt ein Objekt in seine JSON-Form."""
+        if mode not in ('collection', 'sequence'):
+            raise ValueError(f"Unbekannte Diff-Art: {mode}")
+        with self._lock:
+            if kind not in self._kinds:
+                self._kinds[kind] = _Tracked(mode, encode, self.history_size)
+
+    def update(self, kind: str, items: Sequence[Any]) -> Optional[Dict]:
+        """
+        Übernimmt den neuen Zustand, berechnet den Diff zum vorherigen und
+        verteilt ihn. Gibt die Änderung zurück oder None, wenn nichts geändert wurde.
+        """
+        items = tuple(items)
+        with self._lock:
+            tracked = self._kinds.get(kind)
+            if tracked is None:
+                print(f"MapChangeLog: Inhaltsart {kind} nicht angemeldet")
+                return None
+            if len(items) == len(tracked.raw) and all(a is b for a, b in zip(items, tracked.raw)):
+                return None
+            # Unveränderte Objekte (gleiche Identität) nicht erneut kodieren
+            cache = {id(item): encoded for item, encoded in zip(tracked.raw, tracked.encoded)}
+            encode = tracked.encode
+            encoded = [cache[id(item)] if id(item) in cache else (encode(item) if encode else item)
+                       for item in items]
+            if tracked.mode == 'sequence':
+                diff = diff_sequence(tracked.encoded, encoded)
+            else:
+                diff = diff_collection(tracked.encoded, encoded)
+            tracked.raw = items
+            tracked.encoded = encoded
+            if diff is None:
+                return None
+            change = {'kind': kind, 'epoch': self.epoch, 'base': tracked.version,
+                      'version': tracked.version + 1, 'diff': diff}
+            tracked.version += 1
+            tracked.history.append(change)
+            # Unter dem Lock veröffentlichen, damit Diffs in Versionsreihenfolge ankommen
+            if self.hub is not None:
+                self.hub.publish(f'{kind}_diff', change)
+        return change
+
+    def current(self, kind: str) -> Tuple[int, Tuple[Any, ...]]:
+        """Version und Rohobjekte des aktuellen Zustands (konsistentes Paar)."""
+        with self._lock:
+            tracked = self._kinds.get(kind)
+            if tracked is None:
+                return 0, ()
+            return tracked.version, tracked.raw
+
+    def state(self, kind: str) -> Optional[Dict]:
+        """Vollständiger kodierter Zustand als Basis für nachfolgende Diffs."""
+        with self._lock:
+            tracked = self._kinds.get(kind)
+            if tracked is None:
+                return None
+            return {'kind': kind, 'epoch': self.epoch, 'version': tracked.version,
+                    'mode': tracked.mode, 'state': list(tracked.encoded)}
+
+    def changes_since(self, kind: str, since: int, epoch: Optional[str] = None) -> Optional[Dict]:
+        """
+        Alle Änderungen nach Version since. 'full_reload' ist gesetzt, wenn der
+        Verlauf nicht mehr so weit zurückreicht oder die Epoche nicht passt.
+        """
+        with self._lock:
+            tracked = self._kinds.get(kind)
+            if tracked is None:
+                return None
+            result = {'kind': kind, 'epoch': self.epoch, 'version': tracked.version}
+            oldest = tracked.history[0]['base'] if tracked.history else tracked.version
+            if (epoch and epoch != self.epoch) or since > tracked.version or since < oldest:
+                result['full_reload'] = True
+                return result
+            result['changes'] = [change for change in tracked.history if change['version'] > since]
+            return result
+
+    def get_statistics(self) -> Dict:
+        with self._lock:
+            return {
+                'epoch': self.epoch,
+                'history_size': self.history_size,
+                'kinds': {kind: {'mode': t.mode, 'version': t.version, 'items': len(t.raw),
+                                 'history': len(t.history)}
+                          for kind, t in self._kinds.items()}
+            }
+
+def install_change_routes(app, changes: MapChangeLog) -> None:
+    """
+    Registriert die Aufhol-Endpunkte an einer Flask-App:
+      GET /api/changes                      Versionen und Verlauf je Inhaltsart
+      GET /api/changes/<art>?since=&epoch=  Diffs seit einer Version (oder full_reload)
+      GET /api/changes/<art>/state          Vollständiger Zustand mit Version
+    """
+    from flask import jsonify, request
+
+    def changes_overview():
+        return jsonify(changes.get_statistics())
+
+    def changes_for_kind(kind):
+        since = request.args.get('since', 0, type=int)
+        result = changes.changes_since(kind, since, request.args.get('epoch'))
+        if result is None:
+            return jsonify({'error': f'Unbekannte Inhaltsart: {kind}'}), 404
+        return jsonify(result)
+
+    def state_for_kind(kind):
+        result = changes.state(kind)
+        if result is None:
+            return jsonify({'error': f'Unbekannte Inhaltsart: {kind}'}), 404
+        return jsonify(result)
+
+    app.add_url_rule('/api/changes', 'changes_overview', changes_overview)
+    app.add_url_rule('/api/changes/<kind>', 'changes_for_kind', changes_for_kind)
+    app.add_url_rule('/api/changes/<kind>/state', 'changes_state', state_for_kind)
+
+# Globale Instanz
+_map_changes: Optional[MapChangeLog] = None
+
+def get_map_changes(config: Optional[Dict] = None) -> MapChangeLog:
+    """
+    Gibt das globale MapChangeLog zurück (verteilt über den globalen EventHub).
+    config (nur beim ersten Aufruf): {'history': Anzahl gespeicherter Diffs je Inhaltsart}
+    """
+    global _map_changes
+    if _map_changes is None:
+        from communication.event_stream import get_event_hub
+        config = config or {}
+        _map_changes = MapChangeLog(history=config.get('history', 64), hub=get_event_hub())
+    return _map_changes
@@ -10,6 +10,7 @@ class MQTTClient:
       - connect(broker: str, port: int)
       - subscribe(topic: str, callback: Callable[[str, dict], None])
       - publish(topic: str, payload: dict)
+      - publish_bytes(topic: str, payload: bytes)
       - loop_forever()
     """
     def __init__(self, client_id: Optional[str] = None):
@@ -30,10 +31,14 @@ class MQTTClient:
         self._callbacks[topic] = callback
         self.client.subscribe(topic)
 
-    def publish(self, topic: str, payload: dict):
+    def publish(self, topic: str, payload: dict, retain: bool = False):
         """JSON-payload an Topic senden."""
         message = json.dumps(payload)
-        self.client.publish(topic, message)
+        self.client.publish(topic, message, retain=retain)
+
+    def publish_bytes(self, topic: str, payload: bytes, retain: bool = False):
+        """Binären Payload (z.B. CBOR-Telemetrie) unverändert an Topic senden."""
+        self.client.publish(topic, payload, retain=retain)
 
     def _on_message(self, client, userdata, msg):
         try:
@@ -1,5 +1,6 @@
 import serial
 import threading
+from utils.trace import traced
 
 class PicoComm:
     """
@@ -10,6 +11,7 @@ class PicoComm:
         self.ser = serial.Serial(port, baudrate, timeout=timeout)
         self.lock = threading.Lock()
 
+    @traced('pico.read', 'io')
     def read_sensor_data(self) -> str:
         """
         Liest eine ASCII-Zeile vom Pico.
@@ -21,6 +23,7 @@ class PicoComm:
         except Exception:
             return ''
 
+    @traced('pico.write', 'io')
     def send_command(self, cmd: str) -> None:
         """
         Sendet ein ASCII-Kommando an den Pico.
@@ -0,0 +1,248 @@
+"""
+Delta-kodierte Binär-Telemetrie für MQTT.
+
+Pro Tick wird ein Snapshot (verschachteltes Dictionary) übergeben. Der Encoder
+flacht ihn zu Pfaden ('battery.voltage') ab, ordnet jedem Pfad eine feste ID
+aus einem registrierten Schema zu und sendet nur geänderte Felder als CBOR.
+In regelmäßigen Abständen wird ein Keyframe mit allen Feldern gesendet, damit
+neue Abonnenten synchronisieren können.
+
+Nachrichtenformat (CBOR-Map mit Integer-Schlüsseln):
+  0: Sequenznummer, 1: Schema-Version, 2: Keyframe (bool),
+  3: {Feld-ID: Wert}, 4: [entfernte Feld-IDs]
+Schema (JSON, retained auf '<topic>/schema'):
+  {"version": n, "fields": ["pfad.0", "pfad.1", ...]}
+"""
+
+import json
+import time
+from typing import Any, Dict, List, Optional, Tuple
+
+from communication import cbor
+
+SEQ, SCHEMA_VERSION, KEYFRAME, FIELDS, REMOVED = 0, 1, 2, 3, 4
+
+def flatten(snapshot: Dict, prefix: str = '', out: Optional[Dict] = None) -> Dict[str, Any]:
+    """Flacht verschachtelte Dictionaries zu {'a.b': wert} ab; Listen bleiben Blattwerte."""
+    if out is None:
+        out = {}
+    for key, value in snapshot.items():
+        path = f"{prefix}{key}"
+        if isinstance(value, dict) and value:
+            flatten(value, path + '.', out)
+        else:
+            out[path] = value
+    return out
+
+def unflatten(flat: Dict[str, Any]) -> Dict:
+    """Baut aus {'a.b': wert} wieder ein verschachteltes Dictionary."""
+    result: Dict = {}
+    for path, value in flat.items():
+        node = result
+        parts = path.split('.')
+        for part in parts[:-1]:
+            node = node.setdefault(part, {})
+        node[parts[-1]] = value
+    return result
+
+class TelemetryEncoder:
+    """
+    Delta-Encoder für ein Topic.
+    float_precision: Nachkommastellen, auf die Fließkommawerte vor dem Vergleich
+    gerundet werden (Rauschen erzeugt sonst in jedem Tick eine Änderung).
+    precision_overrides: abweichende Stellen je Pfad, z.B. {'gps.lat': 8}.
+    """
+    def __init__(self, keyframe_interval: float = 5.0, float_precision: int = 3,
+                 precision_overrides: Optional[Dict[str, int]] = None):
+        self.keyframe_interval = keyframe_interval
+        self.float_precision = float_precision
+        self.precision_overrides = precision_overrides or {}
+        self.fields: List[str] = []
+        self.schema: Dict[str, int] = {}
+        self.schema_version = 0
+        self.sequence = 0
+        self._last: Dict[int, Any] = {}
+        self._last_keyframe = None
+
+    def _quantize(self, path: str, value: Any) -> Any:
+        if isinstance(value, float):
+            value = round(value, self.precision_overrides.get(path, self.float_precision))
+            if value.is_integer() and abs(value) < 2 ** 53:
+                return int(value)
+            return value
+        if isinstance(value, tuple):
+            return [self._quantize(path, v) for v in value]
+        if isinstance(value, list):
+            return [self._quantize(path, v) for v in value]
+        if isinstance(value, dict):
+            return {k: self._quantize(path, v) for k, v in value.items()}
+        if value is None or isinstance(value, (bool, int, str)):
+            return value
+        return str(getattr(value, 'value', value))
+
+    def _field_id(self, path: str) -> int:
+        field_id = self.schema.get(path)
+        if field_id is None:
+            field_id = len(self.fields)
+            self.fields.append(path)
+            self.schema[path] = field_id
+            self.schema_version += 1
+        return field_id
+
+    def schema_message(self) -> bytes:
+        """Aktuelles Schema als JSON (selten, daher lesbar)."""
+        return json.dumps({'version': self.schema_version, 'fields': self.fields}).encode('utf-8')
+
+    def encode(self, snapshot: Dict, now: Optional[float] = None) -> Tuple[bytes, bool, bool]:
+        """
+        Kodiert einen Snapshot.
+        Rückgabe: (payload, keyframe, schema_changed)
+        """
+        now = time.monotonic() if now is None else now
+        schema_version = self.schema_version
+        current = {}
+        for path, value in flatten(snapshot).items():
+            current[self._field_id(path)] = self._quantize(path, value)
+
+        keyframe = (self._last_keyframe is None or
+                    now - self._last_keyframe >= self.keyframe_interval)
+        if keyframe:
+            self._last_keyframe = now
+            changed = current
+            removed = []
+        else:
+            changed = {fid: v for fid, v in current.items()
+                       if fid not in self._last or self._last[fid] != v}
+            removed = [fid for fid in self._last if fid not in current]
+        self._last = current
+
+        self.sequence += 1
+        message = {SEQ: self.sequence, SCHEMA_VERSION: self.schema_version,
+                   KEYFRAME: keyframe, FIELDS: changed}
+        if removed:
+            message[REMOVED] = removed
+        return cbor.dumps(message), keyframe, self.schema_version != schema_version
+
+class TelemetryDecoder:
+    """
+    Gegenstück zum TelemetryEncoder (für Abonnenten und Tests).
+    Liefert erst nach dem ersten Keyframe Daten; bei Sequenzlücken wird
+    bis zum nächsten Keyframe gewartet.
+    """
+    def __init__(self):
+        self.fields: List[str] = []
+        self.schema_version = 0
+        self.sequence = None
+        self.synced = False
+        self.state: Dict[str, Any] = {}
+
+    def update_schema(self, payload: bytes) -> None:
+        schema = json.loads(payload)
+        self.fields = schema['fields']
+        self.schema_version = schema['version']
+
+    def decode(self, payload: bytes) -> Optional[Dict]:
+        """Wendet eine Nachricht an und gibt den vollständigen Zustand (verschachtelt) zurück."""
+        message = cbor.loads(payload)
+        seq = message[SEQ]
+        if message[SCHEMA_VERSION] > self.schema_version:
+            self.synced = False  # Schema muss zuerst aktualisiert werden
+            return None
+        if message[KEYFRAME]:
+            self.state = {}
+            self.synced = True
+        elif self.sequence is None or seq != self.sequence + 1:
+            self.synced = False
+        self.sequence = seq
+        if not self.synced:
+            return None
+        for fid, value in message[FIELDS].items():
+            self.state[self.fields[fid]] = value
+        for fid in message.get(REMOVED, []):
+            self.state.pop(self.fields[fid], None)
+        return unflatten(self.state)
+
+class TelemetryPublisher:
+    """
+    Veröffentlicht Telemetrie-Snapshots delta-kodiert über MQTT.
+    rate_limits: minimaler Abstand in Sekunden je Topic, z.B.
+      {'sunray/telemetry': 0.1, 'sunray/enhanced_stats': 10.0}
+    binary=False sendet wie bisher vollständiges JSON (für alte Abonnenten).
+    Verwendung:
+      telemetry = TelemetryPublisher(mqtt, rate_limits={'sunray/enhanced_stats': 10.0})
+      if telemetry.due('sunray/enhanced_stats'):
+          telemetry.publish('sunray/enhanced_stats', build_stats())
+    """
+    def __init__(self, mqtt, rate_limits: Optional[Dict[str, float]] = None,
+                 keyframe_interval: float = 5.0, float_precision: int = 3,
+                 precision_overrides: Optional[Dict[str, int]] = None, binary: bool = True):
+        self.mqtt = mqtt
+        self.rate_limits = rate_limits or {}
+        self.keyframe_interval = keyframe_interval
+        self.float_precision = float_precision
+        self.precision_overrides = precision_overrides or {}
+        self.binary = binary
+        self.encoders: Dict[str, TelemetryEncoder] = {}
+        self._last_publish: Dict[str, float] = {}
+        self._stats: Dict[str, Dict] = {}
+        self._json_size: Dict[str, int] = {}
+        self._start_time = time.monotonic()
+
+    def due(self, topic: str, now: Optional[float] = None) -> bool:
+        """True, wenn das Rate-Limit des Topics eine neue Nachricht erlaubt."""
+        now = time.monotonic() if now is None else now
+        last = self._last_publish.get(topic)
+        # 5 % Toleranz, damit ein Takt mit Jitter nicht jede zweite Nachricht verliert
+        return last is None or now - last >= self.rate_limits.get(topic, 0.0) * 0.95
+
+    def publish(self, topic: str, snapshot: Dict, now: Optional[float] = None) -> bool:
+        """Veröffentlicht einen Snapshot, sofern das Rate-Limit es erlaubt."""
+        now = time.monotonic() if now is None else now
+        if not self.due(topic, now):
+            return False
+        self._last_publish[topic] = now
+        stats = self._stats.setdefault(topic, {'messages': 0, 'keyframes': 0,
+                                               'bytes_sent': 0, 'json_bytes': 0})
+
+        if not self.binary:
+            message = json.dumps(snapshot)
+            self.mqtt.publish_bytes(topic, message.encode('utf-8'))
+            stats['messages'] += 1
+            stats['bytes_sent'] += len(message)
+            stats['json_bytes'] += len(message)
+            return True
+
+        encoder = self.encoders.get(topic)
+        if encoder is None:
+            encoder = TelemetryEncoder(self.keyframe_interval, self.float_precision,
+                                       self.precision_overrides)
+            self.encoders[topic] = encoder
+        payload, keyframe, schema_changed = encoder.encode(snapshot, now)
+        if schema_changed:
+            self.mqtt.publish_bytes(f"{topic}/schema", encoder.schema_message(), retain=True)
+        self.mqtt.publish_bytes(topic, payload)
+
+        # JSON-Vergleichsgröße nur bei Keyframes messen, um die Ersparnis nicht
+        # mit einem json.dumps() pro Tick zu erkaufen
+        if keyframe:
+            self._json_size[topic] = len(json.dumps(snapshot, default=str))
+            stats['keyframes'] += 1
+        stats['messages'] += 1
+        stats['bytes_sent'] += len(payload)
+        stats['json_bytes'] += self._json_size.get(topic, len(payload))
+        return True
+
+    def get_statistics(self) -> Dict:
+        """Gesendete und eingesparte Bytes je Topic (gesamt und pro Sekunde)."""
+        elapsed = max(time.monotonic() - self._start_time, 1e-6)
+        result = {}
+        for topic, stats in self._stats.items():
+            saved = stats['json_bytes'] - stats['bytes_sent']
+            result[topic] = dict(
+                stats,
+                bytes_saved=saved,
+                bytes_per_sec=stats['bytes_sent'] / elapsed,
+                bytes_saved_per_sec=saved / elapsed,
+                compression_ratio=stats['bytes_sent'] / stats['json_bytes'] if stats['json_bytes'] else 1.0
+            )
+        return result
@@ -28,11 +28,205 @@ Verwendung:
     config = get_config()
     motor_kp = config.get('motor.pid.left.kp', 1.0)
     config.set('motor.pid.left.kp', 1.5)
+
+Für heiße Pfade steht ein unveränderlicher, typisierter Snapshot bereit,
+der nur beim Laden bzw. bei set() neu aufgebaut wird:
+    snapshot = config.snapshot()
+    kp = snapshot.motor.pid_left.kp
+    config.subscribe(lambda snap: print(snap.version))
 """
 
+import copy
+import inspect
 import json
 import os
-from typing import Any, Dict, Optional
+import threading
+import weakref
+from dataclasses import dataclass
+from types import MappingProxyType
+from typing import Any, Callable, Dict, List, Mapping, Optional
+
+
+@dataclass(frozen=True)
+class PIDParams:
+    """PID-Parameter eines Motors."""
+    kp: float
+    ki: float
+    kd: float
+    output_min: float
+    output_max: float
+
+    @staticmethod
+    def from_dict(data: Dict, kp: float, ki: float, kd: float,
+                  output_min: float, output_max: float) -> 'PIDParams':
+        return PIDParams(
+            kp=data.get('kp', kp),
+            ki=data.get('ki', ki),
+            kd=data.get('kd', kd),
+            output_min=data.get('output_min', output_min),
+            output_max=data.get('output_max', output_max)
+        )
+
+
+@dataclass(frozen=True)
+class MotorSection:
+    """Vorberechnete Motor-Parameter (Sektion 'motor')."""
+    pid_left: PIDParams
+    pid_right: PIDParams
+    pid_mow: PIDParams
+    max_motor_current: float
+    max_mow_current: float
+    max_overload_count: int
+    max_realistic_speed: float
+    ticks_per_meter: float
+    wheel_base: float
+    pwm_scale_factor: float
+    default_mow_pwm: int
+    mow_min_current_threshold: float
+    mow_max_current_threshold: float
+    adaptive_enabled: bool
+    adaptive_current_threshold_factor: float
+    adaptive_min_speed_factor: float
+
+    @staticmethod
+    def from_dict(motor: Dict) -> 'MotorSection':
+        pid = motor.get('pid', {})
+        limits = motor.get('limits', {})
+        physical = motor.get('physical', {})
+        mow = motor.get('mow', {})
+        adaptive = motor.get('adaptive', {})
+        return MotorSection(
+            pid_left=PIDParams.from_dict(pid.get('left', {}), 1.0, 0.1, 0.05, -255, 255),
+            pid_right=PIDParams.from_dict(pid.get('right', {}), 1.0, 0.1, 0.05, -255, 255),
+            pid_mow=PIDParams.from_dict(pid.get('mow', {}), 0.8, 0.05, 0.02, 0, 255),
+            max_motor_current=limits.get('max_motor_current', 3.0),
+            max_mow_current=limits.get('max_mow_current', 5.0),
+            max_overload_count=limits.get('max_overload_count', 5),
+            max_realistic_speed=limits.get('max_realistic_speed', 2.0),
+            ticks_per_meter=physical.get('ticks_per_meter', 1000),
+            wheel_base=physical.get('wheel_base', 0.3),
+            pwm_scale_factor=physical.get('pwm_scale_factor', 100),
+            default_mow_pwm=mow.get('default_pwm', 100),
+            mow_min_current_threshold=mow.get('min_current_threshold', 0.1),
+            mow_max_current_threshold=mow.get('max_current_threshold', 0.5),
+            adaptive_enabled=adaptive.get('enabled', True),
+            adaptive_current_threshold_factor=adaptive.get('current_threshold_factor', 0.7),
+            adaptive_min_speed_factor=adaptive.get('min_speed_factor', 0.3)
+        )
+
+
+@dataclass(frozen=True)
+class NavigationSection:
+    """Vorberechnete Navigations-Parameter (Sektion 'navigation')."""
+    heading_kp: float
+    heading_ki: float
+    heading_kd: float
+    distance_kp: float
+    distance_ki: float
+    distance_kd: float
+    max_linear_speed: float
+    max_angular_speed: float
+    min_turn_radius: float
+
+    @staticmethod
+    def from_dict(nav: Dict) -> 'NavigationSection':
+        return NavigationSection(
+            heading_kp=nav.get('heading_kp', 2.0),
+            heading_ki=nav.get('heading_ki', 0.1),
+            heading_kd=nav.get('heading_kd', 0.5),
+            distance_kp=nav.get('distance_kp', 1.0),
+            distance_ki=nav.get('distance_ki', 0.05),
+            distance_kd=nav.get('distance_kd', 0.2),
+            max_linear_speed=nav.get('max_linear_speed', 0.8),
+            max_angular_speed=nav.get('max_angular_speed', 1.5),
+            min_turn_radius=nav.get('min_turn_radius', 0.5)
+        )
+
+
+@dataclass(frozen=True)
+class AStarSection:
+    """Vorberechnete A*-Parameter (Sektion 'astar_pathfinding')."""
+    diagonal_movement: bool
+    heuristic_weight: float
+    obstacle_inflation: float
+    max_iterations: int
+
+    @staticmethod
+    def from_dict(astar: Dict) -> 'AStarSection':
+        return AStarSection(
+            diagonal_movement=astar.get('diagonal_movement', True),
+            heuristic_weight=astar.get('heuristic_weight', 1.0),
+            obstacle_inflation=astar.get('obstacle_inflation', 0.2),
+            max_iterations=astar.get('max_iterations', 10000)
+        )
+
+
+@dataclass(frozen=True)
+class PlanningSection:
+    """Vorberechnete Parameter der erweiterten Pfadplanung (Sektion 'advanced_path_planning')."""
+    strategy: str
+    max_segment_length: float
+    obstacle_detection_radius: float
+    replanning_threshold: float
+    max_dynamic_obstacles: int
+
+    @staticmethod
+    def from_dict(planning: Dict) -> 'PlanningSection':
+        return PlanningSection(
+            strategy=planning.get('strategy', 'hybrid'),
+            max_segment_length=planning.get('max_segment_length', 10.0),
+            obstacle_detection_radius=planning.get('obstacle_detection_radius', 1.0),
+            replanning_threshold=planning.get('replanning_threshold', 0.5),
+            max_dynamic_obstacles=planning.get('max_dynamic_obstacles', 50)
+        )
+
+
+@dataclass(frozen=True)
+class ConfigSnapshot:
+    """
+    Unveränderlicher Konfigurations-Snapshot.
+    
+    Wird einmal pro Laden bzw. pro set() aufgebaut und danach nur noch
+    gelesen. Leser greifen ohne Lock zu, da der Snapshot als Ganzes
+    atomar (eine Referenzzuweisung) ausgetauscht wird.
+    
+    Attribute:
+        version: Fortlaufende Nummer, steigt bei jedem Neuaufbau
+        motor, navigation, astar, planning: Typisierte Sektionen
+        flat: Punkt-Schlüssel -> Wert für O(1)-Zugriff in Config.get()
+    """
+    version: int
+    motor: MotorSection
+    navigation: NavigationSection
+    astar: AStarSection
+    planning: PlanningSection
+    flat: Mapping[str, Any]
+
+    def get(self, key: str, default: Any = None) -> Any:
+        """Wert per Punkt-Notation ohne Zerlegen des Schlüssels."""
+        return self.flat.get(key, default)
+
+    @staticmethod
+    def build(config: Dict, version: int) -> 'ConfigSnapshot':
+        flat: Dict[str, Any] = {}
+        _flatten(config, '', flat)
+        return ConfigSnapshot(
+            version=version,
+            motor=MotorSection.from_dict(config.get('motor', {})),
+            navigation=NavigationSection.from_dict(config.get('navigation', {})),
+            astar=AStarSection.from_dict(config.get('astar_pathfinding', {})),
+            planning=PlanningSection.from_dict(config.get('advanced_path_planning', {})),
+            flat=MappingProxyType(flat)
+        )
+
+
+def _flatten(data: Dict, prefix: str, out: Dict[str, Any]) -> None:
+    """Legt für jeden verschachtelten Schlüssel einen Punkt-Eintrag an."""
+    for key, value in data.items():
+        full_key = f"{prefix}{key}"
+        out[full_key] = value
+        if isinstance(value, dict):
+            _flatten(value, full_key + '.', out)
 
 class Config:
     """
@@ -74,8 +268,24 @@ class Config:
             config = Config('/path/to/my/config.json')
         """
         self.config_file = config_file
-        self.config = self._load_config()
+        self._write_lock = threading.Lock()
+        # Referenzen (WeakMethod bzw. Funktion), Aufruf liefert den Callback oder None
+        self._subscribers: List[Callable[[], Optional[Callable[[ConfigSnapshot], None]]]] = []
+        self._snapshot: Optional[ConfigSnapshot] = None
+        self._config: Dict = self._load_config()
         self._ensure_default_config()
+        self._publish_snapshot()
+    
+    @property
+    def config(self) -> Dict:
+        """Rohes Konfigurations-Dictionary."""
+        return self._config
+    
+    @config.setter
+    def config(self, value: Dict) -> None:
+        # Direkte Zuweisung ersetzt den Snapshot sofort mit
+        self._config = value
+        self._publish_snapshot()
     
     def _load_config(self) -> Dict:
         """
@@ -222,16 +432,7 @@ class Config:
             # Komplexe Struktur abrufen
             pid_config = config.get('motor.pid.left', {})
         """
-        keys = key.split('.')
-        value = self.config
-        
-        for k in keys:
-            if isinstance(value, dict) and k in value:
-                value = value[k]
-            else:
-                return default
-        
-        return value
+        return self._snapshot.flat.get(key, default)
     
     def set(self, key: str, value: Any) -> bool:
         """
@@ -267,18 +468,84 @@ class Config:
             config.set('custom.new_feature.enabled', True)
         """
         keys = key.split('.')
-        config = self.config
         
-        # Navigiere zu der gewünschten Sektion
-        for k in keys[:-1]:
-            if k not in config:
-                config[k] = {}
-            config = config[k]
+        with self._write_lock:
+            # Copy-on-write: nur der geänderte Zweig wird kopiert, ausgegebene
+            # Snapshots behalten ihre (unveränderten) Dictionaries
+            root = dict(self._config)
+            config = root
+            
+            # Navigiere zu der gewünschten Sektion
+            for k in keys[:-1]:
+                child = config.get(k)
+                config[k] = dict(child) if isinstance(child, dict) else {}
+                config = config[k]
+            
+            # Setze den Wert
+            config[keys[-1]] = copy.deepcopy(value)
+            self._config = root
+            
+            saved = self.save_config()
+        
+        self._publish_snapshot()
+        return saved
+    
+    def snapshot(self) -> ConfigSnapshot:
+        """
+        Gibt den aktuellen unveränderlichen Konfigurations-Snapshot zurück.
+        
+        Der Zugriff ist lock-frei. Komponenten sollten den Snapshot (oder
+        daraus abgeleitete Werte) cachen und sich per subscribe() über
+        Änderungen informieren lassen.
         
-        # Setze den Wert
-        config[keys[-1]] = value
+        Beispiel:
+            limits = config.snapshot().motor
+            if current > limits.max_motor_current:
+                motor.emergency_stop()
+        """
+        return self._snapshot
+    
+    def subscribe(self, callback: Callable[[ConfigSnapshot], None]) -> None:
+        """
+        Registriert einen Callback, der nach jedem Snapshot-Wechsel
+        (set, reload, reset_to_defaults) mit dem neuen Snapshot aufgerufen wird.
         
-        return self.save_config()
+        Gebundene Methoden werden nur schwach referenziert: ersetzte Instanzen
+        (z.B. Motor, AdvancedPathPlanner) bleiben nicht durch das Abonnement
+        am Leben und fallen beim nächsten Snapshot-Wechsel heraus.
+        """
+        if any(ref() == callback for ref in self._subscribers):
+            return
+        if inspect.ismethod(callback):
+            ref = weakref.WeakMethod(callback)
+        else:
+            ref = lambda: callback
+        self._subscribers = self._subscribers + [ref]
+    
+    def unsubscribe(self, callback: Callable[[ConfigSnapshot], None]) -> None:
+        """Entfernt einen registrierten Snapshot-Callback."""
+        self._subscribers = [ref for ref in self._subscribers
+                             if ref() is not None and ref() != callback]
+    
+    def _publish_snapshot(self) -> None:
+        """Baut einen neuen Snapshot, tauscht ihn atomar aus und benachrichtigt Abonnenten."""
+        with self._write_lock:
+            version = self._snapshot.version + 1 if self._snapshot else 1
+            snapshot = ConfigSnapshot.build(self.config, version)
+            self._snapshot = snapshot
+        
+        dead = False
+        for ref in self._subscribers:
+            callback = ref()
+            if callback is None:
+                dead = True
+                continue
+            try:
+                callback(snapshot)
+            except Exception as e:
+                print(f"Config: Fehler in Snapshot-Callback: {e}")
+        if dead:
+            self._subscribers = [ref for ref in self._subscribers if ref() is not None]
     
     def get_motor_config(self) -> Dict:
         """
@@ -361,8 +628,11 @@ class Config:
     def reload(self) -> bool:
         """Lädt die Konfiguration neu aus der Datei."""
         try:
-            self.config = self._load_config()
-            self._ensure_default_config()
+            config = self._load_config()
+            self._merge_defaults(config, self._get_default_config())
+            # Zuweisung tauscht den Snapshot atomar aus
+            self.config = config
+            self.save_config()
             return True
         except Exception as e:
             print(f"Config: Fehler beim Neuladen der Konfiguration: {e}")
@@ -428,6 +698,10 @@ def get_config(config_file: str = "/etc/mower/config.json") -> Config:
         _config_instance = Config(config_file)
     return _config_instance
 
+def get_config_snapshot() -> ConfigSnapshot:
+    """Gibt den aktuellen Snapshot der globalen Konfiguration zurück."""
+    return get_config().snapshot()
+
 def reload_config() -> bool:
     """Lädt die globale Konfiguration neu."""
     global _config_instance
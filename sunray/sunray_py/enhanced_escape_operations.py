@@ -2,6 +2,7 @@ import time
 import json
 import math
 import numpy as np
+from collections import deque
 from typing import Dict, List, Tuple, Optional, Any
 from abc import ABC, abstractmethod
 from op import Operation
@@ -34,8 +35,8 @@ class SensorFusion:
         }
         
         # Bewegungshistorie für Trendanalyse
-        self.movement_history = []
         self.max_history_length = 50
+        self.movement_history = deque(maxlen=self.max_history_length)
         
     def _init_kalman_filter(self):
         """Initialisiert erweiterten Kalman-Filter für Positionsschätzung."""
@@ -257,15 +258,13 @@ class SensorFusion:
     def _update_movement_history(self, state: Dict):
         """Aktualisiert Bewegungshistorie für Trendanalyse."""
         self.movement_history.append(state)
-        if len(self.movement_history) > self.max_history_length:
-            self.movement_history.pop(0)
     
     def get_movement_trend(self) -> Dict:
         """Analysiert Bewegungstrends aus der Historie."""
         if len(self.movement_history) < 5:
             return {'trend': 'insufficient_data'}
         
-        recent_states = self.movement_history[-10:]
+        recent_states = list(self.movement_history)[-10:]
         
         # Positionstrend
         positions = [s['position'] for s in recent_states]
@@ -295,6 +294,8 @@ class LearningSystem:
         self.learning_rate = 0.1
         self.success_threshold = 0.8
         self.min_samples_for_learning = 5
+        # Einzelversuche je Kontext; Erfolgsraten und optimierte Parameter sind bereits verdichtet
+        self.max_attempts_per_context = 100
         
     def _load_learning_data(self) -> Dict:
         """Lädt gespeicherte Lerndaten."""
@@ -336,7 +337,10 @@ class LearningSystem:
             'timestamp': time.time()
         }
         
-        self.learning_data['escape_strategies'][context_key].append(attempt)
+        attempts = self.learning_data['escape_strategies'][context_key]
+        attempts.append(attempt)
+        if len(attempts) > self.max_attempts_per_context:
+            del attempts[:-self.max_attempts_per_context]
         
         # Erfolgsraten aktualisieren
         self._update_success_rates(context_key, strategy, success)
@@ -19,7 +19,8 @@ import time
 from typing import Dict
 from config import Config
 from utils.lowpass_filter import LowPassFilter
-from utils.running_median import RunningMedian
+from utils.running_median import RunningQuantiles
+from utils.metrics import get_metrics
 
 class Battery:
     """
@@ -58,7 +59,10 @@ class Battery:
         
         # Filter initialisieren
         self.voltage_lowpass_filter = LowPassFilter(self.voltage_filter_time_constant)
-        self.voltage_median_filter = RunningMedian(self.voltage_median_filter_size)
+        # Ein Median-Filter für alle Spannungs- und Stromkanäle (ein Aufruf je Messung)
+        self.median_filter = RunningQuantiles(('battery_v', 'charge_v', 'charge_i'),
+                                              self.voltage_median_filter_size)
+        self.voltage_median_filter = self.median_filter.channel('battery_v')
         
         # Spannungsüberwachung für bestätigte Niederspannung
         self._low_voltage_start_time = None
@@ -77,6 +81,13 @@ class Battery:
         self._next_battery_time = 0.0
         self._next_enable_time = 0.0
         self._charging_start = 0.0
+        
+        # Metriken (/metrics)
+        metrics = get_metrics()
+        metrics.gauge('sunray_battery_voltage', 'Gefilterte Batteriespannung',
+                      fn=lambda: self._last_battery_voltage)
+        metrics.gauge('sunray_battery_charger_connected', 'Ladegerät angeschlossen (1/0)',
+                      fn=lambda: self.charger_connected_state)
 
         self.begin()
 
@@ -96,6 +107,27 @@ class Battery:
         self._low_voltage_start_time = None
         self._switch_off_voltage_start_time = None
 
+    def checkpoint_state(self) -> Dict:
+        """Filter- und Ladezustand für den Warmstart (siehe checkpoint.py)."""
+        return {
+            'voltage_lowpass': self.voltage_lowpass_filter._last,
+            'median_filter': self.median_filter.state(),
+            'last_battery_voltage': self._last_battery_voltage,
+            'docked': self.docked,
+            'charging_completed': self._charging_completed
+        }
+
+    def restore_checkpoint(self, state: Dict) -> None:
+        """Stellt Filter- und Ladezustand wieder her, damit der Filter nicht neu einschwingt."""
+        if 'median_filter' in state:
+            self.median_filter.restore(state['median_filter'])
+        if state.get('voltage_lowpass'):
+            self.voltage_lowpass_filter._last = state['voltage_lowpass']
+            self.voltage_lowpass_filter._last_time = time.time()
+        self._last_battery_voltage = state.get('last_battery_voltage', 0.0)
+        self.docked = state.get('docked', False)
+        self._charging_completed = state.get('charging_completed', False)
+
     def enable_charging(self, flag: bool):
         """
         Setzt das Lade-Relais (extern). Hier nur internes Flag setzen.
@@ -191,12 +223,16 @@ class Battery:
 
         # Spannungsfilterung anwenden
         if self.voltage_filter_enabled:
-            # Median-Filter für Ausreißer-Entfernung
-            self.voltage_median_filter.add(battery_v)
-            median_voltage = self.voltage_median_filter.median()
+            # Median-Filter für Ausreißer-Entfernung (alle Kanäle)
+            # Ladeerkennung und Ladeende prüfen ebenfalls die Medianwerte,
+            # damit einzelne Ausreißer das Laden nicht beenden
+            medians = self.median_filter.update((battery_v, charge_v, charge_i))
+            battery_v = medians['battery_v']
+            charge_v = medians['charge_v']
+            charge_i = medians['charge_i']
             
             # Tiefpass-Filter für Glättung
-            filtered_voltage = self.voltage_lowpass_filter(median_voltage)
+            filtered_voltage = self.voltage_lowpass_filter(battery_v)
         else:
             filtered_voltage = battery_v
         
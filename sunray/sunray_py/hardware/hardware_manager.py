@@ -18,6 +18,7 @@ import threading
 from typing import Dict, Optional, Callable, Any
 from pico_comm import PicoComm
 from config import get_config
+from utils.metrics import get_metrics
 
 class HardwareManager:
     """
@@ -79,6 +80,13 @@ class HardwareManager:
         self.hardware_connected = False
         self.communication_errors = 0
         self.max_communication_errors = 10
+        
+        # Metriken (/metrics): Gesamtzahlen, communication_errors wird bei Erfolg zurückgesetzt
+        metrics = get_metrics()
+        self.metric_messages = metrics.counter('sunray_pico_messages', 'Verarbeitete Sensorzeilen vom Pico')
+        self.metric_errors = metrics.counter('sunray_pico_communication_errors', 'Kommunikationsfehler zum Pico')
+        metrics.gauge('sunray_pico_connected', 'Pico-Verbindung aktiv (1/0)',
+                      fn=lambda: self.hardware_connected)
     
     def begin(self) -> bool:
         """
@@ -144,11 +152,13 @@ class HardwareManager:
                         
                         # Kommunikationsfehler zurücksetzen
                         self.communication_errors = 0
+                        self.metric_messages.inc()
                 
                 time.sleep(0.01)  # 100Hz Datenrate
                 
             except Exception as e:
                 self.communication_errors += 1
+                self.metric_errors.inc()
                 if self.communication_errors >= self.max_communication_errors:
                     print(f"HardwareManager: Zu viele Kommunikationsfehler: {e}")
                     self.hardware_connected = False
@@ -31,6 +31,7 @@ import math
 from typing import Tuple, Dict, Optional, List
 from utils.pid import PID, VelocityPID
 from config import get_config
+from utils.metrics import get_metrics
 from navigation.path_planner import PathPlanner, MowPattern
 from map import Point, Polygon
 
@@ -78,25 +79,24 @@ class Motor:
         self.hardware_manager = hardware_manager
         self.config = get_config()
         
-        # PID-Regler für Geschwindigkeitsregelung aus Konfiguration
-        left_pid_config = self.config.get_pid_config('left')
-        right_pid_config = self.config.get_pid_config('right')
-        mow_pid_config = self.config.get_pid_config('mow')
+        # Typisierter Konfigurations-Snapshot (einmal pro Laden aufgebaut)
+        motor_cfg = self.config.snapshot().motor
         
+        # PID-Regler für Geschwindigkeitsregelung aus Konfiguration
         self.left_pid = VelocityPID(
-            Kp=left_pid_config.get('kp', 1.0),
-            Ki=left_pid_config.get('ki', 0.1),
-            Kd=left_pid_config.get('kd', 0.05)
+            Kp=motor_cfg.pid_left.kp,
+            Ki=motor_cfg.pid_left.ki,
+            Kd=motor_cfg.pid_left.kd
         )
         self.right_pid = VelocityPID(
-            Kp=right_pid_config.get('kp', 1.0),
-            Ki=right_pid_config.get('ki', 0.1),
-            Kd=right_pid_config.get('kd', 0.05)
+            Kp=motor_cfg.pid_right.kp,
+            Ki=motor_cfg.pid_right.ki,
+            Kd=motor_cfg.pid_right.kd
         )
         self.mow_pid = PID(
-            Kp=mow_pid_config.get('kp', 0.8),
-            Ki=mow_pid_config.get('ki', 0.05),
-            Kd=mow_pid_config.get('kd', 0.02)
+            Kp=motor_cfg.pid_mow.kp,
+            Ki=motor_cfg.pid_mow.ki,
+            Kd=motor_cfg.pid_mow.kd
         )
         
         # Motorstatus
@@ -126,30 +126,19 @@ class Motor:
         self.last_mow_odom = 0
         self.last_odom_time = time.time()
         
-        # Überlastungsschutz aus Konfiguration
-        limits_config = self.config.get_motor_limits()
-        self.max_motor_current = limits_config.get('max_motor_current', 3.0)
-        self.max_mow_current = limits_config.get('max_mow_current', 5.0)
+        # Überlastungsschutz, physikalische Parameter, Mähmotor und
+        # adaptive Geschwindigkeit aus dem Snapshot übernehmen
         self.overload_count = 0
-        self.max_overload_count = limits_config.get('max_overload_count', 5)
-        
-        # Physikalische Parameter aus Konfiguration
-        physical_config = self.config.get_physical_config()
-        self.ticks_per_meter = physical_config.get('ticks_per_meter', 1000)
-        self.wheel_base = physical_config.get('wheel_base', 0.3)
-        self.pwm_scale_factor = physical_config.get('pwm_scale_factor', 100)
-        
-        # Mähmotor-Konfiguration
-        mow_config = self.config.get('motor.mow', {})
-        self.default_mow_pwm = mow_config.get('default_pwm', 100)
-        self.mow_min_current_threshold = mow_config.get('min_current_threshold', 0.1)
-        self.mow_max_current_threshold = mow_config.get('max_current_threshold', 0.5)
-        
-        # Adaptive Geschwindigkeitsanpassung
-        adaptive_config = self.config.get('motor.adaptive', {})
-        self.adaptive_enabled = adaptive_config.get('enabled', True)
-        self.adaptive_current_threshold_factor = adaptive_config.get('current_threshold_factor', 0.7)
-        self.adaptive_min_speed_factor = adaptive_config.get('min_speed_factor', 0.3)
+        self._apply_motor_config(motor_cfg)
+        
+        # Metriken (/metrics)
+        metrics = get_metrics()
+        self.metric_overloads = metrics.counter('sunray_motor_overloads', 'Regelzyklen mit erkannter Motorüberlastung')
+        self.metric_overload_stops = metrics.counter('sunray_motor_overload_stops', 'Notstopps wegen Überlastung')
+        currents = metrics.gauge('sunray_motor_current_amperes', 'Motorstrom', ('motor',))
+        currents.labels('left').set_function(lambda: self.current_left_current)
+        currents.labels('right').set_function(lambda: self.current_right_current)
+        currents.labels('mow').set_function(lambda: self.current_mow_current)
         
         # Pfadplanung und Navigation
         self.path_planner = PathPlanner()
@@ -162,22 +151,70 @@ class Motor:
         self.obstacles = []  # Liste der Hindernisse
         
         # Navigation PID-Regler
-        nav_config = self.config.get('navigation', {})
+        nav_cfg = self.config.snapshot().navigation
         self.heading_pid = PID(
-            Kp=nav_config.get('heading_kp', 2.0),
-            Ki=nav_config.get('heading_ki', 0.1),
-            Kd=nav_config.get('heading_kd', 0.5)
+            Kp=nav_cfg.heading_kp,
+            Ki=nav_cfg.heading_ki,
+            Kd=nav_cfg.heading_kd
         )
         self.distance_pid = PID(
-            Kp=nav_config.get('distance_kp', 1.0),
-            Ki=nav_config.get('distance_ki', 0.05),
-            Kd=nav_config.get('distance_kd', 0.2)
+            Kp=nav_cfg.distance_kp,
+            Ki=nav_cfg.distance_ki,
+            Kd=nav_cfg.distance_kd
         )
         
         # Navigationsparameter
-        self.max_linear_speed = nav_config.get('max_linear_speed', 0.8)  # m/s
-        self.max_angular_speed = nav_config.get('max_angular_speed', 1.5)  # rad/s
-        self.min_turn_radius = nav_config.get('min_turn_radius', 0.5)  # Meter
+        self.max_linear_speed = nav_cfg.max_linear_speed  # m/s
+        self.max_angular_speed = nav_cfg.max_angular_speed  # rad/s
+        self.min_turn_radius = nav_cfg.min_turn_radius  # Meter
+        
+        # Bei Konfigurationsänderungen gecachte Parameter aktualisieren
+        self.config.subscribe(self._on_config_changed)
+
+    def _apply_motor_config(self, motor_cfg) -> None:
+        """
+        Übernimmt Grenzwerte und Parameter aus der Motor-Sektion eines
+        Konfigurations-Snapshots in die gecachten Attribute.
+        """
+        self.max_motor_current = motor_cfg.max_motor_current
+        self.max_mow_current = motor_cfg.max_mow_current
+        self.max_overload_count = motor_cfg.max_overload_count
+        self.max_realistic_speed = motor_cfg.max_realistic_speed
+        
+        self.ticks_per_meter = motor_cfg.ticks_per_meter
+        self.wheel_base = motor_cfg.wheel_base
+        self.pwm_scale_factor = motor_cfg.pwm_scale_factor
+        
+        self.default_mow_pwm = motor_cfg.default_mow_pwm
+        self.mow_min_current_threshold = motor_cfg.mow_min_current_threshold
+        self.mow_max_current_threshold = motor_cfg.mow_max_current_threshold
+        
+        self.adaptive_enabled = motor_cfg.adaptive_enabled
+        self.adaptive_current_threshold_factor = motor_cfg.adaptive_current_threshold_factor
+        self.adaptive_min_speed_factor = motor_cfg.adaptive_min_speed_factor
+
+    def _on_config_changed(self, snapshot) -> None:
+        """
+        Snapshot-Callback der Konfiguration (Hot-Reload).
+        
+        Überschreibt nur Parameter und Verstärkungen; Integratorzustände
+        der PID-Regler bleiben erhalten, damit die Regelung nicht springt.
+        """
+        motor_cfg = snapshot.motor
+        for pid, params in ((self.left_pid, motor_cfg.pid_left),
+                            (self.right_pid, motor_cfg.pid_right),
+                            (self.mow_pid, motor_cfg.pid_mow)):
+            pid.Kp, pid.Ki, pid.Kd = params.kp, params.ki, params.kd
+        self._apply_motor_config(motor_cfg)
+        
+        nav_cfg = snapshot.navigation
+        self.heading_pid.Kp, self.heading_pid.Ki, self.heading_pid.Kd = (
+            nav_cfg.heading_kp, nav_cfg.heading_ki, nav_cfg.heading_kd)
+        self.distance_pid.Kp, self.distance_pid.Ki, self.distance_pid.Kd = (
+            nav_cfg.distance_kp, nav_cfg.distance_ki, nav_cfg.distance_kd)
+        self.max_linear_speed = nav_cfg.max_linear_speed
+        self.max_angular_speed = nav_cfg.max_angular_speed
+        self.min_turn_radius = nav_cfg.min_turn_radius
 
     def begin(self) -> None:
         """
@@ -249,7 +286,9 @@ class Motor:
         if overload_flag or self._check_current_overload():
             self.overload_detected = True
             self.overload_count += 1
+            self.metric_overloads.inc()
             if self.overload_count >= self.max_overload_count:
+                self.metric_overload_stops.inc()
                 self.stop_immediately()
                 print(f"Motor: Überlastung erkannt - Motoren gestoppt")
         else:
@@ -747,7 +786,7 @@ class Motor:
         """
         # Prüfe auf unrealistische Odometrie-Sprünge
         current_speeds = self._calculate_speeds()
-        max_realistic_speed = self.config.get('motor.limits.max_realistic_speed', 2.0)
+        max_realistic_speed = self.max_realistic_speed
         
         return (abs(current_speeds['left']) > max_realistic_speed or 
                 abs(current_speeds['right']) > max_realistic_speed)
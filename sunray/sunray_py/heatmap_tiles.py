@@ -0,0 +1,341 @@
+"""
+Heatmap-Kacheln für die Web-Oberfläche (Mähabdeckung, GPS-Genauigkeit, Mähmotorstrom).
+
+Statt jeden Messpunkt an den Browser zu schicken, sammelt der Pi die Werte in
+Rasterebenen und liefert sie als PNG-Kacheln (256x256, Palettenbild) je Zoomstufe:
+
+- Koordinaten: lokale Meter (x Ost, y Nord) wie robot_state und Track-Archiv
+- Zoomstufe max_zoom hat die volle Auflösung (resolution Meter je Pixel), jede
+  Stufe darunter halbiert sie; alle Stufen werden beim Eintreffen eines Werts
+  inkrementell mitgeführt, eine Kachel ist also nie teurer als 256x256 Pixel
+- Jede Kachel hält ihre Pixel bereits als PNG-Zeilen (Filterbyte + Palettenindex);
+  gerendert werden nur Kacheln, deren Version sich seit dem letzten Abruf geändert hat
+- changes(since) nennt die geänderten Kacheln, der Browser lädt nur diese nach
+
+Ebenenarten:
+  coverage: Überfahrten je Zelle (Mähbreite als Kreis gestempelt, je Überfahrt einmal);
+            gröbere Stufen zeigen das Maximum der enthaltenen Zellen
+  mean:     Mittelwert aller Messungen in der Zelle (auf jeder Stufe exakt)
+
+Verwendung:
+  heatmap = get_heatmap_tiles(config.get('heatmap', {}))
+  heatmap.add_sample(x, y, mowing=True, gps_accuracy=0.02, mow_current=1.2)   # Regelschleife
+  png, version = heatmap.render_tile('coverage', z, tx, ty)                  # Web-Server
+"""
+
+import math
+import struct
+import threading
+import zlib
+from array import array
+from typing import Dict, Iterable, List, Optional, Tuple
+
+TILE_SIZE = 256
+TILE_SHIFT = 8
+ROW_BYTES = TILE_SIZE + 1  # Filterbyte je Zeile
+
+DEFAULT_LAYERS = {
+    'coverage': {'label': 'Mähabdeckung', 'unit': 'Überfahrten', 'mode': 'coverage',
+                 'min': 1, 'max': 4, 'colors': [[200, 240, 200], [76, 175, 80], [20, 90, 30]]},
+    'gps_accuracy': {'label': 'GPS-Genauigkeit', 'unit': 'm', 'mode': 'mean',
+                     'min': 0.01, 'max': 0.3, 'colors': [[40, 160, 60], [250, 200, 0], [220, 40, 40]]},
+    'mow_current': {'label': 'Mähmotorstrom', 'unit': 'A', 'mode': 'mean',
+                    'min': 0.5, 'max': 3.0, 'colors': [[40, 90, 220], [250, 200, 0], [220, 40, 40]]}
+}
+
+def _png_chunk(kind: bytes, data: bytes) -> bytes:
+    return struct.pack('>I', len(data)) + kind + data + struct.pack('>I', zlib.crc32(kind + data))
+
+def build_palette(colors: List[List[int]], alpha: int) -> Tuple[bytes, bytes]:
+    """PLTE- und tRNS-Daten: Index 0 transparent, 1-255 als Farbverlauf über colors."""
+    plte = bytearray(3)
+    for i in range(255):
+        position = i / 254 * (len(colors) - 1)
+        low = min(int(position), len(colors) - 2) if len(colors) > 1 else 0
+        frac = position - low if len(colors) > 1 else 0.0
+        high = min(low + 1, len(colors) - 1)
+        plte += bytes(int(round(colors[low][c] + (colors[high][c] - colors[low][c]) * frac)) for c in range(3))
+    trns = bytes([0]) + bytes([alpha]) * 255
+    return bytes(plte), trns
+
+def encode_png(rows: bytes, plte: bytes, trns: bytes, level: int = 6) -> bytes:
+    """Kodiert ein 256x256-Palettenbild; rows enthält bereits die Filterbytes."""
+    header = struct.pack('>IIBBBBB', TILE_SIZE, TILE_SIZE, 8, 3, 0, 0, 0)
+    return (b'\x89PNG\r\n\x1a\n' + _png_chunk(b'IHDR', header) + _png_chunk(b'PLTE', plte) +
+            _png_chunk(b'tRNS', trns) + _png_chunk(b'IDAT', zlib.compress(rows, level)) +
+            _png_chunk(b'IEND', b''))
+
+class _Tile:
+    """Werte und PNG-Zeilen einer Kachel auf einer Zoomstufe."""
+    __slots__ = ('counts', 'sums', 'rows', 'version', 'png', 'png_version')
+
+    def __init__(self, with_sums: bool):
+        self.counts = array('H', bytes(2 * TILE_SIZE * TILE_SIZE))
+        self.sums = array('f', bytes(4 * TILE_SIZE * TILE_SIZE)) if with_sums else None
+        self.rows = bytearray(ROW_BYTES * TILE_SIZE)
+        self.version = 0
+        self.png: Optional[bytes] = None
+        self.png_version = -1
+
+class _Layer:
+    def __init__(self, name: str, config: Dict, levels: int, alpha: int):
+        self.name = name
+        self.config = config
+        self.mode = config.get('mode', 'mean')
+        self.min = float(config['min'])
+        self.span = max(1e-9, float(config['max']) - self.min)
+        self.palette = build_palette(config['colors'], alpha)
+        self.levels: List[Dict[Tuple[int, int], _Tile]] = [{} for _ in range(levels)]
+
+    def index(self, value: float) -> int:
+        return 1 + min(254, max(0, int(round((value - self.min) / self.span * 254))))
+
+class HeatmapTiles:
+    """
+    Rasterebenen mit Kachelpyramide und PNG-Cache.
+    config (Abschnitt 'heatmap' in config.json):
+      resolution: Meter je Pixel auf der höchsten Zoomstufe
+      max_zoom: Anzahl gröberer Stufen (Stufe 0: resolution * 2^max_zoom Meter je Pixel)
+      mow_width: Mähbreite in Metern für die Abdeckung
+      alpha: Deckkraft der Kacheln (0-255)
+      layers: Ebenen mit label, unit, mode ('coverage'/'mean'), min, max, colors
+    """
+    def __init__(self, config: Optional[Dict] = None):
+        config = config or {}
+        self.resolution = config.get('resolution', 0.1)
+        self.max_zoom = config.get('max_zoom', 6)
+        self.mow_width = config.get('mow_width', 0.3)
+        self.compress_level = config.get('compress_level', 6)
+        alpha = config.get('alpha', 190)
+        self.layers = {name: _Layer(name, layer, self.max_zoom + 1, alpha)
+                       for name, layer in config.get('layers', DEFAULT_LAYERS).items()}
+        self.origin: Optional[Tuple[float, float]] = None
+        self.version = 0
+        self._next_version = 1
+        self._changed = False
+        self.bounds: Optional[List[float]] = None
+        self._last_stamp: frozenset = frozenset()
+        self._lock = threading.Lock()
+        self.samples = 0
+        self.renders = 0
+        self._empty_png = {}
+
+    def set_origin(self, lat: float, lon: float) -> None:
+        """GPS-Ursprung der lokalen Koordinaten (für die Umrechnung im Browser)."""
+        self.origin = (lat, lon)
+
+    def _tile(self, layer: _Layer, z: int, cx: int, cy: int) -> Tuple[_Tile, int]:
+        key = (cx >> TILE_SHIFT, cy >> TILE_SHIFT)
+        tile = layer.levels[z].get(key)
+        if tile is None:
+            tile = layer.levels[z][key] = _Tile(layer.mode == 'mean')
+        # Zeile 0 liegt im Norden
+        row = TILE_SIZE - 1 - (cy & (TILE_SIZE - 1))
+        return tile, row * TILE_SIZE + (cx & (TILE_SIZE - 1))
+
+    def _set_pixel(self, tile: _Tile, i: int, index: int) -> None:
+        offset = (i >> TILE_SHIFT) * ROW_BYTES + 1 + (i & (TILE_SIZE - 1))
+        if tile.rows[offset] != index:
+            tile.rows[offset] = index
+            tile.version = self._next_version
+            self._changed = True
+
+    def _add_mean(self, layer: _Layer, cx: int, cy: int, value: float) -> None:
+        for z in range(self.max_zoom, -1, -1):
+            tile, i = self._tile(layer, z, cx, cy)
+            if tile.counts[i] < 65535:
+                tile.counts[i] += 1
+                tile.sums[i] += value
+            self._set_pixel(tile, i, layer.index(tile.sums[i] / tile.counts[i]))
+            cx >>= 1
+            cy >>= 1
+
+    def _add_pass(self, layer: _Layer, cx: int, cy: int) -> None:
+        tile, i = self._tile(layer, self.max_zoom, cx, cy)
+        passes = min(65535, tile.counts[i] + 1)
+        tile.counts[i] = passes
+        self._set_pixel(tile, i, layer.index(passes))
+        # Gröbere Stufen: Maximum der enthaltenen Zellen
+        for z in range(self.max_zoom - 1, -1, -1):
+            cx >>= 1
+            cy >>= 1
+            tile, i = self._tile(layer, z, cx, cy)
+            if tile.counts[i] >= passes:
+                break
+            tile.counts[i] = passes
+            self._set_pixel(tile, i, layer.index(passes))
+
+    def _disc(self, x: float, y: float) -> frozenset:
+        radius = self.mow_width / 2
+        cells = []
+        r = int(math.ceil(radius / self.resolution))
+        cx0 = int(math.floor(x / self.resolution))
+        cy0 = int(math.floor(y / self.resolution))
+        for dy in range(-r, r + 1):
+            for dx in range(-r, r + 1):
+                px = (cx0 + dx + 0.5) * self.resolution - x
+                py = (cy0 + dy + 0.5) * self.resolution - y
+                if px * px + py * py <= radius * radius:
+                    cells.append((cx0 + dx, cy0 + dy))
+        return frozenset(cells)
+
+    def add_sample(self, x: float, y: float, mowing: bool = False, **values: Optional[float]) -> None:
+        """
+        Trägt eine Messung an Position (x, y) ein.
+        mowing: Abdeckung stempeln (nur neu überfahrene Zellen zählen)
+        values: Messwerte je 'mean'-Ebene, z.B. gps_accuracy=0.02; None wird ignoriert
+        """
+        cx = int(math.floor(x / self.resolution))
+        cy = int(math.floor(y / self.resolution))
+        with self._lock:
+            # Version nur erhöhen, wenn sich tatsächlich ein Pixel geändert hat
+            self._next_version = self.version + 1
+            self._changed = False
+            self.samples += 1
+            for name, value in values.items():
+                layer = self.layers.get(name)
+                if value is not None and layer is not None and layer.mode == 'mean':
+                    self._add_mean(layer, cx, cy, float(value))
+            if mowing:
+                stamp = self._disc(x, y)
+                for layer in self.layers.values():
+                    if layer.mode == 'coverage':
+                        for cell in stamp - self._last_stamp:
+                            self._add_pass(layer, *cell)
+                self._last_stamp = stamp
+            else:
+                self._last_stamp = frozenset()
+            if self.bounds is None:
+                self.bounds = [x, y, x, y]
+            else:
+                self.bounds = [min(self.bounds[0], x), min(self.bounds[1], y),
+                               max(self.bounds[2], x), max(self.bounds[3], y)]
+            if self._changed:
+                self.version = self._next_version
+
+    def tile_meters(self, z: int) -> float:
+        """Kantenlänge einer Kachel der Stufe z in Metern."""
+        return self.resolution * (1 << (self.max_zoom - z)) * TILE_SIZE
+
+    def render_tile(self, layer_name: str, z: int, tx: int, ty: int) -> Optional[Tuple[bytes, int]]:
+        """
+        PNG einer Kachel und ihre Version; (transparente Kachel, 0) ohne Daten,
+        None für unbekannte Ebene oder Zoomstufe. Unveränderte Kacheln kommen aus dem Cache.
+        """
+        layer = self.layers.get(layer_name)
+        if layer is None or not 0 <= z <= self.max_zoom:
+            return None
+        with self._lock:
+            tile = layer.levels[z].get((tx, ty))
+            if tile is None:
+                empty = self._empty_png.get(layer_name)
+                if empty is None:
+                    empty = self._empty_png[layer_name] = encode_png(
+                        bytes(ROW_BYTES * TILE_SIZE), *layer.palette, level=9)
+                return empty, 0
+            if tile.png_version == tile.version:
+                return tile.png, tile.version
+            version = tile.version
+            rows = bytes(tile.rows)
+        png = encode_png(rows, *layer.palette, level=self.compress_level)
+        with self._lock:
+            self.renders += 1
+            if tile.version == version:
+                tile.png, tile.png_version = png, version
+        return png, version
+
+    def changes(self, since: int, layers: Optional[Iterable[str]] = None,
+                zoom: Optional[int] = None) -> List[List]:
+        """Kacheln, die sich nach Version since geändert haben: [[layer, z, tx, ty, version], ...]."""
+        result = []
+        with self._lock:
+            for name in layers or self.layers:
+                layer = self.layers.get(name)
+                if layer is None:
+                    continue
+                levels = [zoom] if zoom is not None and 0 <= zoom <= self.max_zoom else range(len(layer.levels))
+                for z in levels:
+                    for (tx, ty), tile in layer.levels[z].items():
+                        if tile.version > since:
+                            result.append([name, z, tx, ty, tile.version])
+        return result
+
+    def clear(self) -> None:
+        """Verwirft alle Ebenen (z.B. vor einer neuen Saison)."""
+        with self._lock:
+            for layer in self.layers.values():
+                layer.levels = [{} for _ in range(self.max_zoom + 1)]
+            self.bounds = None
+            self._last_stamp = frozenset()
+            self.version += 1
+
+    def get_metadata(self) -> Dict:
+        """Raster, Ebenen mit Legende, Datenausdehnung und aktuelle Version für den Browser."""
+        with self._lock:
+            tiles = sum(len(level) for layer in self.layers.values() for level in layer.levels)
+            return {
+                'resolution': self.resolution,
+                'tile_size': TILE_SIZE,
+                'min_zoom': 0,
+                'max_zoom': self.max_zoom,
+                'origin': list(self.origin) if self.origin else None,
+                'bounds': list(self.bounds) if self.bounds else None,
+                'version': self.version,
+                'layers': {name: {key: layer.config[key] for key in ('label', 'unit', 'min', 'max', 'colors')
+                                  if key in layer.config}
+                           for name, layer in self.layers.items()},
+                'statistics': {'samples': self.samples, 'tiles': tiles, 'renders': self.renders}
+            }
+
+def install_heatmap_routes(app, heatmap: HeatmapTiles) -> None:
+    """
+    Registriert die Heatmap-Endpunkte an einer Flask-App:
+      GET    /api/heatmap                              Metadaten und Legende
+      GET    /api/heatmap/changes?since=&layer=&z=     geänderte Kacheln
+      GET    /api/heatmap/<layer>/<z>/<tx>/<ty>.png    Kachel (ETag, 304)
+      DELETE /api/heatmap                              alle Ebenen verwerfen
+    """
+    from flask import request, jsonify, make_response
+
+    def heatmap_metadata():
+        if request.method == 'DELETE':
+            heatmap.clear()
+            return jsonify({'cleared': True, 'version': heatmap.version})
+        return jsonify(heatmap.get_metadata())
+
+    def heatmap_changes():
+        since = request.args.get('since', 0, type=int)
+        layer = request.args.get('layer')
+        tiles = heatmap.changes(since, [layer] if layer else None, request.args.get('z', type=int))
+        return jsonify({'version': heatmap.version, 'tiles': tiles})
+
+    def heatmap_tile(layer, z, tx, ty):
+        result = heatmap.render_tile(layer, z, tx, ty)
+        if result is None:
+            return jsonify({'error': 'Unbekannte Ebene oder Zoomstufe'}), 404
+        png, version = result
+        etag = f'"{layer}-{z}-{tx}-{ty}-{version}"'
+        if request.headers.get('If-None-Match') == etag:
+            response = make_response(b'', 304)
+        else:
+            response = make_response(png)
+            response.headers['Content-Type'] = 'image/png'
+        response.headers['ETag'] = etag
+        # Mit ?v= (Version aus changes) unveränderlich, sonst immer revalidieren
+        response.headers['Cache-Control'] = 'public, max-age=86400, immutable' \
+            if request.args.get('v') == str(version) else 'no-cache'
+        return response
+
+    app.add_url_rule('/api/heatmap', 'heatmap_metadata', heatmap_metadata, methods=['GET', 'DELETE'])
+    app.add_url_rule('/api/heatmap/changes', 'heatmap_changes', heatmap_changes)
+    app.add_url_rule('/api/heatmap/<layer>/<int:z>/<int(signed=True):tx>/<int(signed=True):ty>.png',
+                     'heatmap_tile', heatmap_tile)
+
+_heatmap_tiles: Optional[HeatmapTiles] = None
+
+def get_heatmap_tiles(config: Optional[Dict] = None) -> HeatmapTiles:
+    """Gibt die globalen Heatmap-Ebenen zurück (Konfiguration nur beim ersten Aufruf)."""
+    global _heatmap_tiles
+    if _heatmap_tiles is None:
+        _heatmap_tiles = HeatmapTiles(config)
+    return _heatmap_tiles
@@ -1,18 +1,29 @@
-from flask import Flask, request, jsonify, render_template_string, send_from_directory
+from flask import Flask, request, jsonify, render_template_string, send_from_directory, Response
 import os
 import psutil
 import json
+import sys
 import subprocess
 import time
 from datetime import datetime
-from imu import IMUSensor
-from gps_module import GPSModule
 from hardware_manager import get_hardware_manager
 from path_planner import MowPattern
 from map import Point, Polygon
 from enhanced_escape_operations import SensorFusion, LearningSystem, AdaptiveEscapeOp
 from examples.integration_example import EnhancedSunrayController
 from smart_button_controller import get_smart_button_controller, ButtonAction
+from utils.startup_profiler import get_startup_timeline
+from track_archive import TrackArchive
+from communication.event_stream import get_event_hub, subscribe_from_args, SSE_HEADERS
+from communication.map_changes import get_map_changes, install_change_routes
+from utils.snapshot import get_telemetry_snapshot, thaw
+from web_serving import ResponseCache, get_content_versions, get_worker_slots, file_version
+from navigation.plan_codec import iter_plan_chunks, plan_size
+from navigation.planning_jobs import get_planning_jobs
+from heatmap_tiles import get_heatmap_tiles, install_heatmap_routes
+from utils.metrics import get_metrics, install_metrics_routes
+from utils.trace import get_tracer, install_trace_routes
+from utils.sampling_profiler import get_profiler, install_profiler_routes
 
 # Hardware-Konfiguration laden
 def load_hardware_config():
@@ -30,9 +41,50 @@ def load_hardware_config():
     except (FileNotFoundError, json.JSONDecodeError, KeyError):
         return {'port': '/dev/ttyS0', 'baudrate': 115200}
 
+def load_web_server_config():
+    """Lädt den Abschnitt 'web_server' aus config.json."""
+    try:
+        with open('config.json', 'r') as f:
+            return json.load(f).get('web_server', {})
+    except (FileNotFoundError, json.JSONDecodeError):
+        return {}
+
+def load_track_archive_config():
+    """Lädt den Abschnitt 'track_archive' aus config.json (wie main.py)."""
+    try:
+        with open('config.json', 'r') as f:
+            return json.load(f).get('track_archive', {})
+    except (FileNotFoundError, json.JSONDecodeError):
+        return {}
+
 app = Flask(__name__, static_folder='static', static_url_path='/static')
-imu = IMUSensor()
-gps = GPSModule()
+# Dasselbe Verzeichnis wie die Aufzeichnung in main.py (set_track_archive() teilt dessen Instanz)
+track_archive = TrackArchive(load_track_archive_config().get('directory', 'tracks'))
+event_hub = get_event_hub()
+# SSE-Streams und Long-Polls teilen sich ein Kontingent des Worker-Pools
+worker_slots = get_worker_slots()
+# Sensordaten kommen ausschließlich aus dem Snapshot der Regelschleife;
+# Anfragen lesen nie selbst von I2C oder der GPS-Schnittstelle
+snapshots = get_telemetry_snapshot()
+# Antwort-Cache mit ETags für Karten-, Zonen- und Track-Endpunkte
+content_versions = get_content_versions()
+response_cache = ResponseCache(content_versions)
+# Planung läuft als Auftrag in einem eigenen Prozess (Konfiguration durch main.py)
+planning_jobs = get_planning_jobs()
+# Heatmap-Kacheln aus der Regelschleife (/api/heatmap/...)
+install_heatmap_routes(app, get_heatmap_tiles())
+# Metriken aller Subsysteme im OpenMetrics-Format (/metrics)
+install_metrics_routes(app, get_metrics())
+# Trace-Aufzeichnung (Regelschleife, Pico, Planer, Anfragen) als Chrome-Trace (/api/trace)
+install_trace_routes(app, get_tracer())
+# Sampling-Profiler aller Threads, gefaltete Stacks für Flamegraphs (/api/profile)
+install_profiler_routes(app, get_profiler())
+# Versionierte Zonen-, Hindernis- und Plan-Diffs für verbundene Clients (/api/changes)
+map_changes = get_map_changes()
+map_changes.track('zones', encode=lambda polygon: polygon.to_list())
+map_changes.track('obstacles', encode=lambda polygon: polygon.to_list())
+map_changes.track('plan', mode='sequence', encode=lambda segment: path_planner.export_segment(segment))
+install_change_routes(app, map_changes)
 
 # Hardware Manager mit konfigurierbaren Einstellungen
 hw_config = load_hardware_config()
@@ -45,6 +97,8 @@ enhanced_controller = None
 sensor_fusion = None
 learning_system = None
 button_controller = None
+startup_initializer = None
+path_planner = None
 
 def set_motor_instance(motor):
     """Setzt die Motor-Instanz für API-Zugriff."""
@@ -63,18 +117,73 @@ def set_button_controller(controller):
     global button_controller
     button_controller = controller
 
+def set_track_archive(archive):
+    """Setzt das Track-Archiv der Regelschleife (main.py), damit API und Aufzeichnung übereinstimmen."""
+    global track_archive
+    track_archive = archive
+
+def set_startup_initializer(initializer):
+    """Setzt den LazyInitializer für die Start-Statusabfrage."""
+    global startup_initializer
+    startup_initializer = initializer
+
+def set_path_planner(planner):
+    """Setzt den AdvancedPathPlanner für den Plan-Download und die Plan-Diffs."""
+    global path_planner
+    path_planner = planner
+    planner.set_map_changed_callback(_on_planner_map_changed)
+    snapshot = planner.snapshot()
+    map_changes.update('zones', snapshot.zones)
+    _on_planner_map_changed(snapshot)
+
+def _on_planner_map_changed(snapshot):
+    """Plan und Hindernisse aus dem neuen Planer-Snapshot als Diff verteilen."""
+    map_changes.update('plan', snapshot.plan)
+    map_changes.update('obstacles', snapshot.obstacles + snapshot.dynamic_obstacles)
+
 @app.route('/sensors', methods=['GET'])
 def get_sensors():
     """
-    Gibt aktuelle Sensordaten zurück.
+    Gibt aktuelle Sensordaten aus dem letzten Regelzyklus zurück.
     Beispiele:
       GET /sensors
     """
-    data = {
-        'imu': imu.read(),
-        'gps': gps.read()
-    }
-    return jsonify(data)
+    snapshot = snapshots.read()
+    response = jsonify({
+        'imu': thaw(snapshot.data.get('imu')),
+        'gps': thaw(snapshot.data.get('gps')),
+        'snapshot_version': snapshot.version,
+        'snapshot_age': snapshot.age()
+    })
+    response.headers['X-Snapshot-Version'] = str(snapshot.version)
+    return response
+
+@app.route('/api/snapshot', methods=['GET'])
+def get_snapshot():
+    """
+    Vollständiger Zustand des letzten Regelzyklus.
+    Mit ?since=<version>&wait=<s> wird bis zu wait Sekunden auf einen neueren Stand gewartet.
+    """
+    since = request.args.get('since', type=int)
+    snapshot = snapshots.read()
+    busy = False
+    if since is not None:
+        # Warten belegt einen Worker; sind alle Plätze vergeben, sofort antworten
+        if worker_slots.try_acquire():
+            try:
+                snapshot = snapshots.wait_newer(since, min(request.args.get('wait', 5.0, type=float), 30.0))
+            finally:
+                worker_slots.release()
+        else:
+            busy = True
+    response = jsonify({
+        'version': snapshot.version,
+        'age': snapshot.age(),
+        'data': thaw(snapshot.data)
+    })
+    if busy:
+        response.headers['Retry-After'] = '1'
+    return response
 
 @app.route('/command', methods=['POST'])
 def post_command():
@@ -180,6 +289,9 @@ def set_mow_zones():
             zones.append(Polygon(points))
         
         motor_instance.set_mow_zones(zones)
+        content_versions.bump('zones')
+        map_changes.update('zones', zones)
+        event_hub.publish('zones', {'action': 'set', 'zones': zones_data})
         return jsonify({
             'status': 'set', 
             'zones_count': len(zones)
@@ -421,6 +533,31 @@ def index():
     """Hauptseite des Web Interfaces."""
     return send_from_directory('static', 'index.html')
 
+@app.route('/api/stream')
+def api_stream():
+    """Server-Sent Events mit dem Telemetrie-Snapshot der Hauptschleife und Änderungsereignissen."""
+    if not worker_slots.try_acquire():
+        return jsonify({'error': 'Keine freien Worker für Streams'}), 503, {'Retry-After': '5'}
+    client = subscribe_from_args(event_hub, request.args)
+    if client is None:
+        worker_slots.release()
+        return jsonify({'error': 'Zu viele Stream-Clients'}), 503
+    return worker_slots.hold(Response(event_hub.stream(client), mimetype='text/event-stream',
+                                      headers=SSE_HEADERS))
+
+@app.route('/api/stream/stats')
+def api_stream_stats():
+    """Statistik des Push-Kanals."""
+    return jsonify({**event_hub.get_statistics(), 'worker_slots': worker_slots.get_statistics()})
+
+@app.route('/api/cache/stats')
+def api_cache_stats():
+    """Trefferquote des Antwort-Caches und aktuelle Inhaltsversionen."""
+    return jsonify({
+        **response_cache.get_statistics(),
+        'versions': {kind: content_versions.get(kind) for kind in ('map', 'plan', 'zones')}
+    })
+
 @app.route('/api/status')
 def api_status():
     """API Status für Verbindungscheck."""
@@ -434,23 +571,25 @@ def api_status():
 def api_sensors():
     """Erweiterte Sensordaten für das Web Interface."""
     try:
-        imu_data = imu.read()
-        gps_data = gps.read()
+        snapshot = snapshots.read()
+        imu_data = snapshot.data.get('imu') or {}
+        gps_data = snapshot.data.get('gps') or {}
+        battery_data = snapshot.data.get('battery') or {}
         
-        # Batterie-Simulation (falls nicht verfügbar)
+        # Batterie-Füllstand ist vom Pico nicht verfügbar
         battery_level = 85  # Placeholder
         
         return jsonify({
             'battery': {
                 'level': battery_level,
-                'voltage': 12.6,
-                'charging': False
+                'voltage': battery_data.get('voltage', 0.0),
+                'charging': battery_data.get('charger_connected', False)
             },
             'gps': {
-                'latitude': gps_data.get('latitude', 0),
-                'longitude': gps_data.get('longitude', 0),
-                'quality': gps_data.get('quality', 0),
-                'satellites': gps_data.get('satellites', 0)
+                'latitude': gps_data.get('lat', 0),
+                'longitude': gps_data.get('lon', 0),
+                'quality': gps_data.get('fix_type', 0),
+                'satellites': gps_data.get('nsat', 0)
             },
             'imu': {
                 'heading': imu_data.get('heading', 0),
@@ -458,6 +597,7 @@ def api_sensors():
                 'pitch': imu_data.get('pitch', 0),
                 'temperature': imu_data.get('temperature', 25.0)
             },
+            'snapshot_version': snapshot.version,
             'timestamp': datetime.now().isoformat()
         })
     except Exception as e:
@@ -489,6 +629,7 @@ def return_home():
         return jsonify({'error': str(e)}), 500
 
 @app.route('/api/map/current')
+@response_cache.cached('map', 'zones')
 def get_current_map():
     """Gibt die aktuelle Karte zurück."""
     try:
@@ -518,6 +659,7 @@ def get_current_map():
         return jsonify({'error': str(e)}), 500
 
 @app.route('/api/system/stats')
+@response_cache.cached(ttl=2.0)
 def get_system_stats():
     """Gibt System-Statistiken zurück."""
     try:
@@ -552,6 +694,159 @@ def get_system_stats():
     except Exception as e:
         return jsonify({'error': str(e)}), 500
 
+@app.route('/api/system/startup')
+def get_startup_status():
+    """Gibt die Startzeitleiste und den Ladezustand der Hintergrund-Subsysteme zurück."""
+    result = get_startup_timeline().to_dict()
+    result['subsystems'] = startup_initializer.get_status() if startup_initializer else {}
+    return jsonify(result)
+
+@app.route('/api/advanced_planning/plan.bin', methods=['GET'])
+def get_plan_binary():
+    """
+    Aktueller Plan im Binärformat (navigation/plan_codec.py), blockweise gestreamt.
+    Der Browser zeichnet direkt aus Float32Arrays, während der Plan noch übertragen wird.
+    """
+    if not path_planner:
+        return jsonify({'error': 'Path planner not available'}), 503
+    # Unveränderlicher Plan mit seiner Diff-Version: die Regelschleife kann
+    # währenddessen weiterfahren, der Client patcht ab dieser Version
+    version, segments = map_changes.current('plan')
+    chunk_points = min(max(request.args.get('chunk', 4096, type=int), 256), 65536)
+    point_count = sum(len(segment.points) for segment in segments)
+    return app.response_class(
+        iter_plan_chunks(segments, chunk_points),
+        mimetype='application/octet-stream',
+        headers={'Content-Length': str(plan_size(len(segments), point_count)),
+                 'X-Map-Epoch': map_changes.epoch,
+                 'X-Map-Version': str(version),
+                 'Cache-Control': 'no-cache'}
+    )
+
+@app.route('/api/advanced_planning/status', methods=['GET'])
+def get_planner_status():
+    """Planungsstatus aus einem Snapshot des Planers (blockiert die Regelschleife nicht)."""
+    if not path_planner:
+        return jsonify({'error': 'Path planner not available'}), 503
+    return jsonify({**path_planner.get_planning_status(),
+                    'jobs': planning_jobs.get_statistics()})
+
+@app.route('/api/advanced_planning/add_obstacle', methods=['POST'])
+def add_planner_obstacle():
+    """
+    Fügt ein dynamisches Hindernis (Quadrat um x, y) hinzu. Berührt es den
+    verbleibenden Plan, wird die Neuplanung als Auftrag eingereicht.
+      {"x": 3.0, "y": 4.5, "size": 1.0}
+    """
+    if not path_planner:
+        return jsonify({'error': 'Path planner not available'}), 503
+    from map import Polygon, Point
+    data = request.get_json(silent=True) or {}
+    x, y = float(data.get('x', 0.0)), float(data.get('y', 0.0))
+    half = float(data.get('size', 1.0)) / 2
+    obstacle = Polygon([Point(x - half, y - half), Point(x + half, y - half),
+                        Point(x + half, y + half), Point(x - half, y + half)])
+    job_id = None
+    if path_planner.add_dynamic_obstacle(obstacle, replan=False):
+        job_id = planning_jobs.submit(path_planner.planning_request(replan=True), replace=True)
+    status = path_planner.get_planning_status()
+    event_hub.publish('plan', {'action': 'obstacle', 'status': status,
+                               'obstacle': {'x': x, 'y': y, 'size': half * 2},
+                               'replanning_triggered': job_id is not None})
+    return jsonify({'success': True, 'replanning_job': job_id, 'status': status})
+
+@app.route('/api/advanced_planning/reset', methods=['POST'])
+def reset_planner():
+    """Verwirft Plan und dynamische Hindernisse; die Regelschleife sieht danach keinen Plan mehr."""
+    if not path_planner:
+        return jsonify({'error': 'Path planner not available'}), 503
+    # Offene Aufträge würden sonst einen veralteten Plan nachträglich installieren
+    for job in planning_jobs.list_jobs():
+        if job['state'] in ('queued', 'running'):
+            planning_jobs.cancel(job['job_id'])
+    planning_jobs.take_finished_plan()
+    path_planner.reset()
+    status = path_planner.get_planning_status()
+    event_hub.publish('plan', {'action': 'reset', 'status': status})
+    return jsonify({'success': True, 'status': status})
+
+@app.route('/api/planning/jobs', methods=['GET', 'POST'])
+def planning_jobs_api():
+    """
+    GET: Planungsaufträge und Statistik.
+    POST: Neuplanung der aktuellen Zonen als Auftrag einreichen
+      {"strategy": "hybrid", "pattern": "lines", "deadline": 60, "replace": true}
+    Antwortet sofort mit der Auftrags-ID; Fortschritt über /api/stream ('planning_progress').
+    """
+    if request.method == 'GET':
+        return jsonify({'jobs': planning_jobs.list_jobs(), 'statistics': planning_jobs.get_statistics()})
+    if not path_planner:
+        return jsonify({'error': 'Path planner not available'}), 503
+    data = request.get_json(silent=True) or {}
+    job_request = path_planner.planning_request()
+    if not job_request['zones']:
+        return jsonify({'error': 'Keine Zonen definiert'}), 400
+    job_request['strategy'] = data.get('strategy', job_request['strategy'])
+    job_request['pattern'] = data.get('pattern', 'lines')
+    job_id = planning_jobs.submit(job_request, deadline=data.get('deadline'),
+                                  replace=data.get('replace', True))
+    if job_id is None:
+        return jsonify({'error': 'Warteschlange voll'}), 429
+    return jsonify({'job_id': job_id, 'status_url': f'/api/planning/jobs/{job_id}'}), 202
+
+@app.route('/api/planning/jobs/<job_id>', methods=['GET', 'DELETE'])
+def planning_job_api(job_id):
+    """Status eines Planungsauftrags abfragen (GET) oder abbrechen (DELETE)."""
+    if request.method == 'DELETE':
+        if not planning_jobs.cancel(job_id):
+            return jsonify({'error': 'Auftrag nicht gefunden oder bereits beendet'}), 404
+        return jsonify({'job_id': job_id, 'cancelled': True})
+    status = planning_jobs.get(job_id)
+    if status is None:
+        return jsonify({'error': 'Auftrag nicht gefunden'}), 404
+    return jsonify(status)
+
+@app.route('/api/tracks')
+@response_cache.cached(ttl=5.0, extra_version=lambda: file_version(track_archive.directory))
+def list_tracks():
+    """Listet alle aufgezeichneten Missions-Tracks."""
+    return jsonify({'tracks': track_archive.list_missions()})
+
+def _track_export_args():
+    from_t = request.args.get('from', type=float)
+    to_t = request.args.get('to', type=float)
+    step = request.args.get('step', 1, type=int)
+    return from_t, to_t, step
+
+def _track_file_version(mission_id):
+    return file_version(os.path.join(track_archive.directory, os.path.basename(mission_id) + '.trk'))
+
+@app.route('/api/tracks/<mission_id>/geojson')
+@response_cache.cached(extra_version=_track_file_version)
+def get_track_geojson(mission_id):
+    """
+    Exportiert einen Missions-Track als GeoJSON.
+    Query-Parameter: from/to (Unix-Zeit), step (jeder n-te Punkt).
+    """
+    try:
+        reader = track_archive.open(mission_id)
+    except (OSError, ValueError) as e:
+        return jsonify({'error': str(e)}), 404
+    return jsonify(reader.to_geojson(*_track_export_args()))
+
+@app.route('/api/tracks/<mission_id>/gpx')
+def get_track_gpx(mission_id):
+    """Exportiert einen Missions-Track als GPX-Datei."""
+    try:
+        reader = track_archive.open(mission_id)
+    except (OSError, ValueError) as e:
+        return jsonify({'error': str(e)}), 404
+    return app.response_class(
+        reader.to_gpx(*_track_export_args()),
+        mimetype='application/gpx+xml',
+        headers={'Content-Disposition': f'attachment; filename={mission_id}.gpx'}
+    )
+
 @app.route('/api/config', methods=['GET', 'POST'])
 def robot_config():
     """Roboter-Konfiguration verwalten."""
@@ -642,6 +937,7 @@ def camera_stream():
     })
 
 @app.route('/api/zones', methods=['GET', 'POST', 'DELETE'])
+@response_cache.cached('zones', extra_version=lambda: file_version('zones.json'))
 def manage_zones():
     """Verwaltet Mähzonen."""
     zones_file = 'zones.json'
@@ -703,4 +999,8 @@ def manage_zones():
             return jsonify({'error': str(e)}), 500
 
 if __name__ == '__main__':
-    app.run(host='0.0.0.0', port=5000, debug=True)
+    if '--production' in sys.argv:
+        from web_serving import serve
+        serve(app, load_web_server_config())
+    else:
+        app.run(host='0.0.0.0', port=5000, debug=True)
@@ -17,10 +17,17 @@ Project: https://github.com/Starsurfer78/sunray-mower
 
 Hauptskript für Sunray-Python-Port auf Raspberry Pi 4B.
 Initialisiert Module, startet Web-API und MQTT, führt State-Machine aus.
+
+Start in zwei Stufen: Hardware-Verbindungen und Regelschleife kommen zuerst,
+Web-UI, MQTT, Enhanced Escape System und Pfadplanung werden im Hintergrund
+geladen und von der Regelschleife genutzt, sobald sie bereit sind.
 """
 
+import os
 import time
 import threading
+from utils.startup_profiler import get_startup_timeline
+from utils.lazy_init import LazyInitializer
 
 # Hardware Imports mit Fallback
 try:
@@ -38,16 +45,29 @@ from map import Map
 from state_estimator import StateEstimator
 from events import Logger, EventCode
 from storage import Storage
-from communication.mqtt_client import MQTTClient
-from http_server import app
+from track_archive import TrackArchive
+from sensor_log import SensorLogWriter
+from checkpoint import CheckpointManager
+from communication.event_stream import get_event_hub
+from communication.map_changes import get_map_changes
+from utils.snapshot import get_telemetry_snapshot, thaw
+from utils.metrics import get_metrics
+from utils.trace import get_tracer
+from utils.sampling_profiler import get_profiler
+from heatmap_tiles import get_heatmap_tiles
 from op import IdleOp, MowOp, EscapeForwardOp, SmartBumperEscapeOp, GpsWaitRtkOp, GpsErrorOp, ReturnToSafeZoneOp
 from safety.obstacle_detection import ObstacleDetector
 from navigation.path_planner import MowPattern
-from enhanced_escape_operations import SensorFusion, LearningSystem, AdaptiveEscapeOp
-from examples.integration_example import EnhancedSunrayController
+from navigation.planning_jobs import get_planning_jobs
 from smart_button_controller import SmartButtonController, ButtonAction, RobotState, get_smart_button_controller
-from navigation.gps_navigation import GPSNavigation
-from navigation.advanced_path_planner import AdvancedPathPlanner, PlanningStrategy
+
+# Operationen, die nach einem Absturz aus dem Checkpoint fortgesetzt werden.
+# Ausweichmanöver werden nicht fortgesetzt, die Hinderniserkennung entscheidet neu.
+RESTARTABLE_OPERATIONS = ("mow", "gps_wait_rtk", "gps_error", "return_to_safe_zone")
+
+# Operationen, in denen ein asynchron berechneter Plan übernommen werden darf.
+# Während Ausweichmanövern und GPS-Sicherheitsoperationen wartet der neue Plan.
+PLAN_SWAP_OPERATIONS = ("idle", "mow")
 
 def select_operation(op_type: str, motor=None, **params):
     """Operation-Factory basierend auf Zustand."""
@@ -109,8 +129,110 @@ def process_pico_data(line: str) -> dict:
             return data
     return {}
 
+# Fabriken für im Hintergrund geladene Subsysteme.
+# Schwere Imports (Flask, paho-mqtt, Lern- und Planungsmodule) erfolgen erst hier.
+
+def init_web_ui(motor, button_controller, web_config, track_archive=None):
+    """
+    Startet die Web-API mit Motor- und Button-Controller-Zugriff.
+    Im Modus 'production' über waitress (Worker-Pool, Cache, vorkomprimierte Dateien).
+    """
+    from http_server import app, set_motor_instance, set_button_controller, set_track_archive
+    from web_serving import serve
+    set_motor_instance(motor)
+    set_button_controller(button_controller)
+    if track_archive:
+        set_track_archive(track_archive)
+    threading.Thread(
+        target=lambda: serve(app, web_config),
+        daemon=True
+    ).start()
+    return app
+
+def init_mqtt(telemetry_config):
+    """Baut die MQTT-Verbindung auf und gibt den Telemetrie-Publisher zurück."""
+    from communication.mqtt_client import MQTTClient
+    from communication.telemetry_encoder import TelemetryPublisher
+    mqtt = MQTTClient()
+    mqtt.connect('localhost', 1883)
+    threading.Thread(target=mqtt.loop_forever, daemon=True).start()
+    return TelemetryPublisher(
+        mqtt,
+        rate_limits=telemetry_config.get('rate_limits', {
+            'sunray/telemetry': 0.1,
+            'sunray/enhanced_stats': 10.0
+        }),
+        keyframe_interval=telemetry_config.get('keyframe_interval', 5.0),
+        float_precision=telemetry_config.get('float_precision', 3),
+        precision_overrides=telemetry_config.get('precision_overrides', {}),
+        binary=telemetry_config.get('format', 'cbor_delta') == 'cbor_delta'
+    )
+
+def init_enhanced_system(motor, obstacle_detector, estimator):
+    """Initialisiert Sensorfusion, Lernsystem und Enhanced Controller."""
+    from enhanced_escape_operations import SensorFusion, LearningSystem
+    from examples.integration_example import EnhancedSunrayController
+    sensor_fusion = SensorFusion()
+    learning_system = LearningSystem()
+    enhanced_controller = EnhancedSunrayController(
+        motor=motor,
+        sensor_fusion=sensor_fusion,
+        learning_system=learning_system,
+        obstacle_detector=obstacle_detector,
+        state_estimator=estimator
+    )
+    print("Enhanced Escape System initialisiert - Intelligente Navigation aktiviert")
+    return enhanced_controller, sensor_fusion, learning_system
+
+def publish_enhanced_system(enhanced, web_ui):
+    """Übergibt das Enhanced System an die Web-API, sobald beide bereit sind."""
+    from http_server import set_enhanced_system
+    set_enhanced_system(*enhanced)
+    return True
+
+def publish_startup_status(initializer):
+    """Macht Startzeitleiste und Ladezustand unter /api/system/startup abrufbar."""
+    from http_server import set_startup_initializer
+    set_startup_initializer(initializer)
+    return True
+
+def publish_path_planner(planning, web_ui):
+    """Macht den Plan unter /api/advanced_planning/plan.bin und als Diffs unter /api/changes abrufbar."""
+    from http_server import set_path_planner
+    set_path_planner(planning[0])
+    return True
+
+def init_path_planning(gps, map_module):
+    """Initialisiert erweiterte Pfadplanung und GPS-Navigation mit den Kartenzonen."""
+    from navigation.gps_navigation import GPSNavigation
+    from navigation.advanced_path_planner import AdvancedPathPlanner
+    advanced_planner = AdvancedPathPlanner()
+    print("Erweiterte Pfadplanung initialisiert")
+    
+    # GPS-Navigation mit erweiterter Pfadplanung initialisieren
+    gps_navigation = GPSNavigation(gps, advanced_planner)
+    print("GPS-Navigation mit erweiterter Pfadplanung initialisiert")
+    
+    if map_module.mow_zones:
+        # Erweiterte Pfadplanung mit Zonen und Hindernissen konfigurieren
+        obstacles = map_module.exclusions.polygons if map_module.exclusions.polygons else []
+        advanced_planner.set_zones_and_obstacles(map_module.mow_zones, obstacles)
+        
+        # GPS-Navigation mit Zonen konfigurieren
+        gps_navigation.set_mow_zones(map_module.mow_zones)
+    
+    if map_module.exclusions.polygons:
+        # GPS-Navigation mit Ausschlusszonen konfigurieren
+        gps_navigation.set_exclusion_zones(map_module.exclusions.polygons)
+    
+    return advanced_planner, gps_navigation
+
 def main():
+    timeline = get_startup_timeline()
+    timeline.mark('main')
+    
     # Module initialisieren
+    hardware_start = timeline.now()
     if HARDWARE_AVAILABLE:
         imu = IMUSensor()
         # Konfiguration laden
@@ -161,44 +283,77 @@ def main():
         print(f"Hardware Manager: Port '{pico_port}', Baudrate {pico_baudrate}")
     else:
         imu, gps, hardware_manager = get_hardware_or_mock()
+    timeline.record('hardware', hardware_start, timeline.now())
     
-    battery = Battery()
-    motor = Motor(hardware_manager=hardware_manager)
-    map_module = Map()
-    map_module.load_zones('zones.json')
-    # Konfiguration für StateEstimator laden
-    try:
-        import json
-        with open('config.json', 'r') as f:
-            config = json.load(f)
-    except (FileNotFoundError, json.JSONDecodeError) as e:
-        print(f"Warnung: Konfigurationsdatei nicht gefunden ({e}). Verwende Standardwerte.")
-        config = {}
-    
-    estimator = StateEstimator(config)
-    storage = Storage('state.json')
-    logger = Logger
-    mqtt = MQTTClient()
-    obstacle_detector = ObstacleDetector()  # Stromdaten kommen vom Pico über UART
-    
-    # Enhanced Escape System initialisieren
-    sensor_fusion = SensorFusion()
-    learning_system = LearningSystem()
-    enhanced_controller = EnhancedSunrayController(
-        motor=motor,
-        sensor_fusion=sensor_fusion,
-        learning_system=learning_system,
-        obstacle_detector=obstacle_detector,
-        state_estimator=estimator
-    )
-    
-    # Erweiterte Pfadplanung initialisieren
-    advanced_planner = AdvancedPathPlanner()
-    print("Erweiterte Pfadplanung initialisiert")
+    with timeline.phase('core_modules'):
+        battery = Battery()
+        motor = Motor(hardware_manager=hardware_manager)
+        map_module = Map()
+        map_module.load_zones('zones.json')
+        # Konfiguration für StateEstimator laden
+        try:
+            import json
+            with open('config.json', 'r') as f:
+                config = json.load(f)
+        except (FileNotFoundError, json.JSONDecodeError) as e:
+            print(f"Warnung: Konfigurationsdatei nicht gefunden ({e}). Verwende Standardwerte.")
+            config = {}
+        
+        estimator = StateEstimator(config)
+        storage = Storage('state.json')
+        track_config = config.get('track_archive', {})
+        track_archive = TrackArchive(track_config.get('directory', 'tracks')) \
+            if track_config.get('enabled', True) else None
+        # Rohdaten von Pico und GNSS für Wiedergabe und Auswertung (siehe sensor_log.py)
+        sensor_log_config = config.get('sensor_log', {})
+        sensor_log = SensorLogWriter(
+            os.path.join(sensor_log_config.get('directory', 'logs'), time.strftime('%Y-%m-%d_%H%M%S.slg')),
+            compression=sensor_log_config.get('compression', 'lz4'),
+            chunk_seconds=sensor_log_config.get('chunk_seconds', 60.0)
+        ) if sensor_log_config.get('enabled', False) else None
+        logger = Logger
+        obstacle_detector = ObstacleDetector()  # Stromdaten kommen vom Pico über UART
+        # Push-Kanal für die Web-Oberfläche (vor dem Import von http_server konfigurieren)
+        event_hub = get_event_hub(config.get('event_stream', {}))
+        # Verlauf der Zonen-/Plan-Diffs, aus dem getrennte Clients aufholen
+        get_map_changes(config.get('map_changes', {}))
+        # Einmal pro Tick veröffentlichter Zustand für HTTP-, MQTT- und SSE-Leser
+        snapshots = get_telemetry_snapshot()
+        # Heatmap-Kacheln (Abdeckung, GPS-Genauigkeit, Mähmotorstrom) für die Kartenansichten
+        heatmap = get_heatmap_tiles(config.get('heatmap', {}))
+        last_heatmap_version = 0
+        # Pfadplanung als Auftrag in einem eigenen Prozess, Fortschritt über den Push-Kanal
+        planning_jobs = get_planning_jobs(config.get('planning_jobs', {}))
+        planning_jobs.add_listener(lambda job: event_hub.publish(
+            'planning_progress' if job['state'] == 'running' else 'planning', job,
+            coalesce=job['state'] == 'running'))
+        # Metriken für /metrics; die Subsysteme registrieren ihre eigenen beim Erzeugen
+        metrics = get_metrics()
+        loop_tick = metrics.histogram('sunray_loop_tick_seconds', 'Rechenzeit eines Regelzyklus (ohne Pause)')
+        deadline_misses = metrics.counter('sunray_loop_deadline_misses', 'Regelzyklen über trace.tick_deadline')
+        # Trace-Ringpuffer; bei Deadline-Überschreitung werden die letzten Sekunden gespeichert
+        tracer = get_tracer(config.get('trace', {}))
+        # Sampling-Profiler (Start per config oder POST /api/profile/start)
+        profiler = get_profiler(config.get('profiler', {}))
+        if profiler.enabled:
+            profiler.start()
+        metrics.gauge('sunray_snapshot_version', 'Veröffentlichte Telemetrie-Snapshots',
+                      fn=lambda: snapshots.version)
     
-    # GPS-Navigation mit erweiterter Pfadplanung initialisieren
-    gps_navigation = GPSNavigation(gps, advanced_planner)
-    print("GPS-Navigation mit erweiterter Pfadplanung initialisiert")
+    # Warmstart aus dem letzten konsistenten Checkpoint
+    with timeline.phase('checkpoint_restore'):
+        checkpoint_config = config.get('checkpoint', {})
+        checkpoints = None
+        warm_state = {}
+        if checkpoint_config.get('enabled', True):
+            checkpoints = CheckpointManager(
+                checkpoint_config.get('file', 'checkpoint.json'),
+                interval=checkpoint_config.get('interval', 2.0),
+                max_age=checkpoint_config.get('max_age', 600.0)
+            )
+            checkpoints.register('estimator', estimator)
+            checkpoints.register('battery', battery)
+            warm_state = checkpoints.restore()
     
     # Smart Button Controller initialisieren
     button_controller = get_smart_button_controller(
@@ -238,7 +393,6 @@ def main():
     button_controller.set_action_callback(ButtonAction.GO_HOME, go_home_action)
     button_controller.set_action_callback(ButtonAction.EMERGENCY_STOP, emergency_stop_action)
     
-    print("Enhanced Escape System initialisiert - Intelligente Navigation aktiviert")
     print("Smart Button Controller initialisiert - Erweiterte Button-Funktionen verfügbar")
 
     # Zustand aus Speicher laden
@@ -250,23 +404,13 @@ def main():
     motor.begin()
     
     # Pfadplanung konfigurieren
-    if map_module.zones:
-        motor.set_mow_zones(map_module.zones)
-        print(f"Pfadplanung: {len(map_module.zones)} Mähzonen geladen")
-        
-        # Erweiterte Pfadplanung mit Zonen und Hindernissen konfigurieren
-        obstacles = map_module.exclusions if map_module.exclusions else []
-        advanced_planner.set_zones_and_obstacles(map_module.zones, obstacles)
-        
-        # GPS-Navigation mit Zonen konfigurieren
-        gps_navigation.set_mow_zones(map_module.zones)
+    if map_module.mow_zones:
+        motor.set_mow_zones(map_module.mow_zones)
+        print(f"Pfadplanung: {len(map_module.mow_zones)} Mähzonen geladen")
     
-    if map_module.exclusions:
-        motor.set_obstacles(map_module.exclusions)
-        print(f"Pfadplanung: {len(map_module.exclusions)} Ausschlusszonen als Hindernisse gesetzt")
-        
-        # GPS-Navigation mit Ausschlusszonen konfigurieren
-        gps_navigation.set_exclusion_zones(map_module.exclusions)
+    if map_module.exclusions.polygons:
+        motor.set_obstacles(map_module.exclusions.polygons)
+        print(f"Pfadplanung: {len(map_module.exclusions.polygons)} Ausschlusszonen als Hindernisse gesetzt")
     
     # Standard-Mähmuster setzen
     motor.set_mow_pattern(MowPattern.LINES)
@@ -276,27 +420,82 @@ def main():
     last_position_update = 0
     position_update_interval = 0.5  # Sekunden
 
-    # Motor-Instanz, Enhanced System und Button Controller an HTTP-Server übergeben
-    from http_server import set_motor_instance, set_enhanced_system, set_button_controller
-    set_motor_instance(motor)
-    set_enhanced_system(enhanced_controller, sensor_fusion, learning_system)
-    set_button_controller(button_controller)
+    # Hintergrund-Subsysteme starten; die Regelschleife wartet nicht auf sie
+    lazy = LazyInitializer()
+    lazy.register('web_ui', lambda: init_web_ui(motor, button_controller,
+                                                config.get('web_server', {}), track_archive))
+    lazy.register('mqtt', lambda: init_mqtt(config.get('telemetry', {})))
+    lazy.register('enhanced_system',
+                  lambda: init_enhanced_system(motor, obstacle_detector, estimator))
+    lazy.register('enhanced_web_api', publish_enhanced_system,
+                  depends_on=['enhanced_system', 'web_ui'])
+    lazy.register('path_planning', lambda: init_path_planning(gps, map_module))
+    lazy.register('path_planning_api', publish_path_planner,
+                  depends_on=['path_planning', 'web_ui'])
+    lazy.register('startup_api', lambda web_ui: publish_startup_status(lazy),
+                  depends_on=['web_ui'])
+    lazy.start_all()
     
-    # Web-API starten (Flask)
-    threading.Thread(
-        target=lambda: app.run(host='0.0.0.0', port=5000),
-        daemon=True
-    ).start()
-
-    # MQTT-Verbindung starten
-    mqtt.connect('localhost', 1883)
-    threading.Thread(target=mqtt.loop_forever, daemon=True).start()
+    track_recorder = None
+    telemetry = None
+    sensor_fusion = learning_system = enhanced_controller = None
+    advanced_planner = gps_navigation = None
+    startup_reported = False
 
+    timeline.mark('control_loop_ready')
     print("Sunray-Pi: System bereit.")
 
-    # Start-Operation (Idle)
+    # Start-Operation (Idle oder die Operation aus dem Checkpoint)
     current_op = IdleOp("idle")
     current_op.start()
+    restored_op = warm_state.get('operation', {})
+    if restored_op.get('name') in RESTARTABLE_OPERATIONS:
+        current_op = select_operation(restored_op['name'], motor=motor)
+        current_op.start(restored_op.get('params', {}))
+        print(f"Warmstart: Setze Operation '{current_op.name}' fort")
+    
+    def finish_tick(tick, operation):
+        """Schließt den Trace des Zyklus ab; Dump bei Deadline-Überschreitung."""
+        duration = tick.end({'operation': operation})
+        loop_tick.observe(duration)
+        if tracer.check_deadline(duration, {'operation': operation}):
+            deadline_misses.inc()
+    
+    def build_telemetry():
+        """Telemetrie aus dem Snapshot des Ticks (mit Enhanced System Daten) für MQTT und SSE."""
+        learning_stats = learning_system.get_statistics() if learning_system else {}
+        state = thaw(snapshots.read().data)
+        fused = state["fused"]
+        return {
+            "imu": state["imu"],
+            "gps": state["gps"],
+            "obstacles": state["obstacles"],
+            "battery": state["battery"],
+            "motor": state["motor"],
+            "enhanced_system": {
+                "sensor_fusion": {
+                    "confidence": fused.get('confidence', 0.0),
+                    "context": fused.get('context', 'unknown'),
+                    "sensor_weights": sensor_fusion.get_current_weights() if sensor_fusion else {}
+                },
+                "learning_system": {
+                    "total_maneuvers": learning_stats.get('total_maneuvers', 0),
+                    "success_rate": learning_stats.get('success_rate', 0.0),
+                    "active_strategy": getattr(current_op, 'strategy', None) if hasattr(current_op, 'strategy') else None,
+                    "learning_enabled": learning_system.learning_enabled if learning_system else False
+                },
+                "current_operation": {
+                    "name": state["operation"],
+                    "is_adaptive": state["operation"] == "adaptive_escape"
+                }
+            },
+            "advanced_path_planning": advanced_planner.get_planning_status() if advanced_planner else {},
+            **state["pico"]
+        }
+    
+    # Push-Intervall der SSE-Telemetrie
+    push_interval = event_hub.rate_caps.get('telemetry', 0.5)
+    last_push = float('-inf')
     
     # Timer für Summary-Anfragen
     last_summary_request = 0
@@ -304,6 +503,39 @@ def main():
 
     try:
         while True:
+            tick = tracer.begin_tick('control_loop')
+            tick.stage('startup_handover')
+            # Hintergrund-Subsysteme übernehmen, sobald sie bereit sind
+            if not startup_reported:
+                telemetry = lazy.get('mqtt')
+                enhanced = lazy.get('enhanced_system')
+                if enhanced:
+                    enhanced_controller, sensor_fusion, learning_system = enhanced
+                planning = lazy.get('path_planning')
+                if planning and advanced_planner is None:
+                    advanced_planner, gps_navigation = planning
+                    if checkpoints:
+                        if 'planner' in warm_state:
+                            advanced_planner.restore_checkpoint(warm_state['planner'])
+                        checkpoints.register('planner', advanced_planner)
+                if lazy.all_done():
+                    startup_reported = True
+                    timeline.mark('mowing_ready')
+                    print(timeline.report())
+            
+            tick.stage('plan_swap')
+            # Fertigen Plan zwischen zwei Ticks als Ganzes übernehmen
+            if advanced_planner and current_op.name in PLAN_SWAP_OPERATIONS:
+                finished_job = planning_jobs.take_finished_plan()
+                if finished_job:
+                    advanced_planner.install_plan(finished_job.result['plan'],
+                                                  finished_job.result.get('planning_time', 0.0),
+                                                  replan=finished_job.request.get('replan', False))
+                    event_hub.publish('plan', {'action': 'installed', 'job_id': finished_job.id,
+                                               'status': advanced_planner.get_planning_status(),
+                                               'plan_url': '/api/advanced_planning/plan.bin'})
+            
+            tick.stage('sensors')
             # Regelmäßig Summary-Daten anfordern für Stromdaten
             current_time = time.time()
             if current_time - last_summary_request >= summary_interval:
@@ -317,6 +549,7 @@ def main():
             imu_data = imu.read()
             gps_data = gps.read() or {}
             
+            tick.stage('battery_motor')
             # Batteriedaten vom Pico verarbeiten
             if pico_data and 'bat_voltage' in pico_data:
                 battery_status = battery.run(
@@ -333,6 +566,7 @@ def main():
             
             batt_ok = not battery.under_voltage()
             
+            tick.stage('obstacles_buttons')
             # Hinderniserkennung aktualisieren
             obstacle_detected = obstacle_detector.update(pico_data, imu_data)
             
@@ -344,7 +578,7 @@ def main():
                     'op_type': current_op.name if current_op else 'idle',
                     'battery_level': battery.get_percentage(),
                     'is_docked': battery.is_charging(),
-                    'has_map': len(map_module.zones) > 0 if map_module.zones else False
+                    'has_map': len(map_module.mow_zones) > 0 if map_module.mow_zones else False
                 }
                 button_controller.update_robot_state(robot_state_data)
                 
@@ -373,8 +607,8 @@ def main():
                 }
                 
                 # Dynamisches Hindernis zur erweiterten Pfadplanung hinzufügen
-                obstacle_status = obstacle_detector.get_status()
-                if obstacle_status.get('dynamic_obstacle'):
+                obstacle_status = sensor_data_enhanced['obstacle_status']
+                if obstacle_status.get('dynamic_obstacle') and advanced_planner:
                     from map import Polygon, Point
                     # Vereinfachtes Hindernis um aktuelle Position erstellen
                     current_pos = robot_state.get('position', {'x': 0, 'y': 0})
@@ -385,7 +619,9 @@ def main():
                         Point(current_pos['x'] - 0.5, current_pos['y'] + 0.5)
                     ]
                     dynamic_obstacle = Polygon(obstacle_points)
-                    advanced_planner.add_dynamic_obstacle(dynamic_obstacle)
+                    # Neuplanung nicht in der Regelschleife, sondern als Auftrag
+                    if advanced_planner.add_dynamic_obstacle(dynamic_obstacle, replan=False):
+                        planning_jobs.submit(advanced_planner.planning_request(replan=True), replace=True)
                     print("Dynamisches Hindernis zur erweiterten Pfadplanung hinzugefügt")
                 
                 # Enhanced Escape System verwenden für intelligente Ausweichmanöver
@@ -393,12 +629,17 @@ def main():
                     current_op.stop()
                     
                     # Intelligente Ausweichstrategie durch Enhanced System bestimmen
-                    escape_result = enhanced_controller.handle_obstacle(
-                        sensor_data_enhanced,
-                        current_context=current_op.name
-                    )
+                    # (solange es noch lädt, greift die traditionelle Methode)
+                    if enhanced_controller:
+                        escape_result = enhanced_controller.handle_obstacle(
+                            sensor_data_enhanced,
+                            current_context=current_op.name
+                        )
+                    else:
+                        escape_result = {'success': False}
                     
                     if escape_result['success']:
+                        from enhanced_escape_operations import AdaptiveEscapeOp
                         # Adaptive Escape Operation verwenden
                         current_op = AdaptiveEscapeOp(
                             "adaptive_escape", 
@@ -412,7 +653,6 @@ def main():
                         current_op.start(escape_result['parameters'])
                     else:
                         # Fallback auf traditionelle Methode
-                        obstacle_status = obstacle_detector.get_status()
                         bumper_info = obstacle_status.get('bumper', {})
                         if bumper_info.get('collision_detected', False):
                             current_op = SmartBumperEscapeOp("smart_bumper_escape", motor=motor)
@@ -435,6 +675,7 @@ def main():
                 motor.stop_immediately()  # Motoren über Motor-Klasse stoppen
                 hardware_manager.send_command("AT+STOP")  # Zusätzlicher Notfall-Stopp an Pico
             
+            tick.stage('state_estimation')
             # Roboterzustand berechnen (inkl. GPS-Sicherheitsbewertung)
             robot_state = estimator.compute_robot_state(
                 imu_data, gps_data, pico_data
@@ -472,32 +713,35 @@ def main():
                 print(f"GPS-Sicherheit: Geschwindigkeit reduziert auf {gps_speed_factor*100:.0f}%")
             
             # Hindernisinfo zum Roboterzustand hinzufügen
-            robot_state.update(obstacle_detector.get_status())
+            obstacle_status = obstacle_detector.get_status()
+            robot_state.update(obstacle_status)
             
+            tick.stage('sensor_fusion')
             # Enhanced System kontinuierlich aktualisieren
             enhanced_sensor_data = {
                 'imu': imu_data,
                 'gps': gps_data,
                 'pico': pico_data,
                 'robot_state': robot_state,
-                'obstacle_status': obstacle_detector.get_status(),
+                'obstacle_status': obstacle_status,
                 'timestamp': current_time
             }
             
             # Sensorfusion aktualisieren
-            fused_data = sensor_fusion.fuse_sensors(enhanced_sensor_data)
+            fused_data = sensor_fusion.fuse_sensors(enhanced_sensor_data) if sensor_fusion else {}
             
             # Learning System mit aktuellen Daten füttern
-            if current_op.name == "mow":
+            if current_op.name == "mow" and learning_system:
                 learning_system.update_context_data(fused_data)
             
             # Adaptive Escape Operation Feedback verarbeiten
-            if hasattr(current_op, 'get_performance_feedback'):
+            if learning_system and hasattr(current_op, 'get_performance_feedback'):
                 feedback = current_op.get_performance_feedback()
                 if feedback:
                     learning_system.process_feedback(feedback)
                     print(f"Enhanced System Lernen: {feedback.get('strategy', 'unknown')} - Erfolg: {feedback.get('success', False)}")
             
+            tick.stage('navigation')
             # GPS-Navigation aktualisieren
             if current_time - last_position_update >= position_update_interval:
                 if gps_navigation:
@@ -519,6 +763,7 @@ def main():
                 
                 last_position_update = current_time
 
+            tick.stage('operation')
             # Operation nur wechseln wenn keine GPS-Sicherheitsoperation aktiv
             if current_op.name not in ['gps_wait_rtk', 'gps_error', 'return_to_safe_zone']:
                 desired_op = select_operation(robot_state.get("op_type", "idle"), motor=motor)
@@ -529,11 +774,59 @@ def main():
 
             current_op.run()
 
-            # Telemetriedaten über MQTT veröffentlichen (mit Enhanced System Daten)
-            enhanced_telemetry = {
+            tick.stage('recording')
+            if sensor_log:
+                if sensor_data:
+                    sensor_log.append_pico_line(current_time, sensor_data)
+                if gps_data:
+                    sensor_log.append_gps(current_time, gps_data)
+            # Missions-Track aufzeichnen (Mission beginnt mit "mow", endet im Leerlauf)
+            if track_archive:
+                if track_recorder is None and current_op.name == "mow":
+                    track_recorder = track_archive.start_mission(
+                        getattr(gps, 'origin_lat', None) or 0.0,
+                        getattr(gps, 'origin_lon', None) or 0.0,
+                        block_size=track_config.get('block_size', 512)
+                    )
+                    print(f"Track-Aufzeichnung gestartet: {track_recorder.filename}")
+                elif track_recorder is not None and current_op.name == "idle":
+                    track_recorder.close()
+                    print(f"Track-Aufzeichnung beendet: {track_recorder.points_written} Punkte")
+                    track_recorder = None
+                if track_recorder is not None and gps_data:
+                    track_recorder.append(
+                        current_time,
+                        robot_state.get('x', 0.0),
+                        robot_state.get('y', 0.0),
+                        robot_state.get('heading', 0.0),
+                        gps_data.get('fix_type', 0),
+                        gps_data.get('hdop', 0.0)
+                    )
+
+            # Messwerte in die Heatmap-Ebenen eintragen; Browser laden nur geänderte Kacheln
+            if gps_data and gps_data.get('fix_type', 0) >= 2:
+                if heatmap.origin is None and getattr(gps, 'origin_lat', None) is not None:
+                    heatmap.set_origin(gps.origin_lat, gps.origin_lon)
+                mowing = current_op.name == "mow"
+                heatmap.add_sample(
+                    robot_state.get('x', 0.0),
+                    robot_state.get('y', 0.0),
+                    mowing=mowing,
+                    gps_accuracy=gps_data.get('hdop'),
+                    mow_current=pico_data.get('mow_current') if mowing else None
+                )
+                if heatmap.version != last_heatmap_version:
+                    last_heatmap_version = heatmap.version
+                    event_hub.publish("heatmap", {"version": last_heatmap_version}, coalesce=True)
+
+            tick.stage('publish')
+            # Zustand dieses Ticks veröffentlichen; Web- und MQTT-Leser greifen
+            # nur noch hierauf zu, nie direkt auf I2C oder die GPS-Schnittstelle
+            snapshots.publish({
                 "imu": imu_data,
                 "gps": gps_data,
-                "obstacles": obstacle_detector.get_status(),
+                "pico": pico_data,
+                "obstacles": obstacle_status,
                 "battery": {
                     "voltage": pico_data.get('bat_voltage', 0.0),
                     "charge_voltage": pico_data.get('chg_voltage', 0.0),
@@ -546,44 +839,60 @@ def main():
                     **battery_status
                 },
                 "motor": motor_status,
-                "enhanced_system": {
-                    "sensor_fusion": {
-                        "confidence": fused_data.get('confidence', 0.0),
-                        "context": fused_data.get('context', 'unknown'),
-                        "sensor_weights": sensor_fusion.get_current_weights()
-                    },
-                    "learning_system": {
-                        "total_maneuvers": learning_system.get_statistics().get('total_maneuvers', 0),
-                        "success_rate": learning_system.get_statistics().get('success_rate', 0.0),
-                        "active_strategy": getattr(current_op, 'strategy', None) if hasattr(current_op, 'strategy') else None,
-                        "learning_enabled": learning_system.learning_enabled
-                    },
-                    "current_operation": {
-                        "name": current_op.name,
-                        "is_adaptive": isinstance(current_op, AdaptiveEscapeOp)
-                    }
-                },
-                "advanced_path_planning": advanced_planner.get_planning_status(),
-                **pico_data
-            }
+                "robot_state": robot_state,
+                "fused": fused_data,
+                "operation": current_op.name
+            }, timestamp=time.monotonic())
+
+            storage.save(robot_state)
+            if checkpoints:
+                checkpoints.maybe_capture({'operation': current_op.checkpoint_state()})
+            tick.stage('telemetry')
+            # Push-Kanal (SSE) unabhängig von MQTT: läuft auch ohne Broker und mit
+            # eigenem Intervall (event_stream.rate_caps.telemetry)
+            telemetry_payload = None
+            now = time.monotonic()
+            if now - last_push >= push_interval and event_hub.has_subscribers("telemetry"):
+                last_push = now
+                telemetry_payload = build_telemetry()
+                # Derselbe Snapshot für alle Browser, einmal kodiert
+                event_hub.publish("telemetry", telemetry_payload, coalesce=True)
             
-            mqtt.publish("sunray/telemetry", enhanced_telemetry)
+            if not telemetry:
+                finish_tick(tick, current_op.name)
+                time.sleep(0.1)
+                continue
+
+            # Telemetriedaten über MQTT veröffentlichen (mit Enhanced System Daten).
+            # Ein Snapshot pro Tick; gesendet werden nur geänderte Felder.
+            if telemetry.due("sunray/telemetry"):
+                telemetry.publish("sunray/telemetry", telemetry_payload or build_telemetry())
             
-            # Separate Enhanced System Statistiken
-            if current_time % 10 < 0.1:  # Alle 10 Sekunden
-                mqtt.publish("sunray/enhanced_stats", {
+            # Separate Enhanced System Statistiken (Rate-Limit in der Telemetrie-Konfiguration)
+            if learning_system and advanced_planner and telemetry.due("sunray/enhanced_stats"):
+                telemetry.publish("sunray/enhanced_stats", {
                     "learning_stats": learning_system.get_statistics(),
                     "sensor_fusion_stats": sensor_fusion.get_statistics(),
                     "context_distribution": learning_system.get_context_distribution(),
-                    "path_planning_stats": advanced_planner.get_planning_status()
+                    "path_planning_stats": advanced_planner.get_planning_status(),
+                    "telemetry_stats": telemetry.get_statistics()
                 })
 
-            storage.save(robot_state)
+            finish_tick(tick, current_op.name)
             time.sleep(0.1)
 
     except KeyboardInterrupt:
         print("Sunray-Pi: Beende Hauptloop")
+        # Reguläres Beenden: beim nächsten Start nicht automatisch weitermähen
+        if checkpoints:
+            checkpoints.stop()
+            checkpoints.clear()
     finally:
+        planning_jobs.shutdown()
+        if track_recorder is not None:
+            track_recorder.close()
+        if sensor_log:
+            sensor_log.close()
         if HARDWARE_AVAILABLE and hardware_manager:
             hardware_manager.close()
         logger.event(EventCode.SYSTEM_SHUTTING_DOWN)
@@ -14,8 +14,9 @@ Version: 1.0
 """
 
 import math
+import threading
 import time
-from typing import List, Optional, Tuple, Dict, Callable
+from typing import List, NamedTuple, Optional, Tuple, Dict, Callable
 from enum import Enum
 from dataclasses import dataclass
 
@@ -23,6 +24,8 @@ from map import Point, Polygon
 from path_planner import PathPlanner, MowPattern
 from astar_pathfinding import AStarPathfinder
 from config import get_config
+from utils.metrics import get_metrics
+from utils.trace import traced
 
 class PlanningStrategy(Enum):
     """Verfügbare Planungsstrategien."""
@@ -49,6 +52,20 @@ class PathSegment:
     speed_factor: float = 1.0
     priority: int = 0
 
+class PlannerSnapshot(NamedTuple):
+    """
+    Unveränderlicher Stand des Planers: Plan, Fortschritt, Zonen und Hindernisse.
+    Segmente werden nach der Veröffentlichung nicht mehr verändert.
+    """
+    version: int
+    plan: Tuple[PathSegment, ...]
+    segment_index: int
+    point_index: int
+    zones: Tuple[Polygon, ...]
+    obstacles: Tuple[Polygon, ...]
+    dynamic_obstacles: Tuple[Polygon, ...]
+    total_planned_distance: float
+
 class AdvancedPathPlanner:
     """
     Erweiterte Pfadplanung mit A*-Integration.
@@ -64,6 +81,13 @@ class AdvancedPathPlanner:
         planner = AdvancedPathPlanner()
         planner.set_strategy(PlanningStrategy.HYBRID)
         path = planner.plan_zone_coverage(zones, obstacles)
+    
+    Nebenläufigkeit: Plan, Fortschritt und Hindernisse liegen in einem
+    unveränderlichen PlannerSnapshot. Leser (Web-Anfragen, Telemetrie) holen
+    sich mit snapshot() einen konsistenten Stand ohne Lock; Schreiber
+    (Regelschleife, Web-API) bauen unter einem kurzen Schreib-Lock einen neuen
+    Snapshot und tauschen nur die Referenz aus (Copy-on-Write). Geplant wird
+    außerhalb des Locks auf einem festen Eingabe-Snapshot.
     """
     
     def __init__(self):
@@ -77,32 +101,92 @@ class AdvancedPathPlanner:
         self.astar_pathfinder = AStarPathfinder(grid_size=0.1)
         
         # Konfiguration
-        planning_config = self.config.get('advanced_path_planning', {})
-        self.strategy = PlanningStrategy(planning_config.get('strategy', 'hybrid'))
-        self.max_segment_length = planning_config.get('max_segment_length', 10.0)  # Meter
-        self.obstacle_detection_radius = planning_config.get('obstacle_detection_radius', 1.0)  # Meter
-        self.replanning_threshold = planning_config.get('replanning_threshold', 0.5)  # Meter
-        
-        # Zustand
-        self.current_plan: List[PathSegment] = []
-        self.current_segment_index = 0
-        self.current_point_index = 0
-        self.obstacles: List[Polygon] = []
-        self.dynamic_obstacles: List[Polygon] = []
-        self.zones: List[Polygon] = []
+        planning_config = self.config.snapshot().planning
+        self.strategy = PlanningStrategy(planning_config.strategy)
+        self.max_segment_length = planning_config.max_segment_length  # Meter
+        self.obstacle_detection_radius = planning_config.obstacle_detection_radius  # Meter
+        self.replanning_threshold = planning_config.replanning_threshold  # Meter
+        self.max_dynamic_obstacles = planning_config.max_dynamic_obstacles
+        
+        # Zustand (Copy-on-Write, siehe snapshot())
+        self._state = PlannerSnapshot(0, (), 0, 0, (), (), (), 0.0)
+        self._write_lock = threading.RLock()
         
         # Statistiken
-        self.total_planned_distance = 0.0
         self.replanning_count = 0
         self.last_planning_time = 0.0
         
+        # Metriken (/metrics); Pläne aus Planungsaufträgen zählen bei install_plan()
+        metrics = get_metrics()
+        self.metric_replans = metrics.counter('sunray_planner_replans', 'Neuplanungen ab aktueller Position')
+        self.metric_planning_time = metrics.histogram('sunray_planner_planning_seconds', 'Rechenzeit je Plan',
+                                                      buckets=(0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0, 60.0, 120.0))
+        metrics.gauge('sunray_planner_segments', 'Segmente im aktuellen Plan', fn=lambda: len(self._state.plan))
+        
         # Callbacks
         self.obstacle_detected_callback = None
         self.replanning_callback = None
         self.segment_completed_callback = None
+        self.progress_callback = None
+        self.map_changed_callback = None
+        
+        # Hot-Reload der Planungsparameter
+        self.config.subscribe(self._on_config_changed)
         
         print(f"Erweiterte Pfadplanung: Initialisiert (Strategie: {self.strategy.value})")
     
+    def snapshot(self) -> PlannerSnapshot:
+        """Aktueller Stand (lock-frei, unveränderlich)."""
+        return self._state
+    
+    def _publish(self, **changes) -> PlannerSnapshot:
+        """Veröffentlicht einen neuen Snapshot mit den angegebenen Änderungen."""
+        with self._write_lock:
+            state = self._state
+            self._state = state._replace(version=state.version + 1, **changes)
+            return self._state
+    
+    def _notify_map_changed(self) -> None:
+        """Meldet Plan oder Hindernisse nach einer Änderung (außerhalb des Schreib-Locks)."""
+        if self.map_changed_callback:
+            self.map_changed_callback(self._state)
+    
+    @property
+    def current_plan(self) -> Tuple[PathSegment, ...]:
+        return self._state.plan
+    
+    @property
+    def current_segment_index(self) -> int:
+        return self._state.segment_index
+    
+    @property
+    def current_point_index(self) -> int:
+        return self._state.point_index
+    
+    @property
+    def zones(self) -> Tuple[Polygon, ...]:
+        return self._state.zones
+    
+    @property
+    def obstacles(self) -> Tuple[Polygon, ...]:
+        return self._state.obstacles
+    
+    @property
+    def dynamic_obstacles(self) -> Tuple[Polygon, ...]:
+        return self._state.dynamic_obstacles
+    
+    @property
+    def total_planned_distance(self) -> float:
+        return self._state.total_planned_distance
+    
+    def _on_config_changed(self, snapshot) -> None:
+        """Übernimmt geänderte Planungsparameter aus einem neuen Konfigurations-Snapshot."""
+        planning_config = snapshot.planning
+        self.max_segment_length = planning_config.max_segment_length
+        self.obstacle_detection_radius = planning_config.obstacle_detection_radius
+        self.replanning_threshold = planning_config.replanning_threshold
+        self.max_dynamic_obstacles = planning_config.max_dynamic_obstacles
+    
     def set_strategy(self, strategy: PlanningStrategy) -> None:
         """
         Setzt die Planungsstrategie.
@@ -113,22 +197,28 @@ class AdvancedPathPlanner:
         self.strategy = strategy
         print(f"Erweiterte Pfadplanung: Strategie auf {strategy.value} gesetzt")
     
-    def set_zones_and_obstacles(self, zones: List[Polygon], obstacles: List[Polygon]) -> None:
+    def set_zones_and_obstacles(self, zones: List[Polygon], obstacles: List[Polygon],
+                                dynamic_obstacles: Optional[List[Polygon]] = None) -> None:
         """
         Setzt Zonen und Hindernisse für die Planung.
         
         Args:
             zones: Zu mähende Zonen
             obstacles: Statische Hindernisse
+            dynamic_obstacles: Dynamische Hindernisse (None: bisherige behalten)
         """
-        self.zones = zones
-        self.obstacles = obstacles
+        changes = {'zones': tuple(zones), 'obstacles': tuple(obstacles)}
+        if dynamic_obstacles is not None:
+            changes['dynamic_obstacles'] = tuple(dynamic_obstacles)
+        self._publish(**changes)
+        self._notify_map_changed()
         
         # A*-Pathfinder mit Hindernissen konfigurieren
         self.astar_pathfinder.set_obstacles(obstacles)
         
         print(f"Erweiterte Pfadplanung: {len(zones)} Zonen, {len(obstacles)} Hindernisse gesetzt")
     
+    @traced('planner.plan_zone_coverage', 'planner')
     def plan_zone_coverage(self, pattern: MowPattern = MowPattern.LINES) -> bool:
         """
         Plant die vollständige Zonenabdeckung.
@@ -139,60 +229,80 @@ class AdvancedPathPlanner:
         Returns:
             bool: True wenn Planung erfolgreich
         """
-        if not self.zones:
+        inputs = self._state
+        if not inputs.zones:
             print("Erweiterte Pfadplanung: Keine Zonen definiert")
             return False
         
         start_time = time.time()
-        self.current_plan.clear()
-        self.current_segment_index = 0
-        self.current_point_index = 0
+        segments = self._compute_plan(pattern, inputs)
+        if segments is None:
+            # Wie bisher: nach einer fehlgeschlagenen Planung gibt es keinen Plan
+            self._publish(plan=(), segment_index=0, point_index=0, total_planned_distance=0.0)
+            self._notify_map_changed()
+            return False
         
+        self.last_planning_time = time.time() - start_time
+        self.metric_planning_time.observe(self.last_planning_time)
+        state = self._publish(plan=tuple(segments), segment_index=0, point_index=0,
+                              total_planned_distance=self._plan_distance(segments))
+        self._notify_map_changed()
+        print(f"Erweiterte Pfadplanung: Plan erstellt in {self.last_planning_time:.2f}s")
+        print(f"Erweiterte Pfadplanung: {len(state.plan)} Segmente, {state.total_planned_distance:.1f}m")
+        return True
+    
+    def _compute_plan(self, pattern: MowPattern, inputs: PlannerSnapshot) -> Optional[List[PathSegment]]:
+        """
+        Berechnet einen Plan aus einem festen Eingabe-Snapshot, ohne den
+        veröffentlichten Zustand zu verändern. None wenn die Planung fehlschlägt.
+        Eingaben und Entwurf bleiben lokal, damit sich überlappende Planungen
+        nicht gegenseitig beeinflussen.
+        """
+        draft: List[PathSegment] = []
         try:
             if self.strategy == PlanningStrategy.TRADITIONAL:
-                success = self._plan_traditional(pattern)
+                success = self._plan_traditional(pattern, inputs, draft)
             elif self.strategy == PlanningStrategy.ASTAR:
-                success = self._plan_astar()
+                success = self._plan_astar(inputs, draft)
             elif self.strategy == PlanningStrategy.HYBRID:
-                success = self._plan_hybrid(pattern)
+                success = self._plan_hybrid(pattern, inputs, draft)
             elif self.strategy == PlanningStrategy.ADAPTIVE:
-                success = self._plan_adaptive(pattern)
+                success = self._plan_adaptive(pattern, inputs, draft)
             else:
-                success = self._plan_hybrid(pattern)  # Fallback
+                success = self._plan_hybrid(pattern, inputs, draft)  # Fallback
             
-            if success:
-                self._calculate_plan_statistics()
-                self.last_planning_time = time.time() - start_time
-                print(f"Erweiterte Pfadplanung: Plan erstellt in {self.last_planning_time:.2f}s")
-                print(f"Erweiterte Pfadplanung: {len(self.current_plan)} Segmente, {self.total_planned_distance:.1f}m")
-            
-            return success
+            if not success:
+                return None
+            self._report_progress(len(inputs.zones), len(inputs.zones))
+            return draft
             
         except Exception as e:
             print(f"Erweiterte Pfadplanung: Fehler bei Planung - {e}")
-            return False
+            return None
     
-    def _plan_traditional(self, pattern: MowPattern) -> bool:
+    def _plan_traditional(self, pattern: MowPattern, inputs: PlannerSnapshot,
+                          draft: List[PathSegment]) -> bool:
         """
         Traditionelle Pfadplanung mit Mähmustern.
         """
         self.traditional_planner.set_pattern(pattern)
         
-        for i, zone in enumerate(self.zones):
+        for i, zone in enumerate(inputs.zones):
             # Mähpfad für Zone generieren
-            zone_path = self.traditional_planner.generate_zone_path(zone, self.obstacles)
+            zone_path = self.traditional_planner.generate_zone_path(zone, inputs.obstacles)
             
             if zone_path:
                 # Pfad in Segmente aufteilen
                 segments = self._split_path_into_segments(zone_path, PathType.MOWING)
-                self.current_plan.extend(segments)
+                draft.extend(segments)
                 
                 # Transitpfad zur nächsten Zone (falls vorhanden)
-                if i < len(self.zones) - 1:
-                    next_zone = self.zones[i + 1]
+                if i < len(inputs.zones) - 1:
+                    next_zone = inputs.zones[i + 1]
                     transit_path = self._plan_transit_path(
                         zone_path[-1] if zone_path else zone.get_center(),
-                        next_zone.get_center()
+                        next_zone.get_center(),
+                        inputs
                     )
                     if transit_path:
                         transit_segment = PathSegment(
@@ -201,17 +311,21 @@ class AdvancedPathPlanner:
                             mow_enabled=False,
                             speed_factor=1.5
                         )
-                        self.current_plan.append(transit_segment)
+                        draft.append(transit_segment)
+            
+            self._report_progress(i + 1, len(inputs.zones))
         
-        return len(self.current_plan) > 0
+        return len(draft) > 0
     
-    def _plan_astar(self) -> bool:
+    def _plan_astar(self, inputs: PlannerSnapshot, draft: List[PathSegment]) -> bool:
         """
         A*-basierte Pfadplanung.
         """
-        for zone in self.zones:
+        for zone_index, zone in enumerate(inputs.zones):
+            self._report_progress(zone_index, len(inputs.zones))
+            
             # Sampling-basierte Abdeckung der Zone
-            coverage_points = self._generate_coverage_points(zone)
+            coverage_points = self._generate_coverage_points(zone, inputs.obstacles)
             
             if not coverage_points:
                 continue
@@ -226,7 +340,7 @@ class AdvancedPathPlanner:
                 end_point = ordered_points[i + 1]
                 
                 path = self.astar_pathfinder.find_path(
-                    start_point, end_point, self.dynamic_obstacles
+                    start_point, end_point, inputs.dynamic_obstacles
                 )
                 
                 if path:
@@ -239,19 +353,22 @@ class AdvancedPathPlanner:
                 else:
                     print(f"Erweiterte Pfadplanung: Kein A*-Pfad von {start_point} zu {end_point}")
             
-            self.current_plan.extend(zone_segments)
+            draft.extend(zone_segments)
         
-        return len(self.current_plan) > 0
+        return len(draft) > 0
     
-    def _plan_hybrid(self, pattern: MowPattern) -> bool:
+    def _plan_hybrid(self, pattern: MowPattern, inputs: PlannerSnapshot,
+                     draft: List[PathSegment]) -> bool:
         """
         Hybride Planung: Traditionell für Hauptbereiche, A* für Hindernisse.
         """
         self.traditional_planner.set_pattern(pattern)
         
-        for zone in self.zones:
+        for zone_index, zone in enumerate(inputs.zones):
+            self._report_progress(zone_index, len(inputs.zones))
+            
             # Traditioneller Pfad als Basis
-            base_path = self.traditional_planner.generate_zone_path(zone, self.obstacles)
+            base_path = self.traditional_planner.generate_zone_path(zone, inputs.obstacles)
             
             if not base_path:
                 continue
@@ -262,7 +379,7 @@ class AdvancedPathPlanner:
             
             for i, point in enumerate(base_path):
                 # Prüfe auf Hindernisse im Umkreis
-                if self._point_near_obstacles(point, self.dynamic_obstacles):
+                if self._point_near_obstacles(point, inputs.dynamic_obstacles):
                     # Aktuelles Segment abschließen
                     if current_segment:
                         segment = PathSegment(
@@ -275,7 +392,7 @@ class AdvancedPathPlanner:
                     # A*-Umgehung planen
                     if i < len(base_path) - 1:
                         detour_path = self._plan_obstacle_detour(
-                            point, base_path[i + 1], self.dynamic_obstacles
+                            point, base_path[i + 1], inputs.dynamic_obstacles
                         )
                         if detour_path:
                             detour_segment = PathSegment(
@@ -295,43 +412,46 @@ class AdvancedPathPlanner:
                 )
                 refined_segments.append(segment)
             
-            self.current_plan.extend(refined_segments)
+            draft.extend(refined_segments)
         
-        return len(self.current_plan) > 0
+        return len(draft) > 0
     
-    def _plan_adaptive(self, pattern: MowPattern) -> bool:
+    def _plan_adaptive(self, pattern: MowPattern, inputs: PlannerSnapshot,
+                       draft: List[PathSegment]) -> bool:
         """
         Adaptive Planung basierend auf Zoneneigenschaften.
         """
-        for zone in self.zones:
+        for zone_index, zone in enumerate(inputs.zones):
+            self._report_progress(zone_index, len(inputs.zones))
+            
             # Zoneneigenschaften analysieren
             zone_area = self._calculate_polygon_area(zone)
-            obstacle_density = self._calculate_obstacle_density(zone)
+            obstacle_density = self._calculate_obstacle_density(zone, inputs.obstacles)
             zone_complexity = self._calculate_zone_complexity(zone)
             
             # Strategie basierend auf Eigenschaften wählen
             if obstacle_density > 0.3 or zone_complexity > 0.7:
                 # Hohe Hindernisdichte oder Komplexität -> A*
                 print(f"Adaptive Planung: A* für komplexe Zone (Dichte: {obstacle_density:.2f})")
-                zone_segments = self._plan_zone_astar(zone)
+                zone_segments = self._plan_zone_astar(zone, inputs)
             elif zone_area < 50.0:  # Kleine Zone
                 # Kleine Zone -> Spiralmuster
                 print(f"Adaptive Planung: Spiral für kleine Zone ({zone_area:.1f}m²)")
                 self.traditional_planner.set_pattern(MowPattern.SPIRAL)
-                zone_path = self.traditional_planner.generate_zone_path(zone, self.obstacles)
+                zone_path = self.traditional_planner.generate_zone_path(zone, inputs.obstacles)
                 zone_segments = self._split_path_into_segments(zone_path, PathType.MOWING)
             else:
                 # Standard -> Linienmuster
                 print(f"Adaptive Planung: Linien für Standardzone ({zone_area:.1f}m²)")
                 self.traditional_planner.set_pattern(pattern)
-                zone_path = self.traditional_planner.generate_zone_path(zone, self.obstacles)
+                zone_path = self.traditional_planner.generate_zone_path(zone, inputs.obstacles)
                 zone_segments = self._split_path_into_segments(zone_path, PathType.MOWING)
             
-            self.current_plan.extend(zone_segments)
+            draft.extend(zone_segments)
         
-        return len(self.current_plan) > 0
+        return len(draft) > 0
     
-    def _generate_coverage_points(self, zone: Polygon) -> List[Point]:
+    def _generate_coverage_points(self, zone: Polygon, obstacles: List[Polygon]) -> List[Point]:
         """
         Generiert Abdeckungspunkte für eine Zone.
         """
@@ -356,7 +476,7 @@ class AdvancedPathPlanner:
                 # Prüfe ob Punkt in Zone liegt
                 if self._point_in_polygon(point, zone):
                     # Prüfe ob Punkt nicht in Hindernis liegt
-                    if not self._point_in_obstacles(point, self.obstacles):
+                    if not self._point_in_obstacles(point, obstacles):
                         points.append(point)
                 x += spacing
             y += spacing
@@ -414,16 +534,17 @@ class AdvancedPathPlanner:
         
         return segments
     
-    def _plan_transit_path(self, start: Point, end: Point) -> Optional[List[Point]]:
+    def _plan_transit_path(self, start: Point, end: Point,
+                           inputs: PlannerSnapshot) -> Optional[List[Point]]:
         """
         Plant einen Transitpfad zwischen zwei Punkten.
         """
         # Versuche direkten Pfad
-        if self._line_of_sight(start, end):
+        if self._line_of_sight(start, end, inputs.obstacles + inputs.dynamic_obstacles):
             return [start, end]
         
         # Verwende A* für Hindernisvermeidung
-        return self.astar_pathfinder.find_path(start, end, self.dynamic_obstacles)
+        return self.astar_pathfinder.find_path(start, end, inputs.dynamic_obstacles)
     
     def _plan_obstacle_detour(self, start: Point, end: Point, obstacles: List[Polygon]) -> Optional[List[Point]]:
         """
@@ -441,58 +562,80 @@ class AdvancedPathPlanner:
         Returns:
             Tuple[Point, PathType]: Nächster Wegpunkt und Pfadtyp oder None
         """
-        if not self.current_plan or self.current_segment_index >= len(self.current_plan):
-            return None
-        
-        current_segment = self.current_plan[self.current_segment_index]
-        
-        if self.current_point_index >= len(current_segment.points):
-            # Nächstes Segment
-            self.current_segment_index += 1
-            self.current_point_index = 0
-            
-            if self.segment_completed_callback:
-                self.segment_completed_callback(current_segment)
-            
-            return self.get_next_waypoint(current_position)
-        
-        next_point = current_segment.points[self.current_point_index]
-        self.current_point_index += 1
-        
-        return (next_point, current_segment.path_type)
-    
-    def add_dynamic_obstacle(self, obstacle: Polygon) -> None:
+        completed = []
+        waypoint = None
+        with self._write_lock:
+            state = self._state
+            segment_index, point_index = state.segment_index, state.point_index
+            while segment_index < len(state.plan):
+                current_segment = state.plan[segment_index]
+                if point_index < len(current_segment.points):
+                    waypoint = (current_segment.points[point_index], current_segment.path_type)
+                    point_index += 1
+                    break
+                # Nächstes Segment
+                completed.append(current_segment)
+                segment_index += 1
+                point_index = 0
+            if (segment_index, point_index) != (state.segment_index, state.point_index):
+                self._publish(segment_index=segment_index, point_index=point_index)
+        
+        # Callbacks außerhalb des Schreib-Locks
+        if self.segment_completed_callback:
+            for segment in completed:
+                self.segment_completed_callback(segment)
+        
+        return waypoint
+    
+    def add_dynamic_obstacle(self, obstacle: Polygon, replan: bool = True) -> bool:
         """
         Fügt ein dynamisches Hindernis hinzu und löst Neuplanung aus.
+        Ein Hindernis, dessen Mittelpunkt in einem bekannten liegt, wird nicht
+        erneut aufgenommen; über max_dynamic_obstacles fällt das älteste heraus.
         
         Args:
             obstacle: Neues Hindernis
+            replan: False, wenn die Neuplanung asynchron erfolgt (siehe planning_jobs.py)
+            
+        Returns:
+            bool: True wenn der verbleibende Plan das Hindernis berührt
         """
-        self.dynamic_obstacles.append(obstacle)
+        center = obstacle.get_center()
+        with self._write_lock:
+            known = self._state.dynamic_obstacles
+            if self._point_in_obstacles(center, known):
+                return False
+            limit = max(1, self.max_dynamic_obstacles)
+            self._publish(dynamic_obstacles=(known + (obstacle,))[-limit:])
+        self._notify_map_changed()
         
         if self.obstacle_detected_callback:
             self.obstacle_detected_callback(obstacle)
         
         # Prüfe ob Neuplanung erforderlich
-        if self._requires_replanning():
+        if not self._requires_replanning():
+            return False
+        if replan:
             self.replan_from_current_position()
+        return True
     
     def _requires_replanning(self) -> bool:
         """
         Prüft ob eine Neuplanung erforderlich ist.
         """
-        if not self.current_plan or self.current_segment_index >= len(self.current_plan):
+        state = self._state
+        if not state.plan or state.segment_index >= len(state.plan):
             return False
         
         # Prüfe verbleibende Segmente auf Kollisionen
-        for i in range(self.current_segment_index, len(self.current_plan)):
-            segment = self.current_plan[i]
+        for segment in state.plan[state.segment_index:]:
             for point in segment.points:
-                if self._point_near_obstacles(point, self.dynamic_obstacles):
+                if self._point_near_obstacles(point, state.dynamic_obstacles):
                     return True
         
         return False
     
+    @traced('planner.replan', 'planner')
     def replan_from_current_position(self) -> bool:
         """
         Plant den Pfad von der aktuellen Position neu.
@@ -500,41 +643,46 @@ class AdvancedPathPlanner:
         Returns:
             bool: True wenn Neuplanung erfolgreich
         """
-        if not self.current_plan:
+        state = self._state
+        if not state.plan:
             return False
         
-        self.replanning_count += 1
-        
-        if self.replanning_callback:
-            self.replanning_callback(self.replanning_count)
+        self._count_replan()
         
         # Verbleibende Zonen ermitteln
-        remaining_zones = self.zones[self.current_segment_index:] if self.current_segment_index < len(self.zones) else []
+        remaining_zones = state.zones[state.segment_index:] if state.segment_index < len(state.zones) else []
         
         if not remaining_zones:
             return True  # Bereits fertig
         
-        # Neuplanung mit aktuellen Hindernissen
-        old_plan = self.current_plan.copy()
-        old_segment_index = self.current_segment_index
-        
         # Temporär alle Hindernisse setzen
-        all_obstacles = self.obstacles + self.dynamic_obstacles
-        self.astar_pathfinder.set_obstacles(all_obstacles)
+        self.astar_pathfinder.set_obstacles(list(state.obstacles + state.dynamic_obstacles))
         
-        # Neue Planung
-        success = self.plan_zone_coverage()
+        # Neue Planung; der bisherige Plan bleibt bis zum Erfolg veröffentlicht
+        start_time = time.time()
+        segments = self._compute_plan(MowPattern.LINES, state)
         
-        if not success:
-            # Rollback bei Fehler
-            self.current_plan = old_plan
-            self.current_segment_index = old_segment_index
+        if segments is None:
             print("Erweiterte Pfadplanung: Neuplanung fehlgeschlagen - Rollback")
             return False
         
+        self.last_planning_time = time.time() - start_time
+        self.metric_planning_time.observe(self.last_planning_time)
+        self._publish(plan=tuple(segments), segment_index=0, point_index=0,
+                      total_planned_distance=self._plan_distance(segments))
+        self._notify_map_changed()
+        
         print(f"Erweiterte Pfadplanung: Neuplanung erfolgreich (#{self.replanning_count})")
         return True
     
+    def _count_replan(self) -> None:
+        """Zähler, Metrik und Callback einer Neuplanung (synchron und aus Planungsaufträgen)."""
+        self.replanning_count += 1
+        self.metric_replans.inc()
+        
+        if self.replanning_callback:
+            self.replanning_callback(self.replanning_count)
+    
     # Hilfsmethoden
     def _point_in_polygon(self, point: Point, polygon: Polygon) -> bool:
         """Ray-Casting-Algorithmus für Punkt-in-Polygon-Test."""
@@ -574,7 +722,7 @@ class AdvancedPathPlanner:
                     return True
         return False
     
-    def _line_of_sight(self, start: Point, end: Point) -> bool:
+    def _line_of_sight(self, start: Point, end: Point, obstacles: List[Polygon]) -> bool:
         """Prüft freie Sichtlinie zwischen zwei Punkten."""
         # Vereinfachte Implementierung
         steps = int(self._distance(start, end) / 0.1)  # 10cm Schritte
@@ -586,7 +734,7 @@ class AdvancedPathPlanner:
         
         for i in range(steps + 1):
             check_point = Point(start.x + i * dx, start.y + i * dy)
-            if self._point_in_obstacles(check_point, self.obstacles + self.dynamic_obstacles):
+            if self._point_in_obstacles(check_point, obstacles):
                 return False
         
         return True
@@ -610,14 +758,14 @@ class AdvancedPathPlanner:
         
         return abs(area) / 2.0
     
-    def _calculate_obstacle_density(self, zone: Polygon) -> float:
+    def _calculate_obstacle_density(self, zone: Polygon, obstacles: List[Polygon]) -> float:
         """Berechnet die Hindernisdichte in einer Zone."""
         zone_area = self._calculate_polygon_area(zone)
         if zone_area == 0:
             return 0.0
         
         obstacle_area = 0.0
-        for obstacle in self.obstacles:
+        for obstacle in obstacles:
             # Vereinfachte Überschneidungsberechnung
             if self._polygons_intersect(zone, obstacle):
                 obstacle_area += self._calculate_polygon_area(obstacle)
@@ -650,15 +798,15 @@ class AdvancedPathPlanner:
         
         return False
     
-    def _plan_zone_astar(self, zone: Polygon) -> List[PathSegment]:
+    def _plan_zone_astar(self, zone: Polygon, inputs: PlannerSnapshot) -> List[PathSegment]:
         """Plant eine Zone mit A*."""
-        coverage_points = self._generate_coverage_points(zone)
+        coverage_points = self._generate_coverage_points(zone, inputs.obstacles)
         ordered_points = self._optimize_point_order(coverage_points)
         
         segments = []
         for i in range(len(ordered_points) - 1):
             path = self.astar_pathfinder.find_path(
-                ordered_points[i], ordered_points[i + 1], self.dynamic_obstacles
+                ordered_points[i], ordered_points[i + 1], inputs.dynamic_obstacles
             )
             if path:
                 segment = PathSegment(points=path, path_type=PathType.MOWING)
@@ -666,22 +814,21 @@ class AdvancedPathPlanner:
         
         return segments
     
-    def _calculate_plan_statistics(self) -> None:
-        """Berechnet Planungsstatistiken."""
-        self.total_planned_distance = 0.0
-        
-        for segment in self.current_plan:
+    def _plan_distance(self, segments) -> float:
+        """Gesamtlänge eines Plans in Metern."""
+        total = 0.0
+        for segment in segments:
             for i in range(len(segment.points) - 1):
-                self.total_planned_distance += self._distance(
-                    segment.points[i], segment.points[i + 1]
-                )
+                total += self._distance(segment.points[i], segment.points[i + 1])
+        return total
     
     def get_planning_status(self) -> Dict:
         """
         Gibt den aktuellen Planungsstatus zurück.
         """
-        total_segments = len(self.current_plan)
-        completed_segments = self.current_segment_index
+        state = self._state
+        total_segments = len(state.plan)
+        completed_segments = state.segment_index
         
         progress = 0.0
         if total_segments > 0:
@@ -689,15 +836,16 @@ class AdvancedPathPlanner:
         
         return {
             'strategy': self.strategy.value,
+            'version': state.version,
             'total_segments': total_segments,
             'completed_segments': completed_segments,
-            'current_segment_index': self.current_segment_index,
-            'current_point_index': self.current_point_index,
+            'current_segment_index': state.segment_index,
+            'current_point_index': state.point_index,
             'progress': progress,
-            'total_planned_distance': self.total_planned_distance,
+            'total_planned_distance': state.total_planned_distance,
             'replanning_count': self.replanning_count,
             'last_planning_time': self.last_planning_time,
-            'dynamic_obstacles': len(self.dynamic_obstacles)
+            'dynamic_obstacles': len(state.dynamic_obstacles)
         }
     
     def set_obstacle_detected_callback(self, callback: Callable) -> None:
@@ -712,15 +860,125 @@ class AdvancedPathPlanner:
         """Setzt Callback für abgeschlossene Segmente."""
         self.segment_completed_callback = callback
     
+    def set_progress_callback(self, callback: Callable[[float], None]) -> None:
+        """Setzt Callback für den Planungsfortschritt (0.0 - 1.0, je Zone)."""
+        self.progress_callback = callback
+    
+    def set_map_changed_callback(self, callback: Callable[[PlannerSnapshot], None]) -> None:
+        """Setzt Callback für geänderten Plan, Zonen oder Hindernisse (erhält den neuen Snapshot)."""
+        self.map_changed_callback = callback
+    
+    def _report_progress(self, zones_done: int, zones_total: int) -> None:
+        if self.progress_callback:
+            self.progress_callback(zones_done / max(1, zones_total))
+    
+    def planning_request(self, replan: bool = False) -> Dict:
+        """
+        Zonen, Hindernisse und Strategie als serialisierbare Planungsanfrage (siehe planning_jobs.py).
+        replan=True markiert die Anfrage als Neuplanung, install_plan() zählt sie dann mit.
+        """
+        state = self._state
+        request = {
+            'strategy': self.strategy.value,
+            'zones': [zone.to_list() for zone in state.zones],
+            'obstacles': [obstacle.to_list() for obstacle in state.obstacles],
+            'dynamic_obstacles': [obstacle.to_list() for obstacle in state.dynamic_obstacles]
+        }
+        if replan:
+            request['replan'] = True
+        return request
+    
+    def export_plan(self, plan: Optional[Tuple[PathSegment, ...]] = None) -> List[Dict]:
+        """Aktueller (oder übergebener) Plan als Liste serialisierbarer Segmente."""
+        return [self.export_segment(segment) for segment in (self._state.plan if plan is None else plan)]
+    
+    @staticmethod
+    def export_segment(segment: PathSegment) -> Dict:
+        return {
+            'points': [p.to_dict() for p in segment.points],
+            'path_type': segment.path_type.value,
+            'estimated_time': segment.estimated_time,
+            'mow_enabled': segment.mow_enabled,
+            'speed_factor': segment.speed_factor,
+            'priority': segment.priority
+        }
+    
+    @staticmethod
+    def _import_plan(plan: List[Dict]) -> List[PathSegment]:
+        return [
+            PathSegment(
+                points=[Point.from_dict(p) for p in segment['points']],
+                path_type=PathType(segment['path_type']),
+                estimated_time=segment.get('estimated_time', 0.0),
+                mow_enabled=segment.get('mow_enabled', True),
+                speed_factor=segment.get('speed_factor', 1.0),
+                priority=segment.get('priority', 0)
+            )
+            for segment in plan
+        ]
+    
+    @traced('planner.install_plan', 'planner')
+    def install_plan(self, plan: List[Dict], planning_time: float = 0.0, replan: bool = False) -> None:
+        """
+        Übernimmt einen außerhalb der Regelschleife berechneten Plan (export_plan()-Format).
+        Der Plan wird vollständig aufgebaut und erst dann als Ganzes ausgetauscht.
+        replan=True (Auftrag aus planning_request(replan=True)) zählt ihn wie
+        replan_from_current_position() als Neuplanung.
+        """
+        segments = tuple(self._import_plan(plan))
+        if replan:
+            self._count_replan()
+        state = self._publish(plan=segments, segment_index=0, point_index=0,
+                              total_planned_distance=self._plan_distance(segments))
+        self.last_planning_time = planning_time
+        self.metric_planning_time.observe(planning_time)
+        self._notify_map_changed()
+        print(f"Erweiterte Pfadplanung: Neuer Plan übernommen ({len(segments)} Segmente, "
+              f"{state.total_planned_distance:.1f}m)")
+    
+    def checkpoint_state(self) -> Dict:
+        """Plan, Fortschritt und dynamische Hindernisse für den Warmstart (siehe checkpoint.py)."""
+        return self.checkpoint_encode(self.checkpoint_capture())
+    
+    def checkpoint_capture(self) -> Tuple[PlannerSnapshot, PlanningStrategy, int]:
+        """Referenz auf den unveränderlichen Stand; die Regelschleife kopiert nichts."""
+        return self._state, self.strategy, self.replanning_count
+    
+    def checkpoint_encode(self, captured: Tuple[PlannerSnapshot, PlanningStrategy, int]) -> Dict:
+        """Wandelt einen mit checkpoint_capture() festgehaltenen Stand um (Schreib-Thread)."""
+        state, strategy, replanning_count = captured
+        return {
+            'strategy': strategy.value,
+            'plan': self.export_plan(state.plan),
+            'current_segment_index': state.segment_index,
+            'current_point_index': state.point_index,
+            'dynamic_obstacles': [obstacle.to_list() for obstacle in state.dynamic_obstacles],
+            'replanning_count': replanning_count
+        }
+
+    def restore_checkpoint(self, state: Dict) -> None:
+        """Setzt den Plan am gespeicherten Fortschritt fort, statt neu zu planen."""
+        self.strategy = PlanningStrategy(state.get('strategy', self.strategy.value))
+        segments = tuple(self._import_plan(state.get('plan', [])))
+        restored = self._publish(
+            plan=segments,
+            segment_index=state.get('current_segment_index', 0),
+            point_index=state.get('current_point_index', 0),
+            dynamic_obstacles=tuple(Polygon.from_list(o) for o in state.get('dynamic_obstacles', [])),
+            total_planned_distance=self._plan_distance(segments)
+        )
+        self.replanning_count = state.get('replanning_count', 0)
+        self._notify_map_changed()
+        print(f"Erweiterte Pfadplanung: Plan wiederhergestellt "
+              f"(Segment {restored.segment_index}/{len(restored.plan)})")
+
     def reset(self) -> None:
         """
         Setzt den Planer zurück.
         """
-        self.current_plan.clear()
-        self.current_segment_index = 0
-        self.current_point_index = 0
-        self.dynamic_obstacles.clear()
+        self._publish(plan=(), segment_index=0, point_index=0, dynamic_obstacles=(),
+                      total_planned_distance=0.0)
         self.replanning_count = 0
-        self.total_planned_distance = 0.0
+        self._notify_map_changed()
         
         print("Erweiterte Pfadplanung: Zurückgesetzt")
\ No newline at end of file
@@ -81,12 +81,12 @@ class AStarPathfinder:
         self.config = get_config()
         self.grid_size = grid_size
         
-        # A*-Parameter aus Konfiguration
-        astar_config = self.config.get('astar_pathfinding', {})
-        self.diagonal_movement = astar_config.get('diagonal_movement', True)
-        self.heuristic_weight = astar_config.get('heuristic_weight', 1.0)
-        self.obstacle_inflation = astar_config.get('obstacle_inflation', 0.2)  # Meter
-        self.max_iterations = astar_config.get('max_iterations', 10000)
+        # A*-Parameter aus vorberechnetem Konfigurations-Snapshot
+        astar_config = self.config.snapshot().astar
+        self.diagonal_movement = astar_config.diagonal_movement
+        self.heuristic_weight = astar_config.heuristic_weight
+        self.obstacle_inflation = astar_config.obstacle_inflation  # Meter
+        self.max_iterations = astar_config.max_iterations
         
         # Gitter und Knoten
         self.grid: Dict[Tuple[int, int], AStarNode] = {}
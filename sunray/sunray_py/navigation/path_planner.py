@@ -100,9 +100,12 @@ class PathPlanner:
                 start_point = Point(max_x, y)
                 end_point = Point(min_x, y)
                 
-            # Prüfe ob Linie in Zone liegt und nicht durch Hindernisse geht
-            line_points = self._clip_line_to_zone(start_point, end_point, zone, obstacles)
-            path.extend(line_points)
+            # Linie an Zone und Hindernissen zerteilen; Überfahrten zwischen den
+            # Abschnitten umfahren Hindernisse entlang ihres Randes
+            for segment in self._clip_line_to_zone(start_point, end_point, zone, obstacles):
+                if path:
+                    path.extend(self._transit(path[-1], segment[0], zone, obstacles))
+                path.extend(segment)
             
             y += self.line_spacing
             direction *= -1  # Richtung wechseln für Boustrophedon-Muster
@@ -202,20 +205,122 @@ class PathPlanner:
             
         return path
         
-    def _clip_line_to_zone(self, start: Point, end: Point, zone: Polygon, obstacles: List[Polygon]) -> List[Point]:
+    def _clip_line_to_zone(self, start: Point, end: Point, zone: Polygon, obstacles: List[Polygon]) -> List[List[Point]]:
         """
-        Schneidet eine Linie an Zonengrenzen und Hindernissen ab.
-        """
-        # Vereinfachte Implementierung - prüfe nur Start- und Endpunkt
-        points = []
+        Schneidet eine waagerechte Mählinie an Zonengrenzen und Hindernissen ab.
         
-        if self._point_in_zone(start, zone) and not self._point_in_obstacles(start, obstacles):
-            points.append(start)
-            
-        if self._point_in_zone(end, zone) and not self._point_in_obstacles(end, obstacles):
-            points.append(end)
-            
-        return points
+        Liefert je Abschnitt [Anfang, Ende] in Fahrtrichtung (start -> end).
+        Lücken über Hindernissen und Einbuchtungen gehören zu keinem Abschnitt;
+        der Aufrufer muss sie mit _transit() überbrücken.
+        """
+        y = start.y
+        lo, hi = min(start.x, end.x), max(start.x, end.x)
+        segments = [(max(a, lo), min(b, hi)) for a, b in self._scanline_intervals(zone, y)]
+        segments = [(a, b) for a, b in segments if b > a]
+        for obstacle in obstacles:
+            for oa, ob in self._scanline_intervals(obstacle, y):
+                remaining = []
+                for a, b in segments:
+                    if ob <= a or oa >= b:
+                        remaining.append((a, b))
+                        continue
+                    if oa > a:
+                        remaining.append((a, oa))
+                    if ob < b:
+                        remaining.append((ob, b))
+                segments = remaining
+        
+        if end.x < start.x:
+            return [[Point(b, y), Point(a, y)] for a, b in reversed(segments)]
+        return [[Point(a, y), Point(b, y)] for a, b in segments]
+        
+    def _transit(self, start: Point, end: Point, zone: Polygon, obstacles: List[Polygon]) -> List[Point]:
+        """
+        Zwischenpunkte für die Fahrt start -> end (beide ohne sich selbst).
+        Schneidet die Gerade ein Hindernis, wird es entlang seines Randes
+        umfahren; bevorzugt die kürzere Seite, die in der Zone bleibt.
+        """
+        crossings = []
+        for obstacle in obstacles:
+            hit = self._boundary_hits(start, end, obstacle)
+            if hit:
+                crossings.append((hit[0][0], obstacle, hit))
+        crossings.sort(key=lambda c: c[0])
+        
+        detour = []
+        previous = start
+        for _, obstacle, (entry, exit_) in crossings:
+            for point in self._walk_boundary(obstacle, entry, exit_, zone):
+                if math.hypot(point.x - previous.x, point.y - previous.y) > 1e-6:
+                    detour.append(point)
+                    previous = point
+        if detour and math.hypot(end.x - previous.x, end.y - previous.y) <= 1e-6:
+            detour.pop()
+        return detour
+        
+    def _boundary_hits(self, start: Point, end: Point, polygon: Polygon) -> Optional[Tuple[Tuple[float, int, Point], Tuple[float, int, Point]]]:
+        """
+        Erster und letzter Schnitt der Strecke mit dem Polygonrand als
+        (t, Kantenindex, Punkt), sofern die Strecke dazwischen durch das
+        Innere verläuft; sonst None.
+        """
+        n = len(polygon.points)
+        if n < 3:
+            return None
+        dx, dy = end.x - start.x, end.y - start.y
+        hits = []
+        for i in range(n):
+            p1, p2 = polygon.points[i], polygon.points[(i + 1) % n]
+            ex, ey = p2.x - p1.x, p2.y - p1.y
+            denom = dx * ey - dy * ex
+            if abs(denom) < 1e-12:
+                continue  # parallel, auch Fahrt entlang der Kante
+            t = ((p1.x - start.x) * ey - (p1.y - start.y) * ex) / denom
+            u = ((p1.x - start.x) * dy - (p1.y - start.y) * dx) / denom
+            if -1e-9 <= t <= 1 + 1e-9 and -1e-9 <= u <= 1 + 1e-9:
+                hits.append((t, i, Point(start.x + t * dx, start.y + t * dy)))
+        if len(hits) < 2:
+            return None
+        first, last = min(hits, key=lambda h: h[0]), max(hits, key=lambda h: h[0])
+        if last[0] - first[0] < 1e-9:
+            return None
+        middle = Point(start.x + (first[0] + last[0]) / 2 * dx, start.y + (first[0] + last[0]) / 2 * dy)
+        if not self._point_in_zone(middle, polygon):
+            return None
+        return first, last
+        
+    def _walk_boundary(self, polygon: Polygon, entry: Tuple[float, int, Point],
+                       exit_: Tuple[float, int, Point], zone: Polygon) -> List[Point]:
+        """Eckpunkte des Polygons von der Eintritts- zur Austrittskante."""
+        n = len(polygon.points)
+        i, j = entry[1], exit_[1]
+        forward = [polygon.points[(i + k) % n] for k in range(1, (j - i) % n + 1)]
+        backward = [polygon.points[(i - k) % n] for k in range(0, (i - j) % n)]
+        
+        def length(route: List[Point]) -> float:
+            points = [entry[2]] + route + [exit_[2]]
+            return sum(math.hypot(b.x - a.x, b.y - a.y) for a, b in zip(points, points[1:]))
+        
+        routes = sorted((forward, backward), key=length)
+        inside = [r for r in routes if all(self._point_in_zone(p, zone) for p in r)]
+        route = (inside or routes)[0]
+        return [entry[2]] + route + [exit_[2]]
+        
+    def _scanline_intervals(self, polygon: Polygon, y: float) -> List[Tuple[float, float]]:
+        """
+        Innere Abschnitte des Polygons auf der Geraden y (halboffene Kantenregel,
+        damit Eckpunkte nicht doppelt zählen).
+        """
+        crossings = []
+        n = len(polygon.points)
+        if n < 3:
+            return []
+        for i in range(n):
+            p1, p2 = polygon.points[i], polygon.points[(i + 1) % n]
+            if (p1.y <= y < p2.y) or (p2.y <= y < p1.y):
+                crossings.append(p1.x + (y - p1.y) * (p2.x - p1.x) / (p2.y - p1.y))
+        crossings.sort()
+        return [(crossings[i], crossings[i + 1]) for i in range(0, len(crossings) - 1, 2)]
         
     def _point_in_zone(self, point: Point, zone: Polygon) -> bool:
         """
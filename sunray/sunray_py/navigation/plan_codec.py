@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+"""
+Binäres Planformat für die Übertragung an die Web-Oberfläche.
+
+Statt JSON-Arrays aus {x, y}-Objekten wird ein Plan als Little-Endian-Puffer
+übertragen, den der Browser direkt als Float32Array liest:
+
+  Header (32 Byte):   '<4sBBHIIffff'
+    magic 'SPLN', Version, Flags, reserviert, Segmentanzahl, Punktanzahl,
+    Bounding Box (min_x, min_y, max_x, max_y)
+  Segmenttabelle:     je Segment '<IIBBHf' (16 Byte)
+    erster Punktindex, Punktanzahl, Pfadtyp, Mähen an/aus, reserviert, Geschwindigkeitsfaktor
+  Punkte:             float32 x, y (8 Byte je Punkt)
+
+Header und Tabelle sind Vielfache von 4 Byte, die Punkte liegen damit
+ausgerichtet im Puffer. iter_plan_chunks() liefert zuerst Header und Tabelle,
+dann die Punkte in Blöcken - der Browser kann so bereits zeichnen, bevor der
+Plan vollständig empfangen ist.
+
+Autor: Sunray Python Team
+Version: 1.0
+"""
+
+import struct
+import sys
+from array import array
+from typing import Any, Dict, Iterable, Iterator, List, Sequence, Tuple
+
+MAGIC = b'SPLN'
+FORMAT_VERSION = 1
+HEADER = struct.Struct('<4sBBHIIffff')
+SEGMENT = struct.Struct('<IIBBHf')
+POINT_SIZE = 8
+
+# Reihenfolge entspricht den Typcodes im Binärformat (siehe static/js/plan_stream.js)
+PATH_TYPES = ['mowing', 'transit', 'return_home', 'perimeter', 'obstacle_avoidance']
+
+def _type_code(path_type: Any) -> int:
+    name = getattr(path_type, 'value', path_type)
+    if name == 'mow':
+        name = 'mowing'
+    try:
+        return PATH_TYPES.index(name)
+    except ValueError:
+        return 0
+
+def _xy(point: Any) -> Tuple[float, float]:
+    if isinstance(point, dict):
+        return point['x'], point['y']
+    if isinstance(point, (tuple, list)):
+        return point[0], point[1]
+    return point.x, point.y
+
+def normalize_segments(segments: Iterable[Any]) -> List[Dict]:
+    """
+    Vereinheitlicht Segmente zu {'points', 'type', 'mow', 'speed'}.
+    Akzeptiert PathSegment-Objekte des AdvancedPathPlanner und Dictionaries
+    mit 'points' sowie 'type'/'path_type'.
+    """
+    result = []
+    for segment in segments:
+        if isinstance(segment, dict):
+            path_type = segment.get('type', segment.get('path_type', 'mowing'))
+            mow = segment.get('mow_enabled', path_type in ('mow', 'mowing'))
+            speed = segment.get('speed_factor', 1.0)
+            points = segment.get('points', [])
+        else:
+            path_type = segment.path_type
+            mow = segment.mow_enabled
+            speed = segment.speed_factor
+            points = segment.points
+        result.append({'points': points, 'type': _type_code(path_type),
+                       'mow': bool(mow), 'speed': float(speed)})
+    return result
+
+def _pack_points(points: Sequence[Any]) -> bytes:
+    values = array('f')
+    for point in points:
+        values.extend(_xy(point))
+    if sys.byteorder == 'big':
+        values.byteswap()
+    return values.tobytes()
+
+def encode_header(segments: List[Dict]) -> bytes:
+    """Header und Segmenttabelle für normalisierte Segmente."""
+    total = 0
+    min_x = min_y = float('inf')
+    max_x = max_y = float('-inf')
+    table = bytearray()
+    for segment in segments:
+        count = len(segment['points'])
+        table += SEGMENT.pack(total, count, segment['type'], segment['mow'], 0, segment['speed'])
+        total += count
+        for point in segment['points']:
+            x, y = _xy(point)
+            min_x, max_x = min(min_x, x), max(max_x, x)
+            min_y, max_y = min(min_y, y), max(max_y, y)
+    if total == 0:
+        min_x = min_y = max_x = max_y = 0.0
+    return HEADER.pack(MAGIC, FORMAT_VERSION, 0, 0, len(segments), total,
+                       min_x, min_y, max_x, max_y) + bytes(table)
+
+def iter_plan_chunks(segments: Iterable[Any], chunk_points: int = 4096) -> Iterator[bytes]:
+    """Liefert den Plan blockweise: zuerst Header mit Segmenttabelle, dann Punkte."""
+    segments = normalize_segments(segments)
+    yield encode_header(segments)
+    pending: List[Any] = []
+    for segment in segments:
+        points = segment['points']
+        start = 0
+        while start < len(points):
+            take = min(chunk_points - len(pending), len(points) - start)
+            pending.extend(points[start:start + take])
+            start += take
+            if len(pending) >= chunk_points:
+                yield _pack_points(pending)
+                pending = []
+    if pending:
+        yield _pack_points(pending)
+
+def encode_plan(segments: Iterable[Any]) -> bytes:
+    """Kodiert einen vollständigen Plan in einen Puffer."""
+    return b''.join(iter_plan_chunks(segments))
+
+def plan_size(segment_count: int, point_count: int) -> int:
+    """Größe eines kodierten Plans in Byte."""
+    return HEADER.size + SEGMENT.size * segment_count + POINT_SIZE * point_count
+
+def decode_plan(data: bytes) -> Dict:
+    """
+    Dekodiert einen Plan (für Tests und Werkzeuge).
+    Rückgabe: {'bounds': (...), 'segments': [{'type', 'mow', 'speed', 'points': [(x, y), ...]}]}
+    """
+    magic, version, _, _, segment_count, point_count, *bounds = HEADER.unpack_from(data, 0)
+    if magic != MAGIC or version != FORMAT_VERSION:
+        raise ValueError("Kein Sunray-Plan oder unbekannte Version")
+    if len(data) != plan_size(segment_count, point_count):
+        raise ValueError("Plan unvollständig")
+    values = array('f')
+    values.frombytes(data[plan_size(segment_count, 0):])
+    if sys.byteorder == 'big':
+        values.byteswap()
+    segments = []
+    for i in range(segment_count):
+        start, count, type_code, mow, _, speed = SEGMENT.unpack_from(data, HEADER.size + i * SEGMENT.size)
+        flat = values[2 * start:2 * (start + count)]
+        segments.append({
+            'type': PATH_TYPES[type_code] if type_code < len(PATH_TYPES) else 'mowing',
+            'mow': bool(mow),
+            'speed': speed,
+            'points': list(zip(flat[0::2], flat[1::2]))
+        })
+    return {'bounds': tuple(bounds), 'segments': segments}
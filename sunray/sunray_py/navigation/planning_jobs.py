@@ -0,0 +1,364 @@
+#!/usr/bin/env python3
+"""
+Asynchrone Planungsaufträge für die erweiterte Pfadplanung.
+
+Große Zonen blockieren beim synchronen Planen sowohl den HTTP-Worker als auch
+die Regelschleife. Der PlanningJobService nimmt Aufträge entgegen, führt sie
+nacheinander in einem eigenen Prozess aus (eigener Interpreter, kein GIL-Konflikt
+mit der Regelschleife) und meldet den Fortschritt an Listener (z.B. den SSE-Kanal).
+
+- submit() liefert sofort eine Auftrags-ID; replace=True verwirft ältere Aufträge
+- cancel() und Deadlines beenden den Planungsprozess sofort
+- Der fertige Plan wird nicht direkt installiert: die Regelschleife holt ihn an
+  einer sicheren Stelle mit take_finished_plan() ab und tauscht ihn als Ganzes aus
+
+Verwendung:
+  jobs = get_planning_jobs(config.get('planning_jobs', {}))
+  job_id = jobs.submit(planner.planning_request(), deadline=60)
+  ...
+  job = jobs.take_finished_plan()            # Regelschleife, zwischen zwei Ticks
+  if job: planner.install_plan(job.result['plan'], replan=job.request.get('replan', False))
+
+Autor: Sunray Python Team
+Version: 1.0
+"""
+
+import multiprocessing
+import threading
+import time
+import uuid
+from collections import OrderedDict, deque
+from typing import Any, Callable, Dict, List, Optional
+from utils.metrics import get_metrics
+
+QUEUED = 'queued'
+RUNNING = 'running'
+COMPLETED = 'completed'
+FAILED = 'failed'
+CANCELLED = 'cancelled'
+EXPIRED = 'expired'
+FINISHED_STATES = (COMPLETED, FAILED, CANCELLED, EXPIRED)
+
+def plan_coverage(request: Dict, progress: Callable[[float], None]) -> Dict:
+    """
+    Standard-Planungsfunktion (läuft im Planungsprozess).
+    request: Ergebnis von AdvancedPathPlanner.planning_request(), optional mit 'pattern'.
+    """
+    from map import Polygon
+    from navigation.advanced_path_planner import AdvancedPathPlanner, PlanningStrategy
+    from navigation.path_planner import MowPattern
+
+    planner = AdvancedPathPlanner()
+    if request.get('strategy'):
+        planner.set_strategy(PlanningStrategy(request['strategy']))
+    obstacles = [Polygon.from_list(o) for o in request.get('obstacles', [])]
+    dynamic_obstacles = [Polygon.from_list(o) for o in request.get('dynamic_obstacles', [])]
+    planner.set_zones_and_obstacles([Polygon.from_list(z) for z in request.get('zones', [])], obstacles,
+                                    dynamic_obstacles)
+    planner.astar_pathfinder.set_obstacles(obstacles + dynamic_obstacles)
+    planner.set_progress_callback(progress)
+    if not planner.plan_zone_coverage(MowPattern(request.get('pattern', 'lines'))):
+        raise RuntimeError("Planung fehlgeschlagen")
+    return {
+        'plan': planner.export_plan(),
+        'total_planned_distance': planner.total_planned_distance,
+        'planning_time': planner.last_planning_time
+    }
+
+def simulate_planning(request: Dict, progress: Callable[[float], None]) -> Dict:
+    """
+    Simulierte Planung für den Demo-Server (web_server.py): Linienmuster mit
+    Transitsegmenten im export_plan()-Format, verteilt über request['duration'] Sekunden.
+    """
+    total_segments = max(1, int(request.get('total_segments', 20)))
+    points_per_segment = max(2, int(request.get('points_per_segment', 50)))
+    pause = float(request.get('duration', 1.0)) / total_segments
+    lane_width = 0.3
+    plan = []
+    for i in range(total_segments):
+        y = 60 + i * lane_width
+        x0, x1 = (60, 190) if i % 2 == 0 else (190, 60)
+        step = (x1 - x0) / (points_per_segment - 1)
+        plan.append({'path_type': 'mowing', 'mow_enabled': True, 'speed_factor': 1.0,
+                     'points': [{'x': x0 + j * step, 'y': y} for j in range(points_per_segment)]})
+        if i + 1 < total_segments:
+            plan.append({'path_type': 'transit', 'mow_enabled': False, 'speed_factor': 1.5,
+                         'points': [{'x': x1, 'y': y}, {'x': x1, 'y': y + lane_width}]})
+        time.sleep(pause)
+        progress((i + 1) / total_segments)
+    return {'plan': plan, 'total_planned_distance': total_segments * 130.0}
+
+def _worker_main(plan_function: Callable, request: Dict, conn) -> None:
+    """Einstiegspunkt des Planungsprozesses; meldet Fortschritt in 1-%-Schritten."""
+    last = [-1.0]
+
+    def progress(fraction: float) -> None:
+        fraction = min(1.0, max(0.0, float(fraction)))
+        if fraction - last[0] >= 0.01 or fraction == 1.0 and last[0] < 1.0:
+            last[0] = fraction
+            conn.send(('progress', fraction))
+
+    try:
+        conn.send(('done', plan_function(request, progress)))
+    except Exception as e:
+        conn.send(('error', f"{type(e).__name__}: {e}"))
+    finally:
+        conn.close()
+
+class PlanningJob:
+    """Zustand eines Planungsauftrags."""
+    def __init__(self, job_id: str, request: Dict, deadline: Optional[float]):
+        self.id = job_id
+        self.request = request
+        self.state = QUEUED
+        self.progress = 0.0
+        self.submitted = time.time()
+        self.started: Optional[float] = None
+        self.finished: Optional[float] = None
+        self.deadline = time.monotonic() + deadline if deadline else None
+        self.error: Optional[str] = None
+        self.result: Optional[Dict] = None
+        self.installed = False
+        self.cancel_requested = False
+
+    def to_dict(self) -> Dict:
+        """Status ohne Plan (für API und Push-Kanal)."""
+        runtime = None
+        if self.started:
+            runtime = (self.finished or time.time()) - self.started
+        return {
+            'job_id': self.id,
+            'state': self.state,
+            'progress': round(self.progress, 3),
+            'submitted': self.submitted,
+            'runtime': runtime,
+            'deadline_in': max(0.0, self.deadline - time.monotonic()) if self.deadline and
+                           self.state not in FINISHED_STATES else None,
+            'error': self.error,
+            'segments': len(self.result.get('plan', [])) if self.result else None,
+            'installed': self.installed
+        }
+
+class PlanningJobService:
+    """
+    Warteschlange für Planungsaufträge mit einem Planungsprozess zur Zeit.
+    config (Abschnitt 'planning_jobs' in config.json):
+      start_method: 'spawn' (sicher bei laufenden Threads) oder 'fork' (schnellerer Start)
+      max_queue: maximale Anzahl wartender Aufträge
+      default_deadline: Sekunden ab Einreichung, danach wird der Auftrag abgebrochen (0 = keine)
+      history: Anzahl aufbewahrter abgeschlossener Aufträge
+    """
+    def __init__(self, config: Optional[Dict] = None,
+                 plan_function: Callable[[Dict, Callable[[float], None]], Dict] = plan_coverage):
+        config = config or {}
+        self.plan_function = plan_function
+        self.max_queue = config.get('max_queue', 4)
+        self.default_deadline = config.get('default_deadline', 120.0)
+        self.history = config.get('history', 20)
+        self.poll_interval = config.get('poll_interval', 0.05)
+        self._context = multiprocessing.get_context(config.get('start_method', 'spawn'))
+        self._jobs: 'OrderedDict[str, PlanningJob]' = OrderedDict()
+        self._queue: deque = deque()
+        self._finished: Optional[PlanningJob] = None
+        self._listeners: List[Callable[[Dict], None]] = []
+        self._cond = threading.Condition()
+        self._thread: Optional[threading.Thread] = None
+        self._stopping = False
+        self.stats = {'submitted': 0, COMPLETED: 0, FAILED: 0, CANCELLED: 0, EXPIRED: 0, 'rejected': 0}
+        metrics = get_metrics()
+        self.metric_jobs = metrics.counter('sunray_planning_jobs', 'Beendete Planungsaufträge', ('state',))
+        self.metric_duration = metrics.histogram('sunray_planning_job_seconds', 'Laufzeit der Planungsaufträge',
+                                                 buckets=(0.1, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0, 60.0, 120.0, 300.0))
+        metrics.gauge('sunray_planning_jobs_queued', 'Wartende Planungsaufträge', fn=lambda: len(self._queue))
+
+    def add_listener(self, callback: Callable[[Dict], None]) -> None:
+        """callback(job_dict) bei jeder Zustands- und Fortschrittsänderung (aus dem Dienst-Thread)."""
+        self._listeners.append(callback)
+
+    def _notify(self, job: PlanningJob) -> None:
+        status = job.to_dict()
+        for callback in self._listeners:
+            try:
+                callback(status)
+            except Exception as e:
+                print(f"Planungsaufträge: Listener-Fehler - {e}")
+
+    def submit(self, request: Dict, deadline: Optional[float] = None,
+               replace: bool = False) -> Optional[str]:
+        """
+        Reiht einen Auftrag ein und gibt seine ID zurück (None bei voller Warteschlange).
+        replace=True bricht alle noch offenen Aufträge ab (z.B. bei erneuter Neuplanung).
+        """
+        with self._cond:
+            if replace:
+                for job in self._jobs.values():
+                    if job.state in (QUEUED, RUNNING):
+                        job.cancel_requested = True
+            pending = sum(1 for job_id in self._queue if not self._jobs[job_id].cancel_requested)
+            if pending >= self.max_queue:
+                self.stats['rejected'] += 1
+                print("Planungsaufträge: Warteschlange voll")
+                return None
+            job = PlanningJob(uuid.uuid4().hex[:12], request,
+                              deadline if deadline is not None else self.default_deadline)
+            self._jobs[job.id] = job
+            self._queue.append(job.id)
+            self.stats['submitted'] += 1
+            self._prune()
+            if self._thread is None or not self._thread.is_alive():
+                self._stopping = False
+                self._thread = threading.Thread(target=self._run, name='planning-jobs', daemon=True)
+                self._thread.start()
+            self._cond.notify_all()
+        self._notify(job)
+        return job.id
+
+    def cancel(self, job_id: str) -> bool:
+        """Bricht einen wartenden oder laufenden Auftrag ab."""
+        with self._cond:
+            job = self._jobs.get(job_id)
+            if job is None or job.state in FINISHED_STATES:
+                return False
+            job.cancel_requested = True
+            self._cond.notify_all()
+        return True
+
+    def get(self, job_id: str) -> Optional[Dict]:
+        with self._cond:
+            job = self._jobs.get(job_id)
+            return job.to_dict() if job else None
+
+    def list_jobs(self) -> List[Dict]:
+        with self._cond:
+            return [job.to_dict() for job in reversed(self._jobs.values())]
+
+    def take_finished_plan(self) -> Optional[PlanningJob]:
+        """
+        Gibt den zuletzt fertiggestellten, noch nicht übernommenen Auftrag zurück
+        (job.result['plan']). Wird von der Regelschleife an einer sicheren Stelle aufgerufen.
+        """
+        if self._finished is None:
+            return None
+        with self._cond:
+            job, self._finished = self._finished, None
+            if job is None or job.cancel_requested:
+                return None
+            job.installed = True
+        return job
+
+    def get_statistics(self) -> Dict:
+        with self._cond:
+            return dict(self.stats, queued=len(self._queue),
+                        running=sum(1 for job in self._jobs.values() if job.state == RUNNING))
+
+    def shutdown(self) -> None:
+        """Bricht alle Aufträge ab und beendet den Dienst-Thread."""
+        with self._cond:
+            self._stopping = True
+            for job in self._jobs.values():
+                if job.state in (QUEUED, RUNNING):
+                    job.cancel_requested = True
+            self._cond.notify_all()
+        if self._thread is not None:
+            self._thread.join(timeout=5.0)
+
+    def _prune(self) -> None:
+        finished = [job_id for job_id, job in self._jobs.items() if job.state in FINISHED_STATES]
+        for job_id in finished[:max(0, len(finished) - self.history)]:
+            del self._jobs[job_id]
+
+    def _run(self) -> None:
+        while True:
+            with self._cond:
+                while not self._queue and not self._stopping:
+                    self._cond.wait()
+                if self._stopping and not self._queue:
+                    return
+                job = self._jobs[self._queue.popleft()]
+                outcome = None
+                if job.cancel_requested:
+                    outcome = (CANCELLED, None)
+                elif job.deadline and time.monotonic() > job.deadline:
+                    outcome = (EXPIRED, "Deadline vor Planungsbeginn abgelaufen")
+                else:
+                    job.state = RUNNING
+                    job.started = time.time()
+            if outcome is None:
+                self._notify(job)
+                outcome = self._execute(job)
+            self._finish(job, *outcome)
+
+    def _execute(self, job: PlanningJob):
+        """Führt einen Auftrag im Planungsprozess aus und überwacht Abbruch und Deadline."""
+        receiver, sender = self._context.Pipe(duplex=False)
+        process = self._context.Process(target=_worker_main, name=f'planning-{job.id}',
+                                        args=(self.plan_function, job.request, sender), daemon=True)
+        try:
+            process.start()
+        except Exception as e:
+            return FAILED, f"Planungsprozess konnte nicht gestartet werden: {e}"
+        finally:
+            sender.close()
+
+        outcome = None
+        try:
+            while outcome is None:
+                if job.cancel_requested:
+                    outcome = (CANCELLED, None)
+                elif job.deadline and time.monotonic() > job.deadline:
+                    outcome = (EXPIRED, "Deadline überschritten")
+                elif receiver.poll(self.poll_interval):
+                    try:
+                        kind, value = receiver.recv()
+                    except EOFError:
+                        process.join(1.0)
+                        outcome = (FAILED, f"Planungsprozess beendet (Exitcode {process.exitcode})")
+                        continue
+                    if kind == 'progress':
+                        job.progress = value
+                        self._notify(job)
+                    elif kind == 'done':
+                        outcome = (COMPLETED, value)
+                    else:
+                        outcome = (FAILED, value)
+        finally:
+            process.join(1.0 if outcome and outcome[0] == COMPLETED else 0)
+            if process.is_alive():
+                process.terminate()
+                process.join(1.0)
+                if process.is_alive():
+                    process.kill()
+                    process.join()
+            receiver.close()
+        return outcome
+
+    def _finish(self, job: PlanningJob, state: str, value: Any) -> None:
+        with self._cond:
+            if state == COMPLETED and job.cancel_requested:
+                # cancel() kam nach dem letzten Ergebnis des Planungsprozesses: Plan verwerfen
+                state, value = CANCELLED, None
+            job.state = state
+            job.finished = time.time()
+            if state == COMPLETED:
+                job.result = value
+                job.progress = 1.0
+                self._finished = job
+            elif value:
+                job.error = value
+            self.stats[state] += 1
+            self._prune()
+        self.metric_jobs.labels(state).inc()
+        if job.started:
+            self.metric_duration.observe(job.finished - job.started)
+        if state != COMPLETED:
+            print(f"Planungsaufträge: Auftrag {job.id} {state}" + (f" - {job.error}" if job.error else ""))
+        self._notify(job)
+
+_planning_jobs: Optional[PlanningJobService] = None
+
+def get_planning_jobs(config: Optional[Dict] = None, plan_function: Optional[Callable] = None) -> PlanningJobService:
+    """Gibt den globalen Planungsdienst zurück (Konfiguration nur beim ersten Aufruf)."""
+    global _planning_jobs
+    if _planning_jobs is None:
+        _planning_jobs = PlanningJobService(config, plan_function or plan_coverage)
+    return _planning_jobs
@@ -15,6 +15,7 @@ import threading
 import time
 from typing import Optional, Callable, Dict, Any
 from config import get_config
+from utils.metrics import get_metrics
 
 class NTRIPClient:
     """
@@ -72,6 +73,12 @@ class NTRIPClient:
         self.last_data_time = 0
         self.connection_attempts = 0
         self.using_local_rtk = False
+        
+        # Metriken (/metrics)
+        metrics = get_metrics()
+        self.metric_bytes = metrics.counter('sunray_ntrip_received_bytes', 'Empfangene RTCM-Korrekturdaten')
+        self.metric_connects = metrics.counter('sunray_ntrip_connection_attempts', 'Verbindungsversuche zum Caster')
+        metrics.gauge('sunray_ntrip_connected', 'NTRIP-Verbindung aktiv (1/0)', fn=lambda: self.connected)
     
     def set_rtcm_callback(self, callback: Callable[[bytes], None]) -> None:
         """
@@ -168,6 +175,7 @@ class NTRIPClient:
         """
         try:
             self.connection_attempts += 1
+            self.metric_connects.inc()
             
             # Socket erstellen
             self.socket = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
@@ -242,6 +250,7 @@ class NTRIPClient:
                 
                 buffer += data
                 self.bytes_received += len(data)
+                self.metric_bytes.inc(len(data))
                 self.last_data_time = time.time()
                 
                 # RTCM-Nachrichten extrahieren und weiterleiten
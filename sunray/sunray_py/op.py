@@ -10,11 +10,17 @@ class Operation(ABC):
     def __init__(self, name: str):
         self.name = name
         self.active = False
+        self.params: Dict[str, Any] = {}
 
     def start(self, params: Optional[Dict[str, Any]] = None) -> None:
         """Beginnt die Operation mit optionalen Parametern."""
         self.active = True
-        self.on_start(params or {})
+        self.params = params or {}
+        self.on_start(self.params)
+
+    def checkpoint_state(self) -> Dict[str, Any]:
+        """Name und Startparameter für den Warmstart (siehe checkpoint.py)."""
+        return {'name': self.name, 'params': dict(self.params)}
 
     @abstractmethod
     def on_start(self, params: Dict[str, Any]) -> None:
@@ -1,11 +1,14 @@
 # type: ignore
 import serial
 import pynmea2
-from pyubx2 import UBXReader, UBXMessage, UBXWriter, SET
+from pyubx2 import UBXReader, UBXMessage, UBXWriter, SET, POLL
 from typing import Optional, Dict, Callable
 from ntrip_client import NTRIPClient
 import time
 import math
+from collections import deque
+import json
+import os
 
 class RTKGPS:
     """
@@ -25,6 +28,10 @@ class RTKGPS:
     2. NTRIP: Internet-basierte Korrekturdaten (fallback)
     """
 
+    # Erhöhen, wenn sich _configure_ardusimple_board() ändert,
+    # damit die Boards beim nächsten Start neu konfiguriert werden.
+    BOARD_CONFIG_VERSION = 1
+
     def __init__(self, port: str = None, baudrate: int = None, timeout: float = None, 
                  rtk_mode: str = None, enable_ntrip_fallback: bool = None, auto_configure: bool = None, config: dict = None):
         """
@@ -48,6 +55,9 @@ class RTKGPS:
             rtk_mode = rtk_mode or rtk_config.get('rtk_mode', 'auto')
             enable_ntrip_fallback = enable_ntrip_fallback if enable_ntrip_fallback is not None else rtk_config.get('enable_ntrip_fallback', True)
             auto_configure = auto_configure if auto_configure is not None else rtk_config.get('auto_configure', True)
+            board_config_stamp = rtk_config.get('board_config_stamp', 'rtk_board_config.json')
+            self.rtk_detect_window = rtk_config.get('rtk_detect_window', 5.0)
+            self.receiver_poll_timeout = rtk_config.get('receiver_poll_timeout', 0.5)
         else:
             # Fallback zu Standardwerten
             port = port or '/dev/ttyUSB0'
@@ -56,6 +66,20 @@ class RTKGPS:
             rtk_mode = rtk_mode or 'auto'
             enable_ntrip_fallback = enable_ntrip_fallback if enable_ntrip_fallback is not None else True
             auto_configure = auto_configure if auto_configure is not None else True
+            board_config_stamp = 'rtk_board_config.json'
+            self.rtk_detect_window = 5.0
+            self.receiver_poll_timeout = 0.5
+        
+        # Relative Stempelpfade liegen im Datenverzeichnis (data_directory), nicht im
+        # Arbeitsverzeichnis oder im Quellbaum. Ohne Datenverzeichnis kein Stempel.
+        data_directory = (config or {}).get('data_directory')
+        if board_config_stamp and not os.path.isabs(board_config_stamp):
+            if data_directory:
+                board_config_stamp = os.path.join(data_directory, board_config_stamp)
+            else:
+                print("RTK-GPS: WARNUNG - kein data_directory konfiguriert, Konfigurationsstempel deaktiviert "
+                      "(Board wird bei jedem Start konfiguriert)")
+                board_config_stamp = None
         
         print(f"RTK-GPS: Initialisiere mit Port: {port}, Baudrate: {baudrate}, Timeout: {timeout}s")
         print(f"RTK-GPS: RTK-Modus: {rtk_mode}, NTRIP-Fallback: {enable_ntrip_fallback}, Auto-Config: {auto_configure}")
@@ -77,9 +101,22 @@ class RTKGPS:
         # NTRIP Client (optional/fallback)
         self.ntrip_client = None
         
-        # Automatische Board-Konfiguration
+        # Automatische Board-Konfiguration (nur wenn sich die Konfiguration geändert hat,
+        # das Board speichert sie im BBR/Flash)
+        self.board_config_stamp = board_config_stamp
+        self.baudrate = baudrate
+        self.receiver_id = None
         if auto_configure:
-            self._configure_ardusimple_board()
+            # Kennung nur abfragen, wenn ein Stempel sie auch vergleichen kann
+            if self.board_config_stamp:
+                self.receiver_id = self._poll_receiver_id()
+            if self._board_config_current():
+                print("RTK-GPS: Board-Konfiguration unverändert, überspringe Konfiguration")
+            elif self._configure_ardusimple_board():
+                self._write_board_config_stamp()
+        
+        # Zeitfenster für die nicht blockierende XBee-Erkennung im Auto-Modus
+        self._rtk_detect_deadline = None
         
         # RTK-Korrekturdaten-Quelle ermitteln und konfigurieren
         self._configure_rtk_source()
@@ -93,8 +130,8 @@ class RTKGPS:
         self.last_fix_time = 0
         self.fix_type = 0
         self.last_position = {'lat': 0, 'lon': 0}
-        self.position_history = []
         self.max_history = 10
+        self.position_history = deque(maxlen=self.max_history)
         
         # Navigation
         self.current_waypoint = None
@@ -222,10 +259,72 @@ class RTKGPS:
             print("RTK-GPS: - UBX-Nachrichten: NAV-PVT, NAV-RELPOSNED")
             print("RTK-GPS: - NMEA-Nachrichten: GGA")
             print("RTK-GPS: - RTK-Modi aktiviert")
+            return True
             
         except Exception as e:
             print(f"RTK-GPS: Fehler bei Board-Konfiguration: {e}")
             print("RTK-GPS: Verwende Standard-Konfiguration")
+            return False
+    
+    def _poll_ubx(self, msg_class: str, msg_id: str):
+        """Fragt eine UBX-Nachricht ab und wartet höchstens receiver_poll_timeout Sekunden auf die Antwort."""
+        self.ubx_writer.write(UBXMessage(msg_class, msg_id, POLL))
+        deadline = time.monotonic() + self.receiver_poll_timeout
+        while time.monotonic() < deadline:
+            _, parsed = self.ubx_reader.read()
+            if getattr(parsed, 'identity', None) == msg_id:
+                return parsed
+        return None
+    
+    def _poll_receiver_id(self) -> Optional[str]:
+        """
+        Kennung des angeschlossenen Empfängers: Chip-ID aus UBX-SEC-UNIQID,
+        bei älterer Firmware ersatzweise Hardware-/Softwareversion aus UBX-MON-VER.
+        """
+        try:
+            uniqid = self._poll_ubx('SEC', 'SEC-UNIQID')
+            if uniqid is not None:
+                unique_id = uniqid.uniqueId
+                return 'uniqid:' + (unique_id.hex() if isinstance(unique_id, bytes) else f"{unique_id:x}")
+            monver = self._poll_ubx('MON', 'MON-VER')
+            if monver is not None:
+                versions = [value.decode('ascii', 'ignore').strip('\x00') if isinstance(value, bytes) else str(value)
+                            for value in (monver.hwVersion, monver.swVersion)]
+                return 'monver:' + '/'.join(versions)
+        except Exception as e:
+            print(f"RTK-GPS: Empfängerkennung nicht lesbar: {e}")
+        return None
+    
+    def _board_config_fingerprint(self) -> Dict:
+        """Kennung der Board-Konfiguration, die zuletzt geschrieben wurde."""
+        return {'version': self.BOARD_CONFIG_VERSION, 'baudrate': self.baudrate,
+                'receiver': self.receiver_id}
+    
+    def _board_config_current(self) -> bool:
+        """
+        Prüft, ob dieser Empfänger bereits mit der aktuellen Konfiguration beschrieben wurde.
+        Ohne Empfängerkennung (getauschtes Board nicht erkennbar) wird neu konfiguriert.
+        """
+        if self.receiver_id is None:
+            return False
+        if not self.board_config_stamp or not os.path.exists(self.board_config_stamp):
+            return False
+        try:
+            with open(self.board_config_stamp, 'r') as f:
+                return json.load(f) == self._board_config_fingerprint()
+        except (OSError, ValueError):
+            return False
+    
+    def _write_board_config_stamp(self):
+        """Merkt sich die geschriebene Board-Konfiguration für den nächsten Start."""
+        if not self.board_config_stamp:
+            return
+        try:
+            os.makedirs(os.path.dirname(self.board_config_stamp), exist_ok=True)
+            with open(self.board_config_stamp, 'w') as f:
+                json.dump(self._board_config_fingerprint(), f)
+        except OSError as e:
+            print(f"RTK-GPS: Konnte Konfigurationsstempel nicht schreiben: {e}")
     
     def reconfigure_board(self):
         """
@@ -233,22 +332,20 @@ class RTKGPS:
         Nützlich wenn Board-Einstellungen geändert werden sollen.
         """
         print("RTK-GPS: Manuelle Board-Neukonfiguration...")
-        self._configure_ardusimple_board()
+        if self.board_config_stamp:
+            self.receiver_id = self._poll_receiver_id()
+        if self._configure_ardusimple_board():
+            self._write_board_config_stamp()
     
     def _configure_rtk_source(self):
         """Konfiguriert die RTK-Korrekturdaten-Quelle basierend auf Modus und Verfügbarkeit."""
         if self.rtk_mode == "auto":
-            # Automatische Erkennung: Prüfe auf XBee RTK-Nachrichten
+            # Automatische Erkennung ohne den Start zu blockieren: read() schaltet auf
+            # XBee um, sobald RTCM-Nachrichten eintreffen. Bleiben sie im Erkennungsfenster
+            # aus, richtet _check_rtk_source_health() den NTRIP-Fallback ein.
             print("RTK-GPS: Automatische Erkennung der Korrekturdaten-Quelle...")
-            if self._detect_xbee_rtk():
-                self.correction_source = "xbee"
-                self.xbee_rtk_active = True
-                print("RTK-GPS: XBee 868MHz RTK-Verbindung erkannt")
-            elif self.enable_ntrip_fallback:
-                self._setup_ntrip_fallback()
-            else:
-                print("RTK-GPS: Keine RTK-Korrekturdaten verfügbar (Standalone-Modus)")
-                self.correction_source = "none"
+            self.correction_source = "none"
+            self._rtk_detect_deadline = time.time() + self.rtk_detect_window
         
         elif self.rtk_mode == "xbee":
             # Erzwinge XBee-Modus
@@ -304,6 +401,18 @@ class RTKGPS:
         """Überwacht die Gesundheit der RTK-Korrekturdaten-Quelle."""
         current_time = time.time()
         
+        # Ende des Erkennungsfensters im Auto-Modus
+        if self._rtk_detect_deadline is not None:
+            if self.correction_source != "none":
+                self._rtk_detect_deadline = None
+            elif current_time >= self._rtk_detect_deadline:
+                self._rtk_detect_deadline = None
+                if self.enable_ntrip_fallback:
+                    self._setup_ntrip_fallback()
+                else:
+                    print("RTK-GPS: Keine RTK-Korrekturdaten verfügbar (Standalone-Modus)")
+            return
+        
         # XBee RTK Timeout-Prüfung
         if self.correction_source == "xbee":
             if current_time - self.last_rtk_message_time > self.rtk_timeout:
@@ -368,7 +477,7 @@ class RTKGPS:
                     self.correction_source = "xbee"
                     self.xbee_rtk_active = True
                     self.last_rtk_message_time = time.time()
-                    print("RTK-GPS: XBee RTK-Verbindung wiederhergestellt")
+                    print("RTK-GPS: XBee 868MHz RTK-Verbindung erkannt")
                     # NTRIP deaktivieren falls aktiv
                     if self.ntrip_client:
                         self.ntrip_client.disconnect()
@@ -431,8 +540,6 @@ class RTKGPS:
             'lon': gps_data['lon'],
             'time': time.time()
         })
-        if len(self.position_history) > self.max_history:
-            self.position_history.pop(0)
         
         # Setze Origin falls noch nicht gesetzt
         if not self.origin_set and gps_data['fix_type'] >= 2:
@@ -0,0 +1,561 @@
+import bisect
+import calendar
+import json
+import os
+import struct
+import time
+import zlib
+from collections import namedtuple
+from typing import Dict, Iterable, Iterator, List, Optional, Tuple
+
+try:
+    import lz4.block as lz4_block
+except ImportError:
+    lz4_block = None
+
+# Dateiformat (.slg), alle Werte little-endian:
+#   Header:  MAGIC, Version (u8), Flags (u8), Erstellzeit (f64), Schema-Länge (u32),
+#            Schema als JSON: [{"name": ..., "fields": [[Name, struct-Zeichen], ...]}, ...]
+#   Chunks:  CHUNK_MAGIC, Stream (u16), Codec (u8), Anzahl (u32), Rohlänge (u32),
+#            gespeicherte Länge (u32), t_first/t_last (f64, s), danach die Datensätze
+#            eines Streams mit fester Länge (erstes Feld t, f64), ggf. komprimiert
+#   Footer:  ein INDEX_ENTRY pro Chunk, abgeschlossen von TRAILER (Offset des Footers,
+#            Anzahl Einträge, FOOTER_MAGIC) am Dateiende
+# Der Footer entsteht beim Schließen. Fehlt er (Absturz, Stromausfall), wird der
+# Index aus den Chunk-Headern neu aufgebaut; abgeschnittene Chunks werden ignoriert.
+# Unkomprimierte Chunks sind genau die Datensätze hintereinander und lassen sich
+# mit numpy.memmap (dtype(stream)) ohne Kopie einblenden.
+
+MAGIC = b'SSLG'
+VERSION = 1
+HEADER = struct.Struct('<4sBBxxdI')
+CHUNK_MAGIC = b'SC'
+CHUNK_HEADER = struct.Struct('<2sHBxIIIdd')
+INDEX_ENTRY = struct.Struct('<HBxIIIQdd')
+FOOTER_MAGIC = b'SLGX'
+TRAILER = struct.Struct('<QI4s')
+
+CODEC_NONE = 0
+CODEC_LZ4 = 1
+CODEC_ZLIB = 2
+CODECS = {None: CODEC_NONE, 'none': CODEC_NONE, 'lz4': CODEC_LZ4, 'zlib': CODEC_ZLIB}
+
+# Streams der Aufzeichnung; Feldnamen wie in main.process_pico_data bzw. RTKGPS
+STREAMS = {
+    # AT+S:-Zeilen und M-Antworten der Firmware
+    'odometry': (('t', 'd'), ('odom_right', 'i'), ('odom_left', 'i'), ('odom_mow', 'i'),
+                 ('chg_voltage', 'f'), ('bumper', 'B'), ('lift', 'B'), ('stop_button', 'B')),
+    # S-Antworten (Summary mit Strömen)
+    'summary': (('t', 'd'), ('bat_voltage', 'f'), ('chg_voltage', 'f'), ('chg_current', 'f'),
+                ('lift', 'B'), ('bumper', 'B'), ('raining', 'B'), ('motor_overload', 'B'),
+                ('mow_current', 'f'), ('motor_left_current', 'f'), ('motor_right_current', 'f'),
+                ('battery_temp', 'f'), ('stop_button', 'B')),
+    # UBX NAV-PVT bzw. die von RTKGPS.read() gelieferten Werte
+    'gnss': (('t', 'd'), ('lat', 'd'), ('lon', 'd'), ('alt', 'f'), ('fix_type', 'B'),
+             ('carr_soln', 'B'), ('num_sv', 'B'), ('h_acc', 'f'), ('v_acc', 'f'), ('vel_n', 'f'),
+             ('vel_e', 'f'), ('vel_d', 'f'), ('speed', 'f'), ('heading', 'f')),
+    # UBX NAV-RELPOSNED (Basislinie zur RTK-Basis, Meter/Grad)
+    'relpos': (('t', 'd'), ('rel_n', 'f'), ('rel_e', 'f'), ('rel_d', 'f'), ('length', 'f'),
+               ('heading', 'f'), ('acc_n', 'f'), ('acc_e', 'f'), ('acc_d', 'f'), ('flags', 'I')),
+}
+
+def _record_struct(fields) -> struct.Struct:
+    return struct.Struct('<' + ''.join(code for _, code in fields))
+
+def _compress(codec: int, data: bytes) -> bytes:
+    if codec == CODEC_LZ4:
+        return lz4_block.compress(data, store_size=False)
+    if codec == CODEC_ZLIB:
+        return zlib.compress(data, 1)
+    return data
+
+def _decompress(codec: int, data: bytes, raw_length: int) -> bytes:
+    if codec == CODEC_LZ4:
+        if lz4_block is None:
+            raise ValueError("LZ4-komprimierter Chunk, aber das Paket lz4 ist nicht installiert")
+        return lz4_block.decompress(data, uncompressed_size=raw_length)
+    if codec == CODEC_ZLIB:
+        return zlib.decompress(data)
+    return data
+
+class SensorLogWriter:
+    """
+    Schreibt Sensordaten streamweise in Chunks fester Datensatzlänge.
+    Ein Chunk wird geschrieben, sobald er chunk_records Datensätze oder
+    chunk_seconds Sekunden umfasst; das bestimmt die Auflösung des Zeitindex.
+    Verwendung:
+      log = SensorLogWriter('logs/2024-05-01.slg', compression='lz4')
+      log.append('summary', t, 25.1, 0.0, 0.0, 0, 0, 0, 0, 0.4, 0.3, 0.3, 21.0, 0)
+      log.append_pico_line(t, 'AT+S:120,118,0,0.00,,0,0,0')
+      log.close()
+    compression: 'lz4' (Paket lz4, sonst zlib), 'zlib' oder None.
+    """
+    def __init__(self, filename: str, streams: Optional[Dict[str, tuple]] = None,
+                 compression: Optional[str] = 'lz4', chunk_records: int = 4096,
+                 chunk_seconds: float = 60.0):
+        streams = streams if streams is not None else STREAMS
+        for name, fields in streams.items():
+            if not fields or tuple(fields[0]) != ('t', 'd'):
+                raise ValueError(f"Stream {name}: erstes Feld muss ('t', 'd') sein")
+        if compression not in CODECS:
+            raise ValueError(f"Unbekannte Kompression: {compression}")
+        self.codec = CODECS[compression]
+        if self.codec == CODEC_LZ4 and lz4_block is None:
+            print("Sensor-Log: Paket lz4 nicht installiert, komprimiere mit zlib")
+            self.codec = CODEC_ZLIB
+        self.filename = filename
+        self.chunk_records = chunk_records
+        self.chunk_seconds = chunk_seconds
+        self.streams = {name: tuple(tuple(field) for field in fields) for name, fields in streams.items()}
+        self._ids = {name: i for i, name in enumerate(self.streams)}
+        self._structs = {name: _record_struct(fields) for name, fields in self.streams.items()}
+        self._buffers = {name: bytearray() for name in self.streams}
+        self._counts = dict.fromkeys(self.streams, 0)
+        self._first = dict.fromkeys(self.streams)
+        self._last = dict.fromkeys(self.streams)
+        self._index: List[tuple] = []
+        self.records_written = 0
+        self.bytes_raw = 0
+
+        directory = os.path.dirname(filename)
+        if directory:
+            os.makedirs(directory, exist_ok=True)
+        schema = json.dumps([{'name': name, 'fields': [list(field) for field in fields]}
+                             for name, fields in self.streams.items()]).encode('utf-8')
+        self._file = open(filename, 'wb')
+        self._file.write(HEADER.pack(MAGIC, VERSION, 0, time.time(), len(schema)))
+        self._file.write(schema)
+
+    def append(self, stream: str, t: float, *values) -> bool:
+        """Fügt einen Datensatz hinzu (Werte in der Reihenfolge der Felder nach t)."""
+        packer = self._structs.get(stream)
+        if packer is None:
+            print(f"Sensor-Log: Unbekannter Stream '{stream}'")
+            return False
+        last = self._last[stream]
+        if last is not None and t < last:
+            return False  # Zeit muss je Stream monoton sein, sonst ist die Suche nach Zeit nicht möglich
+        try:
+            record = packer.pack(t, *values)
+        except struct.error as e:
+            print(f"Sensor-Log: Datensatz für '{stream}' ungültig ({e})")
+            return False
+        first = self._first[stream]
+        if first is not None and t - first >= self.chunk_seconds:
+            self._write_chunk(stream)
+        if self._first[stream] is None:
+            self._first[stream] = t
+        self._last[stream] = t
+        self._buffers[stream] += record
+        self._counts[stream] += 1
+        if self._counts[stream] >= self.chunk_records:
+            self._write_chunk(stream)
+        return True
+
+    def append_values(self, stream: str, t: float, values: Dict) -> bool:
+        """Wie append(), Werte nach Feldnamen; fehlende Felder werden 0."""
+        fields = self.streams.get(stream)
+        if fields is None:
+            print(f"Sensor-Log: Unbekannter Stream '{stream}'")
+            return False
+        return self.append(stream, t, *(values.get(name) or 0 for name, _ in fields[1:]))
+
+    def append_pico_line(self, t: float, line: str) -> bool:
+        """ASCII-Zeile vom Pico (AT+S:, M, S); andere Zeilen werden übergangen."""
+        parsed = parse_pico_line(line)
+        if parsed is None:
+            return False
+        return self.append(parsed[0], t, *parsed[1])
+
+    def append_gps(self, t: float, gps_data: Dict) -> bool:
+        """Messung im Format von RTKGPS.read() (lat, lon, alt, fix_type, hdop, nsat)."""
+        return self.append_values('gnss', t, {
+            'lat': gps_data.get('lat'), 'lon': gps_data.get('lon'), 'alt': gps_data.get('alt'),
+            'fix_type': gps_data.get('fix_type'), 'num_sv': gps_data.get('nsat'),
+            'h_acc': gps_data.get('hdop'), 'speed': gps_data.get('speed'),
+            'heading': gps_data.get('heading')})
+
+    def _write_chunk(self, stream: str) -> None:
+        count = self._counts[stream]
+        if not count or self._file is None:
+            return
+        raw = bytes(self._buffers[stream])
+        codec = self.codec
+        payload = _compress(codec, raw)
+        if len(payload) >= len(raw):
+            codec, payload = CODEC_NONE, raw
+        offset = self._file.tell()
+        t_first, t_last = self._first[stream], self._last[stream]
+        self._file.write(CHUNK_HEADER.pack(CHUNK_MAGIC, self._ids[stream], codec, count, len(raw),
+                                           len(payload), t_first, t_last))
+        self._file.write(payload)
+        self._index.append((self._ids[stream], codec, count, len(raw), len(payload), offset,
+                            t_first, t_last))
+        self.records_written += count
+        self.bytes_raw += len(raw)
+        self._buffers[stream] = bytearray()
+        self._counts[stream] = 0
+        self._first[stream] = None
+
+    def flush(self) -> None:
+        """Schreibt alle gepufferten Datensätze als Chunks (auch unvollständige)."""
+        if self._file is None:
+            return
+        for stream in self.streams:
+            self._write_chunk(stream)
+        self._file.flush()
+
+    def close(self) -> None:
+        if self._file is None:
+            return
+        self.flush()
+        footer = self._file.tell()
+        for entry in self._index:
+            self._file.write(INDEX_ENTRY.pack(*entry))
+        self._file.write(TRAILER.pack(footer, len(self._index), FOOTER_MAGIC))
+        self._file.close()
+        self._file = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+class SensorLogReader:
+    """
+    Liest ein Sensor-Log mit wahlfreiem Zugriff über den Chunk-Index im Footer.
+    Beim Öffnen werden nur Header und Footer gelesen; ein Zeitfenster kostet
+    eine Binärsuche im Index und das Lesen der überlappenden Chunks.
+    Verwendung:
+      with SensorLogReader('logs/2024-05-01.slg') as log:
+          for r in log.records('summary', t_start, t_end): print(r.t, r.bat_voltage)
+          data = log.array('gnss', t_start, t_end)   # numpy, Spalten data['lat'] usw.
+    """
+    def __init__(self, filename: str):
+        self.filename = filename
+        self._file = open(filename, 'rb')
+        try:
+            self._read_header()
+            self.recovered = False
+            entries = self._read_footer()
+            if entries is None:
+                entries = self._scan_chunks()
+                self.recovered = True
+        except (ValueError, struct.error, UnicodeDecodeError):
+            self._file.close()
+            raise
+        self.index: Dict[str, List[tuple]] = {name: [] for name in self.streams}
+        names = list(self.streams)
+        for stream_id, codec, count, raw, stored, offset, t_first, t_last in entries:
+            if stream_id < len(names):
+                self.index[names[stream_id]].append((t_first, t_last, offset, count, codec, raw, stored))
+        for chunks in self.index.values():
+            chunks.sort()
+        self._ends = {name: [chunk[1] for chunk in chunks] for name, chunks in self.index.items()}
+
+    def _read_header(self) -> None:
+        header = self._file.read(HEADER.size)
+        if len(header) < HEADER.size:
+            raise ValueError(f"Ungültiges Sensor-Log: {self.filename}")
+        magic, version, _, self.created, schema_length = HEADER.unpack(header)
+        if magic != MAGIC or version != VERSION:
+            raise ValueError(f"Ungültiges Sensor-Log: {self.filename}")
+        schema = json.loads(self._file.read(schema_length).decode('utf-8'))
+        self.streams = {entry['name']: tuple(tuple(field) for field in entry['fields']) for entry in schema}
+        self._structs = {name: _record_struct(fields) for name, fields in self.streams.items()}
+        self._types = {name: namedtuple(name, [field for field, _ in fields]) for name, fields in self.streams.items()}
+        self._data_start = HEADER.size + schema_length
+
+    def _read_footer(self) -> Optional[List[tuple]]:
+        size = os.fstat(self._file.fileno()).st_size
+        if size < self._data_start + TRAILER.size:
+            return None
+        self._file.seek(size - TRAILER.size)
+        footer, count, magic = TRAILER.unpack(self._file.read(TRAILER.size))
+        if magic != FOOTER_MAGIC or footer + count * INDEX_ENTRY.size != size - TRAILER.size:
+            return None
+        self._file.seek(footer)
+        return list(INDEX_ENTRY.iter_unpack(self._file.read(count * INDEX_ENTRY.size)))
+
+    def _scan_chunks(self) -> List[tuple]:
+        """Baut den Index aus den Chunk-Headern neu auf (abgeschnittene Chunks werden ignoriert)."""
+        entries = []
+        size = os.fstat(self._file.fileno()).st_size
+        offset = self._data_start
+        while offset + CHUNK_HEADER.size <= size:
+            self._file.seek(offset)
+            magic, stream_id, codec, count, raw, stored, t_first, t_last = \
+                CHUNK_HEADER.unpack(self._file.read(CHUNK_HEADER.size))
+            if magic != CHUNK_MAGIC or offset + CHUNK_HEADER.size + stored > size:
+                break
+            entries.append((stream_id, codec, count, raw, stored, offset, t_first, t_last))
+            offset += CHUNK_HEADER.size + stored
+        return entries
+
+    def close(self) -> None:
+        self._file.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def fields(self, stream: str) -> Tuple[str, ...]:
+        return tuple(name for name, _ in self.streams[stream])
+
+    def record_count(self, stream: str) -> int:
+        return sum(chunk[3] for chunk in self.index.get(stream, ()))
+
+    def time_range(self, stream: Optional[str] = None) -> tuple:
+        """(erste, letzte) Zeit eines Streams oder über alle Streams."""
+        chunks = self.index.get(stream, []) if stream else [c for cs in self.index.values() for c in cs]
+        if not chunks:
+            return (0.0, 0.0)
+        return (min(c[0] for c in chunks), max(c[1] for c in chunks))
+
+    def chunks(self, stream: str, t_start: Optional[float] = None,
+               t_end: Optional[float] = None) -> List[tuple]:
+        """Index-Einträge (t_first, t_last, Offset, Anzahl, Codec, Rohlänge, Länge) im Zeitbereich."""
+        chunks = self.index.get(stream)
+        if chunks is None:
+            raise KeyError(f"Unbekannter Stream '{stream}'")
+        first = bisect.bisect_left(self._ends[stream], t_start) if t_start is not None else 0
+        selected = []
+        for chunk in chunks[first:]:
+            if t_end is not None and chunk[0] > t_end:
+                break
+            selected.append(chunk)
+        return selected
+
+    def _payload(self, chunk: tuple) -> bytes:
+        _, _, offset, _, codec, raw, stored = chunk
+        self._file.seek(offset + CHUNK_HEADER.size)
+        return _decompress(codec, self._file.read(stored), raw)
+
+    def records(self, stream: str, t_start: Optional[float] = None,
+                t_end: Optional[float] = None) -> Iterator[tuple]:
+        """Datensätze im Zeitbereich als namedtuple; springt über den Index direkt zum ersten Chunk."""
+        unpacker = self._structs[stream]
+        make = self._types[stream]._make
+        for chunk in self.chunks(stream, t_start, t_end):
+            for values in unpacker.iter_unpack(self._payload(chunk)):
+                t = values[0]
+                if t_start is not None and t < t_start:
+                    continue
+                if t_end is not None and t > t_end:
+                    return
+                yield make(values)
+
+    def seek(self, stream: str, t: float) -> Optional[tuple]:
+        """Gibt den ersten Datensatz zum Zeitpunkt t oder danach zurück."""
+        return next(self.records(stream, t_start=t), None)
+
+    def dtype(self, stream: str):
+        """numpy-Datentyp eines Datensatzes (gepackt, little-endian)."""
+        import numpy as np
+        return np.dtype([(name, '<' + code) for name, code in self.streams[stream]])
+
+    def memmap(self, stream: str, t_start: Optional[float] = None,
+               t_end: Optional[float] = None) -> list:
+        """
+        Eingeblendete Chunks (numpy.memmap) im Zeitbereich, ohne Kopie.
+        Nur für unkomprimierte Chunks (compression=None); komprimierte liefert array().
+        """
+        import numpy as np
+        dtype = self.dtype(stream)
+        maps = []
+        for chunk in self.chunks(stream, t_start, t_end):
+            if chunk[4] != CODEC_NONE:
+                print(f"Sensor-Log: Chunk bei Offset {chunk[2]} ist komprimiert, nicht einblendbar")
+                return []
+            maps.append(np.memmap(self.filename, dtype=dtype, mode='r',
+                                  offset=chunk[2] + CHUNK_HEADER.size, shape=(chunk[3],)))
+        return maps
+
+    def array(self, stream: str, t_start: Optional[float] = None, t_end: Optional[float] = None):
+        """Alle Datensätze im Zeitbereich als strukturiertes numpy-Array (Spalten über Feldnamen)."""
+        import numpy as np
+        dtype = self.dtype(stream)
+        parts = []
+        for chunk in self.chunks(stream, t_start, t_end):
+            if chunk[4] == CODEC_NONE:
+                part = np.memmap(self.filename, dtype=dtype, mode='r',
+                                 offset=chunk[2] + CHUNK_HEADER.size, shape=(chunk[3],))
+            else:
+                part = np.frombuffer(self._payload(chunk), dtype=dtype)
+            t = part['t']
+            lo = np.searchsorted(t, t_start, 'left') if t_start is not None else 0
+            hi = np.searchsorted(t, t_end, 'right') if t_end is not None else len(part)
+            parts.append(part[lo:hi])
+        if not parts:
+            return np.zeros(0, dtype=dtype)
+        return np.concatenate(parts)
+
+# ---------------------------------------------------------------------------
+# Konverter: Pico-ASCII und UBX
+# ---------------------------------------------------------------------------
+
+def _int(text: str) -> int:
+    return int(text) if text else 0
+
+def _float(text: str) -> float:
+    return float(text) if text else 0.0
+
+def parse_pico_line(line: str) -> Optional[Tuple[str, tuple]]:
+    """
+    (Stream, Werte ohne t) für AT+S:-, M- und S-Zeilen, sonst None.
+    Eine angehängte Prüfsumme der Firmware (,0x..) wird entfernt.
+    """
+    line = line.strip()
+    if line.startswith('AT+S:'):
+        stream, parts = 'odometry', line[5:].split(',')
+    elif line.startswith('M,'):
+        stream, parts = 'odometry', line[2:].split(',')
+    elif line.startswith('S,'):
+        stream, parts = 'summary', line[2:].split(',')
+    else:
+        return None
+    if parts and parts[-1].startswith('0x'):
+        parts = parts[:-1]
+    try:
+        if stream == 'summary':
+            if len(parts) < 11:
+                return None
+            parts += [''] * (12 - len(parts))
+            return stream, (_float(parts[0]), _float(parts[1]), _float(parts[2]), _int(parts[3]),
+                            _int(parts[4]), _int(parts[5]), _int(parts[6]), _float(parts[7]),
+                            _float(parts[8]), _float(parts[9]), _float(parts[10]), _int(parts[11]))
+        if line.startswith('AT+S:'):
+            # AT+S:right,left,mow,chgV,,bumper,lift,stopButton (leeres fünftes Feld)
+            del parts[4:5]
+        if len(parts) < 6:
+            return None
+        parts += [''] * (7 - len(parts))
+        return stream, (_int(parts[0]), _int(parts[1]), _int(parts[2]), _float(parts[3]),
+                        _int(parts[4]), _int(parts[5]), _int(parts[6]))
+    except ValueError:
+        return None
+
+def convert_pico_lines(lines: Iterable[str], writer: SensorLogWriter, rate: float = 20.0,
+                       t0: float = 0.0) -> Dict:
+    """
+    Übernimmt Pico-Zeilen in ein Sensor-Log. Zeilen der Form '<t> <Zeile>'
+    (Zeitstempel in Sekunden vorangestellt) behalten ihre Zeit; Zeilen ohne
+    Zeitstempel werden ab t0 mit der Rate rate (Hz) durchnummeriert.
+    """
+    stats = {'lines': 0, 'records': 0, 'skipped': 0}
+    for raw in lines:
+        line = raw.strip()
+        if not line:
+            continue
+        stats['lines'] += 1
+        stamp, _, rest = line.partition(' ')
+        try:
+            t = float(stamp)
+            line = rest.strip()
+        except ValueError:
+            t = t0 + (stats['lines'] - 1) / rate
+        if writer.append_pico_line(t, line):
+            stats['records'] += 1
+        else:
+            stats['skipped'] += 1
+    return stats
+
+_NAV_PVT = struct.Struct('<IHBBBBBBIiBBBBiiiiIIiiiiiIIHH4xihH')
+_NAV_RELPOSNED = struct.Struct('<BBHIiiiii4xbbbbIIIII4xI')
+
+class UbxScanner:
+    """
+    Zerlegt einen UBX-Bytestrom in Nachrichten (Sync, Länge, Fletcher-Prüfsumme).
+    Daten können stückweise kommen; ein angefangener Rahmen wartet auf den Rest.
+    NMEA-, RTCM- und sonstige Bytes zwischen den Rahmen werden übersprungen.
+    """
+    MAX_LENGTH = 8192
+
+    def __init__(self):
+        self._buffer = bytearray()
+        self.messages = 0
+        self.bad_checksum = 0
+
+    def feed(self, data: bytes) -> Iterator[Tuple[int, int, bytes]]:
+        buffer = self._buffer
+        buffer += data
+        pos = 0
+        while True:
+            start = buffer.find(b'\xb5\x62', pos)
+            if start < 0:
+                pos = max(pos, len(buffer) - 1)
+                break
+            if start + 6 > len(buffer):
+                pos = start
+                break
+            msg_class, msg_id, length = struct.unpack_from('<BBH', buffer, start + 2)
+            if length > self.MAX_LENGTH:
+                pos = start + 2
+                continue
+            end = start + 6 + length + 2
+            if end > len(buffer):
+                pos = start
+                break
+            ck_a = ck_b = 0
+            for byte in buffer[start + 2:end - 2]:
+                ck_a = (ck_a + byte) & 0xFF
+                ck_b = (ck_b + ck_a) & 0xFF
+            if buffer[end - 2] != ck_a or buffer[end - 1] != ck_b:
+                self.bad_checksum += 1
+                pos = start + 2
+                continue
+            self.messages += 1
+            yield msg_class, msg_id, bytes(buffer[start + 6:end - 2])
+            pos = end
+        del buffer[:pos]
+
+def convert_ubx(chunks: Iterable[bytes], writer: SensorLogWriter) -> Dict:
+    """
+    Übernimmt NAV-PVT (Stream gnss) und NAV-RELPOSNED (Stream relpos) aus einem
+    UBX-Bytestrom. Zeit ist die Unix-Zeit aus Datum/Uhrzeit des NAV-PVT; vor
+    dem ersten gültigen Datum die GPS-Wochenzeit iTOW. RELPOSNED erhält die Zeit
+    über iTOW relativ zum letzten NAV-PVT.
+    """
+    scanner = UbxScanner()
+    stats = {'nav_pvt': 0, 'relposned': 0, 'other': 0, 'bad_checksum': 0}
+    week_start = 0.0
+    for data in chunks:
+        for msg_class, msg_id, payload in scanner.feed(data):
+            if (msg_class, msg_id) == (0x01, 0x07) and len(payload) == _NAV_PVT.size:
+                f = _NAV_PVT.unpack(payload)
+                if f[7] & 0x03 == 0x03:
+                    t = calendar.timegm((f[1], f[2], f[3], f[4], f[5], f[6])) + f[9] * 1e-9
+                    week_start = t - f[0] / 1000.0
+                else:
+                    t = week_start + f[0] / 1000.0
+                writer.append('gnss', t, f[15] / 1e7, f[14] / 1e7, f[16] / 1000.0, f[10],
+                              (f[11] >> 6) & 0x03, f[13], f[18] / 1000.0, f[19] / 1000.0,
+                              f[20] / 1000.0, f[21] / 1000.0, f[22] / 1000.0, f[23] / 1000.0,
+                              f[24] / 1e5)
+                stats['nav_pvt'] += 1
+            elif (msg_class, msg_id) == (0x01, 0x3C) and len(payload) == _NAV_RELPOSNED.size:
+                f = _NAV_RELPOSNED.unpack(payload)
+                t = week_start + f[3] / 1000.0
+                # cm plus 0,1-mm-Anteil (HP), Genauigkeiten in 0,1 mm
+                writer.append('relpos', t, f[4] / 100.0 + f[9] / 1e4, f[5] / 100.0 + f[10] / 1e4,
+                              f[6] / 100.0 + f[11] / 1e4, f[7] / 100.0 + f[12] / 1e4, f[8] / 1e5,
+                              f[13] / 1e4, f[14] / 1e4, f[15] / 1e4, f[18])
+                stats['relposned'] += 1
+            else:
+                stats['other'] += 1
+    stats['bad_checksum'] = scanner.bad_checksum
+    return stats
+
+def convert_ubx_file(path: str, writer: SensorLogWriter, block_size: int = 1 << 20) -> Dict:
+    """convert_ubx() für eine Datei (z.B. u-center-Aufzeichnung), blockweise gelesen."""
+    def blocks():
+        with open(path, 'rb') as f:
+            while True:
+                data = f.read(block_size)
+                if not data:
+                    return
+                yield data
+    return convert_ubx(blocks(), writer)
@@ -0,0 +1,26 @@
+"""
+Mähroboter-Simulator für Offline-Tests von Navigation, Ausweichmanövern und Akkuplanung.
+
+- world.py:      Mähzonen, Hindernisse, RTK-Qualitätszonen, Ladestation
+- yard.py:       Synthetische Gärten aus Fläche und Seed für Skalierungstests
+- robot.py:      Differentialantrieb mit Schlupf, Encoder, Bumper, Akku
+- sensors.py:    IMU- und GNSS-Modell
+- protocols.py:  Pico-ASCII-Protokoll, UBX NAV-PVT, NMEA GGA
+- firmware.py:   Unveränderte Pico-Firmware auf virtuellem Board (micropython/)
+- simulator.py:  Headless-Simulator in Simulationszeit
+- pty_bridge.py: Pseudo-Terminals und Start des unveränderten main.py
+- mission.py:    Mähmission in Simulationszeit (Plan, Ausweichen, GPS-Sicherheit)
+- monte_carlo.py: Parallele Parameterstudien über Missionen mit Checkpoint
+- latency_bench.py: Reaktionszeiten von main.py auf Bumper, Lift, Stopp-Taste, Überlast, RTK-Verlust
+- soak.py:       Dauerlauf von main.py mit Überwachung des Speicherwachstums
+
+Aufruf: python -m simulation --help
+"""
+
+from simulation.world import SimWorld
+from simulation.simulator import Simulator
+
+__all__ = [
+    'SimWorld',
+    'Simulator'
+]
@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+"""
+Kommandozeile des Simulators.
+
+Beispiele:
+  python -m simulation main                       # main.py gegen den Simulator (Echtzeit)
+  python -m simulation main --time-scale 10 --world garten.json
+  python -m simulation bridge                     # nur Pseudo-Terminals (/tmp/sunray-sim/pico, gnss)
+  python -m simulation benchmark --duration 600   # Faktor gegenüber Echtzeit, headless
+  python -m simulation world > garten.json        # Standardwelt als Vorlage
+  python -m simulation yard --area 5000 --seed 1 > garten.json   # synthetischer Garten (100 m² bis 2 ha)
+  python -m simulation sweep grid.json --world yard:20000        # Welt direkt aus dem Generator
+  python -m simulation sweep grid.json --output ergebnisse/studie   # Monte-Carlo-Parameterstudie
+  python -m simulation latency --trials 10       # Reaktionszeiten von main.py auf Bumper, Lift, ...
+  python -m simulation soak --hours 8            # Dauerlauf mit Überwachung des Speicherwachstums
+"""
+
+import argparse
+import json
+import sys
+import time
+
+from simulation import latency_bench, soak
+from simulation.yard import generate_yard
+from simulation.monte_carlo import MonteCarloRunner, format_table, load_spec
+from simulation.pty_bridge import PtyBridge, run_main
+from simulation.simulator import Simulator
+from simulation.world import SimWorld
+
+def load_world(source: str):
+    """Welt aus JSON-Datei oder 'yard:<m²>[:<seed>]' aus dem Garten-Generator."""
+    if source.startswith('yard:'):
+        try:
+            values = [float(v) for v in source[5:].split(':')]
+        except ValueError:
+            print(f"Ungültige Generator-Angabe '{source}' (yard:<m²>[:<seed>])")
+            return None
+        return generate_yard(values[0], int(values[1]) if len(values) > 1 else 0)
+    return SimWorld.load(source)
+
+def main():
+    parser = argparse.ArgumentParser(description='Sunray Mähroboter-Simulator')
+    sub = parser.add_subparsers(dest='command', required=True)
+
+    run = sub.add_parser('main', help='main.py unverändert gegen den Simulator starten')
+    run.add_argument('--world', help='Welt als JSON (zones.json-Format mit Simulationseinträgen) '
+                                     'oder yard:<m²>[:<seed>]')
+    run.add_argument('--config', help='Basis-config.json (Standard: config.json im Projekt)')
+    run.add_argument('--workdir', default='sim_run', help='Arbeitsverzeichnis für main.py')
+    run.add_argument('--time-scale', type=float, help='Zeitfaktor (Standard: simulation.time_scale)')
+    run.add_argument('--seed', type=int)
+    run.add_argument('--firmware', help='Pico-Firmware (z.B. ../Pico/1.0/main_old.py) im Emulator ausführen')
+
+    bridge = sub.add_parser('bridge', help='nur die Pseudo-Terminals bereitstellen')
+    bridge.add_argument('--world')
+    bridge.add_argument('--directory', default='/tmp/sunray-sim')
+    bridge.add_argument('--seed', type=int)
+    bridge.add_argument('--firmware', help='Pico-Firmware im Emulator ausführen')
+
+    bench = sub.add_parser('benchmark', help='Geschwindigkeit des Headless-Simulators messen')
+    bench.add_argument('--duration', type=float, default=600.0, help='simulierte Sekunden')
+
+    sub.add_parser('world', help='Standardwelt als JSON ausgeben')
+
+    yard = sub.add_parser('yard', help='synthetischen Garten als JSON ausgeben')
+    yard.add_argument('--area', type=float, default=1000.0, help='Rasenfläche in m² (100 bis 20000)')
+    yard.add_argument('--seed', type=int, default=0)
+    yard.add_argument('--options', help='JSON mit Generator-Optionen (siehe simulation/yard.py)')
+    yard.add_argument('--map', help='zusätzlich map.json (Perimeter, Ausschlusszonen) schreiben')
+
+    sweep = sub.add_parser('sweep', help='Missionen über ein Parametergitter parallel auswerten')
+    sweep.add_argument('grid', help='Gitterdatei (siehe simulation/monte_carlo.py)')
+    sweep.add_argument('--output', default='sweep', help='Präfix für .jsonl (Checkpoint) und .csv')
+    sweep.add_argument('--workers', type=int, help='Prozesse (Standard: alle Kerne)')
+    sweep.add_argument('--world', help='Welt statt der in der Gitterdatei')
+
+    latency = sub.add_parser('latency', help='Reaktionszeiten von main.py auf Sicherheitsereignisse')
+    latency.add_argument('spec', nargs='?', help='Prüfstandsdatei (siehe simulation/latency_bench.py)')
+    latency.add_argument('--world')
+    latency.add_argument('--config', help='Basis-config.json (Standard: config.json im Projekt)')
+    latency.add_argument('--workdir', default='sim_latency', help='Arbeitsverzeichnis für main.py')
+    latency.add_argument('--trials', type=int, help='Versuche je Ereignis')
+    latency.add_argument('--events', help='Auswahl, kommagetrennt (z.B. bumper,lift)')
+    latency.add_argument('--report', help='Bericht zusätzlich als JSON schreiben')
+    latency.add_argument('--seed', type=int)
+
+    soak_run = sub.add_parser('soak', help='Dauerlauf von main.py mit Überwachung des Speicherwachstums')
+    soak_run.add_argument('spec', nargs='?', help='Dauerlaufdatei (siehe DEFAULT_SPEC in simulation/soak.py)')
+    soak_run.add_argument('--world')
+    soak_run.add_argument('--config', help='Basis-config.json (Standard: config.json im Projekt)')
+    soak_run.add_argument('--workdir', default='sim_soak', help='Arbeitsverzeichnis für main.py')
+    soak_run.add_argument('--hours', type=float, help='Simulationszeit in Stunden')
+    soak_run.add_argument('--time-scale', type=float, help='Zeitfaktor')
+    soak_run.add_argument('--report', help='Bericht zusätzlich als JSON schreiben')
+    soak_run.add_argument('--seed', type=int)
+
+    args = parser.parse_args()
+    world = None
+    if getattr(args, 'world', None):
+        world = load_world(args.world)
+        if world is None:
+            return 1
+
+    if args.command == 'main':
+        run_main(world, args.config, args.workdir, args.time_scale, args.seed, args.firmware)
+    elif args.command == 'bridge':
+        pico = {'firmware': args.firmware} if args.firmware else {}
+        link = PtyBridge(Simulator(world, {'pico': pico}, seed=args.seed), args.directory)
+        link.start()
+        try:
+            while True:
+                time.sleep(1.0)
+        except KeyboardInterrupt:
+            pass
+        finally:
+            link.stop()
+    elif args.command == 'benchmark':
+        result = Simulator.benchmark(args.duration)
+        print(f"{result['sim_time']:.0f} s simuliert in {result['wall_time']:.2f} s: "
+              f"{result['speedup']:.0f}x Echtzeit, {result['steps_per_second']:.0f} Schritte/s")
+    elif args.command == 'world':
+        json.dump(SimWorld.default().to_dict(), sys.stdout, indent=2)
+        print()
+    elif args.command == 'yard':
+        options = None
+        if args.options:
+            try:
+                options = json.loads(args.options)
+            except ValueError as e:
+                print(f"Ungültige Optionen: {e}", file=sys.stderr)
+                return 1
+        world = generate_yard(args.area, args.seed, options)
+        json.dump(world.to_dict(), sys.stdout, indent=2)
+        print()
+        print(f"{len(world.mow_zones)} Mähzonen, {len(world.obstacles)} Hindernisse, "
+              f"{len(world.rtk_zones)} RTK-Zonen, {world.mowable_area():.0f} m² mähbar", file=sys.stderr)
+        if args.map:
+            with open(args.map, 'w') as f:
+                json.dump(world.map_file(), f)
+    elif args.command == 'sweep':
+        spec = load_spec(args.grid)
+        if spec is None:
+            return 1
+        if world is None and spec.get('world'):
+            world = load_world(spec['world'])
+            if world is None:
+                return 1
+        runner = MonteCarloRunner(world or SimWorld.default(), spec, args.output, args.workers)
+        try:
+            rows = runner.run()
+        except KeyboardInterrupt:
+            return 130
+        print(format_table(rows))
+        print(f"Ergebnisse: {runner.csv_path}, Einzelläufe: {runner.checkpoint_path}")
+        if runner.failed:
+            return 1
+    elif args.command == 'latency':
+        spec = {}
+        if args.spec:
+            spec = latency_bench.load_spec(args.spec)
+            if spec is None:
+                return 1
+        if args.trials:
+            spec['trials'] = args.trials
+        if args.events:
+            events = latency_bench.merge_spec(spec)['events']
+            spec['events'] = {name: events.get(name, {}) for name in args.events.split(',')}
+        report = latency_bench.run(world, spec, args.config, args.workdir, args.seed)
+        print(latency_bench.format_report(report))
+        if args.report:
+            with open(args.report, 'w') as f:
+                json.dump(report, f, indent=2)
+        if not report['passed']:
+            return 1
+    elif args.command == 'soak':
+        spec = {}
+        if args.spec:
+            spec = soak.load_spec(args.spec)
+            if spec is None:
+                return 1
+        if args.hours:
+            spec['hours'] = args.hours
+        if args.time_scale:
+            spec['time_scale'] = args.time_scale
+        report = soak.run(world, spec, args.config, args.workdir, args.seed)
+        print(soak.format_report(report))
+        if args.report:
+            with open(args.report, 'w') as f:
+                json.dump(report, f, indent=2)
+        if not report['passed']:
+            return 1
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,377 @@
+"""
+Pico-Firmware unter CPython: die unveränderte Firmware-Datei (sunray/Pico/1.0/)
+läuft auf einem virtuellen Board statt auf dem RP2040.
+
+Firmware führt die Datei in einem eigenen Thread aus. Ein Import-Hook liefert
+machine, utime/time, _thread, micropython und die Treiber aus lib/ als Stand-ins
+(simulation/micropython/), weitere Module zuerst aus dem Firmware-Verzeichnis
+(wie auf dem Pico-Dateisystem), dann die in MicroPython vorhandenen Module der
+Standardbibliothek. print() geht auf die USB-Konsole (Firmware.console).
+
+Zeit: run_until(t) lässt die Firmware bis zur Boardzeit t laufen (siehe
+micropython/board.py). Der Watchdog wirkt in Boardzeit: wird WDT.feed()
+länger als das Timeout nicht aufgerufen (Absturz, Endlosschleife ohne feed),
+startet die Firmware neu. Eine Endlosschleife ohne Warte-Stelle erkennt
+run_until daran, dass hang_timeout Sekunden Wanduhrzeit kein Fortschritt kommt;
+der Thread wird dann über eine asynchrone Ausnahme beendet (CPython), und der
+Watchdog löst wie auf dem Pico nach seinem Timeout in Boardzeit aus.
+
+FirmwarePico setzt das an die Stelle von PicoProtocol im Simulator
+(simulation.pico.firmware in config.json oder --firmware): Pins, PWM, Encoder
+und INA226 sind nach der Belegung des Landrumower-Boards (PINS) mit dem
+MowerModel verbunden, Befehle gehen über UART0, Antworten kommen von dort.
+
+Zu beachten beim Betrieb gegen main.py: Die Firmware prüft die Prüfsumme jeder
+Befehlszeile und kennt nur AT+M/AT+S/AT+V/AT+R/AT+Y; HardwareManager sendet
+AT+MOTOR ohne Prüfsumme, das verwirft die Firmware. Die Firmware schickt keine
+periodischen AT+S:-Zeilen, nur Antworten (M,... / S,...).
+"""
+
+import builtins
+import ctypes
+import os
+import threading
+import time
+import traceback
+import types
+from collections import deque
+from typing import Dict, List, Optional
+
+from simulation.micropython import Board, FirmwareReset, FirmwareStopped, build_modules
+from simulation.micropython.devices import INA226Device, LcdDevice
+from simulation.protocols import pico_crc
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+FIRMWARE_DIR = os.path.join(os.path.dirname(ROOT), 'Pico', '1.0')
+DEFAULT_FIRMWARE = os.path.join(FIRMWARE_DIR, 'main.py')
+
+# In MicroPython vorhandene Module der Standardbibliothek (auch mit Präfix u)
+HOST_MODULES = {'sys', 'select', 'math', 'cmath', 'struct', 'json', 'errno', 'random', 're', 'array',
+                'collections', 'io', 'binascii', 'hashlib', 'heapq', 'os', 'asyncio'}
+
+class Firmware:
+    """Eine Firmware-Datei auf einem virtuellen Board."""
+    def __init__(self, path: str, board: Optional[Board] = None, echo: bool = False,
+                 hang_timeout: float = 1.0, epoch: Optional[float] = None):
+        self.path = os.path.abspath(path)
+        self.directory = os.path.dirname(self.path)
+        self.board = board or Board()
+        self.echo = echo
+        self.hang_timeout = hang_timeout
+        self.epoch = epoch
+        self.console: deque = deque(maxlen=1000)
+        self.errors: List[str] = []
+        self.resets = {'watchdog': 0, 'reset': 0}
+        self.boots = 0
+        self.running = False
+        self.halted = False
+        self._code = None
+        self._threads: List[threading.Thread] = []
+        self._partial = ''
+        self._reset_requested = False
+        self.modules: Dict[str, types.ModuleType] = {}
+        self._missing = set()
+
+    # -- Start, Stopp, Reset ------------------------------------------------
+
+    def start(self) -> bool:
+        try:
+            with open(self.path, 'r') as f:
+                self._code = compile(f.read(), self.path, 'exec')
+        except (OSError, SyntaxError) as e:
+            print(f"Firmware: {self.path} nicht ladbar: {e}")
+            return False
+        self.running = True
+        self._boot()
+        return True
+
+    def stop(self) -> None:
+        self.running = False
+        self._kill_threads()
+
+    def _boot(self) -> None:
+        board = self.board
+        board.reset()
+        self.modules = build_modules(board, self._spawn, self.epoch)
+        self._missing = set()
+        self.builtins = dict(vars(builtins))
+        self.builtins['__import__'] = self._import
+        self.builtins['print'] = self._print
+        namespace = {'__name__': '__main__', '__file__': self.path, '__builtins__': self.builtins}
+        self.halted = False
+        self._reset_requested = False
+        self.boots += 1
+        started = threading.Event()
+        thread = threading.Thread(target=self._main, args=(namespace, started), name='pico-core0', daemon=True)
+        self._threads = [thread]
+        thread.start()
+        started.wait()
+        # Bis zur ersten Warte-Stelle laufen lassen (Initialisierung der Firmware)
+        self.run_until(board.us)
+
+    def _main(self, namespace: Dict, started: threading.Event) -> None:
+        board = self.board
+        with board.cond:
+            board.main_thread = threading.get_ident()
+        started.set()
+        try:
+            exec(self._code, namespace)
+        except FirmwareStopped:
+            pass
+        except FirmwareReset:
+            self._reset_requested = True
+        except SystemExit:
+            pass
+        except BaseException:
+            self._crash('core0')
+        finally:
+            with board.cond:
+                if board.main_thread == threading.get_ident():
+                    board.main_thread = None
+                self.halted = True
+                board.cond.notify_all()
+
+    def _spawn(self, function, args, kwargs) -> int:
+        """_thread.start_new_thread: Thread des Hosts, beim Stopp mit beendet."""
+        def run():
+            try:
+                function(*args, **kwargs)
+            except (FirmwareStopped, SystemExit):
+                pass
+            except BaseException:
+                self._crash('core1')
+
+        thread = threading.Thread(target=run, name='pico-core1', daemon=True)
+        self._threads.append(thread)
+        thread.start()
+        return thread.ident
+
+    def _crash(self, where: str) -> None:
+        lines = traceback.format_exc().rstrip().splitlines()
+        self.errors.append(f'{where}: {lines[-1]}')
+        for line in lines:
+            self._console_line(line)
+        print(f"Firmware: Ausnahme in {where} bei t={self.board.us / 1e6:.3f} s: {lines[-1]}")
+
+    def _kill_threads(self) -> None:
+        board = self.board
+        with board.cond:
+            board.stopping = True
+            board.cond.notify_all()
+        for thread in self._threads:
+            if thread is threading.current_thread():
+                continue
+            thread.join(timeout=0.2)
+            if thread.is_alive():
+                # Schleife ohne Warte-Stelle: Ausnahme asynchron im Thread auslösen
+                ctypes.pythonapi.PyThreadState_SetAsyncExc(ctypes.c_ulong(thread.ident),
+                                                           ctypes.py_object(FirmwareStopped))
+                thread.join(timeout=1.0)
+            if thread.is_alive():
+                print(f"Firmware: Thread {thread.name} lässt sich nicht beenden")
+        self._threads = []
+
+    def reboot(self, reason: str) -> None:
+        self.resets[reason] = self.resets.get(reason, 0) + 1
+        self._console_line(f'--- Reset ({reason}) ---')
+        print(f"Firmware: Reset ({reason}) bei t={self.board.us / 1e6:.3f} s")
+        self._kill_threads()
+        self._boot()
+
+    # -- Zeit ---------------------------------------------------------------
+
+    def run_until(self, t_us: int) -> None:
+        """Lässt die Firmware bis Boardzeit t_us laufen; danach blockiert sie oder ist beendet."""
+        if not self.running:
+            return
+        board = self.board
+        board.release(t_us)
+        last = board.yields
+        since = time.perf_counter()
+        while not board.wait_caught_up(0.05):
+            if board.yields != last:
+                last = board.yields
+                since = time.perf_counter()
+            elif time.perf_counter() - since > self.hang_timeout:
+                self._hang()
+                break
+        with board.cond:
+            if board.main_thread is None and board.us < t_us:
+                # Ohne laufende Firmware vergeht die Zeit trotzdem (Watchdog)
+                board.us = t_us
+                board.cond.notify_all()
+        if self._reset_requested:
+            self.reboot('reset')
+        elif board.wdt_timeout_us and board.us - board.last_feed_us > board.wdt_timeout_us:
+            self.reboot('watchdog')
+
+    def _hang(self) -> None:
+        """Endlosschleife ohne Warte-Stelle: Kern steht, ab jetzt läuft nur noch der Watchdog."""
+        print(f"Firmware: Kein Fortschritt seit {self.hang_timeout:.1f} s bei t={self.board.us / 1e6:.3f} s, "
+              f"Firmware hängt")
+        self.errors.append('hang')
+        self._kill_threads()
+        with self.board.cond:
+            self.board.main_thread = None
+        self.halted = True
+
+    # -- Import und Konsole -------------------------------------------------
+
+    def _import(self, name, globals=None, locals=None, fromlist=(), level=0):
+        module = self.modules.get(name)
+        if module is None or name.startswith('lib.'):
+            module = self._local_module(name) or module
+        if module is None:
+            host = name[1:] if name.startswith('u') and name[1:] in HOST_MODULES else name
+            if host.split('.')[0] not in HOST_MODULES:
+                raise ImportError(f"no module named '{name}'")
+            return builtins.__import__(host, globals, locals, fromlist, level)
+        if fromlist or '.' not in name:
+            return module
+        return self.modules[name.split('.')[0]]
+
+    def _local_module(self, name: str) -> Optional[types.ModuleType]:
+        """Modul aus dem Firmware-Verzeichnis (einmal geladen, wie auf dem Pico-Dateisystem)."""
+        if name in self._missing:
+            return None
+        path = os.path.join(self.directory, *name.split('.')) + '.py'
+        if not os.path.isfile(path):
+            self._missing.add(name)
+            return None
+        module = types.ModuleType(name)
+        module.__file__ = path
+        module.__builtins__ = self.builtins
+        self.modules[name] = module
+        with open(path, 'r') as f:
+            exec(compile(f.read(), path, 'exec'), module.__dict__)
+        return module
+
+    def _print(self, *args, sep=' ', end='\n', file=None, flush=False):
+        self._partial += sep.join(str(arg) for arg in args) + end
+        if '\n' in self._partial:
+            *lines, self._partial = self._partial.split('\n')
+            for line in lines:
+                self._console_line(line.rstrip('\r'))
+
+    def _console_line(self, line: str) -> None:
+        self.console.append(line)
+        if self.echo:
+            print(f'[Pico] {line}')
+
+class FirmwarePico:
+    """Firmware als Pico des Simulators: Board-Belegung des Landrumower mit dem MowerModel verbunden."""
+    # Belegung aus Pico/1.0/main.py; 'forward' ist der Pegel des Richtungs-Pins bei Vorwärtsfahrt
+    PINS = {
+        'left': {'pwm': 7, 'dir': 8, 'forward': 1, 'encoder': 6},
+        'right': {'pwm': 3, 'dir': 4, 'forward': 0, 'encoder': 2},
+        'mow': {'pwm': 11, 'encoder': 10},
+        'bumper': (18, 19),
+        'lift': 20,
+        'stop_button': 21,
+        'battery_switch': 22,
+        'rain': 28,
+    }
+    INA = {'battery': 64, 'mow': 65, 'left': 68, 'right': 69}
+    LCD = 39
+
+    def __init__(self, mower, firmware: str, config: Optional[Dict] = None):
+        config = config or {}
+        self.mower = mower
+        self.board = Board(loop_us=int(config.get('loop_us', 1000)), start_us=int(config.get('start_us', 0)))
+        self.start_us = self.board.us
+        # Der Firmware-Faktor CURRENTFACTOR = 10 gehört zu 10-mOhm-Shunts
+        shunt = config.get('shunt_ohm', 0.01)
+        self.ina = {name: INA226Device(shunt) for name in self.INA}
+        for name, address in self.INA.items():
+            self.board.attach_i2c(0, address, self.ina[name])
+        self.lcd = LcdDevice(2, 16)
+        self.board.attach_i2c(1, self.LCD, self.lcd)
+        self.firmware = Firmware(firmware, self.board, echo=config.get('echo', False),
+                                 hang_timeout=config.get('hang_timeout', 1.0))
+        self.commands = 0
+        self._ticks = list(mower.odometry())
+        self._rx = ''
+        self._switched_on = False
+        self._update_inputs(self.board.us, self.board.us)
+        self.powered = self.firmware.start()
+
+    @property
+    def console(self) -> List[str]:
+        return list(self.firmware.console)
+
+    def handle(self, line: str, now: float) -> List[str]:
+        """Befehlszeile an UART0; die Antwort kommt asynchron über read_lines()."""
+        line = line.strip()
+        if not line:
+            return []
+        self.commands += 1
+        self.board.uarts[0].receive((line + '\n').encode('ascii', errors='ignore'))
+        return []
+
+    def check_timeout(self, now: float) -> None:
+        """Lässt die Firmware bis zur Simulationszeit now laufen und überträgt die Motorausgänge."""
+        if not self.powered:
+            self.mower.set_pwm(0, 0, 0)
+            return
+        t_us = self.start_us + int(now * 1e6)
+        self._update_inputs(self.board.us, t_us)
+        self.firmware.run_until(t_us)
+        switch = self.board.pin(self.PINS['battery_switch'])
+        if switch.mode == 1 and switch.level:
+            self._switched_on = True
+        elif self._switched_on and switch.mode == 1 and not switch.level:
+            print(f"Firmware: Batterieschalter aus bei t={now:.2f} s, Pico ohne Versorgung")
+            self.firmware.stop()
+            self.powered = False
+            self.mower.set_pwm(0, 0, 0)
+            return
+        self.mower.set_pwm(self._motor('left'), self._motor('right'), self._motor('mow'))
+
+    def read_lines(self) -> List[str]:
+        data = self.board.uarts[0].take_tx()
+        if not data:
+            return []
+        self._rx += data.decode('ascii', errors='ignore')
+        *lines, self._rx = self._rx.split('\n')
+        return [line.strip() for line in lines if line.strip()]
+
+    def stop(self) -> None:
+        self.firmware.stop()
+
+    def _motor(self, name: str) -> int:
+        spec = self.PINS[name]
+        state = self.board.pwms.get(spec['pwm'])
+        pwm = int(round(state.duty * 255 / 65535)) if state else 0
+        if 'dir' in spec and self.board.pin(spec['dir']).level != spec['forward']:
+            pwm = -pwm
+        return pwm
+
+    def _update_inputs(self, start_us: int, end_us: int) -> None:
+        """Schalter, ADC und INA226 aus dem Modell; neue Encoder-Impulse gleichmäßig über das Intervall."""
+        m = self.mower
+        board = self.board
+        pins = self.PINS
+        board.drive(pins['bumper'][0], 1 if m.bumper_mask & 1 else 0)
+        board.drive(pins['bumper'][1], 1 if m.bumper_mask & 2 else 0)
+        board.drive(pins['lift'], 1 if m.lift else 0)
+        # Taster gegen Masse mit Pull-up: gedrückt = 0
+        board.drive(pins['stop_button'], 0 if m.stop_button else None)
+        board.set_adc(pins['rain'], 10000 if m.raining else 65535)
+
+        load = m.params['idle_current'] + m.current_left + m.current_right + m.current_mow
+        self.ina['battery'].set(m.bat_voltage, load - m.charger_current)
+        self.ina['left'].set(m.bat_voltage, m.current_left)
+        self.ina['right'].set(m.bat_voltage, m.current_right)
+        self.ina['mow'].set(m.bat_voltage, m.current_mow)
+
+        ticks = m.odometry()
+        span = max(1, end_us - start_us)
+        for index, name in enumerate(('left', 'right', 'mow')):
+            count = abs(ticks[index] - self._ticks[index])
+            for k in range(count):
+                board.pulse(pins[name]['encoder'], start_us + span * (k + 1) // count)
+        self._ticks = list(ticks)
+
+def command(line: str) -> str:
+    """Befehlszeile mit Prüfsumme, wie sie die Firmware erwartet (cmdAnswer-Format)."""
+    return f'{line},{pico_crc(line)}'
@@ -0,0 +1,414 @@
+"""
+Reaktionszeiten von main.py auf Sicherheitsereignisse (End-to-End über Pseudo-Terminals).
+
+Der Simulator (simulation/pty_bridge.py) spielt Pico und GNSS-Empfänger, main.py
+läuft unverändert im selben Prozess. Sobald der Roboter mäht und fährt, schaltet
+der Prüfstand nacheinander Fehlerfälle ein (Simulator.inject): Bumper, Lift,
+Stopp-Taste, Motorüberlast, RTK-Verlust. Gemessen wird ab dem Zeitpunkt, an dem
+das Ereignis auf der Leitung steht (erste AT+S:-/S,-Zeile mit gesetztem Feld bzw.
+erster GNSS-Rahmen ohne RTK), bis
+  drive_stop: erster Befehl an den Pico mit PWM 0 für beide Antriebe (AT+MOTOR,0,0,..,
+              AT+M,0,0,..) oder AT+STOP,
+  operation:  erster veröffentlichter Snapshot mit einer anderen Operation.
+Zusätzlich wird die Verzögerung auf der Pico-Seite (Einschalten bis Leitung, durch
+die Ausgaberate bestimmt) ausgewiesen. Alle Zeitstempel stammen aus derselben
+monotonen Uhr; die Bridge liest alle poll_interval Sekunden, das begrenzt die
+Auflösung (Standard 1 ms).
+
+Prüfstandsdatei (JSON, alles optional):
+  {
+    "trials": 20,                       (Versuche je Ereignis)
+    "budget_percentile": 0.99,          (mit dem Budget verglichenes Perzentil)
+    "reaction_timeout": 3.0,            (s, danach gilt die Reaktion als ausgeblieben)
+    "events": {"bumper": {"hold": 0.5, "reactions": ["drive_stop", "operation"],
+                          "budget": {"drive_stop": 0.3}}, ...}
+  }
+Ein Ereignis ohne Reaktion innerhalb von reaction_timeout oder ein Perzentil über
+dem Budget lässt den Prüfstand fehlschlagen (python -m simulation latency: Exit-Code 1).
+"""
+
+import _thread
+import copy
+import json
+import random
+import threading
+from typing import Dict, List, Optional
+
+from simulation.monte_carlo import percentile
+from simulation.pty_bridge import PtyBridge, prepare_main, exec_main, _real_monotonic, _real_sleep
+from simulation.world import SimWorld
+
+# Reihenfolge der Ausführung: die Stopp-Taste beendet den Mähvorgang, deshalb zuletzt
+DEFAULT_SPEC = {
+    'trials': 20,
+    'budget_percentile': 0.99,
+    'startup_timeout': 120.0,    # s bis zum ersten Mähbetrieb
+    'ready_timeout': 30.0,       # s bis der Roboter nach einem Versuch wieder mäht und fährt
+    'reaction_timeout': 3.0,
+    'gap': [0.5, 1.5],           # s zufällige Pause vor jedem Versuch (nicht im Takt der Regelschleife)
+    'ready_operation': 'mow',
+    'events': {
+        'bumper': {'value': 3, 'hold': 0.5, 'reactions': ['drive_stop', 'operation'],
+                   'budget': {'drive_stop': 0.3}},
+        'lift': {'hold': 1.0, 'reactions': ['drive_stop'], 'budget': {'drive_stop': 0.3}},
+        # Überlast meldet nur die Summary-Zeile, die main.py einmal je Sekunde anfordert
+        'overload': {'hold': 3.0, 'reactions': ['drive_stop'], 'budget': {'drive_stop': 1.5}},
+        'rtk_loss': {'value': '3d', 'hold': 5.0, 'reactions': ['drive_stop', 'operation'],
+                     'budget': {'operation': 1.0}},
+        'stop_button': {'hold': 0.3, 'reactions': ['drive_stop'], 'budget': {'drive_stop': 0.5}},
+    },
+}
+
+# Feld der AT+S:-Zeile (odom_right,odom_left,odom_mow,chg_voltage,,bumper,lift,stopButton)
+_ODOMETRY_FIELDS = {'bumper': 5, 'lift': 6, 'stop_button': 7}
+# Feld der Summary-Zeile S,bat,chgV,chgI,lift,bumper,rain,overload,...,stop
+_SUMMARY_FIELDS = {'lift': 4, 'bumper': 5, 'overload': 7, 'stop_button': 12}
+
+def merge_spec(spec: Optional[Dict]) -> Dict:
+    """Prüfstandsdatei über DEFAULT_SPEC; Ereignisse werden je Eintrag ergänzt."""
+    merged = copy.deepcopy(DEFAULT_SPEC)
+    spec = spec or {}
+    for key, value in spec.items():
+        if key != 'events':
+            merged[key] = value
+    if 'events' in spec:
+        events = {}
+        for name, options in spec['events'].items():
+            event = copy.deepcopy(DEFAULT_SPEC['events'].get(name, {'reactions': ['drive_stop']}))
+            event.update(options or {})
+            events[name] = event
+        merged['events'] = events
+    return merged
+
+def _field_set(line: str, index: int) -> bool:
+    parts = line.split(',')
+    if len(parts) <= index:
+        return False
+    try:
+        return int(parts[index]) != 0
+    except ValueError:
+        return False
+
+def shows_event(event: str, line: str) -> bool:
+    """Trägt eine Pico-Ausgabezeile das Ereignis?"""
+    if line.startswith('AT+S:'):
+        index = _ODOMETRY_FIELDS.get(event)
+        return index is not None and _field_set(line[5:], index)
+    if line.startswith('S,'):
+        index = _SUMMARY_FIELDS.get(event)
+        return index is not None and _field_set(line, index)
+    return False
+
+def drive_pwm(line: str) -> Optional[tuple]:
+    """(links, rechts) eines Motorbefehls, (0, 0) für AT+STOP, sonst None."""
+    parts = line.strip().split(',')
+    try:
+        if parts[0] == 'AT+MOTOR' and len(parts) >= 3:
+            return int(parts[1]), int(parts[2])
+        if parts[0] == 'AT+M' and len(parts) >= 3:
+            return int(parts[2]), int(parts[1])
+    except ValueError:
+        return None
+    if parts[0] == 'AT+STOP':
+        return 0, 0
+    return None
+
+class Trial:
+    """Ein Versuch: Zeitpunkte von Einschalten, Leitung und Reaktionen."""
+    def __init__(self, event: str, reactions: List[str], injected: float, operation: Optional[str]):
+        self.event = event
+        self.reactions = reactions
+        self.injected = injected
+        self.operation_before = operation
+        self.visible: Optional[float] = None
+        self.seen: Dict[str, float] = {}
+
+    def complete(self) -> bool:
+        return self.visible is not None and all(r in self.seen for r in self.reactions)
+
+    def result(self) -> Dict:
+        latencies = {r: self.seen[r] - self.visible for r in self.seen} if self.visible is not None else {}
+        return {
+            'event': self.event,
+            'signal': self.visible - self.injected if self.visible is not None else None,
+            'latency': latencies,
+            'missed': [r for r in self.reactions if r not in self.seen],
+            'operation_before': self.operation_before,
+        }
+
+class LatencyRecorder:
+    """
+    Ordnet Leitungsverkehr und Operationswechsel dem laufenden Versuch zu.
+    Wird aus Bridge-, Beobachter- und Prüfstands-Thread aufgerufen.
+    """
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.operation: Optional[str] = None
+        self.driving = False
+        self.trial: Optional[Trial] = None
+        self.results: List[Dict] = []
+        self.skipped: Dict[str, int] = {}
+
+    # -- Quellen -------------------------------------------------------------
+
+    def tap(self, kind: str, data, t: float) -> None:
+        """PtyBridge-Mithörer."""
+        if kind == 'command':
+            self.on_commands(data, t)
+        elif kind == 'pico':
+            self.on_pico_lines(data, t)
+        elif kind == 'gnss':
+            self.on_gnss(t)
+
+    def on_commands(self, lines: List[str], t: float) -> None:
+        with self.lock:
+            for line in lines:
+                pwm = drive_pwm(line)
+                if pwm is None:
+                    continue
+                self.driving = pwm != (0, 0)
+                trial = self.trial
+                if (not self.driving and trial and trial.visible is not None
+                        and 'drive_stop' not in trial.seen):
+                    trial.seen['drive_stop'] = t
+
+    def on_pico_lines(self, lines: List[str], t: float) -> None:
+        with self.lock:
+            trial = self.trial
+            if trial and trial.visible is None and any(shows_event(trial.event, line) for line in lines):
+                trial.visible = t
+
+    def on_gnss(self, t: float) -> None:
+        with self.lock:
+            trial = self.trial
+            # Die Bridge leert den GNSS-Puffer in jedem Durchlauf: alles nach dem
+            # Einschalten ist bereits mit erzwungener Fix-Qualität erzeugt
+            if trial and trial.event == 'rtk_loss' and trial.visible is None:
+                trial.visible = t
+
+    def on_operation(self, name: Optional[str], t: float) -> None:
+        with self.lock:
+            self.operation = name
+            trial = self.trial
+            if (trial and trial.visible is not None and 'operation' not in trial.seen
+                    and name != trial.operation_before):
+                trial.seen['operation'] = t
+
+    # -- Versuche ------------------------------------------------------------
+
+    def ready(self, operation: str) -> bool:
+        with self.lock:
+            return self.operation == operation and self.driving
+
+    def begin(self, event: str, reactions: List[str], t: float) -> Trial:
+        with self.lock:
+            self.trial = Trial(event, reactions, t, self.operation)
+            return self.trial
+
+    def complete(self) -> bool:
+        with self.lock:
+            return self.trial is not None and self.trial.complete()
+
+    def end(self) -> Optional[Dict]:
+        with self.lock:
+            trial, self.trial = self.trial, None
+        if trial is None:
+            return None
+        result = trial.result()
+        self.results.append(result)
+        return result
+
+    def skip(self, event: str) -> None:
+        with self.lock:
+            self.skipped[event] = self.skipped.get(event, 0) + 1
+
+def summarize(results: List[Dict], spec: Dict, skipped: Optional[Dict[str, int]] = None) -> Dict:
+    """Perzentile je Ereignis und Reaktion, Budgetverletzungen."""
+    skipped = skipped or {}
+    q = spec.get('budget_percentile', 0.99)
+    report = {'events': {}, 'violations': []}
+    for name, options in spec['events'].items():
+        trials = [r for r in results if r['event'] == name]
+        entry = {'trials': len(trials), 'skipped': skipped.get(name, 0), 'reactions': {}}
+        signal = [r['signal'] for r in trials if r['signal'] is not None]
+        if signal:
+            entry['signal_p50'] = percentile(signal, 0.5)
+        budgets = options.get('budget', {})
+        for reaction in options.get('reactions', []):
+            values = [r['latency'][reaction] for r in trials if reaction in r['latency']]
+            missed = sum(1 for r in trials if reaction in r['missed'])
+            stats = {'n': len(values), 'missed': missed}
+            if values:
+                stats.update({'p50': percentile(values, 0.5), 'p90': percentile(values, 0.9),
+                              'p99': percentile(values, 0.99), 'max': max(values)})
+            budget = budgets.get(reaction)
+            if budget is not None:
+                stats['budget'] = budget
+                if missed:
+                    report['violations'].append(
+                        f"{name}/{reaction}: keine Reaktion in {missed} von {len(trials)} Versuchen")
+                if values and percentile(values, q) > budget:
+                    report['violations'].append(
+                        f"{name}/{reaction}: P{q * 100:g} {percentile(values, q) * 1000:.0f} ms "
+                        f"> Budget {budget * 1000:.0f} ms")
+            entry['reactions'][reaction] = stats
+        if not trials and budgets:
+            report['violations'].append(f"{name}: kein Versuch durchgeführt")
+        report['events'][name] = entry
+    report['passed'] = not report['violations']
+    return report
+
+def format_report(report: Dict) -> str:
+    """Textausgabe der Perzentile in Millisekunden."""
+    def ms(value):
+        return f'{value * 1000:.0f}' if value is not None else '-'
+    lines = [f"{'Ereignis':<12} {'Reaktion':<11} {'n':>3} {'fehlt':>5} {'P50':>6} {'P90':>6} "
+             f"{'P99':>6} {'max':>6} {'Budget':>7}  (ms)"]
+    for name, entry in report['events'].items():
+        if not entry['reactions']:
+            lines.append(f"{name:<12} {'-':<11} {entry['trials']:>3}")
+        for reaction, stats in entry['reactions'].items():
+            lines.append(f"{name:<12} {reaction:<11} {stats['n']:>3} {stats['missed']:>5} "
+                         f"{ms(stats.get('p50')):>6} {ms(stats.get('p90')):>6} {ms(stats.get('p99')):>6} "
+                         f"{ms(stats.get('max')):>6} {ms(stats.get('budget')):>7}")
+        extra = []
+        if 'signal_p50' in entry:
+            extra.append(f"Pico bis Leitung P50 {ms(entry['signal_p50'])} ms")
+        if entry['skipped']:
+            extra.append(f"{entry['skipped']} Versuche übersprungen (Roboter nicht bereit)")
+        if extra:
+            lines.append(f"{'':<12} " + ', '.join(extra))
+    for violation in report['violations']:
+        lines.append(f"VERLETZT: {violation}")
+    return '\n'.join(lines)
+
+class LatencyBench:
+    """Prüfstand: Versuchsablauf gegen eine laufende PtyBridge, Auswertung."""
+    def __init__(self, spec: Optional[Dict] = None, seed: Optional[int] = None, snapshots=None):
+        self.spec = merge_spec(spec)
+        self.rng = random.Random(seed)
+        self.recorder = LatencyRecorder()
+        self.snapshots = snapshots
+        self.running = False
+        self.error: Optional[str] = None
+
+    def _watch_operations(self) -> None:
+        """Operationswechsel aus den Snapshots der Regelschleife (Zeitstempel der Veröffentlichung)."""
+        version = 0
+        while self.running:
+            snapshot = self.snapshots.wait_newer(version, 0.2)
+            if snapshot.version > version:
+                version = snapshot.version
+                self.recorder.on_operation(snapshot.data.get('operation'), snapshot.timestamp)
+
+    def _wait(self, condition, timeout: float) -> bool:
+        deadline = _real_monotonic() + timeout
+        while self.running and _real_monotonic() < deadline:
+            if condition():
+                return True
+            _real_sleep(0.001)
+        return False
+
+    def run_trials(self, bridge: PtyBridge) -> Dict:
+        """Führt alle Versuche gegen die laufende Bridge aus und gibt den Bericht zurück."""
+        spec = self.spec
+        recorder = self.recorder
+        if self.snapshots is None:
+            from utils.snapshot import get_telemetry_snapshot
+            self.snapshots = get_telemetry_snapshot()
+        bridge.add_tap(recorder.tap)
+        self.running = True
+        watcher = threading.Thread(target=self._watch_operations, name='latency-watch', daemon=True)
+        watcher.start()
+        ready_op = spec['ready_operation']
+        ready = lambda: recorder.ready(ready_op)
+        try:
+            if not self._wait(ready, spec['startup_timeout']):
+                self.error = (f"Roboter erreicht in {spec['startup_timeout']:.0f} s keinen "
+                              f"Betrieb '{ready_op}' mit fahrenden Motoren")
+                print(f"Latenz: {self.error}")
+            else:
+                self._run_events(bridge)
+        finally:
+            self.running = False
+            watcher.join(timeout=1.0)
+        return summarize(recorder.results, spec, recorder.skipped)
+
+    def _run_events(self, bridge: PtyBridge) -> None:
+        spec = self.spec
+        recorder = self.recorder
+        simulator = bridge.simulator
+        ready = lambda: recorder.ready(spec['ready_operation'])
+        for name, options in spec['events'].items():
+            reactions = options.get('reactions', ['drive_stop'])
+            for number in range(spec['trials']):
+                if not self.running:
+                    return
+                if not self._wait(ready, spec['ready_timeout']):
+                    recorder.skip(name)
+                    continue
+                _real_sleep(self.rng.uniform(*spec['gap']))
+                if not ready():
+                    recorder.skip(name)
+                    continue
+                with bridge.lock:
+                    injected = _real_monotonic()
+                    recorder.begin(name, reactions, injected)
+                    if not simulator.inject(name, options.get('value', True)):
+                        recorder.end()
+                        return
+                self._wait(recorder.complete, spec['reaction_timeout'])
+                # Ereignis mindestens hold Sekunden anstehen lassen (Entprellung, Summary-Takt)
+                remaining = injected + options.get('hold', 0.5) - _real_monotonic()
+                if remaining > 0:
+                    _real_sleep(remaining)
+                with bridge.lock:
+                    simulator.clear(name)
+                result = recorder.end()
+                latencies = ', '.join(f"{r} {v * 1000:.0f} ms" for r, v in result['latency'].items())
+                print(f"Latenz: {name} {number + 1}/{spec['trials']}: {latencies or 'keine Reaktion'}")
+
+def run(world: Optional[SimWorld] = None, spec: Optional[Dict] = None,
+        config_path: Optional[str] = None, workdir: str = 'sim_latency',
+        seed: Optional[int] = None) -> Dict:
+    """Startet main.py gegen den Simulator (Echtzeit) und misst die Reaktionszeiten."""
+    bench = LatencyBench(spec, seed)
+    bridge = prepare_main(world, config_path, workdir, time_scale=1.0, seed=seed,
+                          poll_interval=0.001)
+    report: Dict = {}
+    # Eigenes Flag: run_trials() setzt bench.running schon selbst zurück
+    main_running = [True]
+
+    def scenario():
+        try:
+            report.update(bench.run_trials(bridge))
+        finally:
+            # Beendet die Regelschleife wie Strg+C, sofern main.py noch läuft
+            if main_running[0]:
+                _thread.interrupt_main()
+
+    thread = threading.Thread(target=scenario, name='latency-bench', daemon=True)
+    thread.start()
+    try:
+        exec_main()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        main_running[0] = False
+        bench.running = False
+        thread.join(timeout=5.0)
+        bridge.stop()
+    if not report:
+        report = summarize(bench.recorder.results, bench.spec, bench.recorder.skipped)
+    if bench.error:
+        report['violations'].append(bench.error)
+        report['passed'] = False
+    return report
+
+def load_spec(filename: str) -> Optional[Dict]:
+    try:
+        with open(filename, 'r') as f:
+            return json.load(f)
+    except (OSError, ValueError) as e:
+        print(f"Latenz: Prüfstandsdatei {filename} nicht ladbar: {e}")
+        return None
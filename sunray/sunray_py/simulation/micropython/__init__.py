@@ -0,0 +1,44 @@
+"""
+MicroPython-Schicht für die Pico-Firmware unter CPython.
+
+- board.py:   virtuelles Board mit steuerbarer Uhr, Pins, PWM, ADC, I2C, UART, Timer, Watchdog
+- machine.py: Stand-in machine (Pin, PWM, ADC, I2C, UART, WDT, Timer)
+- utime.py:   Stand-in time/utime (ticks_* mit Überlauf, sleep* auf der Boarduhr)
+- threads.py: Stand-in _thread
+- devices.py: I2C-Gerätemodelle (INA226, HD44780 hinter I2C-Adapter)
+- drivers.py: Stand-ins der Treiber lib.ina226, lib.lcd_api, lib.pico_i2c_lcd
+
+Die Module werden je Board erzeugt (build_modules) und nur über den
+Import-Hook des Emulators (simulation/firmware.py) sichtbar, sys.modules bleibt
+unverändert.
+"""
+
+import types
+from typing import Callable, Dict
+
+from simulation.micropython import drivers, machine, threads, utime
+from simulation.micropython.board import Board, FirmwareReset, FirmwareStopped
+
+__all__ = [
+    'Board',
+    'FirmwareReset',
+    'FirmwareStopped',
+    'build_modules'
+]
+
+def build_modules(board: Board, spawn: Callable, epoch: float = None) -> Dict[str, types.ModuleType]:
+    clock = utime.build(board, epoch)
+    modules = {
+        'machine': machine.build(board),
+        'utime': clock,
+        'time': clock,
+        '_thread': threads.build(spawn),
+    }
+    micropython = types.ModuleType('micropython')
+    micropython.const = lambda value: value
+    micropython.native = micropython.viper = lambda function: function
+    micropython.alloc_emergency_exception_buf = lambda size: None
+    micropython.schedule = lambda function, arg: function(arg)
+    modules['micropython'] = micropython
+    modules.update(drivers.build())
+    return modules
@@ -0,0 +1,240 @@
+"""
+Virtuelles Pico-Board: Uhr, Pins, PWM, ADC, I2C-Busse, UARTs, Timer und Watchdog.
+
+Die Uhr ist steuerbar: Simulationszeit vergeht nur in der Hauptschleife der
+Firmware, und zwar an WDT.feed() (loop_us je Durchlauf) und in sleep*(). Der
+Steuernde (Firmware.run_until) gibt eine Grenze vor; erreicht die Firmware sie,
+blockiert sie an der nächsten dieser Stellen, bis die Grenze weiter rückt. Andere
+Threads (_thread.start_new_thread, auf dem Pico der zweite Kern) warten in
+sleep*() passiv auf die Uhr.
+
+Eingänge (Pins von außen, Encoder-Impulse, ADC-Werte, I2C-Geräte) setzt der
+Steuernde, während die Firmware blockiert. Flanken-Interrupts und Timer-Rückrufe
+laufen wie Soft-IRQs im Firmware-Hauptthread an der nächsten Warte-Stelle.
+"""
+
+import heapq
+import threading
+from typing import Callable, Dict, List, Optional, Tuple
+
+class FirmwareStopped(BaseException):
+    """Beendet Firmware-Threads (Stopp, Watchdog, Abschaltung); kein Exception, damit 'except Exception' ihn nicht fängt."""
+
+class FirmwareReset(BaseException):
+    """machine.reset() aus der Firmware."""
+
+IN, OUT, OPEN_DRAIN = 0, 1, 2
+PULL_UP, PULL_DOWN = 1, 2
+IRQ_FALLING, IRQ_RISING = 4, 8
+
+class PinState:
+    """Zustand eines GPIO: Richtung, Pull, Ausgangspegel, von außen angelegter Pegel, Interrupt."""
+    __slots__ = ('id', 'mode', 'pull', 'level', 'external', 'trigger', 'handler', 'pin')
+
+    def __init__(self, pin_id):
+        self.id = pin_id
+        self.mode = IN
+        self.pull = None
+        self.level = 0
+        self.external: Optional[int] = None
+        self.trigger = 0
+        self.handler: Optional[Callable] = None
+        self.pin = None
+
+    def value(self) -> int:
+        if self.mode == OUT:
+            return self.level
+        if self.external is not None:
+            return self.external
+        return 1 if self.pull == PULL_UP else 0
+
+class PwmState:
+    __slots__ = ('freq', 'duty')
+
+    def __init__(self):
+        self.freq = 1000
+        self.duty = 0
+
+class UartPort:
+    """Empfangspuffer (vom Steuernden gefüllt) und Sendepuffer (von der Firmware)."""
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.rx = bytearray()
+        self.tx = bytearray()
+        self.baudrate = 115200
+
+    def receive(self, data: bytes) -> None:
+        with self.lock:
+            self.rx.extend(data)
+
+    def take_tx(self) -> bytes:
+        with self.lock:
+            data = bytes(self.tx)
+            self.tx.clear()
+        return data
+
+class Board:
+    """Hardware-Zustand und steuerbare Uhr eines Pico (RP2040)."""
+    def __init__(self, loop_us: int = 1000, start_us: int = 0):
+        self.cond = threading.Condition()
+        self.loop_us = loop_us
+        self.us = start_us
+        self.limit = start_us
+        self.stopping = False
+        self.main_thread: Optional[int] = None
+        # Hauptthread wartet an der Grenze (Steuernder darf Eingänge setzen)
+        self.waiting = False
+        self.yields = 0
+
+        self.pins: Dict[object, PinState] = {}
+        self.pwms: Dict[object, PwmState] = {}
+        self.adc: Dict[object, int] = {}
+        self.i2c: Dict[int, Dict[int, object]] = {0: {}, 1: {}}
+        self.uarts: Dict[int, UartPort] = {0: UartPort(), 1: UartPort()}
+        self.timers: List[list] = []
+        self.wdt_timeout_us: Optional[int] = None
+        self.last_feed_us = start_us
+        self._pulses: List[Tuple[int, int, object]] = []
+        self._pulse_seq = 0
+        self._edges: List[PinState] = []
+
+    def reset(self) -> None:
+        """Zustand nach einem Reset: Pins, PWM, Timer, Watchdog und UART-Puffer; I2C-Geräte bleiben."""
+        with self.cond:
+            for state in self.pins.values():
+                state.mode, state.pull, state.level = IN, None, 0
+                state.trigger, state.handler, state.pin = 0, None, None
+            self.pwms.clear()
+            self.timers.clear()
+            self.wdt_timeout_us = None
+            self.last_feed_us = self.us
+            self._pulses.clear()
+            self._edges.clear()
+            for port in self.uarts.values():
+                port.rx.clear()
+                port.tx.clear()
+            self.stopping = False
+            self.waiting = False
+            self.main_thread = None
+
+    # -- Zugriffe der Stand-in-Module ---------------------------------------
+
+    def pin(self, pin_id) -> PinState:
+        state = self.pins.get(pin_id)
+        if state is None:
+            state = self.pins[pin_id] = PinState(pin_id)
+        return state
+
+    def pwm(self, pin_id) -> PwmState:
+        state = self.pwms.get(pin_id)
+        if state is None:
+            state = self.pwms[pin_id] = PwmState()
+        return state
+
+    def ticks_us(self) -> int:
+        return self.us
+
+    # -- Eingänge von außen (Steuernder) ------------------------------------
+
+    def drive(self, pin_id, level: Optional[int]) -> None:
+        """Legt einen Pegel an (None: nur Pull); Flanken lösen den Interrupt beim nächsten Service aus."""
+        state = self.pin(pin_id)
+        before = state.value()
+        state.external = level
+        after = state.value()
+        if before != after and state.handler is not None and \
+                state.trigger & (IRQ_RISING if after else IRQ_FALLING):
+            self._edges.append(state)
+
+    def pulse(self, pin_id, at_us: int) -> None:
+        """Kurzer High-Impuls (Encoder) zum Zeitpunkt at_us."""
+        self._pulse_seq += 1
+        heapq.heappush(self._pulses, (at_us, self._pulse_seq, pin_id))
+
+    def set_adc(self, pin_id, value: int) -> None:
+        self.adc[pin_id] = max(0, min(65535, int(value)))
+
+    def attach_i2c(self, bus: int, address: int, device) -> None:
+        self.i2c.setdefault(bus, {})[address] = device
+
+    # -- Uhr ----------------------------------------------------------------
+
+    def _check_stop(self) -> None:
+        if self.stopping:
+            raise FirmwareStopped()
+
+    def idle(self, advance_us: int) -> None:
+        """Warte-Stelle des Hauptthreads: Zeit um advance_us vorrücken, an der Grenze blockieren."""
+        if threading.get_ident() != self.main_thread:
+            return
+        self._advance_to(self.us + advance_us)
+        self.service()
+
+    def sleep_until(self, wake_us: int) -> None:
+        if threading.get_ident() == self.main_thread:
+            # Die Hauptschleife schläft in Schritten, damit Interrupts und Timer dazwischen laufen
+            while self.us < wake_us:
+                self._advance_to(min(wake_us, self.us + self.loop_us))
+                self.service()
+            return
+        with self.cond:
+            while self.us < wake_us:
+                self._check_stop()
+                self.cond.wait()
+            self._check_stop()
+
+    def _advance_to(self, target: int) -> None:
+        with self.cond:
+            self._check_stop()
+            while target > self.limit:
+                self.waiting = True
+                self.cond.notify_all()
+                self.cond.wait()
+                self._check_stop()
+            self.waiting = False
+            self.us = max(self.us, target)
+            self.yields += 1
+            self.cond.notify_all()
+
+    def feed(self) -> None:
+        self.last_feed_us = self.us
+        self.idle(self.loop_us)
+
+    def service(self) -> None:
+        """Fällige Encoder-Impulse, Flanken-Interrupts und Timer im Firmware-Hauptthread."""
+        now = self.us
+        pulses = self._pulses
+        while pulses and pulses[0][0] <= now:
+            _, _, pin_id = heapq.heappop(pulses)
+            state = self.pin(pin_id)
+            state.external = 1
+            if state.handler is not None and state.trigger & IRQ_RISING:
+                state.handler(state.pin)
+            state.external = 0
+        while self._edges:
+            state = self._edges.pop(0)
+            if state.handler is not None:
+                state.handler(state.pin)
+        for timer in list(self.timers):
+            if timer[0] <= now:
+                due, period, callback, one_shot, owner = timer
+                if one_shot:
+                    timer[0] = float('inf')
+                else:
+                    timer[0] = due + period if due + period > now else now + period
+                if callback is not None:
+                    callback(owner)
+        if self.timers:
+            self.timers = [t for t in self.timers if t[0] != float('inf')]
+
+    def release(self, limit_us: int) -> None:
+        """Steuernder: Grenze setzen und die Firmware weiterlaufen lassen."""
+        with self.cond:
+            self.limit = max(self.limit, limit_us)
+            self.waiting = False
+            self.cond.notify_all()
+
+    def wait_caught_up(self, timeout: float) -> bool:
+        """Steuernder: wartet, bis der Hauptthread an der Grenze blockiert oder beendet ist (True)."""
+        with self.cond:
+            return self.cond.wait_for(lambda: self.waiting or self.main_thread is None, timeout)
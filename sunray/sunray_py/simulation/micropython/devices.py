@@ -0,0 +1,102 @@
+"""
+I2C-Geräte am virtuellen Board, auf Registerebene.
+
+- INA226Device: Strom-/Spannungsmonitor (TI INA226). Der Steuernde setzt
+  Busspannung und Strom; Shunt-, Strom- und Leistungsregister entstehen daraus
+  wie im Datenblatt (Shunt 2,5 µV/LSB, Bus 1,25 mV/LSB, Strom = Shunt · CAL / 2048).
+- LcdDevice: HD44780-Textanzeige hinter einem I2C-Adapter. Byte 0 eines
+  Schreibzugriffs ist das Steuerbyte (0x00 Befehl, 0x40 Daten); ausgewertet
+  werden Löschen (0x01) und DDRAM-Adresse (0x80 | Adresse, Zeile 2 ab 0x40).
+"""
+
+from typing import Dict, List, Optional
+
+def _u16(value: int) -> bytes:
+    return (value & 0xFFFF).to_bytes(2, 'big')
+
+def _clamp16(value: float) -> int:
+    return max(-32768, min(32767, int(round(value))))
+
+class INA226Device:
+    REG_CONFIG, REG_SHUNT, REG_BUS, REG_POWER, REG_CURRENT, REG_CALIBRATION = 0, 1, 2, 3, 4, 5
+    REG_MASK, REG_ALERT, REG_MANUFACTURER, REG_DIE = 6, 7, 0xFE, 0xFF
+
+    def __init__(self, shunt_ohm: float = 0.1):
+        self.shunt_ohm = shunt_ohm
+        self.bus_voltage = 0.0
+        self.current = 0.0
+        self.registers: Dict[int, int] = {self.REG_CONFIG: 0x4127, self.REG_CALIBRATION: 0,
+                                          self.REG_MASK: 0, self.REG_ALERT: 0,
+                                          self.REG_MANUFACTURER: 0x5449, self.REG_DIE: 0x2260}
+        self.pointer = 0
+        self.reads = 0
+
+    def set(self, bus_voltage: float, current: float) -> None:
+        """Messgrößen (V, A; positiv vom Bus zur Last)."""
+        self.bus_voltage = bus_voltage
+        self.current = current
+
+    def _register(self, reg: int) -> int:
+        shunt = _clamp16(self.current * self.shunt_ohm / 2.5e-6)
+        if reg == self.REG_SHUNT:
+            return shunt
+        if reg == self.REG_BUS:
+            return max(0, min(0x7FFF, int(round(self.bus_voltage / 1.25e-3))))
+        calibration = self.registers[self.REG_CALIBRATION]
+        current = _clamp16(shunt * calibration / 2048)
+        if reg == self.REG_CURRENT:
+            return current
+        if reg == self.REG_POWER:
+            return abs(current) * self._register(self.REG_BUS) // 20000
+        return self.registers.get(reg, 0)
+
+    def read(self, reg: Optional[int], count: int) -> bytes:
+        self.reads += 1
+        reg = self.pointer if reg is None else reg
+        return _u16(self._register(reg))[:count].ljust(count, b'\x00')
+
+    def write(self, reg: Optional[int], data: bytes) -> None:
+        if reg is None:
+            if not data:
+                return
+            reg, data = data[0], data[1:]
+        self.pointer = reg
+        if len(data) >= 2 and reg in (self.REG_CONFIG, self.REG_CALIBRATION, self.REG_MASK, self.REG_ALERT):
+            self.registers[reg] = int.from_bytes(data[:2], 'big')
+
+class LcdDevice:
+    def __init__(self, rows: int = 2, columns: int = 16):
+        self.rows = rows
+        self.columns = columns
+        self.address = 0
+        self.writes = 0
+        self.clear()
+
+    def clear(self) -> None:
+        self.buffer: List[List[str]] = [[' '] * 40 for _ in range(max(2, self.rows))]
+        self.address = 0
+
+    @property
+    def lines(self) -> List[str]:
+        """Sichtbarer Text je Zeile."""
+        return [''.join(row[:self.columns]) for row in self.buffer[:self.rows]]
+
+    def read(self, reg: Optional[int], count: int) -> bytes:
+        return bytes(count)
+
+    def write(self, reg: Optional[int], data: bytes) -> None:
+        self.writes += 1
+        if reg is None:
+            if not data:
+                return
+            reg, data = data[0], data[1:]
+        for byte in data:
+            if reg == 0x40:
+                row, column = (1, self.address - 0x40) if self.address >= 0x40 else (0, self.address)
+                if row < len(self.buffer) and 0 <= column < 40:
+                    self.buffer[row][column] = chr(byte)
+                self.address += 1
+            elif byte == 0x01:
+                self.clear()
+            elif byte & 0x80:
+                self.address = byte & 0x7F
@@ -0,0 +1,128 @@
+"""
+Stand-ins für die Treiber in lib/ auf dem Pico-Dateisystem (nicht im Repository):
+lib.ina226 (INA226), lib.lcd_api (LcdApi) und lib.pico_i2c_lcd (I2cLcd).
+
+Sie sprechen über machine.I2C mit den Gerätemodellen aus devices.py, Fehler
+auf dem Bus (fehlendes Gerät) kommen also wie auf dem Pico als OSError.
+Liegen die echten Treiber im Firmware-Verzeichnis unter lib/, verwendet der
+Emulator diese statt der Stand-ins.
+"""
+
+import types
+
+class INA226:
+    """Wie die verbreiteten MicroPython-Treiber: Kalibrierung für 0,1 Ohm Shunt, 0,1 mA/LSB."""
+    SHUNT_OHM = 0.1
+    CURRENT_LSB = 0.0001
+
+    def __init__(self, i2c, addr=0x40):
+        self.i2c = i2c
+        self.addr = addr
+
+    def _read(self, reg: int, signed: bool = False) -> int:
+        return int.from_bytes(self.i2c.readfrom_mem(self.addr, reg, 2), 'big', signed=signed)
+
+    def _write(self, reg: int, value: int) -> None:
+        self.i2c.writeto_mem(self.addr, reg, (value & 0xFFFF).to_bytes(2, 'big'))
+
+    def set_calibration(self) -> None:
+        self._write(0x05, int(0.00512 / (self.CURRENT_LSB * self.SHUNT_OHM)))
+
+    @property
+    def shunt_voltage(self) -> float:
+        return self._read(0x01, signed=True) * 2.5e-6
+
+    @property
+    def bus_voltage(self) -> float:
+        return self._read(0x02) * 1.25e-3
+
+    @property
+    def current(self) -> float:
+        return self._read(0x04, signed=True) * self.CURRENT_LSB
+
+    @property
+    def power(self) -> float:
+        return self._read(0x03) * 25 * self.CURRENT_LSB
+
+class LcdApi:
+    """Cursor und Text; hal_write_command/hal_write_data liefert die Unterklasse."""
+    LCD_CLR = 0x01
+    LCD_DDRAM = 0x80
+
+    def __init__(self, num_lines, num_columns):
+        self.num_lines = min(num_lines, 4)
+        self.num_columns = min(num_columns, 40)
+        self.cursor_x = 0
+        self.cursor_y = 0
+        self.backlight = True
+        self.clear()
+
+    def clear(self):
+        self.hal_write_command(self.LCD_CLR)
+        self.cursor_x = 0
+        self.cursor_y = 0
+
+    def move_to(self, cursor_x, cursor_y):
+        self.cursor_x = cursor_x
+        self.cursor_y = cursor_y
+        address = cursor_x & 0x3F
+        if cursor_y & 1:
+            address += 0x40
+        if cursor_y & 2:
+            address += self.num_columns
+        self.hal_write_command(self.LCD_DDRAM | address)
+
+    def putchar(self, char):
+        if char == '\n':
+            self.cursor_x = self.num_columns
+        else:
+            self.hal_write_data(ord(char))
+            self.cursor_x += 1
+        if self.cursor_x >= self.num_columns:
+            self.cursor_x = 0
+            self.cursor_y = (self.cursor_y + 1) % self.num_lines
+            self.move_to(self.cursor_x, self.cursor_y)
+
+    def putstr(self, string):
+        for char in string:
+            self.putchar(char)
+
+    def backlight_on(self):
+        self.backlight = True
+
+    def backlight_off(self):
+        self.backlight = False
+
+    def hide_cursor(self):
+        pass
+
+    def show_cursor(self):
+        pass
+
+class I2cLcd(LcdApi):
+    def __init__(self, i2c, i2c_addr, num_lines, num_columns):
+        self.i2c = i2c
+        self.i2c_addr = i2c_addr
+        # Anwesenheit prüfen wie der echte Treiber beim Initialisieren
+        self.i2c.writeto(self.i2c_addr, bytes([0]))
+        super().__init__(num_lines, num_columns)
+
+    def hal_write_command(self, cmd):
+        self.i2c.writeto(self.i2c_addr, bytes([0x00, cmd]))
+
+    def hal_write_data(self, data):
+        self.i2c.writeto(self.i2c_addr, bytes([0x40, data]))
+
+def build() -> dict:
+    """Module lib, lib.ina226, lib.lcd_api, lib.pico_i2c_lcd."""
+    ina226 = types.ModuleType('lib.ina226')
+    ina226.INA226 = INA226
+    lcd_api = types.ModuleType('lib.lcd_api')
+    lcd_api.LcdApi = LcdApi
+    pico_i2c_lcd = types.ModuleType('lib.pico_i2c_lcd')
+    pico_i2c_lcd.I2cLcd = I2cLcd
+    pico_i2c_lcd.LcdApi = LcdApi
+    package = types.ModuleType('lib')
+    package.__path__ = []
+    package.ina226, package.lcd_api, package.pico_i2c_lcd = ina226, lcd_api, pico_i2c_lcd
+    return {'lib': package, 'lib.ina226': ina226, 'lib.lcd_api': lcd_api, 'lib.pico_i2c_lcd': pico_i2c_lcd}
@@ -0,0 +1,230 @@
+"""
+Stand-in für das MicroPython-Modul machine (rp2) auf einem virtuellen Board.
+
+build(board) liefert ein Modulobjekt, dessen Klassen an dieses Board gebunden
+sind; mehrere Emulatoren im selben Prozess teilen sich nichts. Nachgebildet ist,
+was die Firmware nutzt, mit den Signaturen von MicroPython:
+Pin, PWM, ADC, I2C, UART, WDT, Timer sowie reset, freq, unique_id, idle.
+"""
+
+import errno
+import types
+
+from simulation.micropython import board as hw
+
+def build(board: hw.Board) -> types.ModuleType:
+    module = types.ModuleType('machine')
+    module.__doc__ = 'Stand-in machine (simulation/micropython/machine.py)'
+
+    class Pin:
+        IN, OUT, OPEN_DRAIN = hw.IN, hw.OUT, hw.OPEN_DRAIN
+        PULL_UP, PULL_DOWN = hw.PULL_UP, hw.PULL_DOWN
+        IRQ_FALLING, IRQ_RISING = hw.IRQ_FALLING, hw.IRQ_RISING
+
+        def __init__(self, id, mode=-1, pull=-1, value=None):
+            self._id = id
+            self._state = board.pin(id)
+            self._state.pin = self
+            self.init(mode, pull, value)
+
+        def init(self, mode=-1, pull=-1, value=None):
+            state = self._state
+            if mode != -1 and mode is not None:
+                state.mode = mode
+            if pull != -1:
+                state.pull = pull
+            if value is not None:
+                state.level = 1 if value else 0
+
+        def value(self, x=None):
+            if x is None:
+                return self._state.value()
+            self._state.level = 1 if x else 0
+            return None
+
+        def __call__(self, x=None):
+            return self.value(x)
+
+        def on(self):
+            self._state.level = 1
+
+        def off(self):
+            self._state.level = 0
+
+        high, low = on, off
+
+        def toggle(self):
+            self._state.level ^= 1
+
+        def irq(self, handler=None, trigger=IRQ_FALLING | IRQ_RISING, hard=False):
+            self._state.handler = handler
+            self._state.trigger = trigger if handler is not None else 0
+
+        def __repr__(self):
+            return f'Pin({self._id})'
+
+    class PWM:
+        def __init__(self, dest, *, freq=None, duty_u16=None, duty_ns=None):
+            self._pin = dest._id if isinstance(dest, Pin) else dest
+            self._state = board.pwm(self._pin)
+            if freq is not None:
+                self._state.freq = int(freq)
+            if duty_u16 is not None:
+                self.duty_u16(duty_u16)
+
+        def freq(self, value=None):
+            if value is None:
+                return self._state.freq
+            self._state.freq = int(value)
+
+        def duty_u16(self, value=None):
+            if value is None:
+                return self._state.duty
+            self._state.duty = max(0, min(65535, int(value)))
+
+        def duty_ns(self, value=None):
+            period_ns = 1e9 / max(1, self._state.freq)
+            if value is None:
+                return int(self._state.duty / 65535 * period_ns)
+            self.duty_u16(value / period_ns * 65535)
+
+        def deinit(self):
+            self._state.duty = 0
+
+    class ADC:
+        CORE_TEMP = 4
+
+        def __init__(self, pin):
+            self._pin = pin._id if isinstance(pin, Pin) else pin
+
+        def read_u16(self):
+            return board.adc.get(self._pin, 0)
+
+    class I2C:
+        def __init__(self, id, *, scl=None, sda=None, freq=400000, timeout=50000):
+            self._bus = board.i2c.setdefault(id, {})
+            self.freq = freq
+
+        def _device(self, addr):
+            device = self._bus.get(addr)
+            if device is None:
+                # Kein ACK: rp2 meldet EIO
+                raise OSError(errno.EIO, 'EIO')
+            return device
+
+        def scan(self):
+            return sorted(self._bus)
+
+        def readfrom_mem(self, addr, memaddr, nbytes, *, addrsize=8):
+            return bytes(self._device(addr).read(memaddr, nbytes))
+
+        def readfrom_mem_into(self, addr, memaddr, buf, *, addrsize=8):
+            buf[:] = self.readfrom_mem(addr, memaddr, len(buf))
+
+        def writeto_mem(self, addr, memaddr, buf, *, addrsize=8):
+            self._device(addr).write(memaddr, bytes(buf))
+
+        def writeto(self, addr, buf, stop=True):
+            self._device(addr).write(None, bytes(buf))
+            return 1
+
+        def readfrom(self, addr, nbytes, stop=True):
+            return bytes(self._device(addr).read(None, nbytes))
+
+    class UART:
+        def __init__(self, id, baudrate=115200, bits=8, parity=None, stop=1, *, tx=None, rx=None,
+                     timeout=0, **kwargs):
+            self._port = board.uarts.setdefault(id, hw.UartPort())
+            self._port.baudrate = baudrate
+
+        def init(self, baudrate=115200, **kwargs):
+            self._port.baudrate = baudrate
+
+        def any(self):
+            return len(self._port.rx)
+
+        def read(self, nbytes=None):
+            with self._port.lock:
+                rx = self._port.rx
+                if not rx:
+                    return None
+                count = len(rx) if nbytes is None else min(nbytes, len(rx))
+                data = bytes(rx[:count])
+                del rx[:count]
+            return data
+
+        def readline(self):
+            """Bis einschließlich '\\n'; ohne Zeilenende (Timeout abgelaufen) der vorhandene Rest."""
+            with self._port.lock:
+                rx = self._port.rx
+                if not rx:
+                    return None
+                end = rx.find(b'\n')
+                count = len(rx) if end < 0 else end + 1
+                data = bytes(rx[:count])
+                del rx[:count]
+            return data
+
+        def write(self, buf):
+            data = buf.encode('ascii') if isinstance(buf, str) else bytes(buf)
+            with self._port.lock:
+                self._port.tx.extend(data)
+            return len(data)
+
+        def flush(self):
+            pass
+
+    class WDT:
+        def __init__(self, id=0, timeout=5000):
+            board.wdt_timeout_us = int(timeout) * 1000
+            board.last_feed_us = board.us
+
+        def feed(self):
+            board.feed()
+
+    class Timer:
+        ONE_SHOT, PERIODIC = 0, 1
+
+        def __init__(self, id=-1, *, mode=PERIODIC, period=-1, freq=-1, callback=None):
+            self._entry = None
+            if callback is not None:
+                self.init(mode=mode, period=period, freq=freq, callback=callback)
+
+        def init(self, *, mode=PERIODIC, period=-1, freq=-1, callback=None):
+            self.deinit()
+            period_us = int(1e6 / freq) if freq > 0 else int(period) * 1000
+            period_us = max(period_us, 1)
+            self._entry = [board.us + period_us, period_us, callback, mode == Timer.ONE_SHOT, self]
+            board.timers.append(self._entry)
+
+        def deinit(self):
+            if self._entry is not None and self._entry in board.timers:
+                board.timers.remove(self._entry)
+            self._entry = None
+
+    def reset():
+        raise hw.FirmwareReset()
+
+    def idle():
+        board.idle(board.loop_us)
+
+    def lightsleep(time_ms=None):
+        board.sleep_until(board.us + int(time_ms or 0) * 1000)
+
+    module.Pin = Pin
+    module.PWM = PWM
+    module.ADC = ADC
+    module.I2C = I2C
+    module.SoftI2C = I2C
+    module.UART = UART
+    module.WDT = WDT
+    module.Timer = Timer
+    module.reset = reset
+    module.soft_reset = reset
+    module.idle = idle
+    module.lightsleep = lightsleep
+    module.freq = lambda hz=None: 125_000_000
+    module.unique_id = lambda: b'\xe6\x61\x38\x52\x83\x4d\x2b\x2f'
+    module.disable_irq = lambda: 0
+    module.enable_irq = lambda state=0: None
+    return module
@@ -0,0 +1,30 @@
+"""
+Stand-in für _thread von MicroPython: Threads des Hosts, vom Emulator verwaltet.
+
+Auf dem Pico läuft ein mit start_new_thread gestarteter Thread auf dem zweiten
+Kern. Hier ist es ein Thread des Hosts, der in sleep*() auf die Boarduhr wartet
+und beim Stopp oder Reset des Emulators mit beendet wird.
+"""
+
+import threading
+import types
+from typing import Callable
+
+def build(spawn: Callable) -> types.ModuleType:
+    """spawn(function, args, kwargs) startet und verwaltet den Thread (Firmware._spawn)."""
+    module = types.ModuleType('_thread')
+    module.__doc__ = 'Stand-in _thread (simulation/micropython/threads.py)'
+
+    def start_new_thread(function, args, kwargs=None):
+        return spawn(function, tuple(args), dict(kwargs or {}))
+
+    def exit():
+        raise SystemExit()
+
+    module.start_new_thread = start_new_thread
+    module.allocate_lock = threading.Lock
+    module.LockType = type(threading.Lock())
+    module.get_ident = threading.get_ident
+    module.exit = exit
+    module.stack_size = lambda size=0: 0
+    return module
@@ -0,0 +1,42 @@
+"""
+Stand-in für time/utime von MicroPython auf der steuerbaren Uhr des Boards.
+
+ticks_ms/ticks_us laufen wie auf dem RP2040 nach 2**30 über; ticks_add und
+ticks_diff rechnen modular. Mit Board(start_us=...) nahe am Überlauf lässt sich
+der Umgang der Firmware damit prüfen.
+"""
+
+import time as _host_time
+import types
+
+from simulation.micropython.board import Board
+
+TICKS_PERIOD = 1 << 30
+TICKS_MAX = TICKS_PERIOD - 1
+TICKS_HALFPERIOD = TICKS_PERIOD // 2
+
+def ticks_add(ticks: int, delta: int) -> int:
+    return (ticks + delta) & TICKS_MAX
+
+def ticks_diff(ticks1: int, ticks2: int) -> int:
+    return ((ticks1 - ticks2 + TICKS_HALFPERIOD) & TICKS_MAX) - TICKS_HALFPERIOD
+
+def build(board: Board, epoch: float = None) -> types.ModuleType:
+    """epoch: Unix-Zeit bei Boardzeit 0 (Standard: jetzt)."""
+    epoch = _host_time.time() if epoch is None else epoch
+    module = types.ModuleType('utime')
+    module.__doc__ = 'Stand-in utime (simulation/micropython/utime.py)'
+    module.ticks_ms = lambda: (board.us // 1000) & TICKS_MAX
+    module.ticks_us = lambda: board.us & TICKS_MAX
+    module.ticks_cpu = module.ticks_us
+    module.ticks_add = ticks_add
+    module.ticks_diff = ticks_diff
+    module.sleep = lambda seconds: board.sleep_until(board.us + int(seconds * 1e6))
+    module.sleep_ms = lambda ms: board.sleep_until(board.us + int(ms) * 1000)
+    module.sleep_us = lambda us: board.sleep_until(board.us + int(us))
+    module.time = lambda: int(epoch + board.us / 1e6)
+    module.time_ns = lambda: int((epoch + board.us / 1e6) * 1e9)
+    module.gmtime = lambda secs=None: _host_time.gmtime(module.time() if secs is None else secs)[:8]
+    module.localtime = lambda secs=None: _host_time.localtime(module.time() if secs is None else secs)[:8]
+    module.mktime = lambda t: int(_host_time.mktime(tuple(t[:8]) + (-1,)))
+    return module
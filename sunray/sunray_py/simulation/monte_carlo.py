@@ -0,0 +1,280 @@
+"""
+Parallele Monte-Carlo-Auswertung von Mähmissionen über ein Parametergitter.
+
+Jede Kombination aus Parametersatz und Seed ist eine Mission
+(simulation/mission.py). Die Missionen laufen in einem Prozesspool; die Welt
+wird jedem Prozess einmal beim Start übergeben, dort entstehen Abdeckungsraster
+und Pläne (MissionMap) einmal und werden von allen Missionen des Prozesses nur
+gelesen.
+
+Checkpoint: Jedes Ergebnis wird sofort als JSON-Zeile an <output>.jsonl
+angehängt. Ein abgebrochener Lauf wird mit demselben Aufruf fortgesetzt, bereits
+vorhandene Kombinationen (Schlüssel aus allen Missionsparametern, Welt und
+Seed) werden übersprungen. Am Ende wird je Parametersatz zusammengefasst (Tabelle und
+<output>.csv).
+
+Gitterdatei (JSON):
+  {
+    "world": "garten.json",           (optional, sonst Standardwelt; "yard:5000:1" = Garten-Generator)
+    "seeds": 8,                       (Anzahl oder Liste)
+    "duration": 3600,
+    "base": {"drive.speed": 0.3},     (feste Überschreibungen)
+    "grid": {"planner.line_spacing": [0.25, 0.3],
+             "escape.reverse_duration": [0.5, 1.0, 1.5]}
+  }
+Schlüssel mit Punkt sind Pfade in mission.DEFAULT_PARAMS.
+"""
+
+import csv
+import hashlib
+import itertools
+import json
+import math
+import multiprocessing
+import os
+import sys
+import time
+from typing import Dict, List, Optional, Tuple
+
+from simulation.mission import Mission, MissionMap, DEFAULT_PARAMS, merge_params
+from simulation.world import SimWorld
+
+def expand_grid(grid: Dict[str, List]) -> List[Dict]:
+    """Kartesisches Produkt der Gitterwerte, Schlüssel sortiert (stabile Reihenfolge)."""
+    keys = sorted(grid)
+    values = [grid[key] if isinstance(grid[key], list) else [grid[key]] for key in keys]
+    return [dict(zip(keys, combination)) for combination in itertools.product(*values)]
+
+def world_fingerprint(world: SimWorld) -> str:
+    """Prüfsumme der Weltbeschreibung (auch für generierte Gärten)."""
+    return hashlib.sha1(json.dumps(world.to_dict(), sort_keys=True).encode('utf-8')).hexdigest()
+
+def params_id(params: Dict, world_fp: str = '') -> str:
+    """
+    Schlüssel eines Parametersatzes aus den vollständigen Missionsparametern
+    (Basis, Dauer und Überschreibungen) und der Welt; ein geänderter Aufruf
+    übernimmt so keine Ergebnisse aus einem älteren Checkpoint.
+    """
+    text = json.dumps(params, sort_keys=True, default=str) + world_fp
+    return hashlib.sha1(text.encode('utf-8')).hexdigest()[:12]
+
+def load_checkpoint(path: str) -> Dict[str, Dict]:
+    """Liest die Ergebnisse eines früheren Laufs; eine abgeschnittene letzte Zeile wird verworfen."""
+    records = {}
+    if not os.path.exists(path):
+        return records
+    try:
+        with open(path, 'r') as f:
+            for line in f:
+                try:
+                    record = json.loads(line)
+                except ValueError:
+                    continue
+                records[record['key']] = record
+    except OSError as e:
+        print(f"Monte-Carlo: Checkpoint {path} nicht lesbar: {e}")
+    return records
+
+def percentile(values: List[float], q: float) -> float:
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    position = (len(ordered) - 1) * q
+    lower = int(math.floor(position))
+    upper = min(lower + 1, len(ordered) - 1)
+    return ordered[lower] + (ordered[upper] - ordered[lower]) * (position - lower)
+
+def _mean_std(values: List[float]) -> Tuple[float, float]:
+    if not values:
+        return 0.0, 0.0
+    mean = sum(values) / len(values)
+    variance = sum((v - mean) ** 2 for v in values) / (len(values) - 1) if len(values) > 1 else 0.0
+    return mean, math.sqrt(variance)
+
+def summarize(records: List[Dict]) -> List[Dict]:
+    """Kennzahlen je Parametersatz, sortiert nach mittlerer Abdeckung (absteigend)."""
+    groups: Dict[str, List[Dict]] = {}
+    for record in records:
+        groups.setdefault(record['params_id'], []).append(record)
+    rows = []
+    for pid, group in groups.items():
+        results = [r['result'] for r in group]
+        coverage = [r['coverage'] for r in results]
+        coverage_mean, coverage_std = _mean_std(coverage)
+        escapes = sum(r['escapes'] for r in results)
+        resolved = sum(r['escape_success'] + r['escape_failed'] for r in results)
+        row = {
+            'params_id': pid,
+            'overrides': group[0]['overrides'],
+            'runs': len(group),
+            'coverage_mean': coverage_mean,
+            'coverage_std': coverage_std,
+            'coverage_p10': percentile(coverage, 0.1),
+            'coverage_p50': percentile(coverage, 0.5),
+            'mission_time_mean': _mean_std([r['mission_time'] for r in results])[0],
+            'completed_rate': sum(1 for r in results if r['completed']) / len(results),
+            'escapes_mean': escapes / len(results),
+            'escape_success_rate': sum(r['escape_success'] for r in results) / resolved if resolved else 1.0,
+            'energy_wh_mean': _mean_std([r['energy_wh'] for r in results])[0],
+            'safety_events_mean': _mean_std([r['safety_event_count'] for r in results])[0],
+            'bumper_contacts_mean': _mean_std([r['bumper_contacts'] for r in results])[0],
+        }
+        rows.append(row)
+    rows.sort(key=lambda row: -row['coverage_mean'])
+    return rows
+
+SUMMARY_COLUMNS = [
+    ('runs', 'Läufe', '{:d}'),
+    ('coverage_mean', 'Abd.%', '{:.1f}'),
+    ('coverage_std', '±', '{:.1f}'),
+    ('coverage_p10', 'P10', '{:.1f}'),
+    ('mission_time_mean', 'Zeit s', '{:.0f}'),
+    ('completed_rate', 'fertig', '{:.0%}'),
+    ('escape_success_rate', 'Ausw.ok', '{:.0%}'),
+    ('energy_wh_mean', 'Wh', '{:.1f}'),
+    ('safety_events_mean', 'Sich.', '{:.1f}'),
+    ('bumper_contacts_mean', 'Bumper', '{:.1f}'),
+]
+
+def format_table(rows: List[Dict]) -> str:
+    """Ergebnistabelle als Text; Parameter in der letzten Spalte."""
+    header = [title for _, title, _ in SUMMARY_COLUMNS] + ['Parameter']
+    lines = [[fmt.format(row[key]) for key, _, fmt in SUMMARY_COLUMNS] +
+             [', '.join(f'{k}={v}' for k, v in sorted(row['overrides'].items())) or '(Basis)']
+             for row in rows]
+    widths = [max(len(str(cell)) for cell in column) for column in zip(header, *lines)]
+    out = []
+    for cells in [header] + lines:
+        out.append('  '.join(str(cell).rjust(width) if i < len(SUMMARY_COLUMNS) else str(cell)
+                             for i, (cell, width) in enumerate(zip(cells, widths))))
+    return '\n'.join(out)
+
+def write_csv(rows: List[Dict], path: str) -> None:
+    keys = sorted({key for row in rows for key in row['overrides']})
+    columns = ['params_id'] + keys + [key for key, _, _ in SUMMARY_COLUMNS] + \
+              ['coverage_p50', 'escapes_mean']
+    with open(path, 'w', newline='') as f:
+        writer = csv.writer(f)
+        writer.writerow(columns)
+        for row in rows:
+            writer.writerow([row['params_id']] + [row['overrides'].get(key, '') for key in keys] +
+                            [row[key] for key in columns[1 + len(keys):]])
+
+# -- Arbeitsprozesse --------------------------------------------------------
+
+_worker: Dict = {}
+
+def _init_worker(world_data: Dict, base: Dict, quiet: bool) -> None:
+    """Einmal je Prozess: Welt und MissionMap aufbauen (danach nur gelesen)."""
+    if quiet:
+        # Planer und Sicherheitsmanager melden sich auf stdout
+        sys.stdout = open(os.devnull, 'w')
+    world = SimWorld.from_dict(world_data)
+    _worker['world'] = world
+    _worker['map'] = MissionMap(world)
+    _worker['base'] = base
+
+def _run_task(task: Tuple[str, str, Dict, int]) -> Dict:
+    key, pid, overrides, seed = task
+    started = time.perf_counter()
+    params = merge_params(_worker['base'], overrides)
+    try:
+        result = Mission(_worker['world'], params, seed, _worker['map']).run()
+    except Exception as e:
+        # Eine fehlerhafte Kombination soll die Studie nicht abbrechen
+        return {'key': key, 'params_id': pid, 'overrides': overrides, 'seed': seed,
+                'error': f'{type(e).__name__}: {e}'}
+    return {'key': key, 'params_id': pid, 'overrides': overrides, 'seed': seed,
+            'wall_time': time.perf_counter() - started, 'result': result}
+
+class MonteCarloRunner:
+    """Führt alle (Parametersatz, Seed)-Kombinationen aus, mit Checkpoint und Zusammenfassung."""
+    def __init__(self, world: SimWorld, spec: Dict, output: str, workers: Optional[int] = None):
+        self.world = world
+        self.output = output
+        self.checkpoint_path = output + '.jsonl'
+        self.csv_path = output + '.csv'
+        self.workers = workers or os.cpu_count() or 1
+        seeds = spec.get('seeds', 4)
+        self.seeds = list(seeds) if isinstance(seeds, list) else list(range(seeds))
+        self.base = merge_params(DEFAULT_PARAMS, spec.get('base', {}))
+        if 'duration' in spec:
+            self.base['mission']['duration'] = float(spec['duration'])
+        self.param_sets = expand_grid(spec.get('grid', {}))
+        self.world_fp = world_fingerprint(world)
+        self.failed = 0
+
+    def _ends_with_newline(self) -> bool:
+        with open(self.checkpoint_path, 'rb') as f:
+            f.seek(-1, os.SEEK_END)
+            return f.read(1) == b'\n'
+
+    def tasks(self) -> List[Tuple[str, str, Dict, int]]:
+        tasks = []
+        for overrides in self.param_sets:
+            pid = params_id(merge_params(self.base, overrides), self.world_fp)
+            for seed in self.seeds:
+                tasks.append((f'{pid}:{seed}', pid, overrides, seed))
+        return tasks
+
+    def run(self, quiet: bool = True) -> List[Dict]:
+        """Führt die offenen Missionen aus und gibt die Zusammenfassung aller Ergebnisse zurück."""
+        done = load_checkpoint(self.checkpoint_path)
+        all_tasks = self.tasks()
+        pending = [task for task in all_tasks if task[0] not in done]
+        print(f"Monte-Carlo: {len(self.param_sets)} Parametersätze x {len(self.seeds)} Seeds, "
+              f"{len(all_tasks) - len(pending)} aus Checkpoint, {len(pending)} offen, {self.workers} Prozesse")
+        directory = os.path.dirname(os.path.abspath(self.checkpoint_path))
+        os.makedirs(directory, exist_ok=True)
+
+        started = time.perf_counter()
+        with open(self.checkpoint_path, 'a') as checkpoint:
+            if checkpoint.tell() > 0 and not self._ends_with_newline():
+                # Beim Abbruch abgeschnittene Zeile abschließen, sonst verdirbt sie das nächste Ergebnis
+                checkpoint.write('\n')
+            def store(record: Dict) -> None:
+                if 'error' in record:
+                    self.failed += 1
+                    print(f"Monte-Carlo: {record['key']} fehlgeschlagen: {record['error']}")
+                    return
+                checkpoint.write(json.dumps(record) + '\n')
+                checkpoint.flush()
+                done[record['key']] = record
+
+            if not pending:
+                pass
+            elif self.workers == 1 or len(pending) == 1:
+                _init_worker(self.world.to_dict(), self.base, False)
+                for task in pending:
+                    store(_run_task(task))
+            else:
+                pool = multiprocessing.Pool(self.workers, initializer=_init_worker,
+                                            initargs=(self.world.to_dict(), self.base, quiet))
+                try:
+                    for count, record in enumerate(pool.imap_unordered(_run_task, pending), 1):
+                        store(record)
+                        if count % max(1, len(pending) // 20) == 0 or count == len(pending):
+                            print(f"Monte-Carlo: {count}/{len(pending)} "
+                                  f"({time.perf_counter() - started:.0f} s)")
+                    pool.close()
+                except KeyboardInterrupt:
+                    pool.terminate()
+                    print(f"Monte-Carlo: abgebrochen, {len(done)} Ergebnisse in {self.checkpoint_path}; "
+                          f"gleicher Aufruf setzt fort")
+                    raise
+                finally:
+                    pool.join()
+
+        keys = {task[0] for task in all_tasks}
+        rows = summarize([record for key, record in done.items() if key in keys])
+        if rows:
+            write_csv(rows, self.csv_path)
+        return rows
+
+def load_spec(filename: str) -> Optional[Dict]:
+    try:
+        with open(filename, 'r') as f:
+            return json.load(f)
+    except (OSError, ValueError) as e:
+        print(f"Monte-Carlo: Gitterdatei {filename} nicht ladbar: {e}")
+        return None
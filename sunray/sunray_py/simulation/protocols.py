@@ -0,0 +1,180 @@
+"""
+Leitungsprotokolle des Simulators: Pico (ASCII über UART) und GNSS (UBX/NMEA).
+
+Pico – angenommene Befehle (Zeilen mit \\n):
+  AT+MOTOR,left,right,mow   (hardware_manager.set_motor_pwm)
+  AT+M,right,left,mow       (Firmware-Format, Antwort M,...)
+  AT+S[,state]              Antwort S,batV,chgV,chgI,lift,bumper,rain,overload,mowI,leftI,rightI,temp,stop
+  AT+STOP, AT+V, AT+BUZZER,..., AT+LED,...
+Zusätzlich sendet PicoProtocol.odometry_line() periodisch
+  AT+S:odom_right,odom_left,odom_mow,chg_voltage,,bumper,lift,stopButton
+wie es main.process_pico_data() und HardwareManager erwarten. Antworten der
+Firmware-Befehle tragen wie cmdAnswer() eine Prüfsumme (hex(Summe % 256)) am Ende.
+Ohne Motorbefehl für motor_timeout Sekunden hält der Pico die Motoren an.
+
+GNSS – UBX NAV-PVT (92 Byte Nutzdaten, Fletcher-Prüfsumme) wie ihn RTKGPS über
+pyubx2 liest, optional NMEA GGA (XOR-Prüfsumme) als Fallback-Zeile.
+"""
+
+import struct
+import time
+from typing import Dict, List, Optional
+
+# ---------------------------------------------------------------------------
+# Pico
+# ---------------------------------------------------------------------------
+
+def pico_crc(line: str) -> str:
+    """Prüfsumme der Pico-Firmware (cmdAnswer): hex(Summe der Zeichen % 256)."""
+    return hex(sum(line.encode('ascii', errors='ignore')) % 256)
+
+class PicoProtocol:
+    """Befehlsverarbeitung des Pico gegen ein MowerModel."""
+    VERSION = 'Sunray-Sim,1.0'
+
+    def __init__(self, mower, motor_timeout: float = 3.0):
+        self.mower = mower
+        self.motor_timeout = motor_timeout
+        self.motor_deadline = 0.0
+        self.sunray_state = 0
+        self.commands = 0
+        self.unknown = 0
+        self.leds: Dict[int, int] = {}
+        self.buzzer: Optional[tuple] = None
+
+    def handle(self, line: str, now: float) -> List[str]:
+        """Verarbeitet eine Befehlszeile; now ist die Simulationszeit. Gibt Antwortzeilen zurück."""
+        line = line.strip()
+        if not line:
+            return []
+        self.commands += 1
+        parts = line.split(',')
+        command = parts[0]
+        try:
+            if command == 'AT+MOTOR' and len(parts) >= 4:
+                self.mower.set_pwm(int(parts[1]), int(parts[2]), int(parts[3]))
+                self.motor_deadline = now + self.motor_timeout
+                return []
+            if command == 'AT+M' and len(parts) >= 4:
+                self.mower.set_pwm(int(parts[2]), int(parts[1]), int(parts[3]))
+                self.motor_deadline = now + self.motor_timeout
+                return [self._answer(self.motor_line())]
+            if command == 'AT+S':
+                if len(parts) > 1 and parts[1].strip().isdigit():
+                    self.sunray_state = int(parts[1])
+                return [self._answer(self.summary_line())]
+            if command == 'AT+STOP':
+                self.mower.set_pwm(0, 0, 0)
+                return []
+            if command == 'AT+V':
+                return [self._answer(f'V,{self.VERSION}')]
+            if command == 'AT+BUZZER' and len(parts) >= 3:
+                self.buzzer = (int(parts[1]), int(parts[2]))
+                return []
+            if command == 'AT+LED' and len(parts) >= 3:
+                self.leds[int(parts[1])] = int(parts[2])
+                return []
+        except ValueError:
+            print(f"Simulator: Ungültiger Pico-Befehl: {line}")
+            return []
+        self.unknown += 1
+        return []
+
+    def check_timeout(self, now: float) -> None:
+        """Motor-Timeout der Firmware: ohne neuen Befehl stehen die Motoren."""
+        mower = self.mower
+        if now > self.motor_deadline and (mower.pwm_left or mower.pwm_right or mower.pwm_mow):
+            mower.set_pwm(0, 0, 0)
+
+    def _answer(self, line: str) -> str:
+        return f'{line},{pico_crc(line)}'
+
+    def odometry_line(self) -> str:
+        m = self.mower
+        left, right, mow = m.odometry()
+        return (f'AT+S:{right},{left},{mow},{m.charger_voltage:.2f},,'
+                f'{m.bumper_mask},{int(m.lift)},{int(m.stop_button)}')
+
+    def motor_line(self) -> str:
+        m = self.mower
+        left, right, mow = m.odometry()
+        return (f'M,{right},{left},{mow},{m.charger_voltage:.2f},'
+                f'{m.bumper_mask},{int(m.lift)},{int(m.stop_button)}')
+
+    def summary_line(self) -> str:
+        m = self.mower
+        overload = int(max(m.current_left, m.current_right) > 3.0 or m.current_mow > 4.0)
+        return (f'S,{m.bat_voltage:.2f},{m.charger_voltage:.2f},{m.charger_current:.2f},'
+                f'{int(m.lift)},{m.bumper_mask},{int(m.raining)},{overload},'
+                f'{m.current_mow:.2f},{m.current_left:.2f},{m.current_right:.2f},'
+                f'{m.params["battery_temp"]:.1f},{int(m.stop_button)}')
+
+# ---------------------------------------------------------------------------
+# GNSS
+# ---------------------------------------------------------------------------
+
+_NAV_PVT = struct.Struct('<IHBBBBBBIiBBBBiiiiIIiiiiiIIHH4xihH')
+
+def ubx_frame(msg_class: int, msg_id: int, payload: bytes) -> bytes:
+    """UBX-Rahmen mit Sync-Bytes, Länge und Fletcher-8-Prüfsumme."""
+    body = struct.pack('<BBH', msg_class, msg_id, len(payload)) + payload
+    ck_a = ck_b = 0
+    for byte in body:
+        ck_a = (ck_a + byte) & 0xFF
+        ck_b = (ck_b + ck_a) & 0xFF
+    return b'\xb5\x62' + body + bytes((ck_a, ck_b))
+
+def nav_pvt(sample: Dict, sim_time: float, epoch: float = 0.0) -> bytes:
+    """NAV-PVT aus einer GnssModel-Messung; epoch ist die Unix-Zeit bei sim_time 0."""
+    now = epoch + sim_time
+    t = time.gmtime(now)
+    itow = int(((t.tm_wday + 1) % 7 * 86400 + t.tm_hour * 3600 + t.tm_min * 60 + t.tm_sec) * 1000
+               + (now % 1.0) * 1000)
+    fix_type = sample['fix_type']
+    flags = (1 if fix_type >= 2 else 0) | (sample['carr_soln'] << 6)
+    h_acc = int(sample['h_acc'] * 1000)
+    payload = _NAV_PVT.pack(
+        itow, t.tm_year, t.tm_mon, t.tm_mday, t.tm_hour, t.tm_min, t.tm_sec, 0x07,
+        50, int((now % 1.0) * 1e9), fix_type, flags, 0xE0, sample['num_sv'],
+        int(round(sample['lon'] * 1e7)), int(round(sample['lat'] * 1e7)),
+        int(sample['alt'] * 1000), int(sample['alt'] * 1000), h_acc, h_acc * 2,
+        int(sample['vel_n'] * 1000), int(sample['vel_e'] * 1000), 0,
+        int(sample['speed'] * 1000), int(sample['course'] * 1e5), 50, 100000,
+        120 if fix_type else 9999, 0, 0, 0, 0)
+    return ubx_frame(0x01, 0x07, payload)
+
+def decode_nav_pvt(frame: bytes) -> Optional[Dict]:
+    """Gegenstück zu nav_pvt() für Tests und Werkzeuge (ohne pyubx2)."""
+    if len(frame) != 100 or frame[:2] != b'\xb5\x62' or frame[2:4] != b'\x01\x07':
+        return None
+    if ubx_frame(0x01, 0x07, frame[6:98]) != frame:
+        return None
+    fields = _NAV_PVT.unpack(frame[6:98])
+    return {'iTOW': fields[0], 'fixType': fields[10], 'flags': fields[11], 'numSV': fields[13],
+            'lon': fields[14], 'lat': fields[15], 'height': fields[16], 'hAcc': fields[18],
+            'gSpeed': fields[23], 'headMot': fields[24]}
+
+def nmea_checksum(sentence: str) -> str:
+    checksum = 0
+    for char in sentence:
+        checksum ^= ord(char)
+    return f'{checksum:02X}'
+
+def _nmea_angle(value: float, degree_digits: int) -> str:
+    value = abs(value)
+    degrees = int(value)
+    minutes = (value - degrees) * 60.0
+    return f'{degrees:0{degree_digits}d}{minutes:010.7f}'
+
+def nmea_gga(sample: Dict, sim_time: float, epoch: float = 0.0) -> bytes:
+    """GGA-Satz; die Qualität 4/5 kennzeichnet RTK fixed/float wie im NMEA-Fallback von RTKGPS."""
+    now = epoch + sim_time
+    t = time.gmtime(now)
+    stamp = f'{t.tm_hour:02d}{t.tm_min:02d}{t.tm_sec:02d}.{int(now % 1.0 * 100):02d}'
+    lat, lon = sample['lat'], sample['lon']
+    hdop = max(0.5, sample['h_acc'] * 2.0)
+    age = '1.0' if sample['gga_quality'] in (4, 5) else ''
+    body = (f"GPGGA,{stamp},{_nmea_angle(lat, 2)},{'N' if lat >= 0 else 'S'},"
+            f"{_nmea_angle(lon, 3)},{'E' if lon >= 0 else 'W'},{sample['gga_quality']},"
+            f"{sample['num_sv']:02d},{hdop:.1f},{sample['alt']:.3f},M,0.000,M,{age},0000")
+    return f'${body}*{nmea_checksum(body)}\r\n'.encode('ascii')
@@ -0,0 +1,291 @@
+"""
+Simulator an main.py über Pseudo-Terminals.
+
+PtyBridge legt je ein Pseudo-Terminal für den Pico und den GNSS-Empfänger an
+(symbolische Links <directory>/pico und <directory>/gnss) und treibt den
+Simulator in Wanduhrzeit: Befehle von HardwareManager/PicoComm werden gelesen
+und beantwortet, Odometriezeilen und NAV-PVT/GGA werden in der Rate der echten
+Hardware geschrieben. Daten an den GNSS-Port (Board-Konfiguration, RTCM) werden
+gelesen und verworfen. Läuft der Leser nicht, werden Ausgaben wie bei einem
+vollen UART-Puffer verworfen statt zu blockieren.
+
+Der BNO085 hängt am I2C-Bus und lässt sich nicht über ein Pseudo-Terminal
+nachbilden. run_main() stellt deshalb ein Modul 'hardware.imu' bereit, dessen
+IMUSensor aus dem Simulator liest, schreibt eine config.json mit den
+Pseudo-Terminal-Ports und zones.json aus der Welt in ein Arbeitsverzeichnis und
+startet dort das unveränderte main.py.
+
+Schneller als Echtzeit: main.py rechnet mit time.time()/time.sleep(). Mit
+time_scale > 1 ersetzt install_scaled_clock() diese Funktionen prozessweit durch
+eine beschleunigte Uhr, Simulator und Regelschleife laufen dann gemeinsam
+schneller. Timeouts in C-Code (serielle Leseaufrufe, threading-Wartezeiten)
+bleiben in Echtzeit; der erreichbare Faktor hängt davon ab, wie viel Rechenzeit
+ein Regelzyklus braucht.
+"""
+
+import json
+import os
+import runpy
+import sys
+import threading
+import time
+import tty
+import types
+from typing import Callable, Dict, List, Optional
+
+from simulation.simulator import Simulator
+from simulation.world import SimWorld
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+# Echte Uhr, auch nach install_scaled_clock()
+_real_time = time.time
+_real_monotonic = time.monotonic
+_real_sleep = time.sleep
+
+def install_scaled_clock(scale: float) -> None:
+    """Beschleunigt time.time/time.monotonic/time.sleep für den ganzen Prozess."""
+    if scale == 1.0:
+        return
+    wall0 = _real_time()
+    mono0 = _real_monotonic()
+    time.time = lambda: wall0 + (_real_monotonic() - mono0) * scale
+    time.monotonic = lambda: mono0 + (_real_monotonic() - mono0) * scale
+    time.sleep = lambda seconds: _real_sleep(max(0.0, seconds) / scale)
+
+class PtyLink:
+    """Ein Pseudo-Terminal; der Simulator hält die Master-Seite."""
+    def __init__(self, link_path: Optional[str] = None):
+        self.master, self.slave = os.openpty()
+        # Rohmodus: kein Echo, keine Zeilenumsetzung (pyserial setzt das beim Öffnen ebenfalls)
+        tty.setraw(self.slave)
+        os.set_blocking(self.master, False)
+        self.device = os.ttyname(self.slave)
+        self.path = self.device
+        self.link_path = None
+        if link_path:
+            os.makedirs(os.path.dirname(link_path), exist_ok=True)
+            if os.path.islink(link_path):
+                os.unlink(link_path)
+            os.symlink(self.device, link_path)
+            self.path = self.link_path = link_path
+        self._buffer = b''
+        self.bytes_in = 0
+        self.bytes_out = 0
+        self.dropped = 0
+
+    def read(self) -> bytes:
+        chunks = []
+        while True:
+            try:
+                data = os.read(self.master, 4096)
+            except (BlockingIOError, OSError):
+                break
+            if not data:
+                break
+            chunks.append(data)
+        data = b''.join(chunks)
+        self.bytes_in += len(data)
+        return data
+
+    def read_lines(self) -> List[str]:
+        self._buffer += self.read()
+        if b'\n' not in self._buffer:
+            return []
+        *lines, self._buffer = self._buffer.split(b'\n')
+        return [line.decode('ascii', errors='ignore').strip() for line in lines]
+
+    def write(self, data: bytes) -> None:
+        try:
+            written = os.write(self.master, data)
+        except (BlockingIOError, OSError):
+            written = 0
+        self.bytes_out += written
+        self.dropped += len(data) - written
+
+    def close(self) -> None:
+        if self.link_path and os.path.islink(self.link_path):
+            os.unlink(self.link_path)
+        for fd in (self.master, self.slave):
+            try:
+                os.close(fd)
+            except OSError:
+                pass
+
+class PtyBridge:
+    """Treibt einen Simulator in (skalierter) Wanduhrzeit hinter zwei Pseudo-Terminals."""
+    def __init__(self, simulator: Simulator, directory: str = '/tmp/sunray-sim',
+                 time_scale: float = 1.0, poll_interval: float = 0.002):
+        self.simulator = simulator
+        self.time_scale = time_scale
+        self.poll_interval = poll_interval
+        self.pico = PtyLink(os.path.join(directory, 'pico'))
+        self.gnss = PtyLink(os.path.join(directory, 'gnss'))
+        # Schützt den Simulator zwischen Bridge-Thread und IMU-Lesern
+        self.lock = threading.Lock()
+        self.running = False
+        self.thread: Optional[threading.Thread] = None
+        self.lag = 0.0
+        # Mithörer: tap(kind, data, t) mit kind 'command' (Zeile an den Pico), 'pico'
+        # (geschriebene Zeilen) oder 'gnss' (geschriebene Bytes); t in _real_monotonic()
+        self.taps: List[Callable[[str, object, float], None]] = []
+
+    def add_tap(self, tap: Callable[[str, object, float], None]) -> None:
+        self.taps.append(tap)
+
+    def _notify(self, kind: str, data, t: float) -> None:
+        for tap in self.taps:
+            tap(kind, data, t)
+
+    def start(self) -> None:
+        self.running = True
+        self.thread = threading.Thread(target=self._run, name='sim-bridge', daemon=True)
+        self.thread.start()
+        print(f"Simulator: Pico an {self.pico.path}, GNSS an {self.gnss.path}, Zeitfaktor {self.time_scale}")
+
+    def stop(self) -> None:
+        self.running = False
+        if self.thread:
+            self.thread.join(timeout=2.0)
+        self.simulator.close()
+        self.pico.close()
+        self.gnss.close()
+
+    def read_imu(self) -> Dict:
+        with self.lock:
+            return self.simulator.read_imu()
+
+    def _run(self) -> None:
+        sim = self.simulator
+        start = _real_monotonic()
+        # Höchstens 1 s Simulationszeit je Durchlauf nachholen, sonst Verzug melden
+        max_steps = int(1.0 / sim.dt)
+        while self.running:
+            target = (_real_monotonic() - start) * self.time_scale
+            with self.lock:
+                commands = self.pico.read_lines()
+                if commands and self.taps:
+                    self._notify('command', commands, _real_monotonic())
+                for line in commands:
+                    sim.send(line)
+                self.gnss.read()
+                steps = 0
+                while sim.time < target and steps < max_steps:
+                    sim.step()
+                    steps += 1
+                self.lag = max(0.0, target - sim.time)
+                lines = sim.read_pico_lines()
+                gnss = sim.read_gnss()
+            if lines:
+                self.pico.write(''.join(line + '\r\n' for line in lines).encode('ascii'))
+                if self.taps:
+                    self._notify('pico', lines, _real_monotonic())
+            if gnss:
+                self.gnss.write(gnss)
+                if self.taps:
+                    self._notify('gnss', gnss, _real_monotonic())
+            _real_sleep(self.poll_interval)
+
+def install_imu_module(bridge: PtyBridge) -> None:
+    """Ersetzt hardware.imu (BNO085 über I2C) durch einen IMUSensor, der aus dem Simulator liest."""
+    import hardware
+
+    class IMUSensor:
+        def __init__(self, i2c_bus=1, address=0x28):
+            self.calibrated = True
+            self.last_read_time = time.time()
+
+        def read(self) -> dict:
+            self.last_read_time = time.time()
+            return bridge.read_imu()
+
+        def is_tilted(self) -> bool:
+            return bool(bridge.read_imu()['tilt_warning'])
+
+    module = types.ModuleType('hardware.imu')
+    module.__doc__ = 'Simulierter BNO085 (simulation/pty_bridge.py)'
+    module.IMUSensor = IMUSensor
+    sys.modules['hardware.imu'] = module
+    hardware.imu = module
+
+def prepare_workdir(workdir: str, world: SimWorld, bridge: PtyBridge,
+                    base_config: Dict) -> Dict:
+    """Schreibt config.json (Ports auf die Pseudo-Terminals) und zones.json für main.py."""
+    config = json.loads(json.dumps(base_config))
+    hardware = config.setdefault('hardware', {})
+    hardware.setdefault('pico_communication', {})['port'] = bridge.pico.path
+    rtk = hardware.setdefault('rtk_gps', {})
+    rtk['port'] = bridge.gnss.path
+    # Das simulierte Board braucht keine CFG-Nachrichten
+    rtk['auto_configure'] = False
+    os.makedirs(workdir, exist_ok=True)
+    with open(os.path.join(workdir, 'config.json'), 'w') as f:
+        json.dump(config, f, indent=2, ensure_ascii=False)
+    with open(os.path.join(workdir, 'zones.json'), 'w') as f:
+        json.dump(world.zones_file(), f)
+    return config
+
+def robot_config(base_config: Dict, sim_config: Dict) -> Dict:
+    """Roboterparameter: Geometrie aus motor.physical, damit Odometrie und Modell übereinstimmen."""
+    physical = base_config.get('motor', {}).get('physical', {})
+    robot = {key: physical[key] for key in ('ticks_per_meter', 'wheel_base') if key in physical}
+    robot.update(sim_config.get('robot', {}))
+    return robot
+
+def prepare_main(world: Optional[SimWorld] = None, config_path: Optional[str] = None,
+                 workdir: str = 'sim_run', time_scale: Optional[float] = None,
+                 seed: Optional[int] = None, poll_interval: float = 0.002,
+                 firmware: Optional[str] = None) -> PtyBridge:
+    """
+    Simulator, Pseudo-Terminals, Arbeitsverzeichnis und Importpfade für main.py;
+    die Bridge läuft danach, das Arbeitsverzeichnis ist gewechselt.
+    firmware: Pico-Firmware (main.py des Pico) statt des Protokollmodells ausführen.
+    """
+    config_path = config_path or os.path.join(ROOT, 'config.json')
+    workdir = os.path.abspath(workdir)
+    try:
+        with open(config_path, 'r') as f:
+            base_config = json.load(f)
+    except (OSError, ValueError) as e:
+        print(f"Simulator: Konfiguration {config_path} nicht ladbar ({e}), verwende Standardwerte")
+        base_config = {}
+    sim_config = dict(base_config.get('simulation', {}))
+    sim_config['robot'] = robot_config(base_config, sim_config)
+    if firmware:
+        sim_config['pico'] = dict(sim_config.get('pico', {}), firmware=firmware)
+    if world is None and sim_config.get('world'):
+        world = SimWorld.load(sim_config['world'])
+    world = world or SimWorld.default()
+    if time_scale is None:
+        time_scale = sim_config.get('time_scale', 1.0)
+
+    simulator = Simulator(world, sim_config, seed=seed)
+    bridge = PtyBridge(simulator, sim_config.get('directory', '/tmp/sunray-sim'), time_scale,
+                       poll_interval)
+    prepare_workdir(workdir, world, bridge, base_config)
+
+    # Flache Importe wie auf dem Pi (pico_comm, Planer-Module)
+    for path in (ROOT, os.path.join(ROOT, 'communication'), os.path.join(ROOT, 'navigation')):
+        if path not in sys.path:
+            sys.path.insert(0, path)
+    install_imu_module(bridge)
+    install_scaled_clock(time_scale)
+    bridge.start()
+    os.chdir(workdir)
+    return bridge
+
+def exec_main() -> None:
+    """Führt main.py im aktuellen Prozess aus (kehrt nach KeyboardInterrupt zurück)."""
+    sys.argv = [os.path.join(ROOT, 'main.py')]
+    runpy.run_path(os.path.join(ROOT, 'main.py'), run_name='__main__')
+
+def run_main(world: Optional[SimWorld] = None, config_path: Optional[str] = None,
+             workdir: str = 'sim_run', time_scale: Optional[float] = None,
+             seed: Optional[int] = None, firmware: Optional[str] = None) -> None:
+    """Startet das unveränderte main.py gegen den Simulator."""
+    bridge = prepare_main(world, config_path, workdir, time_scale, seed, firmware=firmware)
+    try:
+        exec_main()
+    finally:
+        bridge.stop()
+        print(f"Simulator: {json.dumps(bridge.simulator.get_statistics())}")
@@ -0,0 +1,214 @@
+"""
+Physikmodell des simulierten Mähroboters.
+
+Differentialantrieb mit PWM-Eingängen wie am Pico (-255..255, Mähmotor 0..255):
+- Radgeschwindigkeit folgt der PWM-Vorgabe mit einer Zeitkonstante (Motorträgheit),
+- Encoder zählen die Radumdrehung; Schlupf verringert nur die Bewegung über Grund,
+  Odometrie und GPS laufen dadurch wie am echten Roboter auseinander,
+- Bumper-Kontakt gegen Hindernisse und Zaun der SimWorld: der Roboter bleibt stehen,
+  die Räder drehen weiter durch (Blockierstrom, Encoder zählen weiter),
+- Akku mit Ladezustand, Leerlaufspannung über SoC und Innenwiderstand; an der
+  Ladestation wird geladen.
+
+Parameter (Sektion 'simulation.robot', Standardwerte in DEFAULTS); ticks_per_meter
+und wheel_base stimmen mit motor.physical überein, damit die Odometrie passt.
+"""
+
+import math
+import random
+from typing import Dict, Optional
+
+from simulation.world import SimWorld
+
+DEFAULTS = {
+    'wheel_base': 0.3,            # m (motor.physical.wheel_base)
+    'ticks_per_meter': 1000.0,    # (motor.physical.ticks_per_meter)
+    'max_wheel_speed': 0.6,       # m/s bei PWM 255
+    'motor_time_constant': 0.15,  # s
+    'slip': 0.03,                 # mittlerer Schlupf (Anteil)
+    'slip_noise': 0.02,
+    'radius': 0.25,               # m, Kollisionskreis
+    'mow_ticks_per_second': 300.0,  # Mähmotor-Ticks bei PWM 255
+    'battery_capacity_ah': 5.0,
+    'battery_soc': 1.0,
+    'battery_empty_voltage': 21.0,
+    'battery_full_voltage': 29.4,
+    'internal_resistance': 0.15,  # Ohm
+    'idle_current': 0.4,          # A, Elektronik
+    'drive_current': 1.0,         # A je Rad bei voller Geschwindigkeit
+    'stall_current': 2.5,         # A je Rad, blockiert
+    'mow_current': 1.5,           # A Mähmotor bei PWM 255 ohne Grasbelastung
+    'grass_load': 0.5,            # zusätzliche Mähmotorlast im Mähbereich (Anteil)
+    'charge_current': 2.0,        # A an der Ladestation
+    'charge_voltage': 29.4,
+    'dock_radius': 0.3,           # m
+    'battery_temp': 25.0,
+}
+
+class MowerModel:
+    """Zustand und Physikschritt des Roboters (lokale Meter, heading in rad, CCW ab x)."""
+    def __init__(self, world: SimWorld, config: Optional[Dict] = None, rng: Optional[random.Random] = None):
+        params = dict(DEFAULTS)
+        params.update(config or {})
+        self.params = params
+        self.world = world
+        self.rng = rng or random.Random()
+
+        self.wheel_base = params['wheel_base']
+        self.ticks_per_meter = params['ticks_per_meter']
+        self.max_wheel_speed = params['max_wheel_speed']
+        self.tau = params['motor_time_constant']
+        self.radius = params['radius']
+
+        # Pose und Radzustand
+        self.x, self.y, self.heading = world.dock
+        self.v_left = 0.0
+        self.v_right = 0.0
+        self.v = 0.0
+        self.omega = 0.0
+        self.accel = 0.0
+        # PWM-Vorgaben
+        self.pwm_left = 0
+        self.pwm_right = 0
+        self.pwm_mow = 0
+        # Encoder (Bruchteile werden mitgeführt, gemeldet wird der ganzzahlige Anteil)
+        self.ticks_left = 0.0
+        self.ticks_right = 0.0
+        self.ticks_mow = 0.0
+        # Sensoren/Zustand für das Pico-Protokoll
+        self.bumper = False
+        self.bumper_mask = 0  # wie Firmware: Bit 0 links, Bit 1 rechts
+        self.lift = False
+        self.raining = False
+        self.stop_button = False
+        self.soc = params['battery_soc']
+        self.current_left = 0.0
+        self.current_right = 0.0
+        self.current_mow = 0.0
+        self.charging = False
+        self.bat_voltage = self._terminal_voltage(0.0)
+        # Statistik
+        self.distance = 0.0
+        self.energy_wh = 0.0
+        self.bumper_contacts = 0
+
+    def set_pwm(self, left: int, right: int, mow: int) -> None:
+        self.pwm_left = max(-255, min(255, int(left)))
+        self.pwm_right = max(-255, min(255, int(right)))
+        self.pwm_mow = max(0, min(255, int(mow)))
+
+    def place(self, x: float, y: float, heading: float) -> None:
+        """Setzt die Pose (z.B. Kidnap-Szenario); Encoder bleiben unverändert."""
+        self.x, self.y, self.heading = x, y, heading
+        self.bumper = False
+        self.bumper_mask = 0
+
+    def step(self, dt: float) -> None:
+        p = self.params
+        rng = self.rng
+
+        # Motorträgheit: erste Ordnung zur PWM-Vorgabe
+        alpha = dt / self.tau if dt < self.tau else 1.0
+        scale = self.max_wheel_speed / 255.0
+        target_left = self.pwm_left * scale
+        target_right = self.pwm_right * scale
+        v_left = self.v_left + (target_left - self.v_left) * alpha
+        v_right = self.v_right + (target_right - self.v_right) * alpha
+        self.v_left, self.v_right = v_left, v_right
+
+        # Encoder messen die Radumdrehung
+        tpm = self.ticks_per_meter * dt
+        self.ticks_left += v_left * tpm
+        self.ticks_right += v_right * tpm
+        self.ticks_mow += self.pwm_mow / 255.0 * p['mow_ticks_per_second'] * dt
+
+        # Schlupf je Rad, Bewegung über Grund
+        slip_left = 1.0 - max(0.0, p['slip'] + rng.gauss(0.0, p['slip_noise']))
+        slip_right = 1.0 - max(0.0, p['slip'] + rng.gauss(0.0, p['slip_noise']))
+        ground_left = v_left * slip_left
+        ground_right = v_right * slip_right
+        v = (ground_left + ground_right) * 0.5
+        omega = (ground_right - ground_left) / self.wheel_base
+
+        heading = self.heading + omega * dt * 0.5
+        nx = self.x + v * math.cos(heading) * dt
+        ny = self.y + v * math.sin(heading) * dt
+        blocked = v != 0.0 and self.world.collides(nx, ny, self.radius)
+        if blocked:
+            if not self.bumper:
+                self.bumper_contacts += 1
+                self.bumper_mask = self._contact_side(v)
+            self.bumper = True
+            # Drehen auf der Stelle bleibt möglich, Fahrt in das Hindernis nicht
+            v = 0.0
+        else:
+            self.distance += abs(v) * dt
+            self.x, self.y = nx, ny
+            # Bumper löst erst, wenn sich der Roboter vom Hindernis entfernt hat
+            if self.bumper and not self.world.collides(nx, ny, self.radius + 0.02):
+                self.bumper = False
+                self.bumper_mask = 0
+        self.heading = (self.heading + omega * dt + math.pi) % (2.0 * math.pi) - math.pi
+        self.accel = (v - self.v) / dt
+        self.v = v
+        self.omega = omega
+
+        # Motorströme: Fahrlast, Blockierstrom, Grasbelastung am Mähmotor
+        drive = p['drive_current']
+        self.current_left = drive * abs(v_left) / self.max_wheel_speed
+        self.current_right = drive * abs(v_right) / self.max_wheel_speed
+        if blocked:
+            stall = p['stall_current']
+            self.current_left += stall * abs(self.pwm_left) / 255.0
+            self.current_right += stall * abs(self.pwm_right) / 255.0
+        mow = 0.0
+        if self.pwm_mow:
+            load = 1.0 + (p['grass_load'] if self.world.in_mow_zone(self.x, self.y) else 0.0)
+            mow = p['mow_current'] * self.pwm_mow / 255.0 * load * (1.0 + rng.gauss(0.0, 0.05))
+        self.current_mow = max(0.0, mow)
+        self._battery_step(dt)
+
+    def _contact_side(self, v: float) -> int:
+        """Bumper-Bitmaske aus Prüfpunkten schräg links/rechts vor (bzw. hinter) dem Roboter."""
+        reach = self.radius * 1.2 * (1.0 if v > 0 else -1.0)
+        mask = 0
+        for bit, angle in ((1, 0.6), (2, -0.6)):
+            px = self.x + reach * math.cos(self.heading + angle)
+            py = self.y + reach * math.sin(self.heading + angle)
+            if self.world.collides(px, py, 0.05):
+                mask |= bit
+        return mask or 3
+
+    def _battery_step(self, dt: float) -> None:
+        p = self.params
+        dock_x, dock_y, _ = self.world.dock
+        dx, dy = self.x - dock_x, self.y - dock_y
+        self.charging = dx * dx + dy * dy <= p['dock_radius'] ** 2 and self.soc < 1.0
+        load = p['idle_current'] + self.current_left + self.current_right + self.current_mow
+        net = load - (p['charge_current'] if self.charging else 0.0)
+        self.soc = max(0.0, min(1.0, self.soc - net * dt / 3600.0 / p['battery_capacity_ah']))
+        self.bat_voltage = self._terminal_voltage(net)
+        self.energy_wh += load * self.bat_voltage * dt / 3600.0
+
+    def _terminal_voltage(self, current: float) -> float:
+        """Leerlaufspannung (linear mit steilerem Abfall unter 10 % SoC) minus I·R."""
+        p = self.params
+        empty, full = p['battery_empty_voltage'], p['battery_full_voltage']
+        soc = self.soc
+        if soc < 0.1:
+            ocv = empty + (full - empty) * 0.3 * soc / 0.1
+        else:
+            ocv = empty + (full - empty) * (0.3 + 0.7 * (soc - 0.1) / 0.9)
+        return ocv - current * p['internal_resistance']
+
+    @property
+    def charger_voltage(self) -> float:
+        return self.params['charge_voltage'] if self.charging else 0.0
+
+    @property
+    def charger_current(self) -> float:
+        return self.params['charge_current'] if self.charging else 0.0
+
+    def odometry(self):
+        """Ganzzahlige Encoderstände (links, rechts, Mähmotor)."""
+        return int(self.ticks_left), int(self.ticks_right), int(self.ticks_mow)
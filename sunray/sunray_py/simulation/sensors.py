@@ -0,0 +1,136 @@
+"""
+Sensormodelle des Simulators: IMU (BNO085) und RTK-GNSS.
+
+ImuModel liefert dasselbe Dictionary wie hardware/imu.py IMUSensor.read():
+Gierrate mit Rauschen und langsam driftendem Bias, daraus integrierter Kurs
+(wie die Sensorfusion des BNO085 ohne Magnetometerstützung), Beschleunigung aus
+der Bewegung plus Rauschen, Nick/Roll als kleines Rauschen.
+
+GnssModel erzeugt Positionen mit der Qualität der RTK-Zone, in der der Roboter
+steht (SimWorld.fix_quality): fixed ~2 cm, float ~25 cm mit langsamer Wanderung,
+3D ~1,5 m, none ohne Fix. Die lokale Position wird mit derselben Projektion
+wie RTKGPS.from_local_coordinates in Breite/Länge umgerechnet.
+"""
+
+import math
+import random
+from typing import Dict, Optional
+
+from simulation.world import FIX_QUALITIES
+
+EARTH_RADIUS = 6371000  # wie rtk_gps.py
+
+IMU_DEFAULTS = {
+    'gyro_noise': 0.01,         # rad/s
+    'gyro_bias_walk': 0.0005,   # rad/s je √s
+    'accel_noise': 0.05,        # m/s²
+    'tilt_noise': 0.3,          # Grad
+}
+
+GNSS_DEFAULTS = {
+    'rate': 5.0,                # Hz (NAV-PVT)
+    'h_acc': {'fixed': 0.02, 'float': 0.25, '3d': 1.5, 'none': 10.0},
+    'num_sv': {'fixed': 28, 'float': 20, '3d': 12, 'none': 3},
+    # s, Korrelationszeit des Positionsfehlers (kurz im Fix: der Fehler fällt sofort auf cm)
+    'wander_time_constant': {'fixed': 1.0, 'float': 20.0, '3d': 30.0, 'none': 30.0},
+    'altitude': 40.0,
+}
+
+def euler_to_quaternion(yaw: float, pitch: float, roll: float):
+    """Euler-Winkel (rad) als Quaternion (w, x, y, z), Umkehrung von IMUSensor._quaternion_to_euler."""
+    cy, sy = math.cos(yaw * 0.5), math.sin(yaw * 0.5)
+    cp, sp = math.cos(pitch * 0.5), math.sin(pitch * 0.5)
+    cr, sr = math.cos(roll * 0.5), math.sin(roll * 0.5)
+    return (cr * cp * cy + sr * sp * sy,
+            sr * cp * cy - cr * sp * sy,
+            cr * sp * cy + sr * cp * sy,
+            cr * cp * sy - sr * sp * cy)
+
+class ImuModel:
+    """Verrauschte IMU-Messungen aus dem Physikmodell."""
+    def __init__(self, mower, config: Optional[Dict] = None, rng: Optional[random.Random] = None):
+        params = dict(IMU_DEFAULTS)
+        params.update(config or {})
+        self.params = params
+        self.mower = mower
+        self.rng = rng or random.Random()
+        self.bias = 0.0
+        self.yaw = mower.heading
+        self.gyro_z = 0.0
+
+    def step(self, dt: float) -> None:
+        """Integriert die gemessene Gierrate (Kursdrift wie am echten Sensor)."""
+        rng = self.rng
+        self.bias += rng.gauss(0.0, self.params['gyro_bias_walk']) * math.sqrt(dt)
+        self.gyro_z = self.mower.omega + self.bias + rng.gauss(0.0, self.params['gyro_noise'])
+        self.yaw = (self.yaw + self.gyro_z * dt + math.pi) % (2.0 * math.pi) - math.pi
+
+    def read(self) -> Dict:
+        rng = self.rng
+        mower = self.mower
+        noise = self.params['accel_noise']
+        tilt = self.params['tilt_noise']
+        pitch = rng.gauss(0.0, tilt)
+        roll = rng.gauss(0.0, tilt)
+        yaw = math.degrees(self.yaw)
+        euler = (yaw, pitch, roll)
+        quat = euler_to_quaternion(self.yaw, math.radians(pitch), math.radians(roll))
+        return {
+            'acceleration': (mower.accel + rng.gauss(0.0, noise),
+                             mower.v * mower.omega + rng.gauss(0.0, noise),
+                             9.81 + rng.gauss(0.0, noise)),
+            'gyro': (rng.gauss(0.0, 0.005), rng.gauss(0.0, 0.005), self.gyro_z),
+            'magnetic': (20.0 * math.cos(self.yaw), -20.0 * math.sin(self.yaw), -40.0),
+            'euler': euler,
+            'quaternion': quat,
+            'heading': yaw,
+            'tilt_warning': abs(pitch) > 35 or abs(roll) > 35,
+        }
+
+class GnssModel:
+    """RTK-Empfänger: Fix-Qualität je Zone, korreliertes Positionsrauschen."""
+    def __init__(self, mower, world, config: Optional[Dict] = None, rng: Optional[random.Random] = None):
+        params = dict(GNSS_DEFAULTS)
+        params.update(config or {})
+        self.params = params
+        self.mower = mower
+        self.world = world
+        self.rng = rng or random.Random()
+        self.origin_lat, self.origin_lon = world.origin
+        self._cos_lat = math.cos(math.radians(self.origin_lat))
+        self.err_x = 0.0
+        self.err_y = 0.0
+        self.fix = 'fixed'
+        # Erzwungene Fix-Qualität unabhängig von der Zone (Simulator.inject('rtk_loss'))
+        self.forced_fix: Optional[str] = None
+
+    def to_lat_lon(self, x: float, y: float):
+        lat = self.origin_lat + math.degrees(y / EARTH_RADIUS)
+        lon = self.origin_lon + math.degrees(x / (EARTH_RADIUS * self._cos_lat))
+        return lat, lon
+
+    def sample(self, dt: float) -> Dict:
+        """Eine Messung; dt ist der Abstand zur vorherigen (für die Fehlerkorrelation)."""
+        mower = self.mower
+        fix, h_acc = self.world.fix_quality(mower.x, mower.y)
+        if self.forced_fix:
+            fix, h_acc = self.forced_fix, None
+        if h_acc is None:
+            h_acc = self.params['h_acc'][fix]
+        # Gauß-Markov-Fehler: springt nicht, sondern wandert wie ein echter Float-Fix
+        decay = math.exp(-dt / self.params['wander_time_constant'][fix])
+        sigma = h_acc * math.sqrt(1.0 - decay * decay)
+        self.err_x = self.err_x * decay + self.rng.gauss(0.0, sigma)
+        self.err_y = self.err_y * decay + self.rng.gauss(0.0, sigma)
+        self.fix = fix
+        x = mower.x + self.err_x
+        y = mower.y + self.err_y
+        lat, lon = self.to_lat_lon(x, y)
+        gga_quality, fix_type, carr_soln = FIX_QUALITIES[fix]
+        return {
+            'lat': lat, 'lon': lon, 'alt': self.params['altitude'],
+            'fix': fix, 'fix_type': fix_type, 'gga_quality': gga_quality, 'carr_soln': carr_soln,
+            'h_acc': h_acc, 'num_sv': self.params['num_sv'][fix],
+            'speed': abs(mower.v), 'course': (90.0 - math.degrees(mower.heading)) % 360.0,
+            'vel_n': mower.v * math.sin(mower.heading), 'vel_e': mower.v * math.cos(mower.heading),
+        }
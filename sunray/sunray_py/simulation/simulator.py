@@ -0,0 +1,226 @@
+"""
+Headless-Simulator: Physik, Sensoren und Pico/GNSS-Protokoll in Simulationszeit.
+
+Simulator.step() rückt die Simulationszeit um dt (Standard 10 ms) vor und erzeugt
+die Ausgaben des Pico (AT+S:-Odometriezeilen, Antworten auf Befehle) und des
+GNSS-Empfängers (NAV-PVT, optional GGA) in den Raten der echten Hardware. Ohne
+Wanduhr läuft die Simulation so schnell wie die CPU erlaubt; auf einem Kern ein
+Vielfaches der Echtzeit (siehe Simulator.benchmark()).
+
+Verwendung (ohne main.py, z.B. für Tests oder Parameterstudien):
+  sim = Simulator(SimWorld.default(), seed=1)
+  sim.send('AT+MOTOR,120,120,200')
+  sim.run(10.0, controller=lambda s: s.send('AT+MOTOR,120,120,200'), control_interval=0.5)
+  lines = sim.read_pico_lines()
+
+Fehlerfälle lassen sich unabhängig von der Welt einschalten (inject/clear), z.B.
+für Reaktionszeitmessungen: bumper, lift, stop_button, overload, rtk_loss.
+
+Mit main.py über Pseudo-Terminals: siehe simulation/pty_bridge.py. Statt des
+Protokollmodells kann die echte Pico-Firmware laufen (pico.firmware, siehe
+simulation/firmware.py); close() beendet dann ihre Threads.
+"""
+
+import random
+import time
+from collections import deque
+from typing import Callable, Dict, List, Optional
+
+from simulation.world import SimWorld
+from simulation.robot import MowerModel
+from simulation.sensors import ImuModel, GnssModel
+from simulation.protocols import PicoProtocol, nav_pvt, nmea_gga
+
+FAULTS = ('bumper', 'lift', 'stop_button', 'overload', 'rtk_loss')
+
+# A je Antriebsmotor, über der Überlastschwelle der Firmware (3 A)
+OVERLOAD_CURRENT = 3.5
+
+class Simulator:
+    """Roboter in einer SimWorld mit Protokollausgaben in Simulationszeit."""
+    def __init__(self, world: Optional[SimWorld] = None, config: Optional[Dict] = None,
+                 seed: Optional[int] = None):
+        config = config or {}
+        self.config = config
+        self.world = world or SimWorld.default()
+        self.rng = random.Random(seed)
+        self.dt = config.get('dt', 0.01)
+        self.mower = MowerModel(self.world, config.get('robot'), self.rng)
+        self.imu = ImuModel(self.mower, config.get('imu'), self.rng)
+        self.gnss = GnssModel(self.mower, self.world, config.get('gnss'), self.rng)
+        pico_config = config.get('pico', {})
+        # Mit pico.firmware läuft die echte Firmware (simulation/firmware.py) statt PicoProtocol
+        self.firmware = pico_config.get('firmware')
+        if self.firmware:
+            from simulation.firmware import FirmwarePico
+            self.pico = FirmwarePico(self.mower, self.firmware, pico_config)
+        else:
+            self.pico = PicoProtocol(self.mower, pico_config.get('motor_timeout', 3.0))
+        # Unix-Zeit bei Simulationszeit 0 (für GNSS-Zeitstempel)
+        self.epoch = config.get('epoch', time.time())
+        self.time = 0.0
+        self.steps = 0
+
+        self.odometry_interval = 1.0 / pico_config.get('odometry_rate', 20.0)
+        self.gnss_interval = 1.0 / self.gnss.params['rate']
+        self.nmea = config.get('gnss', {}).get('nmea', True)
+        self._next_odometry = 0.0
+        self._next_gnss = 0.0
+        self._last_gnss = 0.0
+        self.last_gnss: Optional[Dict] = None
+        # Wie ein UART-Puffer: ohne Leser gehen die ältesten Zeilen verloren
+        buffer = config.get('output_buffer', 1000)
+        self._pico_out: deque = deque(maxlen=buffer)
+        self._gnss_out: deque = deque(maxlen=buffer)
+        self.fix_time = {'fixed': 0.0, 'float': 0.0, '3d': 0.0, 'none': 0.0}
+        self.faults: Dict[str, object] = {}
+
+    # -- Eingänge -----------------------------------------------------------
+
+    def send(self, line: str) -> List[str]:
+        """Befehlszeile an den simulierten Pico; Antworten werden auch in die Ausgabe gestellt."""
+        responses = self.pico.handle(line, self.time)
+        self._pico_out.extend(responses)
+        return responses
+
+    def inject(self, fault: str, value=True) -> bool:
+        """
+        Schaltet einen Fehlerfall ein, bis clear() ihn aufhebt:
+          bumper (Bitmaske, Standard 3), lift, stop_button, overload (Motorstrom
+          über der Schwelle), rtk_loss (Fix-Qualität, Standard '3d').
+        """
+        if fault not in FAULTS:
+            print(f"Simulator: Unbekannter Fehlerfall '{fault}'")
+            return False
+        if fault == 'bumper' and value is True:
+            value = 3
+        if fault == 'rtk_loss':
+            self.gnss.forced_fix = value if isinstance(value, str) else '3d'
+        self.faults[fault] = value
+        self._apply_faults()
+        return True
+
+    def clear(self, fault: str) -> None:
+        if self.faults.pop(fault, None) is None:
+            return
+        mower = self.mower
+        if fault == 'bumper':
+            # Ein echter Hindernis-Kontakt wird im nächsten Schritt neu erkannt
+            mower.bumper = False
+            mower.bumper_mask = 0
+        elif fault == 'lift':
+            mower.lift = False
+        elif fault == 'stop_button':
+            mower.stop_button = False
+        elif fault == 'rtk_loss':
+            self.gnss.forced_fix = None
+
+    def _apply_faults(self) -> None:
+        faults = self.faults
+        mower = self.mower
+        if 'bumper' in faults:
+            mower.bumper = True
+            mower.bumper_mask = int(faults['bumper'])
+        if 'lift' in faults:
+            mower.lift = True
+        if 'stop_button' in faults:
+            mower.stop_button = True
+        if 'overload' in faults:
+            mower.current_left = max(mower.current_left, OVERLOAD_CURRENT)
+            mower.current_right = max(mower.current_right, OVERLOAD_CURRENT)
+
+    # -- Zeit ---------------------------------------------------------------
+
+    def step(self) -> None:
+        dt = self.dt
+        self.pico.check_timeout(self.time)
+        self.mower.step(dt)
+        if self.faults:
+            self._apply_faults()
+        self.imu.step(dt)
+        self.time += dt
+        self.steps += 1
+        now = self.time
+        if self.firmware:
+            self._pico_out.extend(self.pico.read_lines())
+        elif now >= self._next_odometry:
+            self._next_odometry += self.odometry_interval
+            self._pico_out.append(self.pico.odometry_line())
+        if now >= self._next_gnss:
+            self._next_gnss += self.gnss_interval
+            sample = self.gnss.sample(now - self._last_gnss)
+            self._last_gnss = now
+            self.last_gnss = sample
+            self.fix_time[sample['fix']] += self.gnss_interval
+            self._gnss_out.append(nav_pvt(sample, now, self.epoch))
+            if self.nmea:
+                self._gnss_out.append(nmea_gga(sample, now, self.epoch))
+
+    def run(self, duration: float, controller: Optional[Callable[['Simulator'], None]] = None,
+            control_interval: float = 0.02) -> None:
+        """
+        Simuliert duration Sekunden. controller(sim) wird alle control_interval
+        Sekunden Simulationszeit aufgerufen (z.B. eine Regelschleife, die Befehle sendet).
+        """
+        end = self.time + duration
+        next_control = self.time
+        step = self.step
+        while self.time < end:
+            if controller is not None and self.time >= next_control:
+                next_control += control_interval
+                controller(self)
+            step()
+
+    def close(self) -> None:
+        """Beendet die Threads der Firmware (nur mit pico.firmware)."""
+        if self.firmware:
+            self.pico.stop()
+
+    # -- Ausgänge -----------------------------------------------------------
+
+    def read_pico_lines(self) -> List[str]:
+        lines = list(self._pico_out)
+        self._pico_out.clear()
+        return lines
+
+    def read_gnss(self) -> bytes:
+        data = b''.join(self._gnss_out)
+        self._gnss_out.clear()
+        return data
+
+    def read_imu(self) -> Dict:
+        return self.imu.read()
+
+    def get_statistics(self) -> Dict:
+        m = self.mower
+        return {
+            'sim_time': self.time,
+            'steps': self.steps,
+            'pose': {'x': m.x, 'y': m.y, 'heading': m.heading},
+            'distance': m.distance,
+            'bumper_contacts': m.bumper_contacts,
+            'battery_soc': m.soc,
+            'battery_voltage': m.bat_voltage,
+            'energy_wh': m.energy_wh,
+            'fix_time': dict(self.fix_time),
+            'pico_commands': self.pico.commands,
+        }
+
+    @staticmethod
+    def benchmark(duration: float = 600.0, seed: int = 1) -> Dict:
+        """Misst den Faktor gegenüber Echtzeit (Fahrt in Kurven mit Mähmotor, alle Ausgaben)."""
+        sim = Simulator(seed=seed)
+        turn = [0]
+
+        def controller(s):
+            turn[0] += 1
+            right = 160 if (turn[0] // 20) % 2 else 110
+            s.send(f'AT+MOTOR,140,{right},200')
+            s.read_pico_lines()
+            s.read_gnss()
+
+        start = time.perf_counter()
+        sim.run(duration, controller, control_interval=0.1)
+        elapsed = time.perf_counter() - start
+        return {'sim_time': sim.time, 'wall_time': elapsed, 'speedup': sim.time / elapsed,
+                'steps_per_second': sim.steps / elapsed}
@@ -0,0 +1,296 @@
+"""
+Dauerlauf (Soak-Test) von main.py mit Überwachung des Speicherwachstums.
+
+main.py läuft beschleunigt (install_scaled_clock) gegen den Simulator, Standard
+8 Stunden Simulationszeit. In regelmäßigen Abständen Simulationszeit nimmt
+SoakMonitor eine Probe:
+  - RSS des Prozesses (/proc/self/statm),
+  - von tracemalloc verfolgter Python-Heap,
+  - Anzahl Objekte je Typ (gc.get_objects, nur vom GC verfolgte Objekte),
+  - Dauer der Regelzyklen seit der letzten Probe (P50/P99/max aus utils/trace.Tick).
+Nach der Einschwingzeit wird je Größe eine Ausgleichsgerade über die
+Simulationszeit gelegt. Steigungen über den Schwellen gelten als Fehler; für
+Heap- und Objektwachstum nennt der Bericht die Aufrufstellen mit dem größten
+Zuwachs (tracemalloc-Vergleich Ende gegen Einschwingende).
+
+Damit Ausweich- und GPS-Sicherheitspfade mitlaufen, schaltet der Dauerlauf
+periodisch Fehlerfälle des Simulators ein (Bumper, RTK-Verlust).
+
+tracemalloc verlangsamt den Interpreter deutlich; der erreichbare Zeitfaktor
+liegt entsprechend niedriger als bei python -m simulation main.
+"""
+
+import _thread
+import copy
+import gc
+import json
+import os
+import random
+import threading
+import tracemalloc
+from collections import Counter
+from typing import Callable, Dict, List, Optional
+
+from simulation.monte_carlo import percentile
+from simulation.pty_bridge import prepare_main, exec_main, _real_sleep
+from simulation.world import SimWorld
+
+DEFAULT_SPEC = {
+    'hours': 8.0,                 # Simulationszeit
+    'time_scale': 20.0,
+    'sample_interval': 300.0,     # s Simulationszeit zwischen zwei Proben
+    'warmup_hours': 0.5,          # Caches, Pläne, Lerndaten füllen sich zuerst
+    'event_interval': 120.0,      # s Simulationszeit zwischen zwei Fehlerfällen (0 = aus)
+    'events': {'bumper': 0.5, 'rtk_loss': 5.0},   # Fehlerfall: Dauer in s
+    'thresholds': {
+        'rss_mb_per_hour': 2.0,
+        'heap_mb_per_hour': 1.0,
+        'objects_per_hour': 2000,     # je Typ
+        'tick_p99_ms_per_hour': 2.0,
+    },
+    'top_types': 15,
+    'top_sites': 10,
+    'trace_frames': 6,
+}
+
+def merge_spec(spec: Optional[Dict]) -> Dict:
+    merged = copy.deepcopy(DEFAULT_SPEC)
+    for key, value in (spec or {}).items():
+        if key == 'thresholds':
+            merged['thresholds'].update(value)
+        else:
+            merged[key] = value
+    return merged
+
+def slope(xs: List[float], ys: List[float]) -> float:
+    """Steigung der Ausgleichsgeraden (kleinste Quadrate)."""
+    n = len(xs)
+    if n < 2:
+        return 0.0
+    mean_x = sum(xs) / n
+    mean_y = sum(ys) / n
+    sxx = sum((x - mean_x) ** 2 for x in xs)
+    if sxx == 0.0:
+        return 0.0
+    return sum((x - mean_x) * (y - mean_y) for x, y in zip(xs, ys)) / sxx
+
+def read_rss() -> int:
+    """Residenter Speicher des Prozesses in Byte (0, wenn nicht verfügbar)."""
+    try:
+        with open('/proc/self/statm', 'r') as f:
+            return int(f.read().split()[1]) * os.sysconf('SC_PAGE_SIZE')
+    except (OSError, ValueError, IndexError):
+        return 0
+
+def type_counts() -> Counter:
+    return Counter(type(obj).__name__ for obj in gc.get_objects())
+
+class SoakMonitor:
+    """Proben über die Simulationszeit und Auswertung des Wachstums."""
+    def __init__(self, clock: Callable[[], float], spec: Optional[Dict] = None):
+        self.clock = clock            # Simulationszeit in Sekunden
+        self.spec = merge_spec(spec)
+        self.samples: List[Dict] = []
+        self.type_history: List[Counter] = []
+        self._ticks: List[float] = []
+        self._lock = threading.Lock()
+        self._baseline: Optional[tracemalloc.Snapshot] = None
+        self._started_tracing = False
+
+    def start(self) -> None:
+        if not tracemalloc.is_tracing():
+            tracemalloc.start(self.spec['trace_frames'])
+            self._started_tracing = True
+
+    def stop(self) -> None:
+        if self._started_tracing:
+            tracemalloc.stop()
+            self._started_tracing = False
+
+    def record_tick(self, duration: float) -> None:
+        with self._lock:
+            self._ticks.append(duration)
+
+    def sample(self) -> Dict:
+        hours = self.clock() / 3600.0
+        with self._lock:
+            ticks, self._ticks = self._ticks, []
+        gc.collect()
+        counts = type_counts()
+        heap = tracemalloc.get_traced_memory()[0] if tracemalloc.is_tracing() else 0
+        sample = {
+            'hours': hours,
+            'rss_mb': read_rss() / 1e6,
+            'heap_mb': heap / 1e6,
+            'objects': sum(counts.values()),
+            'ticks': len(ticks),
+            'tick_p50_ms': percentile(ticks, 0.5) * 1000.0,
+            'tick_p99_ms': percentile(ticks, 0.99) * 1000.0,
+            'tick_max_ms': max(ticks) * 1000.0 if ticks else 0.0,
+        }
+        self.samples.append(sample)
+        self.type_history.append(counts)
+        if self._baseline is None and hours >= self.spec['warmup_hours'] and tracemalloc.is_tracing():
+            self._baseline = self._snapshot()
+        return sample
+
+    def _snapshot(self) -> tracemalloc.Snapshot:
+        # Eigene Buchführung (Proben, tracemalloc selbst) nicht mitzählen
+        return tracemalloc.take_snapshot().filter_traces((
+            tracemalloc.Filter(False, tracemalloc.__file__),
+            tracemalloc.Filter(False, __file__),
+        ))
+
+    def call_sites(self) -> List[Dict]:
+        """Aufrufstellen mit dem größten Zuwachs seit dem Ende der Einschwingzeit."""
+        if self._baseline is None or not tracemalloc.is_tracing():
+            return []
+        sites = []
+        for stat in self._snapshot().compare_to(self._baseline, 'traceback'):
+            if stat.size_diff <= 0:
+                continue
+            frames = [f"{os.path.relpath(frame.filename)}:{frame.lineno}" for frame in stat.traceback]
+            sites.append({'size_kb': stat.size_diff / 1024.0, 'count': stat.count_diff,
+                          'traceback': list(reversed(frames))})
+            if len(sites) >= self.spec['top_sites']:
+                break
+        return sites
+
+    def report(self) -> Dict:
+        thresholds = self.spec['thresholds']
+        warmup = self.spec['warmup_hours']
+        index = [i for i, s in enumerate(self.samples) if s['hours'] >= warmup]
+        report = {'samples': self.samples, 'slopes': {}, 'types': [], 'violations': [], 'call_sites': []}
+        if len(index) < 3:
+            report['violations'].append(
+                f"zu wenige Proben nach der Einschwingzeit ({len(index)}), Lauf zu kurz")
+            report['passed'] = False
+            return report
+
+        hours = [self.samples[i]['hours'] for i in index]
+        limits = {'rss_mb': ('rss_mb_per_hour', 'MB/h'), 'heap_mb': ('heap_mb_per_hour', 'MB/h'),
+                  'tick_p99_ms': ('tick_p99_ms_per_hour', 'ms/h')}
+        for key, (limit_key, unit) in limits.items():
+            value = slope(hours, [self.samples[i][key] for i in index])
+            report['slopes'][key] = value
+            if value > thresholds[limit_key]:
+                report['violations'].append(
+                    f"{key}: +{value:.2f} {unit} > {thresholds[limit_key]} {unit}")
+
+        first, last = self.type_history[index[0]], self.type_history[index[-1]]
+        candidates = sorted(set(first) | set(last), key=lambda name: first.get(name, 0) - last.get(name, 0))
+        for name in candidates[:self.spec['top_types']]:
+            value = slope(hours, [self.type_history[i].get(name, 0) for i in index])
+            if value <= 0:
+                continue
+            report['types'].append({'type': name, 'count': last.get(name, 0), 'per_hour': value})
+            if value > thresholds['objects_per_hour']:
+                report['violations'].append(
+                    f"Typ {name}: +{value:.0f} Objekte/h > {thresholds['objects_per_hour']}")
+
+        if report['violations']:
+            report['call_sites'] = self.call_sites()
+        report['passed'] = not report['violations']
+        return report
+
+def format_report(report: Dict) -> str:
+    lines = [f"{'h':>6} {'RSS MB':>8} {'Heap MB':>8} {'Objekte':>9} {'Zyklen':>7} "
+             f"{'P50 ms':>7} {'P99 ms':>7} {'max ms':>7}"]
+    for s in report['samples']:
+        lines.append(f"{s['hours']:6.2f} {s['rss_mb']:8.1f} {s['heap_mb']:8.2f} {s['objects']:9d} "
+                     f"{s['ticks']:7d} {s['tick_p50_ms']:7.2f} {s['tick_p99_ms']:7.2f} {s['tick_max_ms']:7.1f}")
+    if report['slopes']:
+        lines.append('Steigung je Stunde: ' + ', '.join(f"{k} {v:+.3f}" for k, v in report['slopes'].items()))
+    for entry in report['types'][:10]:
+        lines.append(f"  {entry['type']:<28} {entry['count']:>8d}  {entry['per_hour']:+.0f}/h")
+    for violation in report['violations']:
+        lines.append(f"WACHSTUM: {violation}")
+    for site in report['call_sites']:
+        lines.append(f"  +{site['size_kb']:.1f} KB in {site['count']:+d} Blöcken: {site['traceback'][0]}")
+        for frame in site['traceback'][1:]:
+            lines.append(f"      aufgerufen von {frame}")
+    return '\n'.join(lines)
+
+def _patch_tick(monitor: SoakMonitor) -> Callable[[], None]:
+    """Misst jeden Regelzyklus über utils/trace.Tick.end; gibt die Rücknahme zurück."""
+    from utils.trace import Tick
+    original = Tick.end
+
+    def end(self, args=None):
+        duration = original(self, args)
+        monitor.record_tick(duration)
+        return duration
+
+    Tick.end = end
+    return lambda: setattr(Tick, 'end', original)
+
+def run(world: Optional[SimWorld] = None, spec: Optional[Dict] = None,
+        config_path: Optional[str] = None, workdir: str = 'sim_soak',
+        seed: Optional[int] = None) -> Dict:
+    """Startet main.py beschleunigt gegen den Simulator und überwacht das Wachstum."""
+    spec = merge_spec(spec)
+    bridge = prepare_main(world, config_path, workdir, time_scale=spec['time_scale'], seed=seed)
+    simulator = bridge.simulator
+    monitor = SoakMonitor(lambda: simulator.time, spec)
+    monitor.start()
+    restore_tick = _patch_tick(monitor)
+    rng = random.Random(seed)
+    running = [True]
+    report: Dict = {}
+
+    def scenario():
+        end = spec['hours'] * 3600.0
+        next_sample = 0.0
+        next_event = spec['event_interval'] or float('inf')
+        active = None
+        try:
+            while running[0] and simulator.time < end:
+                now = simulator.time
+                if now >= next_sample:
+                    sample = monitor.sample()
+                    print(f"Soak: {sample['hours']:.2f} h, RSS {sample['rss_mb']:.1f} MB, "
+                          f"Heap {sample['heap_mb']:.2f} MB, Zyklus P99 {sample['tick_p99_ms']:.1f} ms")
+                    next_sample += spec['sample_interval']
+                if active and now >= active[1]:
+                    with bridge.lock:
+                        simulator.clear(active[0])
+                    active = None
+                if active is None and now >= next_event and spec['events']:
+                    fault = rng.choice(sorted(spec['events']))
+                    with bridge.lock:
+                        simulator.inject(fault)
+                    active = (fault, now + spec['events'][fault])
+                    next_event = now + spec['event_interval']
+                _real_sleep(0.05)
+            monitor.sample()
+            report.update(monitor.report())
+        finally:
+            # Regelschleife wie Strg+C beenden, sofern main.py noch läuft
+            if running[0]:
+                _thread.interrupt_main()
+
+    thread = threading.Thread(target=scenario, name='soak', daemon=True)
+    thread.start()
+    try:
+        exec_main()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        running[0] = False
+        thread.join(timeout=30.0)
+        restore_tick()
+        bridge.stop()
+        monitor.stop()
+    if not report:
+        report = monitor.report()
+        report['violations'].append('main.py hat vor Ende des Dauerlaufs beendet')
+        report['passed'] = False
+    return report
+
+def load_spec(filename: str) -> Optional[Dict]:
+    try:
+        with open(filename, 'r') as f:
+            return json.load(f)
+    except (OSError, ValueError) as e:
+        print(f"Soak: Datei {filename} nicht ladbar: {e}")
+        return None
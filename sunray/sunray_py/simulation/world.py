@@ -0,0 +1,207 @@
+"""
+Simulierte Umgebung: Mähzonen, Hindernisse, RTK-Qualitätszonen und Ladestation.
+
+Die Welt wird im Format von zones.json beschrieben und um simulationsspezifische
+Einträge ergänzt (lokale Meter, Ursprung = GPS-Ursprung des Roboters):
+
+  {
+    "mow_zones": [[{"x": 0, "y": 0}, ...]],          # wie zones.json
+    "obstacles": [[{"x": 5, "y": 5}, ...]],          # Bumper-Kontakt beim Anfahren
+    "boundary": [{"x": -5, "y": -5}, ...],           # optional: Zaun um das Grundstück
+    "rtk_zones": [{"polygon": [...], "fix": "float", "h_acc": 0.25}],
+    "dock": {"x": 0.0, "y": 0.0, "heading": 0.0},
+    "origin": {"lat": 52.52, "lon": 13.405}
+  }
+
+Die Geometrie arbeitet auf Tupellisten statt auf map.Polygon, weil die
+Kollisionsprüfung in jedem Physikschritt läuft.
+"""
+
+import json
+import math
+from typing import Dict, List, Optional, Sequence, Tuple
+
+Ring = List[Tuple[float, float]]
+
+# Fix-Qualitäten (NMEA-GGA-Kennung, UBX-fixType, UBX-carrSoln)
+FIX_QUALITIES = {
+    'fixed': (4, 3, 2),
+    'float': (5, 3, 1),
+    '3d': (1, 3, 0),
+    'none': (0, 0, 0),
+}
+
+def _ring(points: Sequence) -> Ring:
+    """Punktliste ({x, y}-Dicts oder Paare) als Tupelliste."""
+    ring = []
+    for p in points:
+        if isinstance(p, dict):
+            ring.append((float(p.get('x', 0.0)), float(p.get('y', 0.0))))
+        else:
+            ring.append((float(p[0]), float(p[1])))
+    return ring
+
+def _bounds(ring: Ring) -> Tuple[float, float, float, float]:
+    xs = [p[0] for p in ring]
+    ys = [p[1] for p in ring]
+    return min(xs), min(ys), max(xs), max(ys)
+
+def point_in_ring(x: float, y: float, ring: Ring) -> bool:
+    """Strahlverfahren (gerade/ungerade Schnittzahl)."""
+    inside = False
+    j = len(ring) - 1
+    for i in range(len(ring)):
+        xi, yi = ring[i]
+        xj, yj = ring[j]
+        if (yi > y) != (yj > y) and x < (xj - xi) * (y - yi) / (yj - yi) + xi:
+            inside = not inside
+        j = i
+    return inside
+
+def distance_to_ring(x: float, y: float, ring: Ring) -> float:
+    """Kürzester Abstand zum Rand des Rings."""
+    best = float('inf')
+    j = len(ring) - 1
+    for i in range(len(ring)):
+        ax, ay = ring[j]
+        bx, by = ring[i]
+        dx, dy = bx - ax, by - ay
+        length2 = dx * dx + dy * dy
+        t = 0.0 if length2 == 0 else max(0.0, min(1.0, ((x - ax) * dx + (y - ay) * dy) / length2))
+        px, py = ax + t * dx - x, ay + t * dy - y
+        d = px * px + py * py
+        if d < best:
+            best = d
+        j = i
+    return math.sqrt(best)
+
+def ring_area(ring: Ring) -> float:
+    area = 0.0
+    j = len(ring) - 1
+    for i in range(len(ring)):
+        area += (ring[j][0] + ring[i][0]) * (ring[j][1] - ring[i][1])
+        j = i
+    return abs(area) / 2.0
+
+class _Shape:
+    """Ring mit Begrenzungsrechteck für die schnelle Vorauswahl."""
+    __slots__ = ('ring', 'bounds')
+
+    def __init__(self, ring: Ring):
+        self.ring = ring
+        self.bounds = _bounds(ring)
+
+    def near(self, x: float, y: float, margin: float) -> bool:
+        x0, y0, x1, y1 = self.bounds
+        return x0 - margin <= x <= x1 + margin and y0 - margin <= y <= y1 + margin
+
+class SimWorld:
+    """Statische Umgebung des simulierten Roboters."""
+    def __init__(self, mow_zones: Optional[List[Ring]] = None, obstacles: Optional[List[Ring]] = None,
+                 boundary: Optional[Ring] = None, rtk_zones: Optional[List[Dict]] = None,
+                 dock: Optional[Dict] = None, origin: Optional[Dict] = None):
+        self.mow_zones = [_ring(z) for z in (mow_zones or [])]
+        self.obstacles = [_Shape(_ring(o)) for o in (obstacles or [])]
+        self.boundary = _Shape(_ring(boundary)) if boundary else None
+        self.rtk_zones = []
+        for zone in rtk_zones or []:
+            fix = zone.get('fix', 'float')
+            if fix not in FIX_QUALITIES:
+                print(f"SimWorld: Unbekannte Fix-Qualität '{fix}', verwende 'float'")
+                fix = 'float'
+            self.rtk_zones.append((_Shape(_ring(zone.get('polygon', []))), fix, zone.get('h_acc')))
+        dock = dock or {}
+        self.dock = (float(dock.get('x', 0.0)), float(dock.get('y', 0.0)), float(dock.get('heading', 0.0)))
+        origin = origin or {}
+        self.origin = (float(origin.get('lat', 52.52)), float(origin.get('lon', 13.405)))
+
+    @staticmethod
+    def from_dict(data: Dict) -> 'SimWorld':
+        return SimWorld(mow_zones=data.get('mow_zones'), obstacles=data.get('obstacles'),
+                        boundary=data.get('boundary'), rtk_zones=data.get('rtk_zones'),
+                        dock=data.get('dock'), origin=data.get('origin'))
+
+    @staticmethod
+    def load(filename: str) -> Optional['SimWorld']:
+        """Lädt eine Welt aus JSON (zones.json-Format mit Simulationseinträgen)."""
+        try:
+            with open(filename, 'r') as f:
+                return SimWorld.from_dict(json.load(f))
+        except (OSError, ValueError) as e:
+            print(f"SimWorld: Welt {filename} nicht ladbar: {e}")
+            return None
+
+    def to_dict(self) -> Dict:
+        def points(ring):
+            return [{'x': x, 'y': y} for x, y in ring]
+        data = {
+            'mow_zones': [points(z) for z in self.mow_zones],
+            'obstacles': [points(o.ring) for o in self.obstacles],
+            'rtk_zones': [{'polygon': points(shape.ring), 'fix': fix, 'h_acc': h_acc}
+                          for shape, fix, h_acc in self.rtk_zones],
+            'dock': {'x': self.dock[0], 'y': self.dock[1], 'heading': self.dock[2]},
+            'origin': {'lat': self.origin[0], 'lon': self.origin[1]},
+        }
+        if self.boundary:
+            data['boundary'] = points(self.boundary.ring)
+        return data
+
+    def zones_file(self) -> Dict:
+        """Inhalt für zones.json (Map.load_zones)."""
+        return {'mow_zones': [[{'x': x, 'y': y} for x, y in z] for z in self.mow_zones]}
+
+    def map_file(self) -> Dict:
+        """Inhalt für map.json (Map.load): Zaun als Perimeter, Hindernisse als Ausschlusszonen."""
+        def points(ring):
+            return [{'x': x, 'y': y} for x, y in ring]
+        return {
+            'points': [], 'free_points': [], 'obstacles': [],
+            'perimeter': points(self.boundary.ring) if self.boundary else [],
+            'exclusions': [points(o.ring) for o in self.obstacles],
+        }
+
+    def collides(self, x: float, y: float, radius: float) -> bool:
+        """True, wenn ein Kreis mit radius an (x, y) ein Hindernis oder den Zaun berührt."""
+        for shape in self.obstacles:
+            if shape.near(x, y, radius):
+                if point_in_ring(x, y, shape.ring) or distance_to_ring(x, y, shape.ring) < radius:
+                    return True
+        boundary = self.boundary
+        if boundary is not None:
+            if not point_in_ring(x, y, boundary.ring) or distance_to_ring(x, y, boundary.ring) < radius:
+                return True
+        return False
+
+    def in_mow_zone(self, x: float, y: float) -> bool:
+        for ring in self.mow_zones:
+            if point_in_ring(x, y, ring):
+                return True
+        return False
+
+    def fix_quality(self, x: float, y: float) -> Tuple[str, Optional[float]]:
+        """RTK-Qualität an einer Position (erste passende Zone, sonst 'fixed')."""
+        for shape, fix, h_acc in self.rtk_zones:
+            if shape.near(x, y, 0.0) and point_in_ring(x, y, shape.ring):
+                return fix, h_acc
+        return 'fixed', None
+
+    def mowable_area(self) -> float:
+        return sum(ring_area(z) for z in self.mow_zones) - \
+            sum(ring_area(o.ring) for o in self.obstacles)
+
+    @staticmethod
+    def default() -> 'SimWorld':
+        """Rechteckiger Garten 20 x 12 m mit Baum, Beet und RTK-Schatten am Haus."""
+        return SimWorld.from_dict({
+            'mow_zones': [[{'x': -1, 'y': -1}, {'x': 19, 'y': -1}, {'x': 19, 'y': 11}, {'x': -1, 'y': 11}]],
+            'obstacles': [
+                [{'x': 6, 'y': 4}, {'x': 7, 'y': 4}, {'x': 7, 'y': 5}, {'x': 6, 'y': 5}],
+                [{'x': 12, 'y': 7}, {'x': 15, 'y': 7}, {'x': 15, 'y': 8.5}, {'x': 12, 'y': 8.5}],
+            ],
+            'boundary': [{'x': -2, 'y': -2}, {'x': 20, 'y': -2}, {'x': 20, 'y': 12}, {'x': -2, 'y': 12}],
+            'rtk_zones': [
+                {'polygon': [{'x': 14, 'y': 9}, {'x': 20, 'y': 9}, {'x': 20, 'y': 12}, {'x': 14, 'y': 12}],
+                 'fix': 'float', 'h_acc': 0.25},
+            ],
+            'dock': {'x': 0.0, 'y': 0.0, 'heading': 0.0},
+        })
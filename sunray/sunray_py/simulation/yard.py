@@ -0,0 +1,306 @@
+"""
+Synthetische Gärten für Skalierungstests.
+
+Aus Fläche und Seed entsteht eine Welt im Format von zones.json mit
+Simulationseinträgen (siehe world.py). Derselbe Seed liefert dieselbe Welt:
+
+- Mähzonen: Rasenstücke mit Einbuchtungen (konkav), bei größeren Gärten
+  mehrere, verbunden durch schmale Durchgänge (eigene Mähzonen, Breite
+  passage_width)
+- Beete als Hindernisse (Rechtecke und Nierenformen) und Bäume als kleine
+  Achtecke, Anzahl proportional zur Fläche
+- RTK-Schatten: Band an der Hauswand der ersten Zone (float, nah an der Wand
+  3d), Baumkronen (float/3d) und ab 400 m² ein Carport ohne Fix ('none')
+- Zaun (boundary) um alles, Ladestation am Rand der ersten Zone im Ursprung
+
+Die Fläche ist der eine Regler (100 m² bis 2 ha); alles andere wird daraus
+abgeleitet und lässt sich über die Optionen in DEFAULT_OPTIONS überschreiben.
+Die mähbare Fläche (SimWorld.mowable_area) liegt nahe am Zielwert: Durchgänge
+kommen hinzu, Beete und Bäume gehen ab.
+
+Aufruf: python -m simulation yard --area 5000 --seed 1 > garten.json
+"""
+
+import math
+import random
+from typing import Dict, List, Optional, Tuple
+
+from simulation.world import Ring, SimWorld, _bounds, distance_to_ring, point_in_ring, ring_area
+
+MIN_AREA = 100.0
+MAX_AREA = 20000.0
+
+DEFAULT_OPTIONS = {
+    'zones': None,              # Anzahl Rasenstücke (Standard: aus der Fläche)
+    'passage_width': 1.2,       # Breite der Durchgänge zwischen den Zonen
+    'passage_length': [2.0, 5.0],
+    'notches': [1, 3],          # Einbuchtungen je Zone
+    'vertices': 64,             # Eckpunkte je Zone
+    'bed_density': 1 / 250.0,   # Beete je m²
+    'bed_area': [2.0, 12.0],
+    'tree_density': 1 / 150.0,  # Bäume je m²
+    'tree_radius': [0.15, 0.4],
+    'clearance': 0.8,           # Mindestabstand von Beeten/Bäumen zum Rand und untereinander
+    'shadow_fraction': 0.15,    # Anteil der Fläche mit RTK-Schatten (ungefähr)
+    'origin': {'lat': 52.52, 'lon': 13.405},
+}
+
+def merge_options(options: Optional[Dict]) -> Dict:
+    merged = dict(DEFAULT_OPTIONS)
+    for key, value in (options or {}).items():
+        if key not in DEFAULT_OPTIONS:
+            print(f"Garten-Generator: Unbekannte Option '{key}' ignoriert")
+            continue
+        merged[key] = value
+    return merged
+
+def zone_count(area: float) -> int:
+    """Ein Rasenstück bis 400 m², dann mit der Wurzel der Fläche wachsend, höchstens 8."""
+    return max(1, min(8, 1 + int(math.sqrt(area / 400.0))))
+
+def _overlap(a: Tuple[float, float, float, float], b: Tuple[float, float, float, float], margin: float) -> bool:
+    return a[0] - margin < b[2] and b[0] - margin < a[2] and a[1] - margin < b[3] and b[1] - margin < a[3]
+
+def _ray_exit(ring: Ring, cx: float, cy: float, dx: float, dy: float) -> float:
+    """Abstand vom Zentrum bis zum Rand entlang (dx, dy); die Zonen sind sternförmig um das Zentrum."""
+    best = 0.0
+    j = len(ring) - 1
+    for i in range(len(ring)):
+        ax, ay = ring[j]
+        bx, by = ring[i]
+        ex, ey = bx - ax, by - ay
+        det = dx * ey - dy * ex
+        if abs(det) > 1e-12:
+            t = ((ax - cx) * ey - (ay - cy) * ex) / det
+            u = ((ax - cx) * dy - (ay - cy) * dx) / det
+            if t > 0.0 and 0.0 <= u <= 1.0:
+                best = max(best, t)
+        j = i
+    return best
+
+def _apart(ring: Ring, others: List[Ring], margin: float) -> bool:
+    """True, wenn ring keinen der anderen Ringe schneidet und mindestens margin Abstand hält."""
+    box = _bounds(ring)
+    for other in others:
+        if not _overlap(box, _bounds(other), margin):
+            continue
+        if any(point_in_ring(x, y, other) or distance_to_ring(x, y, other) < margin for x, y in ring):
+            return False
+        if any(point_in_ring(x, y, ring) for x, y in other):
+            return False
+    return True
+
+def _rect(cx: float, cy: float, half_x: float, half_y: float, angle: float = 0.0) -> Ring:
+    c, s = math.cos(angle), math.sin(angle)
+    return [(cx + x * c - y * s, cy + x * s + y * c)
+            for x, y in ((-half_x, -half_y), (half_x, -half_y), (half_x, half_y), (-half_x, half_y))]
+
+def _circle(cx: float, cy: float, radius: float, count: int = 8) -> Ring:
+    return [(cx + radius * math.cos(2 * math.pi * k / count), cy + radius * math.sin(2 * math.pi * k / count))
+            for k in range(count)]
+
+class YardGenerator:
+    """Erzeugt eine SimWorld aus Fläche und Seed (deterministisch)."""
+    def __init__(self, area: float, seed: int = 0, options: Optional[Dict] = None):
+        if not MIN_AREA <= area <= MAX_AREA:
+            print(f"Garten-Generator: Fläche {area:.0f} m² außerhalb {MIN_AREA:.0f}..{MAX_AREA:.0f} m², begrenzt")
+            area = max(MIN_AREA, min(MAX_AREA, area))
+        self.area = float(area)
+        self.seed = seed
+        self.options = merge_options(options)
+        self.rng = random.Random(f"yard:{seed}:{self.area:.1f}")
+        self.zones: List[Ring] = []
+        self.centers: List[Tuple[float, float]] = []
+        self.passages: List[Ring] = []
+        self.obstacles: List[Ring] = []
+        self.trees: List[Tuple[float, float, float]] = []
+        self.rtk_zones: List[Dict] = []
+
+    def _uniform(self, bounds) -> float:
+        return self.rng.uniform(bounds[0], bounds[1])
+
+    def _lawn(self, cx: float, cy: float, target: float) -> Ring:
+        """
+        Rasenstück als sternförmiges Polygon: Superellipse (rechteckig mit runden
+        Ecken), leichte Welligkeit und Einbuchtungen; danach auf die Zielfläche skaliert.
+        """
+        rng = self.rng
+        count = int(self.options['vertices'])
+        aspect = rng.uniform(1.0, 2.0)
+        exponent = rng.uniform(3.0, 6.0)
+        rotation = rng.uniform(0.0, math.pi)
+        waves = [(rng.randint(2, 5), rng.uniform(0.0, 0.05), rng.uniform(0.0, 2 * math.pi)) for _ in range(3)]
+        notches = [(rng.uniform(0.0, 2 * math.pi), rng.uniform(0.3, 0.5), rng.uniform(0.25, 0.5))
+                   for _ in range(rng.randint(*self.options['notches']))]
+        radii = []
+        for k in range(count):
+            theta = 2 * math.pi * k / count
+            c, s = abs(math.cos(theta)) / aspect, abs(math.sin(theta))
+            r = (c ** exponent + s ** exponent) ** (-1.0 / exponent)
+            r *= 1.0 + sum(amplitude * math.sin(n * theta + phase) for n, amplitude, phase in waves)
+            for center, depth, width in notches:
+                delta = math.atan2(math.sin(theta - center), math.cos(theta - center))
+                r *= 1.0 - depth * math.exp(-(delta / width) ** 2)
+            radii.append(r)
+        unit = [(r * math.cos(2 * math.pi * k / count + rotation), r * math.sin(2 * math.pi * k / count + rotation))
+                for k, r in enumerate(radii)]
+        scale = math.sqrt(target / ring_area(unit))
+        return [(cx + x * scale, cy + y * scale) for x, y in unit]
+
+    def _layout(self) -> None:
+        """Rasenstücke als Baum: jedes neue Stück hängt über einen Durchgang an einem vorhandenen."""
+        rng = self.rng
+        count = int(self.options['zones'] or zone_count(self.area))
+        weights = [rng.uniform(0.7, 1.3) for _ in range(count)]
+        targets = [self.area * w / sum(weights) for w in weights]
+        width = float(self.options['passage_width'])
+
+        self.zones.append(self._lawn(0.0, 0.0, targets[0]))
+        self.centers.append((0.0, 0.0))
+        directions = [(1.0, 0.0), (0.0, 1.0), (-1.0, 0.0), (0.0, -1.0)]
+        for target in targets[1:]:
+            for _ in range(200):
+                parent = rng.randrange(len(self.zones))
+                dx, dy = rng.choice(directions)
+                px, py = self.centers[parent]
+                lawn = self._lawn(0.0, 0.0, target)
+                start = _ray_exit(self.zones[parent], px, py, dx, dy)
+                gap = self._uniform(self.options['passage_length'])
+                reach = _ray_exit(lawn, 0.0, 0.0, -dx, -dy)
+                cx, cy = px + dx * (start + gap + reach), py + dy * (start + gap + reach)
+                lawn = [(x + cx, y + cy) for x, y in lawn]
+                # Durchgang ragt um seine Breite in beide Zonen, damit er trotz schräger Ränder anschließt
+                a, b = start - width, start + gap + width
+                mid = (a + b) / 2
+                passage = _rect(px + dx * mid, py + dy * mid, (b - a) / 2 if dx else width / 2,
+                                (b - a) / 2 if dy else width / 2)
+                if not _apart(lawn, self.zones + self.passages, 1.5):
+                    continue
+                if not _apart(passage, [zone for i, zone in enumerate(self.zones) if i != parent] + self.passages,
+                              0.5):
+                    continue
+                self.zones.append(lawn)
+                self.centers.append((cx, cy))
+                self.passages.append(passage)
+                break
+            else:
+                print(f"Garten-Generator: Kein Platz für Zone {len(self.zones) + 1}, Garten bleibt kleiner")
+                break
+
+    def _free(self, ring: Ring, zone: Ring, margin: float) -> bool:
+        """Alle Eckpunkte in der Zone, mit Abstand zu Rand, Ladestation, Durchgängen und anderen Hindernissen."""
+        clearance = float(self.options['clearance'])
+        for x, y in ring:
+            if not point_in_ring(x, y, zone) or distance_to_ring(x, y, zone) < clearance:
+                return False
+        box = _bounds(ring)
+        if _overlap(box, (-1.5, -1.5, 1.5, 1.5), margin):
+            return False
+        return not any(_overlap(box, _bounds(other), margin) for other in self.obstacles + self.passages)
+
+    def _place(self, make, count: int, margin: float) -> List[Ring]:
+        placed = []
+        weights = [ring_area(zone) for zone in self.zones]
+        for _ in range(count):
+            for _ in range(50):
+                zone = self.rng.choices(self.zones, weights)[0]
+                x0, y0, x1, y1 = _bounds(zone)
+                ring = make(self.rng.uniform(x0, x1), self.rng.uniform(y0, y1))
+                if self._free(ring, zone, margin):
+                    self.obstacles.append(ring)
+                    placed.append(ring)
+                    break
+        return placed
+
+    def _bed(self, x: float, y: float) -> Ring:
+        rng = self.rng
+        area = self._uniform(self.options['bed_area'])
+        if rng.random() < 0.6:
+            aspect = rng.uniform(1.5, 4.0)
+            half_y = math.sqrt(area / aspect) / 2
+            return _rect(x, y, half_y * aspect, half_y, rng.uniform(0.0, math.pi))
+        # Nierenform: Kreis mit einer Delle
+        dent = rng.uniform(0.0, 2 * math.pi)
+        unit = []
+        for k in range(16):
+            theta = 2 * math.pi * k / 16
+            delta = math.atan2(math.sin(theta - dent), math.cos(theta - dent))
+            r = 1.0 - 0.45 * math.exp(-(delta / 0.5) ** 2)
+            unit.append((r * math.cos(theta), r * math.sin(theta)))
+        scale = math.sqrt(area / ring_area(unit))
+        return [(x + px * scale, y + py * scale) for px, py in unit]
+
+    def _tree(self, x: float, y: float) -> Ring:
+        radius = self._uniform(self.options['tree_radius'])
+        self.trees.append((x, y, radius))
+        return _circle(x, y, radius)
+
+    def _dock(self) -> Tuple[float, float, float]:
+        """Ladestation 1 m innerhalb des Rands der ersten Zone, Blick zur Mitte."""
+        angle = self.rng.uniform(0.0, 2 * math.pi)
+        dx, dy = math.cos(angle), math.sin(angle)
+        reach = _ray_exit(self.zones[0], 0.0, 0.0, dx, dy)
+        return dx * (reach - 1.0), dy * (reach - 1.0), math.atan2(-dy, -dx)
+
+    def _shadows(self) -> None:
+        """RTK-Schatten bis etwa shadow_fraction der Fläche; schlechtere Qualität zuerst (erste passende Zone gilt)."""
+        rng = self.rng
+        budget = self.area * float(self.options['shadow_fraction'])
+        worst, medium, light = [], [], []
+
+        # Hauswand entlang einer Seite der ersten Zone
+        x0, y0, x1, y1 = _bounds(self.zones[0])
+        band = min(0.5 * budget / max(x1 - x0, 1.0), (y1 - y0) / 3)
+        wall = y1 + 1.0
+        light.append((_rect((x0 + x1) / 2, wall - band / 2, (x1 - x0) / 2 + 1.0, band / 2), 'float', 0.25))
+        medium.append((_rect((x0 + x1) / 2, wall - band / 6, (x1 - x0) / 2 + 1.0, band / 6), '3d', 1.5))
+        budget -= band * (x1 - x0)
+
+        if self.area >= 400.0:
+            zone = rng.choice(self.zones)
+            bx0, by0, bx1, by1 = _bounds(zone)
+            worst.append((_rect(rng.uniform(bx0, bx1), rng.uniform(by0, by1), 2.5, 1.5), 'none', None))
+            budget -= 12.0
+
+        # Baumkronen: große Bäume zuerst
+        for x, y, radius in sorted(self.trees, key=lambda t: -t[2]):
+            if budget <= 0:
+                break
+            crown = rng.uniform(2.0, 4.0)
+            if rng.random() < 0.3:
+                medium.append((_circle(x, y, crown, 12), '3d', 1.5))
+            else:
+                light.append((_circle(x, y, crown, 12), 'float', rng.uniform(0.15, 0.4)))
+            budget -= math.pi * crown * crown
+
+        for ring, fix, h_acc in worst + medium + light:
+            self.rtk_zones.append({'polygon': ring, 'fix': fix, 'h_acc': h_acc})
+
+    def generate(self) -> SimWorld:
+        self._layout()
+        self.dock = self._dock()
+        dock_x, dock_y, heading = self.dock
+        # Ladestation in den Ursprung legen (Sperrbereich um sie bei _free)
+        self.zones = [[(x - dock_x, y - dock_y) for x, y in zone] for zone in self.zones]
+        self.passages = [[(x - dock_x, y - dock_y) for x, y in ring] for ring in self.passages]
+        self.centers = [(x - dock_x, y - dock_y) for x, y in self.centers]
+
+        margin = float(self.options['clearance'])
+        self._place(self._bed, int(round(self.area * self.options['bed_density'])), margin)
+        self._place(self._tree, int(round(self.area * self.options['tree_density'])), margin)
+        self._shadows()
+
+        points = [p for ring in self.zones + self.passages for p in ring]
+        x0, y0 = min(p[0] for p in points) - 1.5, min(p[1] for p in points) - 1.5
+        x1, y1 = max(p[0] for p in points) + 1.5, max(p[1] for p in points) + 1.5
+        def mm(ring):
+            return [(round(x, 3), round(y, 3)) for x, y in ring]
+        return SimWorld(mow_zones=[mm(ring) for ring in self.zones + self.passages],
+                        obstacles=[mm(ring) for ring in self.obstacles],
+                        boundary=mm([(x0, y0), (x1, y0), (x1, y1), (x0, y1)]),
+                        rtk_zones=[dict(zone, polygon=mm(zone['polygon'])) for zone in self.rtk_zones],
+                        dock={'x': 0.0, 'y': 0.0, 'heading': heading}, origin=self.options['origin'])
+
+def generate_yard(area: float, seed: int = 0, options: Optional[Dict] = None) -> SimWorld:
+    """Garten mit etwa area m² Rasen; gleicher Seed, gleiche Welt."""
+    return YardGenerator(area, seed, options).generate()
@@ -31,6 +31,15 @@ class KalmanFilter:
         
         return self.estimate
 
+    def checkpoint_state(self) -> Dict:
+        return {'estimate': self.estimate, 'estimate_error': self.estimate_error,
+                'initialized': self.initialized}
+
+    def restore_checkpoint(self, state: Dict) -> None:
+        self.estimate = state.get('estimate', 0.0)
+        self.estimate_error = state.get('estimate_error', 1.0)
+        self.initialized = state.get('initialized', False)
+
 class StateEstimator:
     """
     Schätzlogik für Roboterzustand.
@@ -203,6 +212,34 @@ class StateEstimator:
             "rtk_wait_remaining": gps_safety_result.get('rtk_wait_remaining', 0.0)
         }
 
+    def checkpoint_state(self) -> Dict:
+        """Wiederherstellbarer Schätzzustand für den Warmstart (siehe checkpoint.py)."""
+        return {
+            'x': self.state_x,
+            'y': self.state_y,
+            'heading': self.state_heading,
+            'roll': self.state_roll,
+            'pitch': self.state_pitch,
+            'ground_speed': self.state_ground_speed,
+            'last_imu_yaw': self.last_imu_yaw,
+            'heading_filter': self.heading_filter.checkpoint_state(),
+            'roll_filter': self.roll_filter.checkpoint_state(),
+            'pitch_filter': self.pitch_filter.checkpoint_state()
+        }
+
+    def restore_checkpoint(self, state: Dict) -> None:
+        """Stellt den Schätzzustand aus einem Checkpoint wieder her."""
+        self.state_x = state.get('x', 0.0)
+        self.state_y = state.get('y', 0.0)
+        self.state_heading = state.get('heading', 0.0)
+        self.state_roll = state.get('roll', 0.0)
+        self.state_pitch = state.get('pitch', 0.0)
+        self.state_ground_speed = state.get('ground_speed', 0.0)
+        self.last_imu_yaw = state.get('last_imu_yaw', self.state_heading)
+        self.heading_filter.restore_checkpoint(state.get('heading_filter', {}))
+        self.roll_filter.restore_checkpoint(state.get('roll_filter', {}))
+        self.pitch_filter.restore_checkpoint(state.get('pitch_filter', {}))
+
     def reset_imu_timeout(self) -> None:
         """
         Setzt den IMU-Timeout zurück, wenn Daten ankommen.
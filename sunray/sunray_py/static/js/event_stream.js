@@ -0,0 +1,96 @@
+// Sunray Push-Kanal (Server-Sent Events über /api/stream)
+// Ersetzt das periodische Abfragen der REST-Endpunkte: der Server sendet
+// Telemetrie-Snapshots sowie Plan-, Zonen- und Kartierungsänderungen.
+//
+// Verwendung:
+//   const stream = new SunrayStream({events: ['telemetry', 'plan'], telemetryInterval: 1.0});
+//   stream.on('telemetry', data => { ... });
+//   stream.on('resync', () => { /* vollständigen Zustand per REST nachladen */ });
+//   stream.onStatus(connected => { ... });
+//   stream.connect();
+class SunrayStream {
+    constructor(options = {}) {
+        this.url = options.url || '/api/stream';
+        this.events = options.events || [];
+        this.intervals = {};
+        if (options.telemetryInterval) {
+            this.intervals.telemetry = options.telemetryInterval;
+        }
+        this.handlers = {};
+        this.statusHandlers = [];
+        this.source = null;
+        this.connected = false;
+    }
+
+    on(event, handler) {
+        (this.handlers[event] = this.handlers[event] || []).push(handler);
+        if (this.source) {
+            this._listen(event);
+        }
+        return this;
+    }
+
+    onStatus(handler) {
+        this.statusHandlers.push(handler);
+        return this;
+    }
+
+    static supported() {
+        return typeof window.EventSource !== 'undefined';
+    }
+
+    connect() {
+        if (!SunrayStream.supported()) {
+            this._setStatus(false);
+            return false;
+        }
+        const params = new URLSearchParams();
+        if (this.events.length) {
+            params.set('events', this.events.join(','));
+        }
+        Object.entries(this.intervals).forEach(([event, interval]) => {
+            params.set(event + '_interval', interval);
+        });
+        const query = params.toString();
+        this.source = new EventSource(query ? this.url + '?' + query : this.url);
+        this.source.onopen = () => this._setStatus(true);
+        // EventSource verbindet sich selbstständig neu (retry vom Server)
+        this.source.onerror = () => this._setStatus(false);
+        Object.keys(this.handlers).forEach(event => this._listen(event));
+        return true;
+    }
+
+    close() {
+        if (this.source) {
+            this.source.close();
+            this.source = null;
+        }
+        this._setStatus(false);
+    }
+
+    _listen(event) {
+        if (this.source._listening && this.source._listening[event]) {
+            return;
+        }
+        this.source._listening = this.source._listening || {};
+        this.source._listening[event] = true;
+        this.source.addEventListener(event, message => {
+            let data = null;
+            try {
+                data = JSON.parse(message.data);
+            } catch (e) {
+                console.warn('SunrayStream: ungültige Nachricht', event, e);
+                return;
+            }
+            (this.handlers[event] || []).forEach(handler => handler(data));
+        });
+    }
+
+    _setStatus(connected) {
+        if (this.connected === connected) {
+            return;
+        }
+        this.connected = connected;
+        this.statusHandlers.forEach(handler => handler(connected));
+    }
+}
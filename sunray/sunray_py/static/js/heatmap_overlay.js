@@ -0,0 +1,140 @@
+// Sunray Heatmap-Overlay (Kacheln aus heatmap_tiles.py)
+// Zeichnet PNG-Kacheln einer Ebene (Abdeckung, GPS-Genauigkeit, Mähmotorstrom)
+// in ein Canvas. Die Zoomstufe richtet sich nach dem Maßstab, geladen werden nur
+// sichtbare Kacheln; nach einem 'heatmap'-Ereignis werden nur geänderte Kacheln
+// neu angefordert (Kachel-URLs mit Version sind unveränderlich und werden gecacht).
+//
+// Verwendung:
+//   const overlay = new HeatmapOverlay({layer: 'coverage', onUpdate: redraw});
+//   await overlay.load();
+//   overlay.draw(ctx, {toCanvas: (x, y) => ({x, y}), metersPerPixel, minX, minY, maxX, maxY});
+//   stream.on('heatmap', () => overlay.refresh());
+const HEATMAP_EARTH_RADIUS = 6371000;  // wie RTKGPS
+const HEATMAP_MAX_TILES = 64;
+
+class HeatmapOverlay {
+    constructor(options = {}) {
+        this.base = options.base || '/api/heatmap';
+        this.layer = options.layer || 'coverage';
+        this.onUpdate = options.onUpdate || (() => {});
+        this.meta = null;
+        this.version = 0;
+        this.tileVersions = new Map();
+        this.images = new Map();
+        this.refreshing = false;
+    }
+
+    async load() {
+        const response = await fetch(this.base, {cache: 'no-store'});
+        this.meta = await response.json();
+        await this.refresh(true);
+        return this.meta;
+    }
+
+    setLayer(layer) {
+        this.layer = layer;
+        this.refresh(true);
+    }
+
+    // Geänderte Kacheln seit der letzten bekannten Version abfragen
+    async refresh(full = false) {
+        if (!this.meta || this.refreshing) return;
+        this.refreshing = true;
+        try {
+            const since = full ? 0 : this.version;
+            const response = await fetch(`${this.base}/changes?since=${since}&layer=${this.layer}`,
+                                         {cache: 'no-store'});
+            const changes = await response.json();
+            if (full || changes.version < this.version) {
+                // Erstaufruf oder Ebenen wurden verworfen
+                this.tileVersions.clear();
+                this.images.clear();
+            }
+            changes.tiles.forEach(([layer, z, tx, ty, version]) => {
+                const key = `${layer}/${z}/${tx}/${ty}`;
+                this.tileVersions.set(key, version);
+                this.images.delete(key);
+            });
+            this.version = changes.version;
+            if (changes.tiles.length || full) {
+                const meta = await fetch(this.base, {cache: 'no-store'});
+                this.meta = await meta.json();
+                this.onUpdate();
+            }
+        } catch (error) {
+            console.warn('Heatmap: Aktualisierung fehlgeschlagen', error);
+        } finally {
+            this.refreshing = false;
+        }
+    }
+
+    // Lokale Meter (x Ost, y Nord) <-> GPS, Ursprung vom Roboter
+    toLatLon(x, y) {
+        const [lat0, lon0] = this.meta.origin;
+        return {
+            lat: lat0 + (y / HEATMAP_EARTH_RADIUS) * 180 / Math.PI,
+            lon: lon0 + (x / (HEATMAP_EARTH_RADIUS * Math.cos(lat0 * Math.PI / 180))) * 180 / Math.PI
+        };
+    }
+
+    toLocal(lat, lon) {
+        const [lat0, lon0] = this.meta.origin;
+        return {
+            x: (lon - lon0) * Math.PI / 180 * HEATMAP_EARTH_RADIUS * Math.cos(lat0 * Math.PI / 180),
+            y: (lat - lat0) * Math.PI / 180 * HEATMAP_EARTH_RADIUS
+        };
+    }
+
+    // Gröbste Stufe, deren Pixel nicht größer als ein Bildschirmpixel sind
+    zoomFor(metersPerPixel) {
+        const steps = Math.floor(Math.log2(Math.max(metersPerPixel, this.meta.resolution) / this.meta.resolution));
+        return Math.max(this.meta.min_zoom, this.meta.max_zoom - steps);
+    }
+
+    tileMeters(z) {
+        return this.meta.resolution * Math.pow(2, this.meta.max_zoom - z) * this.meta.tile_size;
+    }
+
+    draw(ctx, view) {
+        if (!this.meta || !this.meta.bounds) return;
+        let z = this.zoomFor(view.metersPerPixel);
+        let size = this.tileMeters(z);
+        // Bei sehr großem Ausschnitt gröbere Stufe statt vieler Kacheln
+        while (z > this.meta.min_zoom &&
+               (Math.floor(view.maxX / size) - Math.floor(view.minX / size) + 1) *
+               (Math.floor(view.maxY / size) - Math.floor(view.minY / size) + 1) > HEATMAP_MAX_TILES) {
+            z -= 1;
+            size = this.tileMeters(z);
+        }
+        const [minX, minY, maxX, maxY] = this.meta.bounds;
+        const smoothing = ctx.imageSmoothingEnabled;
+        ctx.imageSmoothingEnabled = false;
+        for (let tx = Math.floor(Math.max(view.minX, minX) / size); tx <= Math.floor(Math.min(view.maxX, maxX) / size); tx++) {
+            for (let ty = Math.floor(Math.max(view.minY, minY) / size); ty <= Math.floor(Math.min(view.maxY, maxY) / size); ty++) {
+                const key = `${this.layer}/${z}/${tx}/${ty}`;
+                let image = this.images.get(key);
+                if (!image) {
+                    image = new Image();
+                    image.onload = () => this.onUpdate();
+                    image.src = `${this.base}/${key}.png?v=${this.tileVersions.get(key) || 0}`;
+                    this.images.set(key, image);
+                    continue;
+                }
+                if (!image.complete || !image.naturalWidth) continue;
+                const topLeft = view.toCanvas(tx * size, (ty + 1) * size);
+                const bottomRight = view.toCanvas((tx + 1) * size, ty * size);
+                ctx.drawImage(image, topLeft.x, topLeft.y, bottomRight.x - topLeft.x, bottomRight.y - topLeft.y);
+            }
+        }
+        ctx.imageSmoothingEnabled = smoothing;
+    }
+
+    // Legende der aktiven Ebene als CSS-Verlauf
+    legend() {
+        const layer = this.meta && this.meta.layers[this.layer];
+        if (!layer) return null;
+        const stops = layer.colors.map(c => `rgb(${c[0]}, ${c[1]}, ${c[2]})`).join(', ');
+        return {label: layer.label, unit: layer.unit, min: layer.min, max: layer.max,
+                gradient: `linear-gradient(to right, ${stops})`};
+    }
+}
@@ -0,0 +1,178 @@
+// Sunray Karten-/Plan-Diffs (Server: communication/map_changes.py)
+// Hält eine lokale Kopie von Zonen, Hindernissen und Plan und patcht sie mit
+// den versionierten '<art>_diff'-Ereignissen des Push-Kanals, statt nach jeder
+// Änderung alles neu zu laden. Nach einem Verbindungsabbruch oder 'resync'
+// werden die verpassten Diffs über /api/changes/<art>?since= nachgeholt; nur
+// wenn der Verlauf des Servers nicht reicht, wird der Zustand vollständig geladen.
+//
+// Verwendung:
+//   const stream = new SunrayStream({events: ['plan']});
+//   const changes = new MapChanges(stream, ['zones', 'plan']);
+//   changes.on('zones', (zones, change) => { ... });   // change ist null nach vollständigem Laden
+//   changes.start();
+//   stream.connect();
+//
+// Mit {load: false} wird der Zustand nicht per JSON geladen, sondern von der
+// Seite über setState() gesetzt (z.B. der Plan aus plan.bin).
+class MapChanges {
+    constructor(stream, kinds, options = {}) {
+        this.stream = stream;
+        this.kinds = kinds;
+        this.url = options.url || '/api/changes';
+        this.load = options.load !== false;
+        this.maxPending = options.maxPending || 100;
+        this.states = {};
+        this.handlers = {};
+        this.pending = {};
+        this.busy = {};
+        this.statistics = {patched: 0, caughtUp: 0, reloaded: 0};
+        // Diff-Ereignisse zum Abonnement hinzufügen (vor stream.connect())
+        if (stream.events.length) {
+            kinds.forEach(kind => {
+                if (!stream.events.includes(kind + '_diff')) stream.events.push(kind + '_diff');
+            });
+        }
+    }
+
+    on(kind, handler) {
+        (this.handlers[kind] = this.handlers[kind] || []).push(handler);
+        return this;
+    }
+
+    get(kind) {
+        return this.states[kind] ? this.states[kind].items : null;
+    }
+
+    start() {
+        this.kinds.forEach(kind => {
+            this.stream.on(kind + '_diff', change => this._receive(kind, change));
+            if (this.load) this.reload(kind);
+        });
+        this.stream.on('resync', () => this.catchUpAll());
+        let wasConnected = this.stream.connected;
+        this.stream.onStatus(connected => {
+            if (connected && !wasConnected) this.catchUpAll();
+            wasConnected = connected;
+        });
+        return this;
+    }
+
+    // Basis von außen setzen, z.B. aus plan.bin (Header X-Map-Epoch/X-Map-Version)
+    setState(kind, epoch, version, items) {
+        this.states[kind] = {epoch: epoch, version: version, items: items};
+        this._drainPending(kind);
+    }
+
+    async reload(kind) {
+        return this._exclusive(kind, async () => {
+            const response = await fetch(`${this.url}/${kind}/state`, {cache: 'no-store'});
+            if (!response.ok) throw new Error(`${kind}: HTTP ${response.status}`);
+            const result = await response.json();
+            this.states[kind] = {epoch: result.epoch, version: result.version, items: result.state};
+            this.statistics.reloaded++;
+            this._emit(kind, null);
+        });
+    }
+
+    catchUpAll() {
+        this.kinds.forEach(kind => this.catchUp(kind));
+    }
+
+    async catchUp(kind) {
+        const state = this.states[kind];
+        if (!state) return this.load ? this.reload(kind) : null;
+        return this._exclusive(kind, async () => {
+            const query = `since=${state.version}&epoch=${encodeURIComponent(state.epoch)}`;
+            const response = await fetch(`${this.url}/${kind}?${query}`, {cache: 'no-store'});
+            if (!response.ok) throw new Error(`${kind}: HTTP ${response.status}`);
+            const result = await response.json();
+            if (result.full_reload) {
+                this.busy[kind] = false;
+                return this.reload(kind);
+            }
+            result.changes.forEach(change => this._apply(kind, change));
+            this.statistics.caughtUp++;
+        });
+    }
+
+    _receive(kind, change) {
+        const state = this.states[kind];
+        if (!state || this.busy[kind]) {
+            // Während des Ladens eintreffende Diffs nach dem Laden anwenden
+            const pending = this.pending[kind] = this.pending[kind] || [];
+            pending.push(change);
+            // Lücken durch verworfene Diffs werden später per catchUp() geschlossen
+            if (pending.length > this.maxPending) pending.shift();
+            return;
+        }
+        if (change.epoch !== state.epoch) {
+            this.reload(kind);
+        } else if (change.version <= state.version) {
+            return;
+        } else if (change.base === state.version) {
+            this._apply(kind, change);
+        } else {
+            this.catchUp(kind);
+        }
+    }
+
+    _apply(kind, change) {
+        const state = this.states[kind];
+        if (change.epoch !== state.epoch || change.base !== state.version) return;
+        try {
+            state.items = MapChanges.applyDiff(state.items, change.diff);
+        } catch (error) {
+            console.warn('MapChanges:', kind, error.message);
+            // Erst nach einem laufenden Aufholen neu laden
+            setTimeout(() => this.reload(kind), 0);
+            return;
+        }
+        state.version = change.version;
+        this.statistics.patched++;
+        this._emit(kind, change);
+    }
+
+    async _exclusive(kind, task) {
+        if (this.busy[kind]) return;
+        this.busy[kind] = true;
+        try {
+            await task();
+        } catch (error) {
+            console.warn('MapChanges:', error.message);
+        } finally {
+            this.busy[kind] = false;
+        }
+        this._drainPending(kind);
+    }
+
+    _drainPending(kind) {
+        const pending = this.pending[kind] || [];
+        this.pending[kind] = [];
+        pending.forEach(change => this._receive(kind, change));
+    }
+
+    _emit(kind, change) {
+        (this.handlers[kind] || []).forEach(handler => handler(this.states[kind].items, change));
+    }
+
+    static itemKey(item, index) {
+        return item && !Array.isArray(item) && item.id !== undefined && item.id !== null ? item.id : index;
+    }
+
+    static applyDiff(items, diff) {
+        if (diff.type === 'sequence') {
+            const result = items.slice(0, diff.start).concat(diff.insert, items.slice(diff.start + diff.remove));
+            if (result.length !== diff.length) throw new Error('Diff passt nicht zum lokalen Stand');
+            return result;
+        }
+        const removed = new Set(diff.removed.map(String));
+        const modified = new Map(diff.modified.map(entry => [String(entry.key), entry.item]));
+        const result = [];
+        items.forEach((item, index) => {
+            const key = String(MapChanges.itemKey(item, index));
+            if (removed.has(key)) return;
+            result.push(modified.has(key) ? modified.get(key) : item);
+        });
+        return result.concat(diff.added.map(entry => entry.item));
+    }
+}
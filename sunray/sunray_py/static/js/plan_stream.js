@@ -0,0 +1,136 @@
+// Sunray Binärplan-Empfang (Format: navigation/plan_codec.py)
+// Der Plan wird blockweise gelesen und direkt in einen vorab reservierten
+// ArrayBuffer kopiert; Punkte werden ohne Objekt-Allokation als Float32Array
+// gelesen. onProgress wird nach jedem Block mit der Anzahl vollständig
+// empfangener Punkte aufgerufen, sodass bereits während der Übertragung
+// gezeichnet werden kann.
+//
+// Verwendung:
+//   loadPlanStream('/api/advanced_planning/plan.bin', {
+//       onHeader: plan => { ... },                      // Segmenttabelle und Bounding Box
+//       onProgress: (plan, points) => { ... },          // plan.points[0 .. 2*points)
+//       onDone: plan => { ... }
+//   });
+// plan.epoch/plan.version geben den Stand für die Plan-Diffs an (static/js/map_changes.js),
+// planToSegments(plan) liefert die Segmentliste, auf die diese angewendet werden.
+const PLAN_HEADER_SIZE = 32;
+const PLAN_SEGMENT_SIZE = 16;
+const PLAN_PATH_TYPES = ['mowing', 'transit', 'return_home', 'perimeter', 'obstacle_avoidance'];
+const PLAN_LITTLE_ENDIAN = new Uint8Array(new Uint16Array([1]).buffer)[0] === 1;
+
+function parsePlanHeader(bytes) {
+    const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+    const magic = String.fromCharCode(bytes[0], bytes[1], bytes[2], bytes[3]);
+    if (magic !== 'SPLN' || bytes[4] !== 1) {
+        throw new Error('Kein Sunray-Plan oder unbekannte Version');
+    }
+    const segmentCount = view.getUint32(8, true);
+    const pointCount = view.getUint32(12, true);
+    return {
+        segmentCount: segmentCount,
+        pointCount: pointCount,
+        bounds: {
+            minX: view.getFloat32(16, true), minY: view.getFloat32(20, true),
+            maxX: view.getFloat32(24, true), maxY: view.getFloat32(28, true)
+        },
+        pointsOffset: PLAN_HEADER_SIZE + PLAN_SEGMENT_SIZE * segmentCount,
+        byteLength: PLAN_HEADER_SIZE + PLAN_SEGMENT_SIZE * segmentCount + 8 * pointCount
+    };
+}
+
+function parsePlanSegments(bytes, plan) {
+    const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+    // Struktur-of-Arrays statt Objekt je Segment
+    plan.segStart = new Uint32Array(plan.segmentCount);
+    plan.segCount = new Uint32Array(plan.segmentCount);
+    plan.segType = new Uint8Array(plan.segmentCount);
+    plan.segMow = new Uint8Array(plan.segmentCount);
+    for (let i = 0; i < plan.segmentCount; i++) {
+        const offset = PLAN_HEADER_SIZE + i * PLAN_SEGMENT_SIZE;
+        plan.segStart[i] = view.getUint32(offset, true);
+        plan.segCount[i] = view.getUint32(offset + 4, true);
+        plan.segType[i] = view.getUint8(offset + 8);
+        plan.segMow[i] = view.getUint8(offset + 9);
+    }
+}
+
+function planPointsView(plan, received) {
+    const complete = Math.max(0, Math.min(plan.pointCount,
+        Math.floor((received - plan.pointsOffset) / 8)));
+    if (PLAN_LITTLE_ENDIAN) {
+        return complete;
+    }
+    // Big-Endian-Hosts: empfangene Punkte einmalig umkopieren
+    const view = new DataView(plan.buffer);
+    for (let i = plan.convertedPoints || 0; i < complete * 2; i++) {
+        plan.points[i] = view.getFloat32(plan.pointsOffset + i * 4, true);
+    }
+    plan.convertedPoints = complete * 2;
+    return complete;
+}
+
+async function loadPlanStream(url, handlers = {}) {
+    const response = await fetch(url, {cache: 'no-store'});
+    if (!response.ok) {
+        throw new Error('Plan nicht verfügbar (HTTP ' + response.status + ')');
+    }
+    const reader = response.body.getReader();
+    let head = new Uint8Array(0);
+    let plan = null;
+    let bytes = null;
+    let received = 0;
+
+    while (true) {
+        const {done, value} = await reader.read();
+        if (done) break;
+
+        if (!plan) {
+            // Bis Header und Segmenttabelle vollständig sind, zwischenspeichern
+            const merged = new Uint8Array(head.length + value.length);
+            merged.set(head);
+            merged.set(value, head.length);
+            head = merged;
+            if (head.length < PLAN_HEADER_SIZE) continue;
+            const header = parsePlanHeader(head);
+            if (head.length < header.pointsOffset) continue;
+
+            plan = header;
+            plan.epoch = response.headers.get('X-Map-Epoch');
+            plan.version = parseInt(response.headers.get('X-Map-Version') || '0', 10);
+            plan.buffer = new ArrayBuffer(plan.byteLength);
+            bytes = new Uint8Array(plan.buffer);
+            bytes.set(head.subarray(0, Math.min(head.length, plan.byteLength)));
+            received = Math.min(head.length, plan.byteLength);
+            parsePlanSegments(bytes, plan);
+            plan.points = PLAN_LITTLE_ENDIAN ?
+                new Float32Array(plan.buffer, plan.pointsOffset, plan.pointCount * 2) :
+                new Float32Array(plan.pointCount * 2);
+            head = null;
+            if (handlers.onHeader) handlers.onHeader(plan);
+        } else {
+            const length = Math.min(value.length, plan.byteLength - received);
+            bytes.set(value.subarray(0, length), received);
+            received += length;
+        }
+        if (handlers.onProgress) handlers.onProgress(plan, planPointsView(plan, received));
+    }
+    if (!plan || received < plan.byteLength) {
+        throw new Error('Plan unvollständig empfangen');
+    }
+    if (handlers.onDone) handlers.onDone(plan);
+    return plan;
+}
+
+function planToSegments(plan) {
+    const segments = [];
+    for (let s = 0; s < plan.segmentCount; s++) {
+        const points = [];
+        const start = plan.segStart[s];
+        for (let i = start; i < start + plan.segCount[s]; i++) {
+            points.push({x: plan.points[2 * i], y: plan.points[2 * i + 1]});
+        }
+        segments.push({points: points, path_type: PLAN_PATH_TYPES[plan.segType[s]] || 'mowing',
+                       mow_enabled: plan.segMow[s] === 1});
+    }
+    return segments;
+}
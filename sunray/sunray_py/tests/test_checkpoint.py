@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+"""
+Tests für den absturzsicheren Laufzeit-Checkpoint (Warmstart).
+"""
+
+import unittest
+import tempfile
+import json
+import os
+import sys
+import threading
+
+# Pfad zum Hauptverzeichnis hinzufügen
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from checkpoint import CheckpointManager
+from state_estimator import StateEstimator
+from op import IdleOp
+
+class Counter:
+    """Minimale Komponente mit Checkpoint-Schnittstelle."""
+    def __init__(self):
+        self.value = 0
+
+    def checkpoint_state(self):
+        return {'value': self.value}
+
+    def restore_checkpoint(self, state):
+        self.value = state['value']
+
+class SnapshotComponent:
+    """Komponente mit unveränderlichem Zustand: capture hält nur die Referenz."""
+    def __init__(self):
+        self.state = ('a',)
+        self.encoded_in = []
+
+    def checkpoint_state(self):
+        return self.checkpoint_encode(self.checkpoint_capture())
+
+    def checkpoint_capture(self):
+        return self.state
+
+    def checkpoint_encode(self, captured):
+        self.encoded_in.append(threading.current_thread().name)
+        return {'items': list(captured)}
+
+    def restore_checkpoint(self, state):
+        self.state = tuple(state['items'])
+
+class TestCheckpointManager(unittest.TestCase):
+    """Tests für CheckpointManager."""
+
+    def setUp(self):
+        """Setup für jeden Test."""
+        self.temp_dir = tempfile.TemporaryDirectory()
+        self.filename = os.path.join(self.temp_dir.name, 'checkpoint.json')
+
+    def tearDown(self):
+        """Cleanup nach jedem Test."""
+        self.temp_dir.cleanup()
+
+    def _manager(self, **kwargs):
+        manager = CheckpointManager(self.filename, **kwargs)
+        self.addCleanup(manager.stop)
+        return manager
+
+    def test_roundtrip(self):
+        """Ein geschriebener Checkpoint stellt alle Komponenten wieder her."""
+        counter = Counter()
+        manager = self._manager()
+        manager.register('counter', counter)
+        counter.value = 42
+        manager.capture({'operation': {'name': 'mow', 'params': {}}})
+        manager.flush()
+
+        restored = Counter()
+        manager2 = self._manager()
+        manager2.register('counter', restored)
+        state = manager2.restore()
+
+        self.assertEqual(restored.value, 42)
+        self.assertEqual(state['operation']['name'], 'mow')
+
+    def test_capture_is_copy(self):
+        """Spätere Änderungen verändern einen erfassten Snapshot nicht."""
+        counter = Counter()
+        manager = self._manager()
+        manager.register('counter', counter)
+        counter.value = 1
+        snapshot = manager.capture()
+        counter.value = 2
+        self.assertEqual(snapshot['state']['counter']['value'], 1)
+
+    def test_deferred_encoding_on_writer_thread(self):
+        """capture() hält nur die Referenz; umgewandelt wird im Schreib-Thread."""
+        component = SnapshotComponent()
+        manager = self._manager()
+        manager.register('planner', component)
+        snapshot = manager.capture()
+        # Neuer Stand nach dem Erfassen ändert den geschriebenen Checkpoint nicht
+        component.state = ('a', 'b')
+        manager.flush()
+        self.assertNotIn('planner', snapshot['state'])
+        self.assertEqual(component.encoded_in, ['checkpoint-writer'])
+
+        restored = SnapshotComponent()
+        manager2 = self._manager()
+        manager2.register('planner', restored)
+        manager2.restore()
+        self.assertEqual(restored.state, ('a',))
+
+    def test_corrupt_file_falls_back_to_backup(self):
+        """Bei beschädigter Hauptdatei wird der vorherige Checkpoint verwendet."""
+        counter = Counter()
+        manager = self._manager()
+        manager.register('counter', counter)
+        counter.value = 1
+        manager.capture()
+        manager.flush()
+        counter.value = 2
+        manager.capture()
+        manager.flush()
+
+        with open(self.filename, 'r') as f:
+            record = json.load(f)
+        record['state']['counter']['value'] = 99  # Prüfsumme passt nicht mehr
+        with open(self.filename, 'w') as f:
+            json.dump(record, f)
+
+        restored = Counter()
+        manager2 = self._manager()
+        manager2.register('counter', restored)
+        manager2.restore()
+        self.assertEqual(restored.value, 1)
+
+    def test_stale_checkpoint_ignored(self):
+        """Zu alte Checkpoints führen zu einem Kaltstart."""
+        manager = self._manager(max_age=0.001)
+        manager.register('counter', Counter())
+        snapshot = manager.capture()
+        manager.flush()
+        snapshot['time'] -= 10
+        manager.write(snapshot)
+
+        self.assertEqual(manager.restore(), {})
+
+    def test_estimator_and_operation_state(self):
+        """StateEstimator und Operation liefern serialisierbaren Zustand."""
+        estimator = StateEstimator({})
+        estimator.state_x = 3.5
+        estimator.heading_filter.update(1.2)
+        op = IdleOp('idle')
+        op.start({'reason': 'test'})
+
+        manager = self._manager()
+        manager.register('estimator', estimator)
+        manager.capture({'operation': op.checkpoint_state()})
+        manager.flush()
+
+        restored = StateEstimator({})
+        manager2 = self._manager()
+        manager2.register('estimator', restored)
+        state = manager2.restore()
+
+        self.assertEqual(restored.state_x, 3.5)
+        self.assertTrue(restored.heading_filter.initialized)
+        self.assertEqual(state['operation']['params'], {'reason': 'test'})
+
+if __name__ == '__main__':
+    unittest.main()
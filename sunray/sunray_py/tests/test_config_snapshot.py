@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+"""
+Tests für unveränderliche Konfigurations-Snapshots.
+Prüft typisierte Zugriffe, atomaren Austausch und Benachrichtigung.
+"""
+
+import unittest
+import tempfile
+import os
+import sys
+from dataclasses import FrozenInstanceError
+
+# Pfad zum Hauptverzeichnis hinzufügen
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from config import Config, ConfigSnapshot
+
+class TestConfigSnapshot(unittest.TestCase):
+    """Tests für ConfigSnapshot und Config.subscribe()."""
+
+    def setUp(self):
+        """Setup für jeden Test."""
+        self.temp_dir = tempfile.TemporaryDirectory()
+        self.temp_config_path = os.path.join(self.temp_dir.name, 'config.json')
+
+    def tearDown(self):
+        """Cleanup nach jedem Test."""
+        self.temp_dir.cleanup()
+
+    def test_typed_sections(self):
+        """Typisierte Sektionen entsprechen den Rohwerten."""
+        config = Config(self.temp_config_path)
+        snapshot = config.snapshot()
+
+        self.assertIsInstance(snapshot, ConfigSnapshot)
+        self.assertEqual(snapshot.motor.pid_left.kp, config.get('motor.pid.left.kp'))
+        self.assertEqual(snapshot.motor.max_motor_current,
+                         config.get('motor.limits.max_motor_current'))
+        self.assertEqual(snapshot.astar.max_iterations, 10000)
+        self.assertEqual(snapshot.planning.strategy, 'hybrid')
+
+    def test_snapshot_is_frozen(self):
+        """Snapshots können nicht verändert werden."""
+        snapshot = Config(self.temp_config_path).snapshot()
+
+        with self.assertRaises(FrozenInstanceError):
+            snapshot.motor.pid_left.kp = 5.0
+        with self.assertRaises(TypeError):
+            snapshot.flat['motor.pid.left.kp'] = 5.0
+
+    def test_set_swaps_snapshot(self):
+        """set() baut einen neuen Snapshot, alte Referenzen bleiben konsistent."""
+        config = Config(self.temp_config_path)
+        old_snapshot = config.snapshot()
+
+        self.assertTrue(config.set('motor.pid.left.kp', 2.5))
+        new_snapshot = config.snapshot()
+
+        self.assertIsNot(old_snapshot, new_snapshot)
+        self.assertGreater(new_snapshot.version, old_snapshot.version)
+        self.assertEqual(new_snapshot.motor.pid_left.kp, 2.5)
+        self.assertNotEqual(old_snapshot.motor.pid_left.kp, 2.5)
+        self.assertEqual(config.get('motor.pid.left.kp'), 2.5)
+
+    def test_subscribers_notified(self):
+        """Abonnenten erhalten jeden neuen Snapshot."""
+        config = Config(self.temp_config_path)
+        received = []
+        config.subscribe(received.append)
+
+        config.set('advanced_path_planning.max_segment_length', 4.0)
+        config.reload()
+
+        self.assertEqual(len(received), 2)
+        self.assertEqual(received[0].planning.max_segment_length, 4.0)
+        self.assertIs(received[-1], config.snapshot())
+
+        config.unsubscribe(received.append)
+        config.set('system.debug', True)
+        self.assertEqual(len(received), 2)
+
+    def test_set_does_not_change_old_snapshots(self):
+        """set() kopiert den geänderten Zweig; ausgegebene Snapshots bleiben unverändert."""
+        config = Config(self.temp_config_path)
+        old = config.snapshot()
+        old_pid = old.get('motor.pid.left')
+        old_kp = old_pid['kp']
+
+        config.set('motor.pid.left.kp', old_kp + 1.0)
+
+        self.assertEqual(old.get('motor.pid.left.kp'), old_kp)
+        self.assertEqual(old_pid['kp'], old_kp)
+        self.assertEqual(old.get('motor')['pid']['left']['kp'], old_kp)
+        self.assertEqual(config.get('motor.pid.left')['kp'], old_kp + 1.0)
+        # Unveränderte Zweige werden weiter geteilt
+        self.assertIs(config.get('navigation'), old.get('navigation'))
+
+    def test_subscribed_instances_not_kept_alive(self):
+        """Gebundene Methoden werden schwach referenziert."""
+        import gc
+        import weakref
+        config = Config(self.temp_config_path)
+        received = []
+
+        class Listener:
+            def on_change(self, snapshot):
+                received.append(snapshot.version)
+
+        listener = Listener()
+        config.subscribe(listener.on_change)
+        config.set('system.debug', True)
+        self.assertEqual(len(received), 1)
+
+        alive = weakref.ref(listener)
+        del listener
+        gc.collect()
+        self.assertIsNone(alive())
+        config.set('system.debug', False)
+        self.assertEqual(len(received), 1)
+        self.assertEqual(config._subscribers, [])
+
+    def test_get_nested_and_missing(self):
+        """get() liefert Teilbäume und Standardwerte wie bisher."""
+        config = Config(self.temp_config_path)
+
+        self.assertIsInstance(config.get('motor.pid.left', {}), dict)
+        self.assertEqual(config.get('does.not.exist', 42), 42)
+        self.assertEqual(config.get('motor.pid.left.kp.deeper', 'x'), 'x')
+
+    def test_direct_assignment_rebuilds(self):
+        """Direkte Zuweisung von config.config ersetzt den Snapshot."""
+        config = Config(self.temp_config_path)
+        config.config = {"motor": {"invalid": "config"}}
+
+        self.assertFalse(config.validate_config())
+        self.assertEqual(config.snapshot().motor.pid_left.kp, 1.0)
+
+if __name__ == '__main__':
+    unittest.main()
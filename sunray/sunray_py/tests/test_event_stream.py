@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""
+Tests für den SSE-Push-Kanal der Web-Oberfläche.
+"""
+
+import unittest
+import threading
+import json
+import time
+import os
+import sys
+
+# Pfad zum Hauptverzeichnis hinzufügen
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from communication.event_stream import EventHub, encode_event, subscribe_from_args
+
+def parse(messages):
+    """Zerlegt SSE-Nachrichten in (event, data)-Paare."""
+    result = []
+    for message in messages:
+        fields = dict(line.split(': ', 1) for line in message.decode('utf-8').strip().split('\n'))
+        result.append((fields['event'], json.loads(fields['data'])))
+    return result
+
+class TestEventHub(unittest.TestCase):
+    """Tests für EventHub."""
+
+    def test_encoded_once_for_all_clients(self):
+        """Ein Ereignis wird einmal kodiert und an alle Clients verteilt."""
+        hub = EventHub(rate_caps={})
+        clients = [hub.subscribe() for _ in range(5)]
+        self.assertEqual(hub.publish('plan', {'action': 'planned'}), 5)
+        self.assertEqual(hub.encode_count, 1)
+        payloads = [hub.poll(c, 0.1) for c in clients]
+        self.assertTrue(all(p[0] is payloads[0][0] for p in payloads))
+
+    def test_no_work_without_subscribers(self):
+        """Ohne Abonnenten wird nichts kodiert."""
+        hub = EventHub()
+        self.assertEqual(hub.publish('telemetry', {'x': 1}, coalesce=True), 0)
+        self.assertEqual(hub.encode_count, 0)
+
+    def test_event_filter(self):
+        """Clients erhalten nur die abonnierten Ereignistypen."""
+        hub = EventHub(rate_caps={})
+        client = hub.subscribe(events=['zones'])
+        hub.publish('plan', {'a': 1})
+        hub.publish('zones', {'a': 2})
+        self.assertEqual(parse(hub.poll(client, 0.1)), [('zones', {'a': 2})])
+
+    def test_snapshots_coalesce_and_rate_cap(self):
+        """Ein langsamer Client erhält nur den neuesten Snapshot im Takt seines Limits."""
+        hub = EventHub(rate_caps={'telemetry': 0.2})
+        client = hub.subscribe()
+        for i in range(10):
+            hub.publish('telemetry', {'i': i}, coalesce=True)
+        self.assertEqual(parse(hub.poll(client, 0.1)), [('telemetry', {'i': 9})])
+
+        hub.publish('telemetry', {'i': 10}, coalesce=True)
+        self.assertEqual(hub.poll(client, 0.05), [])
+        start = time.monotonic()
+        self.assertEqual(parse(hub.poll(client, 1.0)), [('telemetry', {'i': 10})])
+        self.assertGreater(time.monotonic() - start, 0.1)
+
+    def test_client_cannot_exceed_server_rate(self):
+        """Angeforderte Raten unterhalb des Server-Limits werden angehoben."""
+        hub = EventHub(rate_caps={'telemetry': 0.5})
+        client = subscribe_from_args(hub, {'telemetry_interval': '0.01', 'plan_interval': '2'})
+        self.assertEqual(client.rate_caps['telemetry'], 0.5)
+        self.assertEqual(client.rate_caps['plan'], 2.0)
+
+    def test_overflow_requests_resync(self):
+        """Läuft die Warteschlange über, folgt ein resync-Ereignis statt alter Änderungen."""
+        hub = EventHub(rate_caps={}, max_queue=3)
+        slow = hub.subscribe()
+        fast = hub.subscribe()
+        for i in range(5):
+            hub.publish('plan', {'i': i})
+            hub.poll(fast, 0.0)
+        events = parse(hub.poll(slow, 0.1))
+        self.assertEqual(events[0][0], 'resync')
+        self.assertEqual(events[1:], [('plan', {'i': 4})])
+        self.assertGreater(slow.dropped, 0)
+        self.assertEqual(fast.dropped, 0)
+
+    def test_stream_generator(self):
+        """Der Stream liefert Ereignisse und meldet den Client beim Schließen ab."""
+        hub = EventHub(rate_caps={}, heartbeat=0.05)
+        client = hub.subscribe()
+        stream = hub.stream(client)
+        self.assertTrue(next(stream).startswith(b'retry:'))
+        self.assertEqual(next(stream), b': ping\n\n')
+
+        threading.Timer(0.02, hub.publish, ('zones', {'action': 'created'})).start()
+        self.assertEqual(parse([next(stream)]), [('zones', {'action': 'created'})])
+        stream.close()
+        self.assertFalse(hub.has_subscribers())
+
+    def test_max_clients(self):
+        """Über der Client-Grenze wird kein weiterer Stream angenommen."""
+        hub = EventHub(max_clients=1)
+        self.assertIsNotNone(hub.subscribe())
+        self.assertIsNone(hub.subscribe())
+
+    def test_encode_event_format(self):
+        """Das SSE-Format enthält id, event und eine data-Zeile."""
+        self.assertEqual(encode_event('plan', {'a': 1}, 7), b'id: 7\nevent: plan\ndata: {"a":1}\n\n')
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+"""
+Tests für den Emulator der Pico-Firmware (simulation/firmware.py, simulation/micropython/).
+"""
+
+import unittest
+import errno
+import os
+import sys
+
+# Pfad zum Hauptverzeichnis hinzufügen
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.insert(0, ROOT)
+
+from simulation.firmware import FIRMWARE_DIR, Firmware, command
+from simulation.micropython import Board, build_modules
+from simulation.micropython import utime
+from simulation.protocols import pico_crc
+from simulation.simulator import Simulator
+
+MAIN_OLD = os.path.join(FIRMWARE_DIR, 'main_old.py')
+
+def check_crc(line):
+    """Antwort ohne Prüfsumme, wenn diese stimmt."""
+    body, crc = line.rsplit(',', 1)
+    return body if pico_crc(body) == crc else None
+
+class TestFirmwareEmulator(unittest.TestCase):
+    """Unveränderte Firmware main_old.py gegen den Simulator."""
+
+    def setUp(self):
+        self.sim = Simulator(config={'pico': {'firmware': MAIN_OLD, 'hang_timeout': 0.3}}, seed=1)
+        self.sim.run(0.2)
+        self.sim.read_pico_lines()
+
+    def tearDown(self):
+        self.sim.close()
+
+    def request(self, line, duration=0.1):
+        self.sim.send(command(line))
+        self.sim.run(duration)
+        return [check_crc(reply) for reply in self.sim.read_pico_lines()]
+
+    def test_version_with_crc(self):
+        replies = self.request('AT+V')
+        self.assertEqual(len(replies), 1)
+        self.assertTrue(replies[0].startswith('V,'))
+
+    def test_command_without_crc_is_rejected(self):
+        self.sim.send('AT+V')
+        self.sim.run(0.1)
+        self.assertEqual(self.sim.read_pico_lines(), [])
+
+    def test_motor_odometry_and_timeout(self):
+        self.request('AT+M,100,100,0', 1.0)
+        mower = self.sim.mower
+        self.assertGreater(mower.pwm_left, 0)
+        self.assertGreater(mower.pwm_right, 0)
+        reply = self.request('AT+M,100,100,0')[0].split(',')
+        # Encoder-Flanken aus dem Modell zählt die Firmware in ihren Interrupts
+        self.assertGreater(int(reply[1]), 0)
+        self.assertGreater(int(reply[2]), 0)
+        # Ohne weitere Befehle stoppt die Firmware die Motoren nach 3 s
+        self.sim.run(3.5)
+        self.assertEqual((mower.pwm_left, mower.pwm_right), (0, 0))
+
+    def test_bumper_in_summary(self):
+        self.sim.inject('bumper')
+        self.sim.run(0.2)
+        fields = self.request('AT+S')[0].split(',')
+        self.assertEqual(fields[5], '1')
+        # batVoltageLP startet bei 0 und folgt der INA226-Busspannung tiefpassgefiltert
+        self.assertGreater(float(fields[1]), 0.0)
+
+    def test_watchdog_reset_after_hang(self):
+        firmware = self.sim.pico.firmware
+        self.sim.send(command('AT+Y'))
+        self.sim.run(1.0)
+        self.assertIn('hang', firmware.errors)
+        self.assertEqual(firmware.resets['watchdog'], 0)
+        # WDT(6000) in Boardzeit, nicht in Rechenzeit
+        self.sim.run(6.0)
+        self.assertEqual(firmware.resets['watchdog'], 1)
+        self.assertEqual(firmware.boots, 2)
+        replies = self.request('AT+V')
+        self.assertTrue(replies and replies[0].startswith('V,'))
+
+class TestMicroPythonLayer(unittest.TestCase):
+    """Stand-ins für machine und utime."""
+
+    def test_ticks_wraparound(self):
+        board = Board(start_us=(utime.TICKS_MAX - 500) * 1000)
+        clock = build_modules(board, None)['utime']
+        before = clock.ticks_ms()
+        deadline = clock.ticks_add(before, 1000)
+        board.us += 1_000_000
+        after = clock.ticks_ms()
+        self.assertLess(after, before)
+        self.assertEqual(clock.ticks_diff(after, before), 1000)
+        self.assertEqual(clock.ticks_diff(deadline, after), 0)
+
+    def test_missing_i2c_device(self):
+        board = Board()
+        machine = build_modules(board, None)['machine']
+        bus = machine.I2C(0)
+        with self.assertRaises(OSError) as ctx:
+            bus.readfrom_mem(0x40, 0x02, 2)
+        self.assertEqual(ctx.exception.errno, errno.EIO)
+
+    def test_boot_error_is_reported(self):
+        firmware = Firmware(os.path.join(FIRMWARE_DIR, 'main.py'))
+        try:
+            self.assertTrue(firmware.start())
+            firmware.run_until(100_000)
+            self.assertTrue(any('command_processor' in error for error in firmware.errors))
+        finally:
+            firmware.stop()
+
+if __name__ == '__main__':
+    unittest.main()
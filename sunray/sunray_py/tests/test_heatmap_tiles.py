@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""
+Tests für die Heatmap-Kacheln (heatmap_tiles.py).
+"""
+
+import unittest
+import struct
+import zlib
+import os
+import sys
+
+# Pfad zum Hauptverzeichnis hinzufügen
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from heatmap_tiles import HeatmapTiles, TILE_SIZE
+
+def decode_png(png):
+    """Liest Größe und Palettenindizes einer Kachel (nur Filter 0, wie von encode_png erzeugt)."""
+    assert png[:8] == b'\x89PNG\r\n\x1a\n'
+    pos, chunks = 8, {}
+    while pos < len(png):
+        length, kind = struct.unpack('>I4s', png[pos:pos + 8])
+        data = png[pos + 8:pos + 8 + length]
+        crc, = struct.unpack('>I', png[pos + 8 + length:pos + 12 + length])
+        assert crc == zlib.crc32(kind + data)
+        chunks[kind] = chunks.get(kind, b'') + data
+        pos += 12 + length
+    width, height, depth, color = struct.unpack('>IIBB', chunks[b'IHDR'][:10])
+    raw = zlib.decompress(chunks[b'IDAT'])
+    rows = [raw[r * (width + 1) + 1:(r + 1) * (width + 1)] for r in range(height)]
+    assert all(raw[r * (width + 1)] == 0 for r in range(height))
+    return width, height, depth, color, len(chunks[b'PLTE']) // 3, chunks[b'tRNS'], rows
+
+class TestHeatmapTiles(unittest.TestCase):
+    """Tests für HeatmapTiles."""
+
+    def setUp(self):
+        self.heatmap = HeatmapTiles({'resolution': 0.1, 'max_zoom': 3, 'mow_width': 0.3})
+
+    def test_png_is_valid_palette_image(self):
+        """Kacheln sind gültige 256x256-Palettenbilder mit transparentem Index 0."""
+        self.heatmap.add_sample(1.05, 2.05, gps_accuracy=0.02)
+        png, version = self.heatmap.render_tile('gps_accuracy', 3, 0, 0)
+        width, height, depth, color, colors, trns, rows = decode_png(png)
+        self.assertEqual((width, height, depth, color, colors), (TILE_SIZE, TILE_SIZE, 8, 3, 256))
+        self.assertEqual(trns[0], 0)
+        self.assertGreater(version, 0)
+        # Zelle (10, 20): Zeile 0 liegt im Norden
+        self.assertNotEqual(rows[TILE_SIZE - 1 - 20][10], 0)
+        self.assertEqual(sum(1 for row in rows for px in row if px), 1)
+
+    def test_mean_value_on_all_zoom_levels(self):
+        """Mittelwerte stimmen auf feiner und grober Stufe überein."""
+        layer = self.heatmap.layers['mow_current']
+        for value in (1.0, 2.0):
+            self.heatmap.add_sample(0.55, 0.55, mow_current=value)
+        for z in range(4):
+            tile = layer.levels[z][(0, 0)]
+            cell = 5 >> (3 - z)
+            i = (TILE_SIZE - 1 - cell) * TILE_SIZE + cell
+            self.assertEqual(tile.counts[i], 2)
+            self.assertAlmostEqual(tile.sums[i] / tile.counts[i], 1.5)
+
+    def test_coverage_counts_passes_not_samples(self):
+        """Langsames Fahren über dieselben Zellen zählt nur eine Überfahrt; eine zweite Fahrt zwei."""
+        layer = self.heatmap.layers['coverage']
+        for _ in range(2):
+            for step in range(50):
+                self.heatmap.add_sample(step * 0.02, 0.05, mowing=True)
+            self.heatmap.add_sample(0.0, 0.0, mowing=False)
+        tile = layer.levels[3][(0, 0)]
+        i = (TILE_SIZE - 1 - 0) * TILE_SIZE + 5
+        self.assertEqual(tile.counts[i], 2)
+        coarse = layer.levels[0][(0, 0)]
+        self.assertEqual(coarse.counts[(TILE_SIZE - 1) * TILE_SIZE], 2)
+
+    def test_only_dirty_tiles_are_rendered(self):
+        """Unveränderte Kacheln kommen aus dem Cache; nur geänderte werden neu kodiert."""
+        self.heatmap.add_sample(1.0, 1.0, gps_accuracy=0.05)
+        self.heatmap.add_sample(30.0, 1.0, gps_accuracy=0.05)     # andere Kachel auf Stufe 3
+        first, _ = self.heatmap.render_tile('gps_accuracy', 3, 0, 0)
+        self.heatmap.render_tile('gps_accuracy', 3, 1, 0)
+        renders = self.heatmap.renders
+        since = self.heatmap.version
+        self.heatmap.add_sample(30.5, 1.0, gps_accuracy=0.05)
+        changed = self.heatmap.changes(since, ['gps_accuracy'], zoom=3)
+        self.assertEqual([tile[:4] for tile in changed], [['gps_accuracy', 3, 1, 0]])
+        self.assertIs(self.heatmap.render_tile('gps_accuracy', 3, 0, 0)[0], first)
+        self.heatmap.render_tile('gps_accuracy', 3, 1, 0)
+        self.assertEqual(self.heatmap.renders, renders + 1)
+
+    def test_unchanged_pixels_keep_version(self):
+        """Messungen ohne sichtbare Änderung erhöhen keine Version."""
+        self.heatmap.add_sample(1.0, 1.0, gps_accuracy=0.05)
+        version = self.heatmap.version
+        self.heatmap.add_sample(1.0, 1.0, gps_accuracy=0.05)
+        self.assertEqual(self.heatmap.version, version)
+
+    def test_negative_coordinates_and_empty_tiles(self):
+        """Negative Koordinaten liegen in Kacheln mit negativem Index; leere Kacheln sind transparent."""
+        self.heatmap.add_sample(-0.05, -0.05, gps_accuracy=0.1)
+        self.assertIn((-1, -1), self.heatmap.layers['gps_accuracy'].levels[3])
+        png, version = self.heatmap.render_tile('gps_accuracy', 3, 5, 5)
+        self.assertEqual(version, 0)
+        self.assertFalse(any(px for row in decode_png(png)[6] for px in row))
+        self.assertIsNone(self.heatmap.render_tile('unbekannt', 3, 0, 0))
+        self.assertIsNone(self.heatmap.render_tile('coverage', 9, 0, 0))
+
+if __name__ == '__main__':
+    unittest.main()
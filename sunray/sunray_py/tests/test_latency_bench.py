@@ -0,0 +1,200 @@
+#!/usr/bin/env python3
+"""
+Tests für den Reaktionszeit-Prüfstand und die Fehlerfälle des Simulators.
+"""
+
+import unittest
+import os
+import sys
+import tempfile
+import threading
+import time
+from unittest import mock
+
+# Pfad zum Hauptverzeichnis hinzufügen
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.insert(0, ROOT)
+
+from simulation import latency_bench
+from simulation.latency_bench import LatencyBench, LatencyRecorder, drive_pwm, shows_event, summarize, merge_spec
+from simulation.pty_bridge import PtyBridge
+from simulation.simulator import Simulator
+from utils.snapshot import SnapshotBuffer
+
+class TestFaultInjection(unittest.TestCase):
+    def test_faults_reach_protocol(self):
+        """Eingeschaltete Fehlerfälle stehen in AT+S:- und S,-Zeilen, clear() hebt sie auf."""
+        sim = Simulator(seed=1)
+        sim.inject('bumper')
+        sim.inject('lift')
+        sim.inject('overload')
+        sim.run(0.2)
+        line = sim.read_pico_lines()[-1]
+        self.assertTrue(shows_event('bumper', line))
+        self.assertTrue(shows_event('lift', line))
+        self.assertTrue(shows_event('overload', sim.send('AT+S')[0]))
+
+        for fault in ('bumper', 'lift', 'overload'):
+            sim.clear(fault)
+        sim.run(0.2)
+        line = sim.read_pico_lines()[-1]
+        self.assertFalse(shows_event('bumper', line))
+        self.assertFalse(shows_event('overload', sim.send('AT+S')[0]))
+        self.assertFalse(sim.inject('regen'))
+
+    def test_rtk_loss(self):
+        """RTK-Verlust erzwingt die Fix-Qualität unabhängig von der Zone."""
+        sim = Simulator(seed=2)
+        sim.run(0.5)
+        self.assertEqual(sim.last_gnss['fix'], 'fixed')
+        sim.inject('rtk_loss', '3d')
+        sim.run(0.5)
+        self.assertEqual(sim.last_gnss['fix'], '3d')
+        sim.clear('rtk_loss')
+        sim.run(0.5)
+        self.assertEqual(sim.last_gnss['fix'], 'fixed')
+
+class TestLatencyRecorder(unittest.TestCase):
+    def test_drive_pwm(self):
+        self.assertEqual(drive_pwm('AT+MOTOR,0,0,200'), (0, 0))
+        self.assertEqual(drive_pwm('AT+M,10,20,0'), (20, 10))
+        self.assertEqual(drive_pwm('AT+STOP'), (0, 0))
+        self.assertIsNone(drive_pwm('AT+S,1'))
+
+    def test_latency_from_wire(self):
+        """Latenz zählt ab der ersten Zeile mit dem Ereignis, nicht ab dem Einschalten."""
+        recorder = LatencyRecorder()
+        recorder.on_operation('mow', 0.0)
+        recorder.on_commands(['AT+MOTOR,100,100,200'], 0.1)
+        self.assertTrue(recorder.ready('mow'))
+
+        recorder.begin('bumper', ['drive_stop', 'operation'], 1.0)
+        # Zufälliger Stopp vor dem Ereignis auf der Leitung zählt nicht
+        recorder.on_commands(['AT+MOTOR,0,0,200'], 1.01)
+        recorder.on_commands(['AT+MOTOR,100,100,200'], 1.02)
+        recorder.on_pico_lines(['AT+S:1,1,1,0.00,,0,0,0'], 1.03)
+        recorder.on_pico_lines(['AT+S:1,1,1,0.00,,3,0,0'], 1.05)
+        recorder.on_commands(['AT+S,1', 'AT+MOTOR,0,0,200'], 1.17)
+        self.assertFalse(recorder.complete())
+        recorder.on_operation('smart_bumper_escape', 1.25)
+        self.assertTrue(recorder.complete())
+        result = recorder.end()
+        self.assertAlmostEqual(result['signal'], 0.05)
+        self.assertAlmostEqual(result['latency']['drive_stop'], 0.12)
+        self.assertAlmostEqual(result['latency']['operation'], 0.20)
+        self.assertEqual(result['missed'], [])
+
+    def test_budget(self):
+        """Perzentil über Budget und ausgebliebene Reaktionen sind Verletzungen."""
+        spec = merge_spec({'events': {'bumper': {'budget': {'drive_stop': 0.2}}, 'lift': {}}})
+        results = [{'event': 'bumper', 'signal': 0.02, 'latency': {'drive_stop': v, 'operation': 0.3},
+                    'missed': [], 'operation_before': 'mow'} for v in (0.1, 0.12, 0.15)]
+        results.append({'event': 'lift', 'signal': 0.03, 'latency': {'drive_stop': 0.1}, 'missed': [],
+                        'operation_before': 'mow'})
+        report = summarize(results, spec)
+        self.assertTrue(report['passed'])
+        self.assertAlmostEqual(report['events']['bumper']['reactions']['drive_stop']['p50'], 0.12)
+
+        results.append({'event': 'bumper', 'signal': 0.02, 'latency': {'drive_stop': 0.4},
+                        'missed': ['operation'], 'operation_before': 'mow'})
+        results.append({'event': 'lift', 'signal': 0.03, 'latency': {}, 'missed': ['drive_stop'],
+                        'operation_before': 'mow'})
+        report = summarize(results, spec)
+        self.assertFalse(report['passed'])
+        self.assertEqual(len(report['violations']), 2)
+
+class FakeController(threading.Thread):
+    """Steht für main.py: fährt, stoppt bei Bumper oder ohne RTK-Fix (GGA-Qualität 4/5)."""
+    def __init__(self, bridge: PtyBridge, snapshots: SnapshotBuffer):
+        super().__init__(daemon=True)
+        self.pico = os.open(bridge.pico.path, os.O_RDWR | os.O_NONBLOCK)
+        self.gnss = os.open(bridge.gnss.path, os.O_RDWR | os.O_NONBLOCK)
+        self.snapshots = snapshots
+        self.running = True
+        self.bumper = False
+        self.rtk = True
+        self.buffers = {self.pico: '', self.gnss: ''}
+
+    def _lines(self, fd):
+        try:
+            self.buffers[fd] += os.read(fd, 65536).decode('ascii', errors='ignore')
+        except BlockingIOError:
+            pass
+        *lines, self.buffers[fd] = self.buffers[fd].split('\n')
+        return lines
+
+    def run(self):
+        while self.running:
+            for line in self._lines(self.pico):
+                if line.startswith('AT+S:'):
+                    self.bumper = shows_event('bumper', line)
+            for line in self._lines(self.gnss):
+                if '$GPGGA' in line:
+                    self.rtk = line[line.index('$GPGGA'):].split(',')[6] in ('4', '5')
+            stop = self.bumper or not self.rtk
+            os.write(self.pico, b'AT+MOTOR,0,0,0\n' if stop else b'AT+MOTOR,100,100,200\n')
+            self.snapshots.publish({'operation': 'escape' if stop else 'mow'})
+            time.sleep(0.02)
+
+    def close(self):
+        self.running = False
+        self.join(timeout=1.0)
+        os.close(self.pico)
+        os.close(self.gnss)
+
+class TestLatencyBench(unittest.TestCase):
+    def test_trials_over_pty(self):
+        """Versuche über echte Pseudo-Terminals: Reaktionen werden gefunden und bewertet."""
+        directory = tempfile.mkdtemp()
+        bridge = PtyBridge(Simulator(seed=3), directory, poll_interval=0.001)
+        snapshots = SnapshotBuffer()
+        bridge.start()
+        controller = FakeController(bridge, snapshots)
+        controller.start()
+        spec = {'trials': 3, 'gap': [0.05, 0.15], 'startup_timeout': 5.0, 'ready_timeout': 5.0,
+                'reaction_timeout': 1.5,
+                'events': {'bumper': {'hold': 0.2, 'budget': {'drive_stop': 0.5, 'operation': 0.5}},
+                           'rtk_loss': {'hold': 0.5, 'budget': {'drive_stop': 0.5}}}}
+        try:
+            report = LatencyBench(spec, seed=1, snapshots=snapshots).run_trials(bridge)
+        finally:
+            controller.close()
+            bridge.stop()
+        self.assertTrue(report['passed'], report['violations'])
+        bumper = report['events']['bumper']
+        self.assertEqual(bumper['trials'], 3)
+        self.assertEqual(bumper['reactions']['drive_stop']['n'], 3)
+        self.assertLess(bumper['reactions']['drive_stop']['max'], 0.2)
+        self.assertEqual(report['events']['rtk_loss']['reactions']['operation']['n'], 3)
+
+    def test_run_stops_main_loop(self):
+        """Nach den Versuchen beendet run() die Regelschleife und liefert den Bericht."""
+        bridge = mock.Mock()
+        looped = {'interrupted': False}
+
+        def fake_main():
+            deadline = time.monotonic() + 5.0
+            try:
+                while time.monotonic() < deadline:
+                    time.sleep(0.01)
+            except KeyboardInterrupt:
+                looped['interrupted'] = True
+                raise
+
+        def fake_trials(bench, _bridge):
+            time.sleep(0.2)
+            bench.running = False
+            return summarize([], bench.spec, {})
+
+        with mock.patch.object(latency_bench, 'prepare_main', return_value=bridge), \
+                mock.patch.object(latency_bench, 'exec_main', fake_main), \
+                mock.patch.object(LatencyBench, 'run_trials', fake_trials):
+            started = time.monotonic()
+            report = latency_bench.run(spec={'trials': 1})
+        self.assertTrue(looped['interrupted'])
+        self.assertLess(time.monotonic() - started, 4.0)
+        self.assertIn('events', report)
+        bridge.stop.assert_called_once()
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""
+Tests für Startzeitleiste und Hintergrund-Initialisierung.
+"""
+
+import unittest
+import threading
+import os
+import sys
+
+# Pfad zum Hauptverzeichnis hinzufügen
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from utils.startup_profiler import StartupTimeline
+from utils.lazy_init import LazyInitializer
+
+class TestStartupTimeline(unittest.TestCase):
+    """Tests für StartupTimeline."""
+
+    def test_phases_and_marks(self):
+        """Phasen werden mit Dauer und Thread erfasst, Meilensteine nur einmal."""
+        timeline = StartupTimeline(origin=0.0)
+        with timeline.phase('hardware'):
+            pass
+        first = timeline.mark('ready')
+        self.assertEqual(timeline.mark('ready'), first)
+
+        data = timeline.to_dict()
+        self.assertEqual(data['phases'][0]['name'], 'hardware')
+        self.assertGreaterEqual(data['phases'][0]['duration'], 0.0)
+        self.assertEqual(data['phases'][0]['thread'], threading.current_thread().name)
+        self.assertIn('ready', data['marks'])
+        self.assertIn('hardware', timeline.report())
+
+    def test_phase_records_error(self):
+        """Fehler in einer Phase werden vermerkt und weitergereicht."""
+        timeline = StartupTimeline()
+        with self.assertRaises(ValueError):
+            with timeline.phase('broken'):
+                raise ValueError('kaputt')
+        self.assertEqual(timeline.to_dict()['phases'][0]['error'], 'kaputt')
+
+class TestLazyInitializer(unittest.TestCase):
+    """Tests für LazyInitializer."""
+
+    def test_not_ready_until_factory_returns(self):
+        """value_or_none() liefert None, solange die Fabrik läuft."""
+        release = threading.Event()
+        lazy = LazyInitializer()
+        lazy.register('slow', lambda: release.wait(5) and 'slow-value')
+        lazy.start_all()
+
+        self.assertIsNone(lazy.get('slow'))
+        self.assertFalse(lazy.all_done())
+
+        release.set()
+        self.assertTrue(lazy.wait_all(timeout=5))
+        self.assertEqual(lazy.get('slow'), 'slow-value')
+        self.assertEqual(lazy.get_status()['slow']['state'], 'ready')
+
+    def test_dependencies_passed_in_order(self):
+        """Abhängigkeiten werden als Argumente übergeben."""
+        lazy = LazyInitializer()
+        lazy.register('a', lambda: 1)
+        lazy.register('b', lambda: 2)
+        lazy.register('sum', lambda a, b: a + b, depends_on=['a', 'b'])
+        lazy.start_all()
+
+        self.assertTrue(lazy.wait_all(timeout=5))
+        self.assertEqual(lazy.get('sum'), 3)
+
+    def test_failed_dependency(self):
+        """Ein fehlerhaftes Subsystem blockiert abhängige nicht dauerhaft."""
+        def broken():
+            raise RuntimeError('keine Verbindung')
+
+        lazy = LazyInitializer()
+        lazy.register('mqtt', broken)
+        lazy.register('stats', lambda mqtt: 'ok', depends_on=['mqtt'])
+        lazy.start_all()
+
+        self.assertTrue(lazy.wait_all(timeout=5))
+        status = lazy.get_status()
+        self.assertEqual(status['mqtt']['state'], 'failed')
+        self.assertEqual(status['stats']['state'], 'failed')
+        self.assertIsNone(lazy.get('stats'))
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+"""
+Tests für die Regelschleife in main.py.
+"""
+
+import unittest
+import os
+import sys
+import tempfile
+from unittest import mock
+
+# Pfad zum Hauptverzeichnis hinzufügen
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.insert(0, ROOT)
+
+import main
+from communication.event_stream import EventHub
+from hardware.motor import Motor
+
+class RecordingHub(EventHub):
+    """Push-Kanal mit einem Abonnenten; beendet main() nach dem ersten Telemetrie-Ereignis."""
+    def __init__(self):
+        super().__init__()
+        self.published = []
+
+    def has_subscribers(self, event=None):
+        return True
+
+    def publish(self, event, data, coalesce=False):
+        self.published.append((event, data, coalesce))
+        if event == 'telemetry':
+            raise KeyboardInterrupt
+        return 1
+
+class FakeIMU:
+    def read(self):
+        return {}
+
+class FakeGPS:
+    origin_lat = origin_lon = None
+    def __init__(self, config=None):
+        pass
+    def read(self):
+        return None
+
+class FakeHardwareManager:
+    """Pico ohne Antwort: die Regelschleife läuft mit leeren Sensordaten, höchstens MAX_TICKS Zyklen."""
+    MAX_TICKS = 5
+    def __init__(self, port=None, baudrate=None):
+        self.commands = []
+        self.ticks = 0
+    def send_command(self, command):
+        self.commands.append(command)
+        return True
+    def send_motor_command(self, left, right, mow):
+        return True
+    def get_sensor_data(self):
+        self.ticks += 1
+        if self.ticks > self.MAX_TICKS:
+            raise KeyboardInterrupt
+        return None
+    def close(self):
+        pass
+
+class LoopMotor(Motor):
+    """Ohne GPS-Fix drosselt die GPS-Sicherheit über set_speed_factor(), das Motor nicht anbietet."""
+    def set_speed_factor(self, factor):
+        pass
+
+class TestMainLoop(unittest.TestCase):
+    def test_sse_telemetry_without_mqtt(self):
+        """Ohne erreichbaren MQTT-Broker (telemetry=None) erhält der Push-Kanal trotzdem Telemetrie."""
+        hub = RecordingHub()
+        def no_broker(config):
+            raise ConnectionRefusedError("kein Broker")
+        cwd = os.getcwd()
+        workdir = tempfile.TemporaryDirectory()
+        self.addCleanup(workdir.cleanup)
+        os.chdir(workdir.name)
+        self.addCleanup(os.chdir, cwd)
+        with mock.patch.object(main, 'HARDWARE_AVAILABLE', True), \
+             mock.patch.object(main, 'IMUSensor', FakeIMU, create=True), \
+             mock.patch.object(main, 'RTKGPS', FakeGPS, create=True), \
+             mock.patch.object(main, 'get_hardware_manager', FakeHardwareManager, create=True), \
+             mock.patch.object(main, 'Motor', LoopMotor), \
+             mock.patch.object(main, 'get_event_hub', return_value=hub), \
+             mock.patch.object(main, 'init_mqtt', no_broker), \
+             mock.patch.object(main, 'init_web_ui', return_value=None):
+            main.main()
+        telemetry = [(data, coalesce) for event, data, coalesce in hub.published if event == 'telemetry']
+        self.assertEqual(len(telemetry), 1)
+        data, coalesce = telemetry[0]
+        self.assertTrue(coalesce)
+        self.assertIn('battery', data)
+        self.assertIn('enhanced_system', data)
+
+if __name__ == '__main__':
+    unittest.main()
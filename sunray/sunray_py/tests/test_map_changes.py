@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""
+Tests für die versionierten Karten- und Plan-Diffs (communication/map_changes.py).
+"""
+
+import unittest
+import os
+import sys
+
+# Pfad zum Hauptverzeichnis hinzufügen (navigation/ für die flachen Importe des Planers)
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.insert(0, ROOT)
+sys.path.insert(0, os.path.join(ROOT, 'navigation'))
+
+from communication.map_changes import MapChangeLog, apply_diff, diff_collection, diff_sequence
+from map import Point, Polygon
+from navigation.advanced_path_planner import AdvancedPathPlanner
+
+class RecordingHub:
+    def __init__(self):
+        self.events = []
+
+    def publish(self, event, data, coalesce=False):
+        self.events.append((event, data))
+        return 1
+
+def zone(zone_id, size):
+    return {'id': zone_id, 'points': [{'x': 0, 'y': 0}, {'x': size, 'y': 0}, {'x': size, 'y': size}]}
+
+def make_plan(rows):
+    return [{'points': [{'x': float(i), 'y': float(row)} for i in range(5)], 'path_type': 'mowing'}
+            for row in rows]
+
+class TestDiffs(unittest.TestCase):
+    def test_collection_diff(self):
+        """Zonen mit id: hinzugefügt, entfernt und geändert; apply_diff ergibt den neuen Stand."""
+        old = [zone(1, 10), zone(2, 20), zone(3, 30)]
+        new = [zone(1, 10), zone(3, 35), zone(4, 40)]
+        diff = diff_collection(old, new)
+        self.assertEqual(diff['removed'], [2])
+        self.assertEqual([e['key'] for e in diff['added']], [4])
+        self.assertEqual([e['key'] for e in diff['modified']], [3])
+        self.assertEqual(apply_diff(old, diff), new)
+        self.assertIsNone(diff_collection(new, list(new)))
+
+    def test_sequence_diff(self):
+        """Nur der geänderte Segmentbereich wird übertragen."""
+        old = make_plan(range(10))
+        new = old[:4] + make_plan([40, 41, 42]) + old[6:]
+        diff = diff_sequence(old, new)
+        self.assertEqual((diff['start'], diff['remove'], len(diff['insert'])), (4, 2, 3))
+        self.assertEqual(diff['length'], 11)
+        self.assertEqual(apply_diff(old, diff), new)
+        self.assertEqual(apply_diff(old, diff_sequence(old, [])), [])
+        self.assertIsNone(diff_sequence(old, list(old)))
+
+class TestMapChangeLog(unittest.TestCase):
+    def setUp(self):
+        self.hub = RecordingHub()
+        self.log = MapChangeLog(history=3, hub=self.hub)
+        self.log.track('zones')
+
+    def test_versions_and_events(self):
+        """Jede Änderung erhöht die Version und wird als '<art>_diff' verteilt."""
+        self.assertIsNone(self.log.update('zones', []))
+        change = self.log.update('zones', [zone(1, 10)])
+        self.assertEqual((change['base'], change['version']), (0, 1))
+        self.assertIsNone(self.log.update('zones', [zone(1, 10)]))
+        self.log.update('zones', [zone(1, 12)])
+        self.assertEqual([event for event, _ in self.hub.events], ['zones_diff', 'zones_diff'])
+        self.assertEqual(self.hub.events[-1][1]['diff']['modified'][0]['key'], 1)
+        state = self.log.state('zones')
+        self.assertEqual((state['version'], state['state']), (2, [zone(1, 12)]))
+
+    def test_catch_up_from_history(self):
+        """Ein Client holt verpasste Diffs nach; reicht der Verlauf nicht, vollständig neu laden."""
+        items = []
+        states = [list(items)]
+        for i in range(5):
+            items = items + [zone(i + 1, i)]
+            self.log.update('zones', items)
+            states.append(list(items))
+
+        result = self.log.changes_since('zones', 3)
+        self.assertEqual([c['version'] for c in result['changes']], [4, 5])
+        patched = states[3]
+        for change in result['changes']:
+            patched = apply_diff(patched, change['diff'])
+        self.assertEqual(patched, states[5])
+
+        self.assertEqual(self.log.changes_since('zones', 5)['changes'], [])
+        self.assertTrue(self.log.changes_since('zones', 1).get('full_reload'))
+        self.assertTrue(self.log.changes_since('zones', 9).get('full_reload'))
+        self.assertTrue(self.log.changes_since('zones', 4, epoch='alt').get('full_reload'))
+        self.assertIsNone(self.log.changes_since('unbekannt', 0))
+
+class TestPlannerChanges(unittest.TestCase):
+    def test_planner_callback(self):
+        """Hindernisse und Neuplanungen des Planers erzeugen kleine Diffs."""
+        hub = RecordingHub()
+        log = MapChangeLog(hub=hub)
+        log.track('obstacles', encode=lambda polygon: polygon.to_list())
+        log.track('plan', mode='sequence', encode=AdvancedPathPlanner.export_segment)
+        planner = AdvancedPathPlanner()
+
+        def on_changed(snapshot):
+            log.update('plan', snapshot.plan)
+            log.update('obstacles', snapshot.obstacles + snapshot.dynamic_obstacles)
+
+        planner.set_map_changed_callback(on_changed)
+        planner.install_plan(make_plan(range(20)))
+        self.assertEqual(log.state('plan')['version'], 1)
+
+        square = Polygon([Point(50, 50), Point(51, 50), Point(51, 51), Point(50, 51)])
+        planner.add_dynamic_obstacle(square, replan=False)
+        obstacles = [data for event, data in hub.events if event == 'obstacles_diff']
+        self.assertEqual(len(obstacles), 1)
+        self.assertEqual(obstacles[0]['diff']['added'][0]['item'], square.to_list())
+
+        # Ein neu installierter Plan, der nur zwei Segmente ersetzt
+        rows = list(range(20))
+        rows[7:9] = [70, 80]
+        planner.install_plan(make_plan(rows))
+        diff = hub.events[-1][1]['diff']
+        self.assertEqual(hub.events[-1][0], 'plan_diff')
+        self.assertEqual((diff['start'], diff['remove'], len(diff['insert'])), (7, 2, 2))
+
+        planner.reset()
+        self.assertEqual(log.state('plan')['state'], [])
+        self.assertEqual(log.state('obstacles')['state'], [])
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""
+Tests für die Metrik-Registry (utils/metrics.py).
+"""
+
+import os
+import sys
+import threading
+import unittest
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from utils.metrics import MetricsRegistry
+
+class TestMetricsRegistry(unittest.TestCase):
+    def setUp(self):
+        self.registry = MetricsRegistry()
+
+    def test_counter_threads_lose_no_updates(self):
+        """Jeder Thread zählt in seine eigene Zelle, die Summe ist exakt."""
+        counter = self.registry.counter('test_events', 'Ereignisse')
+
+        def worker():
+            for _ in range(20000):
+                counter.inc()
+
+        threads = [threading.Thread(target=worker) for _ in range(8)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        self.assertEqual(counter.value, 8 * 20000)
+
+    def test_bind_cell(self):
+        """bind() liefert die Zelle des Threads für heiße Pfade."""
+        counter = self.registry.counter('test_hot')
+        cell = counter.bind()
+        cell[0] += 5
+        counter.inc(2)
+        self.assertEqual(counter.value, 7)
+
+    def test_finished_threads_retire_cells(self):
+        """Zellen beendeter Threads gehen in die Summenzelle über, ihre Werte bleiben erhalten."""
+        counter = self.registry.counter('test_requests')
+        histogram = self.registry.histogram('test_request_seconds', buckets=(0.1, 1.0))
+        counter.inc()
+
+        def request():
+            counter.inc()
+            histogram.observe(0.5)
+
+        for _ in range(50):
+            thread = threading.Thread(target=request)
+            thread.start()
+            thread.join()
+        self.assertEqual(counter.value, 51)
+        self.assertEqual(histogram.count, 50)
+        self.assertAlmostEqual(histogram.sum, 25.0)
+        self.assertEqual(len(counter._cells), 1)
+        self.assertEqual(len(histogram._cells), 0)
+
+    def test_registration_is_idempotent(self):
+        """Gleicher Name liefert dieselbe Metrik, anderer Typ ist ein Fehler."""
+        first = self.registry.counter('test_total', 'Zähler')
+        second = self.registry.counter('test', 'Zähler')
+        self.assertIs(first, second)
+        with self.assertRaises(ValueError):
+            self.registry.gauge('test')
+
+    def test_histogram_buckets(self):
+        """Buckets werden kumulativ ausgegeben, dazu Anzahl und Summe."""
+        histogram = self.registry.histogram('test_seconds', 'Dauer', buckets=(0.1, 1.0))
+        for value in (0.05, 0.1, 0.5, 2.0):
+            histogram.observe(value)
+        text = self.registry.expose()
+        self.assertIn('test_seconds_bucket{le="0.1"} 2', text)
+        self.assertIn('test_seconds_bucket{le="1.0"} 3', text)
+        self.assertIn('test_seconds_bucket{le="+Inf"} 4', text)
+        self.assertIn('test_seconds_count 4', text)
+        self.assertEqual(histogram.count, 4)
+        self.assertAlmostEqual(histogram.sum, 2.65)
+
+    def test_openmetrics_exposition(self):
+        """Zähler mit _total, Labels escaped, Gauges aus Funktionen, Abschluss mit # EOF."""
+        requests = self.registry.counter('test_requests', 'HTTP-Anfragen', ('endpoint', 'code'))
+        requests.labels('/api/"x"', '200').inc(3)
+        requests.labels(endpoint='/api/status', code='500').inc()
+        self.registry.gauge('test_voltage', 'Spannung', fn=lambda: 25.2)
+        self.registry.gauge('test_broken', 'Quelle nicht lesbar', fn=lambda: 1 / 0)
+        text = self.registry.expose()
+        lines = text.splitlines()
+        self.assertEqual(lines[-1], '# EOF')
+        self.assertIn('# TYPE test_requests counter', lines)
+        self.assertIn('test_requests_total{endpoint="/api/\\"x\\"",code="200"} 3', lines)
+        self.assertIn('test_requests_total{endpoint="/api/status",code="500"} 1', lines)
+        self.assertIn('test_voltage 25.2', lines)
+        self.assertFalse([line for line in lines if line.startswith('test_broken')])
+        with self.assertRaises(ValueError):
+            requests.labels('/api/status')
+
+if __name__ == '__main__':
+    unittest.main()
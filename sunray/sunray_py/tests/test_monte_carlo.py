@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+"""
+Tests für simulierte Missionen und die Monte-Carlo-Parameterstudie.
+"""
+
+import unittest
+import os
+import shutil
+import sys
+import tempfile
+
+# Pfad zum Hauptverzeichnis hinzufügen (navigation/ für die flachen Importe der Planer)
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.insert(0, ROOT)
+sys.path.insert(0, os.path.join(ROOT, 'navigation'))
+
+from simulation.mission import Mission, MissionMap, merge_params, segment_hits_ring, DEFAULT_PARAMS
+from simulation.monte_carlo import MonteCarloRunner, expand_grid, load_checkpoint, summarize
+from simulation.world import SimWorld
+
+def rect(x0, y0, x1, y1):
+    return [{'x': x0, 'y': y0}, {'x': x1, 'y': y0}, {'x': x1, 'y': y1}, {'x': x0, 'y': y1}]
+
+def strip_world(obstacles=(), rtk_zones=()):
+    """Schmaler Streifen 10 x 3 m, Ladestation am Anfang der ersten Mählinie."""
+    return SimWorld.from_dict({
+        'mow_zones': [rect(0, 0, 10, 3)],
+        'obstacles': list(obstacles),
+        'boundary': rect(-1, -1, 11, 4),
+        'rtk_zones': list(rtk_zones),
+        'dock': {'x': 0.2, 'y': 0.0, 'heading': 0.0},
+    })
+
+class TestMission(unittest.TestCase):
+    def test_merge_params(self):
+        """Punkt-Schlüssel überschreiben einzelne Werte, die Vorgabe bleibt unverändert."""
+        params = merge_params(DEFAULT_PARAMS, {'escape.reverse_duration': 2.0, 'drive': {'speed': 0.2}})
+        self.assertEqual(params['escape']['reverse_duration'], 2.0)
+        self.assertEqual(params['escape']['curve_duration'], DEFAULT_PARAMS['escape']['curve_duration'])
+        self.assertEqual(params['drive']['speed'], 0.2)
+        self.assertEqual(DEFAULT_PARAMS['escape']['reverse_duration'], 1.0)
+
+    def test_plan_avoids_mapped_obstacles(self):
+        """Kein Planabschnitt schneidet ein kartiertes Hindernis; der Plan wird je Parametersatz wiederverwendet."""
+        world = SimWorld.default()
+        mission_map = MissionMap(world)
+        plan = mission_map.plan(DEFAULT_PARAMS['planner'], 0.35, seed=0)
+        self.assertGreater(len(plan), 50)
+        for a, b in zip(plan, plan[1:]):
+            for obstacle in world.obstacles:
+                self.assertFalse(segment_hits_ring(a, b, obstacle.ring), (a, b))
+        self.assertIs(mission_map.plan(DEFAULT_PARAMS['planner'], 0.35, seed=1), plan)
+
+    def test_mission_is_deterministic(self):
+        """Gleicher Seed, gleiches Ergebnis; Mähen erzeugt Abdeckung ohne Bumper-Kontakt."""
+        world = strip_world()
+        mission_map = MissionMap(world)
+        # Im 3 m breiten Streifen darf auch am Rand gemäht werden
+        params = {'mission.duration': 60.0, 'gps_safety.safe_zone_boundary_margin': 0.0}
+        first = Mission(world, params, seed=5, mission_map=mission_map).run()
+        second = Mission(world, params, seed=5, mission_map=mission_map).run()
+        self.assertEqual(first, second)
+        self.assertGreater(first['coverage'], 3.0)
+        self.assertEqual(first['bumper_contacts'], 0)
+        self.assertEqual(first['end_reason'], 'timeout')
+
+    def test_unmapped_obstacle_triggers_escape(self):
+        """Ein nicht kartiertes Hindernis auf der ersten Mählinie löst Ausweichmanöver aus."""
+        world = strip_world(obstacles=[rect(3.0, -0.5, 3.5, 0.6)])
+        result = Mission(world, {'mission.duration': 90.0, 'planner.map_obstacles': False}, seed=1).run()
+        self.assertGreaterEqual(result['escapes'], 1)
+        self.assertGreaterEqual(result['bumper_contacts'], 1)
+        self.assertGreaterEqual(result['escapes'], result['escape_success'] + result['escape_failed'])
+
+    def test_gps_safety_stops_mission(self):
+        """Nur 3D-Fix hinter x = 3 m: GPSSafetyManager hält an, nach rtk_wait_timeout endet die Mission."""
+        world = strip_world(rtk_zones=[{'polygon': rect(3.0, -1, 11, 4), 'fix': '3d'}])
+        result = Mission(world, {'mission.duration': 120.0, 'gps_safety.rtk_wait_timeout': 20.0},
+                         seed=2).run()
+        self.assertEqual(result['end_reason'], 'gps_timeout')
+        self.assertIn('stop_and_wait_rtk', result['safety_events'])
+        self.assertLess(result['mission_time'], 90.0)
+
+class TestMonteCarlo(unittest.TestCase):
+    def setUp(self):
+        self.directory = tempfile.mkdtemp()
+        self.output = os.path.join(self.directory, 'studie')
+
+    def tearDown(self):
+        shutil.rmtree(self.directory, ignore_errors=True)
+
+    def test_expand_grid(self):
+        grid = expand_grid({'b': [1, 2], 'a': ['x', 'y', 'z']})
+        self.assertEqual(len(grid), 6)
+        self.assertEqual(grid[0], {'a': 'x', 'b': 1})
+
+    def test_parallel_sweep_with_resume(self):
+        """Zwei Prozesse, Ergebnisse im Checkpoint; Fortsetzung rechnet nur neue Kombinationen."""
+        world = strip_world()
+        spec = {'seeds': 2, 'duration': 20.0, 'base': {'gps_safety.safe_zone_boundary_margin': 0.0},
+                'grid': {'drive.speed': [0.2, 0.3]}}
+        rows = MonteCarloRunner(world, spec, self.output, workers=2).run()
+        self.assertEqual(len(rows), 2)
+        self.assertEqual([row['runs'] for row in rows], [2, 2])
+        # Schnellere Fahrt mäht in derselben Zeit mehr
+        self.assertEqual(rows[0]['overrides'], {'drive.speed': 0.3})
+        self.assertTrue(os.path.exists(self.output + '.csv'))
+
+        # Abgebrochener Schreibvorgang: unvollständige letzte Zeile
+        with open(self.output + '.jsonl', 'a') as f:
+            f.write('{"key": "abgeschn')
+        self.assertEqual(len(load_checkpoint(self.output + '.jsonl')), 4)
+
+        spec['grid']['drive.speed'].append(0.25)
+        runner = MonteCarloRunner(world, spec, self.output, workers=2)
+        pending = [task for task in runner.tasks() if task[0] not in load_checkpoint(runner.checkpoint_path)]
+        self.assertEqual(len(pending), 2)
+        rows = runner.run()
+        self.assertEqual(len(rows), 3)
+        self.assertEqual(len(load_checkpoint(self.output + '.jsonl')), 6)
+
+    def test_changed_spec_does_not_reuse_results(self):
+        """Andere Basis, Dauer oder Welt ergeben neue Schlüssel, alte Ergebnisse zählen nicht."""
+        world = strip_world()
+        spec = {'seeds': 1, 'duration': 20.0, 'grid': {'drive.speed': [0.3]}}
+        keys = {task[0] for task in MonteCarloRunner(world, spec, self.output).tasks()}
+        self.assertEqual(keys, {task[0] for task in MonteCarloRunner(world, dict(spec), self.output).tasks()})
+        changed = [
+            (world, dict(spec, duration=30.0)),
+            (world, dict(spec, base={'planner.line_spacing': 0.4})),
+            (strip_world(obstacles=[rect(4, 1, 5, 2)]), spec),
+        ]
+        for other_world, other_spec in changed:
+            other = {task[0] for task in MonteCarloRunner(other_world, other_spec, self.output).tasks()}
+            self.assertFalse(keys & other)
+
+    def test_summary(self):
+        """Mittelwerte und Ausweich-Erfolgsquote über alle Läufe eines Parametersatzes."""
+        def record(seed, coverage, escapes, success):
+            return {'key': f'p:{seed}', 'params_id': 'p', 'overrides': {'x': 1}, 'seed': seed,
+                    'result': {'coverage': coverage, 'mission_time': 100.0, 'completed': seed == 0,
+                               'escapes': escapes, 'escape_success': success,
+                               'escape_failed': escapes - success, 'energy_wh': 2.0,
+                               'safety_event_count': 1, 'bumper_contacts': escapes}}
+        rows = summarize([record(0, 80.0, 2, 2), record(1, 60.0, 2, 0)])
+        self.assertEqual(len(rows), 1)
+        self.assertAlmostEqual(rows[0]['coverage_mean'], 70.0)
+        self.assertAlmostEqual(rows[0]['escape_success_rate'], 0.5)
+        self.assertAlmostEqual(rows[0]['completed_rate'], 0.5)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+"""
+Tests für das Linienmuster des PathPlanner (navigation/path_planner.py).
+"""
+
+import unittest
+import os
+import sys
+
+# Pfad zum Hauptverzeichnis hinzufügen
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from map import Point, Polygon
+from navigation.path_planner import MowPattern, PathPlanner
+
+def rect(x0, y0, x1, y1):
+    return Polygon([Point(x0, y0), Point(x1, y0), Point(x1, y1), Point(x0, y1)])
+
+class TestLinePattern(unittest.TestCase):
+    """Mählinien und Überfahrten dürfen kein Hindernis durchqueren."""
+
+    def setUp(self):
+        self.planner = PathPlanner()
+        self.planner.set_pattern(MowPattern.LINES)
+        self.planner.set_line_spacing(1.0)
+        self.zone = rect(0, 0, 10, 10)
+
+    def assert_clear(self, path, obstacles):
+        # Fahrt auf dem Rand ist erlaubt, geprüft wird das Innere
+        inner = []
+        for o in obstacles:
+            xs, ys = [p.x for p in o.points], [p.y for p in o.points]
+            inner.append(rect(min(xs) + 0.01, min(ys) + 0.01, max(xs) - 0.01, max(ys) - 0.01))
+        for a, b in zip(path, path[1:]):
+            for k in range(1, 20):
+                point = Point(a.x + (b.x - a.x) * k / 20, a.y + (b.y - a.y) * k / 20)
+                self.assertFalse(self.planner._point_in_obstacles(point, inner),
+                                 f"({a.x}, {a.y}) -> ({b.x}, {b.y}) durchquert ein Hindernis")
+
+    def test_clip_returns_separate_segments(self):
+        """Ein Hindernis teilt die Linie in getrennte Abschnitte."""
+        obstacle = rect(4, -1, 6, 1)
+        segments = self.planner._clip_line_to_zone(Point(0, 0), Point(10, 0), self.zone, [obstacle])
+        self.assertEqual([[(p.x, p.y) for p in s] for s in segments], [[(0, 0), (4, 0)], [(6, 0), (10, 0)]])
+        reverse = self.planner._clip_line_to_zone(Point(10, 0), Point(0, 0), self.zone, [obstacle])
+        self.assertEqual([[(p.x, p.y) for p in s] for s in reverse], [[(10, 0), (6, 0)], [(4, 0), (0, 0)]])
+
+    def test_path_detours_around_obstacle(self):
+        """Die Lücke über dem Hindernis wird entlang des Randes umfahren."""
+        obstacle = rect(4, -1, 6, 6)
+        path = self.planner.generate_zone_path(self.zone, [obstacle])
+        self.assertEqual([(p.x, p.y) for p in path[:6]],
+                         [(0, 0), (4, 0), (4, 6), (6, 6), (6, 0), (10, 0)])
+        self.assert_clear(path, [obstacle])
+        self.assertTrue(all(self.planner._point_in_zone(p, self.zone) or p.y in (0, 10) or p.x in (0, 10)
+                            for p in path))
+
+    def test_inner_obstacle_and_line_changes(self):
+        """Auch Hindernisse mitten in der Zone und Wechsel zwischen Linien bleiben frei."""
+        obstacles = [rect(3.5, 2.5, 6.5, 5.5), rect(8.5, 6.5, 11, 8.5)]
+        path = self.planner.generate_zone_path(self.zone, obstacles)
+        self.assert_clear(path, obstacles)
+        self.assertEqual((path[0].x, path[0].y), (0, 0))
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""
+Tests für das binäre Planformat (navigation/plan_codec.py).
+"""
+
+import unittest
+import os
+import sys
+
+# Pfad zum Hauptverzeichnis hinzufügen
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from navigation.plan_codec import (decode_plan, encode_plan, iter_plan_chunks, plan_size,
+                                   HEADER, SEGMENT)
+
+class _Point:
+    def __init__(self, x, y):
+        self.x = x
+        self.y = y
+
+class _PathType:
+    def __init__(self, value):
+        self.value = value
+
+class _Segment:
+    """Nachbildung eines PathSegment aus advanced_path_planner."""
+    def __init__(self, points, path_type, mow_enabled=True, speed_factor=1.0):
+        self.points = points
+        self.path_type = _PathType(path_type)
+        self.mow_enabled = mow_enabled
+        self.speed_factor = speed_factor
+
+def _segments():
+    return [
+        {'type': 'mowing', 'points': [(0.0, 0.0), (10.0, 0.0), (10.0, 0.5)]},
+        {'type': 'transit', 'points': [{'x': 10.0, 'y': 0.5}, {'x': -2.0, 'y': 4.0}]},
+    ]
+
+class TestPlanCodec(unittest.TestCase):
+    """Tests für Kodierung und Dekodierung."""
+
+    def test_roundtrip(self):
+        """Segmente, Typen und Punkte bleiben erhalten."""
+        plan = decode_plan(encode_plan(_segments()))
+        self.assertEqual([s['type'] for s in plan['segments']], ['mowing', 'transit'])
+        self.assertEqual([s['mow'] for s in plan['segments']], [True, False])
+        self.assertEqual(plan['segments'][0]['points'], [(0.0, 0.0), (10.0, 0.0), (10.0, 0.5)])
+        self.assertEqual(plan['segments'][1]['points'][1], (-2.0, 4.0))
+        self.assertEqual(plan['bounds'], (-2.0, 0.0, 10.0, 4.0))
+
+    def test_layout(self):
+        """Größe entspricht plan_size, Punkte liegen 4-Byte-ausgerichtet hinter der Tabelle."""
+        data = encode_plan(_segments())
+        self.assertEqual(len(data), plan_size(2, 5))
+        self.assertEqual(HEADER.size, 32)
+        self.assertEqual(SEGMENT.size, 16)
+        self.assertEqual(plan_size(2, 0) % 4, 0)
+        self.assertEqual(data[:4], b'SPLN')
+
+    def test_chunks_match_full_encoding(self):
+        """Blockweise Ausgabe ergibt denselben Puffer; Blöcke enthalten höchstens chunk_points Punkte."""
+        segments = [{'type': 'mowing', 'points': [(i, i) for i in range(25)]},
+                    {'type': 'transit', 'points': [(i, -i) for i in range(7)]}]
+        chunks = list(iter_plan_chunks(segments, chunk_points=10))
+        self.assertEqual(len(chunks[0]), plan_size(2, 0))
+        self.assertTrue(all(len(chunk) <= 10 * 8 for chunk in chunks[1:]))
+        self.assertEqual(b''.join(chunks), encode_plan(segments))
+
+    def test_path_segment_objects(self):
+        """PathSegment-Objekte mit Enum-Typ und Point-Objekten werden akzeptiert."""
+        segments = [_Segment([_Point(1, 2), _Point(3, 4)], 'return_home', False, 0.5)]
+        plan = decode_plan(encode_plan(segments))
+        segment = plan['segments'][0]
+        self.assertEqual(segment['type'], 'return_home')
+        self.assertFalse(segment['mow'])
+        self.assertAlmostEqual(segment['speed'], 0.5)
+
+    def test_empty_plan(self):
+        """Ein leerer Plan besteht nur aus dem Header."""
+        data = encode_plan([])
+        self.assertEqual(len(data), HEADER.size)
+        self.assertEqual(decode_plan(data)['segments'], [])
+
+    def test_truncated_plan_rejected(self):
+        """Unvollständige oder fremde Daten werden abgelehnt."""
+        data = encode_plan(_segments())
+        with self.assertRaises(ValueError):
+            decode_plan(data[:-4])
+        with self.assertRaises(ValueError):
+            decode_plan(b'XXXX' + data[4:])
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+"""
+Tests für die Snapshot-Lesezugriffe des AdvancedPathPlanner (Copy-on-Write).
+"""
+
+import unittest
+import os
+import sys
+import threading
+
+# Pfad zum Hauptverzeichnis hinzufügen (navigation/ für die flachen Importe des Planers)
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.insert(0, ROOT)
+sys.path.insert(0, os.path.join(ROOT, 'navigation'))
+
+from map import Point, Polygon
+from navigation.advanced_path_planner import AdvancedPathPlanner, PlanningStrategy
+from path_planner import MowPattern
+
+def square(x, y, size=1.0):
+    return Polygon([Point(x, y), Point(x + size, y), Point(x + size, y + size), Point(x, y + size)])
+
+def make_plan(segments=20, points=10):
+    """Plan im export_plan()-Format: waagerechte Bahnen mit je `points` Punkten."""
+    return [{
+        'points': [{'x': float(i), 'y': float(s)} for i in range(points)],
+        'path_type': 'mowing'
+    } for s in range(segments)]
+
+class TestPlannerSnapshot(unittest.TestCase):
+    def setUp(self):
+        self.planner = AdvancedPathPlanner()
+        self.planner.set_zones_and_obstacles([square(0, 0, 20)], [])
+        self.planner.install_plan(make_plan())
+
+    def test_snapshot_is_immutable(self):
+        """Ein gehaltener Snapshot ändert sich nicht, Schreiber veröffentlichen neue Versionen."""
+        before = self.planner.snapshot()
+        waypoint, path_type = self.planner.get_next_waypoint(Point(0, 0))
+        self.assertEqual((waypoint.x, waypoint.y), (0.0, 0.0))
+        after = self.planner.snapshot()
+        self.assertEqual(before.point_index, 0)
+        self.assertEqual(after.point_index, 1)
+        self.assertGreater(after.version, before.version)
+        self.assertIs(after.plan, before.plan)
+
+        self.planner.add_dynamic_obstacle(square(50, 50), replan=False)
+        self.planner.reset()
+        self.assertEqual(len(after.plan), 20)
+        self.assertEqual(after.dynamic_obstacles, ())
+        self.assertEqual(self.planner.snapshot().plan, ())
+
+    def test_waypoints_advance_over_segments(self):
+        """Segmentwechsel ruft den Callback auf und setzt den Punktindex zurück."""
+        completed = []
+        self.planner.set_segment_completed_callback(completed.append)
+        for _ in range(12):
+            waypoint, _ = self.planner.get_next_waypoint(Point(0, 0))
+        self.assertEqual((waypoint.x, waypoint.y), (1.0, 1.0))
+        self.assertEqual(len(completed), 1)
+        status = self.planner.get_planning_status()
+        self.assertEqual((status['current_segment_index'], status['current_point_index']), (1, 2))
+
+    def test_concurrent_web_access(self):
+        """Web-Zugriffe während der Navigation: keine Ausnahmen, nur konsistente Stände."""
+        errors = []
+        done = threading.Event()
+
+        def navigation():
+            try:
+                while not done.is_set():
+                    if self.planner.get_next_waypoint(Point(0, 0)) is None:
+                        self.planner.install_plan(make_plan())
+            except Exception as e:
+                errors.append(e)
+
+        def web():
+            try:
+                for i in range(300):
+                    status = self.planner.get_planning_status()
+                    self.assertLessEqual(status['completed_segments'], status['total_segments'])
+                    snapshot = self.planner.snapshot()
+                    exported = self.planner.export_plan(snapshot.plan)
+                    self.assertEqual(len(exported), len(snapshot.plan))
+                    self.planner.add_dynamic_obstacle(square(100 + i, 100), replan=False)
+                    if i % 50 == 0:
+                        self.planner.reset()
+            except Exception as e:
+                errors.append(e)
+
+        threads = [threading.Thread(target=navigation)] + [threading.Thread(target=web) for _ in range(2)]
+        for thread in threads:
+            thread.start()
+        for thread in threads[1:]:
+            thread.join()
+        done.set()
+        threads[0].join()
+        self.assertEqual(errors, [])
+
+    def test_failed_replan_keeps_plan(self):
+        """Schlägt die Neuplanung fehl, bleibt der bisherige Plan veröffentlicht."""
+        for _ in range(3):
+            self.planner.get_next_waypoint(Point(0, 0))
+        before = self.planner.snapshot()
+        self.planner._compute_plan = lambda pattern, inputs: None
+        self.assertFalse(self.planner.replan_from_current_position())
+        after = self.planner.snapshot()
+        self.assertIs(after.plan, before.plan)
+        self.assertEqual(after.point_index, 3)
+
+    def test_overlapping_plans_stay_separate(self):
+        """Eine während einer Planung gestartete zweite Planung verändert deren Ergebnis nicht."""
+        self.planner.strategy = PlanningStrategy.TRADITIONAL
+        self.planner.set_zones_and_obstacles([square(0, 0, 4), square(10, 0, 4)], [])
+        outer_inputs = self.planner.snapshot()
+        expected = self.planner._compute_plan(MowPattern.LINES, outer_inputs)
+        self.planner.set_zones_and_obstacles([square(30, 30, 2)], [])
+        inner_inputs = self.planner.snapshot()
+        inner = []
+
+        def overlap(progress):
+            if not inner:
+                inner.append(None)
+                inner[0] = self.planner._compute_plan(MowPattern.LINES, inner_inputs)
+
+        self.planner.set_progress_callback(overlap)
+        result = self.planner._compute_plan(MowPattern.LINES, outer_inputs)
+        self.assertTrue(inner[0])
+        coords = lambda plan: [[(p.x, p.y) for p in s.points] for s in plan]
+        self.assertEqual(coords(result), coords(expected))
+
+    def test_async_replan_bookkeeping(self):
+        """Ein Neuplanungsauftrag zählt beim Übernehmen wie die synchrone Neuplanung."""
+        counts = []
+        self.planner.set_replanning_callback(counts.append)
+        self.assertNotIn('replan', self.planner.planning_request())
+        request = self.planner.planning_request(replan=True)
+        self.assertTrue(request['replan'])
+        self.planner.install_plan(make_plan(), replan=request['replan'])
+        self.planner.install_plan(make_plan())
+        self.planner.replan_from_current_position()
+        self.assertEqual(counts, [1, 2])
+        self.assertEqual(self.planner.get_planning_status()['replanning_count'], 2)
+
+    def test_checkpoint_roundtrip(self):
+        """Checkpoint aus einem Snapshot, Wiederherstellung als neuer Snapshot."""
+        self.planner.get_next_waypoint(Point(0, 0))
+        self.planner.add_dynamic_obstacle(square(5, 5), replan=False)
+        state = self.planner.checkpoint_state()
+        restored = AdvancedPathPlanner()
+        restored.restore_checkpoint(state)
+        snapshot = restored.snapshot()
+        self.assertEqual(len(snapshot.plan), 20)
+        self.assertEqual(snapshot.point_index, 1)
+        self.assertEqual(len(snapshot.dynamic_obstacles), 1)
+        self.assertAlmostEqual(snapshot.total_planned_distance, 20 * 9.0)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+"""
+Tests für die asynchronen Planungsaufträge (navigation/planning_jobs.py).
+"""
+
+import unittest
+import os
+import sys
+import time
+
+# Pfad zum Hauptverzeichnis hinzufügen
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from navigation.planning_jobs import (PlanningJob, PlanningJobService, simulate_planning,
+                                      COMPLETED, FAILED, CANCELLED, EXPIRED)
+
+def slow_planning(request, progress):
+    """Planung, die erst nach request['duration'] Sekunden fertig wird."""
+    steps = 20
+    for i in range(steps):
+        time.sleep(request.get('duration', 5.0) / steps)
+        progress((i + 1) / steps)
+    return {'plan': [], 'marker': request.get('marker')}
+
+def failing_planning(request, progress):
+    raise ValueError("keine Zonen")
+
+def crashing_planning(request, progress):
+    os._exit(3)
+
+class TestPlanningJobs(unittest.TestCase):
+    """Tests für PlanningJobService."""
+
+    def _service(self, plan_function, **config):
+        service = PlanningJobService(dict({'start_method': 'spawn', 'poll_interval': 0.01}, **config),
+                                     plan_function)
+        self.addCleanup(service.shutdown)
+        return service
+
+    def _wait(self, service, job_id, timeout=20.0):
+        deadline = time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            status = service.get(job_id)
+            if status['state'] in (COMPLETED, FAILED, CANCELLED, EXPIRED):
+                return status
+            time.sleep(0.02)
+        self.fail(f"Auftrag {job_id} nicht abgeschlossen")
+
+    def test_completed_plan_with_progress(self):
+        """Ein Auftrag liefert Fortschritt bis 100 % und einen abholbaren Plan."""
+        service = self._service(simulate_planning)
+        progress = []
+        service.add_listener(lambda job: progress.append(job['progress']))
+        job_id = service.submit({'total_segments': 5, 'points_per_segment': 10, 'duration': 0.2})
+        status = self._wait(service, job_id)
+        self.assertEqual(status['state'], COMPLETED)
+        self.assertEqual(progress[-1], 1.0)
+        self.assertEqual(progress, sorted(progress))
+        job = service.take_finished_plan()
+        self.assertEqual(job.id, job_id)
+        self.assertEqual(len(job.result['plan']), 9)
+        self.assertIsNone(service.take_finished_plan())
+        self.assertTrue(service.get(job_id)['installed'])
+
+    def test_submit_returns_immediately(self):
+        """submit() blockiert nicht, auch wenn die Planung lange dauert."""
+        service = self._service(slow_planning)
+        start = time.monotonic()
+        job_id = service.submit({'duration': 5.0})
+        self.assertLess(time.monotonic() - start, 0.5)
+        self.assertTrue(service.cancel(job_id))
+        self.assertEqual(self._wait(service, job_id)['state'], CANCELLED)
+
+    def test_cancel_running_job(self):
+        """Abbrechen beendet den Planungsprozess sofort; es bleibt kein Plan zurück."""
+        service = self._service(slow_planning)
+        job_id = service.submit({'duration': 10.0})
+        while service.get(job_id)['progress'] == 0.0:
+            time.sleep(0.02)
+        start = time.monotonic()
+        service.cancel(job_id)
+        self.assertEqual(self._wait(service, job_id)['state'], CANCELLED)
+        self.assertLess(time.monotonic() - start, 2.0)
+        self.assertIsNone(service.take_finished_plan())
+        self.assertFalse(service.cancel(job_id))
+
+    def test_cancel_after_result_discards_plan(self):
+        """Kommt cancel() nach dem Ergebnis, aber vor dem Abschluss, wird der Plan nicht übernommen."""
+        service = self._service(slow_planning)
+        job = PlanningJob('late', {}, None)
+        service._jobs[job.id] = job
+        job.state = 'running'
+        self.assertTrue(service.cancel(job.id))
+        service._finish(job, COMPLETED, {'plan': []})
+        self.assertEqual(service.get(job.id)['state'], CANCELLED)
+        self.assertIsNone(service.take_finished_plan())
+        self.assertEqual(service.get_statistics()[CANCELLED], 1)
+
+    def test_deadline(self):
+        """Überschreitet ein Auftrag seine Deadline, wird er abgebrochen."""
+        service = self._service(slow_planning)
+        job_id = service.submit({'duration': 10.0}, deadline=0.5)
+        status = self._wait(service, job_id)
+        self.assertEqual(status['state'], EXPIRED)
+        self.assertIn('Deadline', status['error'])
+
+    def test_replace_cancels_pending_jobs(self):
+        """replace=True verwirft ältere Aufträge; nur der neueste Plan wird übernommen."""
+        service = self._service(slow_planning)
+        first = service.submit({'duration': 10.0, 'marker': 1})
+        second = service.submit({'duration': 10.0, 'marker': 2})
+        third = service.submit({'duration': 0.2, 'marker': 3}, replace=True)
+        self.assertEqual(self._wait(service, third)['state'], COMPLETED)
+        self.assertEqual(service.get(first)['state'], CANCELLED)
+        self.assertEqual(service.get(second)['state'], CANCELLED)
+        self.assertEqual(service.take_finished_plan().result['marker'], 3)
+
+    def test_errors_are_reported(self):
+        """Ausnahmen und abgestürzte Planungsprozesse führen zu FAILED statt zu hängenden Aufträgen."""
+        service = self._service(failing_planning)
+        status = self._wait(service, service.submit({}))
+        self.assertEqual(status['state'], FAILED)
+        self.assertIn('keine Zonen', status['error'])
+
+        service = self._service(crashing_planning)
+        status = self._wait(service, service.submit({}))
+        self.assertEqual(status['state'], FAILED)
+        self.assertIn('Exitcode 3', status['error'])
+
+    def test_queue_limit(self):
+        """Bei voller Warteschlange wird der Auftrag abgelehnt."""
+        service = self._service(slow_planning, max_queue=1)
+        running = service.submit({'duration': 10.0})
+        while service.get(running)['state'] != 'running':
+            time.sleep(0.02)
+        self.assertIsNotNone(service.submit({'duration': 10.0}))
+        self.assertIsNone(service.submit({'duration': 10.0}))
+        self.assertEqual(service.get_statistics()['rejected'], 1)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+"""
+Tests für den gleitenden Median-/Quantil-Filter (utils/running_median.py).
+"""
+
+import unittest
+import os
+import random
+import sys
+
+# Pfad zum Hauptverzeichnis hinzufügen
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from utils.running_median import RunningMedian, RunningQuantiles
+
+def reference_quantile(window, q):
+    ordered = sorted(window)
+    pos = q * (len(ordered) - 1)
+    lower = int(pos)
+    if lower + 1 >= len(ordered):
+        return ordered[lower]
+    return ordered[lower] + (ordered[lower + 1] - ordered[lower]) * (pos - lower)
+
+def reference_median(window):
+    ordered = sorted(window)
+    n = len(ordered)
+    return ordered[n // 2] if n % 2 else 0.5 * (ordered[n // 2 - 1] + ordered[n // 2])
+
+class TestRunningMedian(unittest.TestCase):
+    """Vergleich mit sorted() über das jeweils aktuelle Fenster."""
+
+    def test_matches_sorted_window(self):
+        """Median und Quantile stimmen vor und nach dem Umlauf des Ringpuffers."""
+        rng = random.Random(7)
+        for size in (1, 2, 5, 15, 1500):
+            rm = RunningMedian(size)
+            values = [round(rng.gauss(25.0, 2.0), 2) for _ in range(3 * size + 11)]
+            for i, value in enumerate(values):
+                rm.add(value)
+                window = values[max(0, i + 1 - size):i + 1]
+                self.assertEqual(rm.buffer, window)
+                self.assertEqual(rm.median(), reference_median(window))
+                for q in (0.0, 0.1, 0.9, 1.0):
+                    self.assertAlmostEqual(rm.quantile(q), reference_quantile(window, q))
+
+    def test_blocks_split_and_merge(self):
+        """Große Fenster verteilen sich auf mehrere Blöcke, auch mit vielen Duplikaten."""
+        rm = RunningMedian(3000)
+        values = [float(i % 17) for i in range(9000)] + [float(i) for i in range(4000)]
+        for i, value in enumerate(values):
+            rm.add(value)
+            if i % 997 == 0:
+                window = values[max(0, i + 1 - 3000):i + 1]
+                self.assertEqual(rm.sorted, sorted(window))
+                self.assertEqual(rm.median(), reference_median(window))
+        self.assertGreater(len(rm._blocks), 1)
+        self.assertEqual(len(rm), 3000)
+
+    def test_empty_and_nan(self):
+        """Leeres Fenster liefert 0.0, NaN wird verworfen."""
+        rm = RunningMedian(5)
+        self.assertEqual(rm.median(), 0.0)
+        self.assertEqual(rm.quantile(0.9), 0.0)
+        rm.add(1.0)
+        rm.add(float('nan'))
+        rm.add(3.0)
+        self.assertEqual(rm.buffer, [1.0, 3.0])
+        self.assertEqual(rm.median(), 2.0)
+        rm.clear()
+        self.assertEqual(len(rm), 0)
+
+class TestRunningQuantiles(unittest.TestCase):
+    """Mehrkanaliger Filter."""
+
+    def test_update_all_channels(self):
+        """Ein Aufruf filtert alle Kanäle; Ausreißer je Kanal werden unterdrückt."""
+        rq = RunningQuantiles(('battery_v', 'charge_v', 'charge_i'), 5)
+        for sample in ((25.0, 29.0, 1.0), (25.1, 0.0, 1.1), (40.0, 29.1, 0.0), (25.2, 29.2, 1.2)):
+            medians = rq.update(sample)
+        self.assertEqual(medians, {'battery_v': 25.15, 'charge_v': 29.05, 'charge_i': 1.05})
+        self.assertEqual(rq.quantile('charge_i', 1.0), 1.2)
+        upper = rq.update({'charge_i': 1.3}, q=0.75)
+        self.assertEqual(rq.channel('battery_v').buffer, [25.0, 25.1, 40.0, 25.2])
+        self.assertAlmostEqual(upper['charge_i'], 1.2)
+
+    def test_state_roundtrip(self):
+        """state()/restore() übernimmt die Fenster aller Kanäle."""
+        rq = RunningQuantiles(('a', 'b'), 3)
+        for i in range(5):
+            rq.update((float(i), float(-i)))
+        restored = RunningQuantiles(('a', 'b'), 3)
+        restored.restore(rq.state())
+        self.assertEqual(restored.state(), {'a': [2.0, 3.0, 4.0], 'b': [-2.0, -3.0, -4.0]})
+        self.assertEqual(restored.quantiles(), rq.quantiles())
+
+if __name__ == '__main__':
+    unittest.main()
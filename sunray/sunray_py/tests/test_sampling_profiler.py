@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""
+Tests für den Sampling-Profiler (utils/sampling_profiler.py).
+"""
+
+import unittest
+import os
+import sys
+import threading
+import time
+
+# Pfad zum Hauptverzeichnis hinzufügen
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from utils.sampling_profiler import TRUNCATED, SamplingProfiler
+
+def busy_leaf(stop):
+    x = 0
+    while not stop.is_set():
+        for _ in range(100000):
+            x += 1
+    return x
+
+def busy_outer(stop):
+    return busy_leaf(stop)
+
+class TestSamplingProfiler(unittest.TestCase):
+    def setUp(self):
+        self.stop = threading.Event()
+        self.threads = []
+
+    def tearDown(self):
+        self.stop.set()
+        for thread in self.threads:
+            thread.join()
+
+    def spawn(self, target, name):
+        thread = threading.Thread(target=target, args=(self.stop,), name=name)
+        thread.start()
+        self.threads.append(thread)
+
+    def profile(self, seconds, **config):
+        profiler = SamplingProfiler(dict({'rate': 100}, **config))
+        profiler.start()
+        time.sleep(seconds)
+        profiler.stop()
+        return profiler
+
+    def test_folded_stacks_per_thread(self):
+        """Gefaltete Stacks enthalten Thread-Name und Aufrufkette von außen nach innen."""
+        self.spawn(busy_outer, 'busy')
+        profiler = self.profile(0.5)
+        lines = [line for line in profiler.folded('busy').splitlines()]
+        self.assertTrue(lines)
+        stack, count = lines[0].rsplit(' ', 1)
+        frames = stack.split(';')
+        self.assertEqual(frames[0], 'busy')
+        self.assertTrue(frames[-1].startswith('busy_leaf (test_sampling_profiler.py:'))
+        self.assertTrue(frames[-2].startswith('busy_outer'))
+        self.assertGreater(sum(int(line.rsplit(' ', 1)[1]) for line in lines), 20)
+        self.assertNotIn('sampling-profiler', profiler.folded())
+
+    def test_top_functions(self):
+        """top() sortiert nach Eigenanteil; die Aufrufer erscheinen nur im Gesamtanteil."""
+        self.spawn(busy_outer, 'busy')
+        profiler = self.profile(0.3)
+        top = {entry['function'].split(' ')[0]: entry for entry in profiler.top(10, 'busy')}
+        self.assertGreater(top['busy_leaf']['self_share'], 0.9)
+        self.assertEqual(top['busy_outer']['self'], 0)
+        self.assertGreater(top['busy_outer']['total_share'], 0.9)
+
+    def test_waiting_threads_are_skipped(self):
+        """Threads in Event.wait zählen nur mit include_idle."""
+        self.spawn(lambda stop: stop.wait(), 'waiter')
+        profiler = self.profile(0.2)
+        self.assertEqual(profiler.folded('waiter'), '')
+        self.assertGreater(profiler.stats['idle_skipped'], 0)
+        profiler = self.profile(0.2, include_idle=True)
+        self.assertIn('waiter;', profiler.folded('waiter'))
+
+    def test_overhead_below_limit(self):
+        """Bei 100 Hz bleibt der Abtastaufwand unter 2 % der Wanduhrzeit."""
+        for i in range(8):
+            self.spawn(lambda stop: stop.wait(), f'waiter{i}')
+        self.spawn(busy_outer, 'busy')
+        profiler = self.profile(1.0)
+        status = profiler.get_status()
+        self.assertGreater(status['samples'], 50)
+        self.assertLess(status['overhead'], 0.02)
+        self.assertEqual(status['rate_reductions'], 0)
+
+    def test_rate_reduced_when_too_expensive(self):
+        """Ist das Abtasten teurer als max_overhead, halbiert sich die Rate."""
+        self.spawn(busy_outer, 'busy')
+        profiler = self.profile(1.3, rate=200, max_overhead=1e-6)
+        self.assertGreaterEqual(profiler.stats['rate_reductions'], 1)
+        self.assertLess(profiler.current_rate, 200)
+
+    def test_stack_limit_and_duration(self):
+        """Über max_stacks hinaus wird unter TRUNCATED gezählt; duration beendet das Abtasten."""
+        self.spawn(busy_outer, 'busy')
+        profiler = SamplingProfiler({'rate': 100, 'max_stacks': 0, 'duration': 0.2})
+        profiler.start()
+        time.sleep(0.5)
+        self.assertFalse(profiler.running)
+        self.assertIn(f'busy;{TRUNCATED} ', profiler.folded())
+        self.assertFalse(profiler.stop())
+        self.assertTrue(profiler.start(duration=0.1))
+        self.assertFalse(profiler.start())
+        profiler.stop()
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+"""
+Tests für das indizierte Sensor-Log (sensor_log.py).
+"""
+
+import unittest
+import os
+import struct
+import sys
+import tempfile
+
+# Pfad zum Hauptverzeichnis hinzufügen
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.insert(0, ROOT)
+
+from sensor_log import (SensorLogReader, SensorLogWriter, UbxScanner, convert_pico_lines,
+                        convert_ubx, parse_pico_line)
+from simulation.protocols import nav_pvt, ubx_frame
+
+try:
+    import numpy
+except ImportError:
+    numpy = None
+
+class TestSensorLog(unittest.TestCase):
+    """Tests für SensorLogWriter/SensorLogReader."""
+
+    def setUp(self):
+        """Setup für jeden Test."""
+        self.temp_dir = tempfile.TemporaryDirectory()
+        self.path = os.path.join(self.temp_dir.name, 'log.slg')
+        self.t0 = 1700000000.0
+
+    def tearDown(self):
+        """Cleanup nach jedem Test."""
+        self.temp_dir.cleanup()
+
+    def _record(self, seconds=600, compression='zlib', close=True):
+        writer = SensorLogWriter(self.path, compression=compression, chunk_seconds=30.0)
+        for i in range(seconds * 10):
+            t = self.t0 + i / 10.0
+            writer.append('odometry', t, i * 3, i * 2, i, 0.0, i % 2, 0, 0)
+            if i % 10 == 0:
+                writer.append('summary', t, 25.0 + i / 1e4, 0.0, 0.0, 0, 0, 0, 0, 1.0, 0.5, 0.5, 20.0, 0)
+        if close:
+            writer.close()
+        return writer
+
+    def test_roundtrip_and_time_window(self):
+        """Ein Zeitfenster liefert genau die Datensätze darin, über Chunk-Grenzen hinweg."""
+        self._record()
+        with SensorLogReader(self.path) as log:
+            self.assertFalse(log.recovered)
+            self.assertEqual(log.record_count('odometry'), 6000)
+            self.assertEqual(log.record_count('summary'), 600)
+            window = list(log.records('odometry', self.t0 + 100.0, self.t0 + 159.95))
+            self.assertEqual(len(window), 600)
+            self.assertAlmostEqual(window[0].t, self.t0 + 100.0)
+            self.assertEqual(window[0].odom_right, 3000)
+            # Nur die überlappenden Chunks werden gelesen
+            self.assertLessEqual(len(log.chunks('odometry', self.t0 + 100.0, self.t0 + 159.95)), 3)
+            point = log.seek('summary', self.t0 + 42.5)
+            self.assertAlmostEqual(point.t, self.t0 + 43.0)
+            self.assertAlmostEqual(point.bat_voltage, 25.043, places=4)
+
+    def test_uncompressed_and_compressed_equal(self):
+        """Kompression ändert die gelesenen Werte nicht."""
+        self._record(compression=None)
+        with SensorLogReader(self.path) as log:
+            plain = list(log.records('odometry'))
+        self._record(compression='zlib')
+        with SensorLogReader(self.path) as log:
+            self.assertEqual(list(log.records('odometry')), plain)
+        self.assertLess(os.path.getsize(self.path), 6000 * 25)
+
+    def test_recovers_without_footer(self):
+        """Ohne Footer (Absturz) wird der Index aus den Chunks neu aufgebaut."""
+        writer = self._record(close=False)
+        writer._file.flush()
+        with open(self.path, 'ab') as f:
+            f.write(b'SC\x00')  # abgeschnittener Chunk-Header
+        with SensorLogReader(self.path) as log:
+            self.assertTrue(log.recovered)
+            self.assertGreater(log.record_count('odometry'), 5000)
+            self.assertEqual(next(log.records('odometry')).odom_right, 0)
+        writer._file.close()
+
+    def test_rejects_non_monotonic_time_and_bad_stream(self):
+        """Zeitsprünge zurück und unbekannte Streams werden verworfen."""
+        with SensorLogWriter(self.path) as writer:
+            self.assertTrue(writer.append('odometry', 10.0, 1, 1, 0, 0.0, 0, 0, 0))
+            self.assertFalse(writer.append('odometry', 9.0, 2, 2, 0, 0.0, 0, 0, 0))
+            self.assertFalse(writer.append('imu', 11.0, 0.0))
+        with self.assertRaises(ValueError):
+            SensorLogReader(os.path.join(ROOT, 'config.json'))
+
+    @unittest.skipIf(numpy is None, 'numpy nicht installiert')
+    def test_numpy_columns(self):
+        """Unkomprimierte Chunks lassen sich als numpy.memmap einblenden."""
+        self._record(compression=None)
+        with SensorLogReader(self.path) as log:
+            maps = log.memmap('odometry')
+            self.assertEqual(sum(len(m) for m in maps), 6000)
+            data = log.array('odometry', self.t0 + 100.0, self.t0 + 159.95)
+            self.assertEqual(len(data), 600)
+            self.assertEqual(int(data['odom_left'][0]), 2000)
+
+class TestConverters(unittest.TestCase):
+    """Pico-ASCII- und UBX-Konverter."""
+
+    def setUp(self):
+        """Setup für jeden Test."""
+        self.temp_dir = tempfile.TemporaryDirectory()
+        self.path = os.path.join(self.temp_dir.name, 'log.slg')
+
+    def tearDown(self):
+        """Cleanup nach jedem Test."""
+        self.temp_dir.cleanup()
+
+    def test_parse_pico_lines(self):
+        """AT+S:, M (mit Prüfsumme) und S werden den Streams zugeordnet."""
+        self.assertEqual(parse_pico_line('AT+S:120,118,7,0.00,,2,1,0'),
+                         ('odometry', (120, 118, 7, 0.0, 2, 1, 0)))
+        self.assertEqual(parse_pico_line('M,5,6,0,27.5,0,0,1,0x7f'),
+                         ('odometry', (5, 6, 0, 27.5, 0, 0, 1)))
+        stream, values = parse_pico_line('S,26.41,0.00,0.00,0,1,0,0,1.21,0.42,0.45,24.5')
+        self.assertEqual(stream, 'summary')
+        self.assertAlmostEqual(values[0], 26.41)
+        self.assertEqual(values[4], 1)
+        self.assertIsNone(parse_pico_line('V,Landrumower RPI Pico 1.15.3,0xe'))
+        self.assertIsNone(parse_pico_line('AT+S:x,y'))
+
+    def test_convert_pico_lines(self):
+        """Zeitstempel vor der Zeile werden übernommen, sonst gilt die Rate."""
+        lines = ['12.50 AT+S:1,1,0,0.00,,0,0,0', '12.55 AT+S:2,2,0,0.00,,0,0,0', 'debug output',
+                 '13.00 S,25.1,0,0,0,0,0,0,1,0.5,0.5,20,0']
+        with SensorLogWriter(self.path) as writer:
+            stats = convert_pico_lines(lines, writer)
+        self.assertEqual(stats, {'lines': 4, 'records': 3, 'skipped': 1})
+        with SensorLogReader(self.path) as log:
+            self.assertEqual([r.t for r in log.records('odometry')], [12.5, 12.55])
+            self.assertAlmostEqual(log.seek('summary', 0.0).bat_voltage, 25.1, places=5)
+
+    def test_convert_ubx_stream(self):
+        """NAV-PVT und NAV-RELPOSNED aus einem gestückelten Strom mit Fremdbytes."""
+        epoch = 1700000000.0
+        stream = bytearray(b'$GPGGA,garbage*00\r\n')
+        for i in range(20):
+            sample = {'fix_type': 3, 'carr_soln': 2, 'h_acc': 0.014, 'num_sv': 24, 'lat': 52.5 + i * 1e-6,
+                      'lon': 13.4, 'alt': 40.0, 'vel_n': 0.3, 'vel_e': 0.1, 'speed': 0.32, 'course': 18.4}
+            stream += nav_pvt(sample, i * 0.1, epoch)
+        itow = 2 * 86400 * 1000 + 1000
+        relpos = struct.pack('<BBHIiiiii4xbbbbIIIII4xI', 1, 0, 0, itow, 150, -20, 3, 151, 9000000,
+                             5, 0, 0, 1, 140, 140, 300, 140, 0, 0x137)
+        stream += ubx_frame(0x01, 0x3C, relpos)
+        corrupt = bytearray(ubx_frame(0x01, 0x07, bytes(92)))
+        corrupt[-1] ^= 0xFF
+        stream += corrupt
+        pieces = [bytes(stream[i:i + 37]) for i in range(0, len(stream), 37)]
+        with SensorLogWriter(self.path) as writer:
+            stats = convert_ubx(pieces, writer)
+        self.assertEqual(stats['nav_pvt'], 20)
+        self.assertEqual(stats['relposned'], 1)
+        self.assertEqual(stats['bad_checksum'], 1)
+        with SensorLogReader(self.path) as log:
+            fixes = list(log.records('gnss'))
+            self.assertAlmostEqual(fixes[0].t, epoch, places=2)
+            self.assertAlmostEqual(fixes[19].lat, 52.500019, places=7)
+            self.assertEqual(fixes[0].carr_soln, 2)
+            self.assertAlmostEqual(fixes[0].h_acc, 0.014, places=4)
+            baseline = next(log.records('relpos'))
+            self.assertAlmostEqual(baseline.rel_n, 1.5005, places=4)
+            self.assertAlmostEqual(baseline.heading, 90.0, places=4)
+            self.assertEqual(baseline.flags, 0x137)
+
+    def test_scanner_waits_for_partial_frame(self):
+        """Ein angefangener Rahmen wird erst mit dem Rest geliefert."""
+        frame = ubx_frame(0x01, 0x07, bytes(92))
+        scanner = UbxScanner()
+        self.assertEqual(list(scanner.feed(frame[:50])), [])
+        messages = list(scanner.feed(frame[50:]))
+        self.assertEqual([(c, i, len(p)) for c, i, p in messages], [(0x01, 0x07, 92)])
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+"""
+Tests für den Mähroboter-Simulator (simulation/).
+"""
+
+import unittest
+import math
+import os
+import shutil
+import sys
+import tempfile
+import time
+
+# Pfad zum Hauptverzeichnis hinzufügen (navigation/ für die flachen Importe aus main.py)
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.insert(0, ROOT)
+sys.path.insert(0, os.path.join(ROOT, 'navigation'))
+
+from main import process_pico_data
+from simulation.protocols import decode_nav_pvt, nmea_checksum, pico_crc
+from simulation.pty_bridge import PtyBridge
+from simulation.simulator import Simulator
+from simulation.world import SimWorld
+
+def drive(sim, left, right, mow, duration):
+    """Sendet den Motorbefehl wie HardwareManager regelmäßig und gibt die letzte Odometriezeile zurück."""
+    sim.run(duration, lambda s: s.send(f'AT+MOTOR,{left},{right},{mow}'), control_interval=0.1)
+    lines = [line for line in sim.read_pico_lines() if line.startswith('AT+S:')]
+    return process_pico_data(lines[-1])
+
+class TestKinematics(unittest.TestCase):
+    def setUp(self):
+        self.sim = Simulator(SimWorld.default(), seed=3)
+
+    def test_straight_drive_with_slip(self):
+        """Encoder zählen die Radumdrehung, über Grund fährt der Roboter wegen Schlupf etwas weniger."""
+        data = drive(self.sim, 128, 128, 0, 5.0)
+        mower = self.sim.mower
+        wheel_distance = (data['odom_left'] + data['odom_right']) / 2.0 / 1000.0
+        self.assertAlmostEqual(data['odom_left'], data['odom_right'], delta=20)
+        self.assertGreater(wheel_distance, 1.2)
+        self.assertLess(mower.x, wheel_distance)
+        self.assertGreater(mower.x, wheel_distance * 0.9)
+        self.assertAlmostEqual(mower.y, 0.0, delta=0.3)
+
+    def test_turn_in_place_and_imu(self):
+        """Gegenläufige Räder drehen auf der Stelle, der IMU-Kurs folgt mit kleiner Drift."""
+        drive(self.sim, -80, 80, 0, 2.0)
+        mower = self.sim.mower
+        self.assertLess(math.hypot(mower.x, mower.y), 0.05)
+        self.assertGreater(abs(mower.heading), 0.5)
+        imu = self.sim.read_imu()
+        error = (math.radians(imu['heading']) - mower.heading + math.pi) % (2 * math.pi) - math.pi
+        self.assertLess(abs(error), 0.1)
+        self.assertEqual(len(imu['quaternion']), 4)
+
+    def test_bumper_against_obstacle(self):
+        """Fahrt gegen den Baum: Bumper in AT+S: und S, Blockierstrom, Roboter bleibt davor stehen."""
+        self.sim.mower.place(4.0, 4.5, 0.0)
+        data = drive(self.sim, 150, 150, 0, 6.0)
+        mower = self.sim.mower
+        self.assertEqual(data['bumper'], 3)
+        self.assertLess(mower.x, 6.0 - mower.radius + 0.01)
+        self.assertEqual(mower.bumper_contacts, 1)
+        summary = process_pico_data(self.sim.send('AT+S,1')[0])
+        self.assertEqual(summary['bumper'], 3)
+        self.assertGreater(summary['motor_left_current'], 1.5)
+
+        drive(self.sim, -150, -150, 0, 1.0)
+        self.assertFalse(mower.bumper)
+
+    def test_motor_timeout(self):
+        """Ohne neuen Motorbefehl hält der Pico nach 3 s an."""
+        self.sim.send('AT+MOTOR,100,100,0')
+        self.sim.run(5.0)
+        self.assertEqual(self.sim.mower.pwm_left, 0)
+        self.assertAlmostEqual(self.sim.mower.v, 0.0, places=3)
+
+    def test_firmware_commands(self):
+        """AT+M (rechts, links) und AT+V antworten mit Prüfsumme wie cmdAnswer()."""
+        response = self.sim.send('AT+M,50,-50,0')[0]
+        line, crc = response.rsplit(',', 1)
+        self.assertTrue(line.startswith('M,'))
+        self.assertEqual(crc, pico_crc(line))
+        self.assertEqual((self.sim.mower.pwm_left, self.sim.mower.pwm_right), (-50, 50))
+        self.assertTrue(self.sim.send('AT+V')[0].startswith('V,'))
+        self.sim.send('AT+STOP')
+        self.assertEqual(self.sim.mower.pwm_right, 0)
+
+class TestBatteryAndGnss(unittest.TestCase):
+    def test_battery_drain_and_charging(self):
+        """Mähen entlädt den Akku, an der Ladestation wird geladen."""
+        sim = Simulator(SimWorld.default(), {'robot': {'battery_soc': 0.5}}, seed=1)
+        sim.mower.place(5.0, 2.0, 0.0)
+        start_voltage = sim.mower.bat_voltage
+        drive(sim, 60, -60, 255, 600.0)
+        self.assertLess(sim.mower.soc, 0.5)
+        self.assertLess(sim.mower.bat_voltage, start_voltage)
+        self.assertGreater(sim.get_statistics()['energy_wh'], 1.0)
+
+        sim.mower.place(0.0, 0.0, 0.0)
+        soc = sim.mower.soc
+        sim.run(60.0)
+        summary = process_pico_data(sim.send('AT+S')[0])
+        self.assertGreater(summary['chg_voltage'], 25.0)
+        self.assertGreater(summary['chg_current'], 0.0)
+        self.assertGreater(sim.mower.soc, soc)
+
+    def test_gnss_quality_zones(self):
+        """NAV-PVT mit RTK fixed im Garten, float im RTK-Schatten; GGA mit gültiger Prüfsumme."""
+        sim = Simulator(SimWorld.default(), seed=2)
+        sim.run(1.0)
+        data = sim.read_gnss()
+        frames = [data[i:i + 100] for i in range(len(data)) if data[i:i + 2] == b'\xb5\x62']
+        pvt = decode_nav_pvt(frames[-1])
+        self.assertEqual((pvt['fixType'], pvt['flags'] >> 6), (3, 2))
+        self.assertLessEqual(pvt['hAcc'], 50)
+        self.assertAlmostEqual(pvt['lat'] / 1e7, sim.world.origin[0], places=5)
+
+        sim.mower.place(17.0, 10.5, 0.0)
+        sim.run(1.0)
+        data = sim.read_gnss()
+        frames = [data[i:i + 100] for i in range(len(data)) if data[i:i + 2] == b'\xb5\x62']
+        pvt = decode_nav_pvt(frames[-1])
+        self.assertEqual(pvt['flags'] >> 6, 1)
+        self.assertEqual(pvt['hAcc'], 250)
+        gga = data[data.rindex(b'$'):].decode().strip()
+        body, checksum = gga[1:].split('*')
+        self.assertEqual(checksum, nmea_checksum(body))
+        self.assertEqual(body.split(',')[6], '5')
+
+    def test_faster_than_real_time(self):
+        """Der Headless-Simulator läuft auf einem Kern deutlich schneller als Echtzeit."""
+        result = Simulator.benchmark(60.0)
+        self.assertGreater(result['speedup'], 10.0)
+
+class TestPtyBridge(unittest.TestCase):
+    def setUp(self):
+        self.directory = tempfile.mkdtemp()
+        self.bridge = PtyBridge(Simulator(SimWorld.default(), seed=4), self.directory)
+        self.bridge.start()
+
+    def tearDown(self):
+        self.bridge.stop()
+        shutil.rmtree(self.directory, ignore_errors=True)
+
+    def read_until(self, fd, predicate, timeout=3.0):
+        data = b''
+        end = time.monotonic() + timeout
+        while time.monotonic() < end and not predicate(data):
+            try:
+                data += os.read(fd, 4096)
+            except BlockingIOError:
+                time.sleep(0.01)
+        return data
+
+    def test_serial_ports(self):
+        """main.py-Seite: Befehl über das Pico-Terminal, Odometrie- und NAV-PVT-Daten kommen an."""
+        pico = os.open(os.path.join(self.directory, 'pico'), os.O_RDWR | os.O_NOCTTY | os.O_NONBLOCK)
+        gnss = os.open(os.path.join(self.directory, 'gnss'), os.O_RDWR | os.O_NOCTTY | os.O_NONBLOCK)
+        try:
+            os.write(pico, b'AT+V\n')
+            data = self.read_until(pico, lambda d: b'V,' in d and b'AT+S:' in d)
+            lines = data.decode().split('\r\n')
+            self.assertTrue(any(line.startswith('V,Sunray-Sim') for line in lines))
+            odometry = [line for line in lines if line.startswith('AT+S:')]
+            self.assertEqual(process_pico_data(odometry[0])['odom_left'], 0)
+            os.write(gnss, b'\xb5\x62\x06\x8a\x00\x00')  # Konfiguration wird verworfen
+            data = self.read_until(gnss, lambda d: b'\xb5\x62\x01\x07' in d)
+            self.assertIn(b'\xb5\x62\x01\x07', data)
+        finally:
+            os.close(pico)
+            os.close(gnss)
+
+if __name__ == '__main__':
+    unittest.main()
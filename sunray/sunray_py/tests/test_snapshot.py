@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+"""
+Tests für den versionierten Telemetrie-Snapshot.
+"""
+
+import unittest
+import threading
+import json
+import os
+import sys
+
+# Pfad zum Hauptverzeichnis hinzufügen
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from utils.snapshot import SnapshotBuffer, thaw
+
+class TestSnapshotBuffer(unittest.TestCase):
+    """Tests für SnapshotBuffer."""
+
+    def test_publish_and_read(self):
+        """Jede Veröffentlichung erhöht die Version."""
+        buffer = SnapshotBuffer()
+        self.assertEqual(buffer.version, 0)
+        self.assertEqual(buffer.publish({'gps': {'lat': 52.1}}), 1)
+        self.assertEqual(buffer.get('gps')['lat'], 52.1)
+        self.assertEqual(buffer.read().version, 1)
+
+    def test_snapshot_is_isolated(self):
+        """Spätere Änderungen der Quelldaten verändern den Snapshot nicht; Leser können nicht schreiben."""
+        buffer = SnapshotBuffer()
+        gps = {'lat': 52.1, 'sats': [1, 2]}
+        buffer.publish({'gps': gps})
+        gps['lat'] = 0.0
+        gps['sats'].append(3)
+        snapshot = buffer.read()
+        self.assertEqual(snapshot.data['gps']['lat'], 52.1)
+        self.assertEqual(thaw(snapshot.data)['gps']['sats'], [1, 2])
+        with self.assertRaises(TypeError):
+            snapshot.data['gps']['lat'] = 1.0
+
+    def test_thaw_is_json_serializable(self):
+        """Aufgetaute Snapshots lassen sich direkt als JSON ausgeben."""
+        buffer = SnapshotBuffer()
+        buffer.publish({'imu': {'roll': 1.5}, 'list': [{'a': 1}]})
+        self.assertEqual(json.loads(json.dumps(thaw(buffer.read().data))),
+                         {'imu': {'roll': 1.5}, 'list': [{'a': 1}]})
+
+    def test_readers_see_consistent_state(self):
+        """Gleichzeitige Leser sehen nie einen halb geschriebenen Stand."""
+        buffer = SnapshotBuffer()
+        stop = threading.Event()
+        torn = []
+
+        def reader():
+            while not stop.is_set():
+                data = buffer.read().data
+                if data and data['b'] != data['a'] * 2:
+                    torn.append(data)
+
+        threads = [threading.Thread(target=reader) for _ in range(4)]
+        for thread in threads:
+            thread.start()
+        for i in range(5000):
+            buffer.publish({'a': i, 'b': i * 2})
+        stop.set()
+        for thread in threads:
+            thread.join()
+        self.assertEqual(torn, [])
+
+    def test_wait_newer(self):
+        """wait_newer kehrt zurück, sobald ein neuerer Snapshot vorliegt."""
+        buffer = SnapshotBuffer()
+        buffer.publish({'a': 1})
+        threading.Timer(0.05, buffer.publish, ({'a': 2},)).start()
+        snapshot = buffer.wait_newer(1, timeout=2.0)
+        self.assertEqual(snapshot.version, 2)
+        self.assertEqual(buffer.wait_newer(5, timeout=0.01).version, 2)
+
+if __name__ == '__main__':
+    unittest.main()
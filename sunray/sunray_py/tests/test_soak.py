@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+"""
+Tests für die Wachstumsauswertung des Dauerlaufs und die begrenzten Verläufe.
+"""
+
+import unittest
+import os
+import sys
+from collections import deque
+
+# Pfad zum Hauptverzeichnis hinzufügen (navigation/ für die flachen Importe der Planer)
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.insert(0, ROOT)
+sys.path.insert(0, os.path.join(ROOT, 'navigation'))
+
+from simulation.soak import SoakMonitor, slope
+
+class LeakedRecord:
+    """Objekt, das in den Tests je Probe in einer Liste liegen bleibt."""
+    def __init__(self, value):
+        self.value = value
+        self.payload = [value] * 8
+
+def leak(store, count, tick):
+    for i in range(count):
+        store.append(LeakedRecord(tick * count + i))
+
+class SoakWorkload:
+    """Simulationszeit und Regelzyklen für SoakMonitor ohne main.py."""
+    def __init__(self, spec):
+        self.time = 0.0
+        self.monitor = SoakMonitor(lambda: self.time, spec)
+
+    def run(self, samples, step, tick_duration=lambda i: 0.005):
+        self.monitor.start()
+        try:
+            for i in range(samples):
+                step(i)
+                for _ in range(20):
+                    self.monitor.record_tick(tick_duration(i))
+                self.monitor.sample()
+                self.time += 1800.0
+            return self.monitor.report()
+        finally:
+            self.monitor.stop()
+
+SPEC = {'warmup_hours': 1.0, 'thresholds': {'rss_mb_per_hour': 1e9, 'objects_per_hour': 500,
+                                            'heap_mb_per_hour': 0.1, 'tick_p99_ms_per_hour': 1.0}}
+
+class TestSoakMonitor(unittest.TestCase):
+    def test_slope(self):
+        self.assertAlmostEqual(slope([0, 1, 2, 3], [1, 3, 5, 7]), 2.0)
+        self.assertEqual(slope([1], [5]), 0.0)
+
+    def test_growth_reported_with_call_site(self):
+        """Wachsende Liste: Typ, Heap-Steigung und die Zeile mit append werden gemeldet."""
+        store = []
+        report = SoakWorkload(SPEC).run(10, lambda i: leak(store, 2000, i),
+                                        tick_duration=lambda i: 0.005 + i * 0.002)
+        self.assertFalse(report['passed'])
+        self.assertTrue(any('LeakedRecord' in v for v in report['violations']), report['violations'])
+        self.assertTrue(any(v.startswith('heap_mb') for v in report['violations']))
+        self.assertTrue(any(v.startswith('tick_p99_ms') for v in report['violations']))
+        self.assertGreater(report['slopes']['tick_p99_ms'], 1.0)
+        sites = [site['traceback'][0] for site in report['call_sites']]
+        self.assertTrue(any('test_soak.py' in site for site in sites), sites)
+
+    def test_bounded_history_passes(self):
+        """Ein Ringpuffer (deque mit maxlen) wächst nach dem Füllen nicht weiter."""
+        store = deque(maxlen=2000)
+        report = SoakWorkload(SPEC).run(10, lambda i: leak(store, 2000, i))
+        self.assertTrue(report['passed'], report['violations'])
+        self.assertEqual(report['call_sites'], [])
+
+    def test_short_run_fails(self):
+        report = SoakWorkload(SPEC).run(2, lambda i: None)
+        self.assertFalse(report['passed'])
+
+class TestBoundedStructures(unittest.TestCase):
+    def test_planner_dynamic_obstacles(self):
+        """Doppelte Hindernisse werden nicht aufgenommen, die Anzahl ist begrenzt."""
+        from advanced_path_planner import AdvancedPathPlanner
+        from map import Point, Polygon
+
+        def square(x, y, size=0.5):
+            return Polygon([Point(x, y), Point(x + size, y), Point(x + size, y + size), Point(x, y + size)])
+
+        planner = AdvancedPathPlanner()
+        planner.max_dynamic_obstacles = 5
+        planner.add_dynamic_obstacle(square(0, 0), replan=False)
+        planner.add_dynamic_obstacle(square(0.1, 0.1), replan=False)
+        self.assertEqual(len(planner.dynamic_obstacles), 1)
+        for i in range(10):
+            planner.add_dynamic_obstacle(square(10 + i, 0), replan=False)
+        self.assertEqual(len(planner.dynamic_obstacles), 5)
+        self.assertAlmostEqual(planner.dynamic_obstacles[-1].points[0].x, 19)
+
+if __name__ == '__main__':
+    unittest.main()
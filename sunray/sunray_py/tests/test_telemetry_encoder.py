@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+"""
+Tests für CBOR und die delta-kodierte Telemetrie.
+"""
+
+import unittest
+import os
+import sys
+
+# Pfad zum Hauptverzeichnis hinzufügen
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from communication import cbor
+from communication.telemetry_encoder import TelemetryEncoder, TelemetryDecoder, TelemetryPublisher
+
+class FakeMQTT:
+    """Zeichnet veröffentlichte Nachrichten auf."""
+    def __init__(self):
+        self.messages = []
+        self.retained = {}
+
+    def publish_bytes(self, topic, payload, retain=False):
+        self.messages.append((topic, payload))
+        if retain:
+            self.retained[topic] = payload
+
+def snapshot(voltage=26.4, x=1.0):
+    return {
+        'battery': {'voltage': voltage, 'charging': False},
+        'gps': {'lat': 52.12345678, 'lon': 13.1, 'fix_type': 4},
+        'motor': {'pwm': [120, 118], 'state': 'mow'},
+        'position': {'x': x, 'y': 2.0}
+    }
+
+class TestCBOR(unittest.TestCase):
+    """Tests für den CBOR-Kodierer."""
+
+    def test_roundtrip(self):
+        """Alle unterstützten Typen überstehen Kodieren und Dekodieren."""
+        data = {0: 1, 1: -500, 2: 1.5, 3: 52.12345678, 'text': 'Mähen',
+                'list': [True, False, None, 70000, -2 ** 40], 'bytes': b'\x01\x02'}
+        self.assertEqual(cbor.loads(cbor.dumps(data)), data)
+
+    def test_known_encoding(self):
+        """Kodierung entspricht RFC 8949 Anhang A."""
+        self.assertEqual(cbor.dumps(100), bytes.fromhex('1864'))
+        self.assertEqual(cbor.dumps(-1000), bytes.fromhex('3903e7'))
+        self.assertEqual(cbor.dumps([1, [2, 3]]), bytes.fromhex('8201820203'))
+        self.assertEqual(cbor.dumps(1.5), bytes.fromhex('fa3fc00000'))
+
+class TestTelemetryEncoder(unittest.TestCase):
+    """Tests für Encoder und Decoder."""
+
+    def _sync(self, encoder, decoder, data, now):
+        payload, _, schema_changed = encoder.encode(data, now)
+        if schema_changed:
+            decoder.update_schema(encoder.schema_message())
+        return payload, decoder.decode(payload)
+
+    def test_only_changed_fields(self):
+        """Nach dem Keyframe werden nur geänderte Felder gesendet."""
+        encoder = TelemetryEncoder(keyframe_interval=5.0, precision_overrides={'gps.lat': 8})
+        decoder = TelemetryDecoder()
+
+        full, state = self._sync(encoder, decoder, snapshot(), 0.0)
+        self.assertEqual(state['gps']['lat'], 52.12345678)
+
+        delta, state = self._sync(encoder, decoder, snapshot(x=1.25), 0.1)
+        self.assertLess(len(delta), len(full) / 3)
+        self.assertEqual(cbor.loads(delta)[3], {encoder.schema['position.x']: 1.25})
+        self.assertEqual(state['position']['x'], 1.25)
+        self.assertEqual(state['motor']['pwm'], [120, 118])
+
+    def test_noise_below_precision_not_sent(self):
+        """Änderungen unterhalb der Genauigkeit erzeugen keine Felder."""
+        encoder = TelemetryEncoder(float_precision=2)
+        encoder.encode(snapshot(voltage=26.401), 0.0)
+        payload, _, _ = encoder.encode(snapshot(voltage=26.4012), 0.1)
+        self.assertEqual(cbor.loads(payload)[3], {})
+
+    def test_new_and_removed_fields(self):
+        """Neue Felder erweitern das Schema, fehlende werden als entfernt gemeldet."""
+        encoder = TelemetryEncoder()
+        decoder = TelemetryDecoder()
+        self._sync(encoder, decoder, snapshot(), 0.0)
+
+        data = snapshot()
+        del data['motor']
+        data['rain'] = True
+        _, state = self._sync(encoder, decoder, data, 0.1)
+        self.assertNotIn('motor', state)
+        self.assertTrue(state['rain'])
+
+    def test_decoder_waits_for_keyframe_after_gap(self):
+        """Nach einer Sequenzlücke liefert der Decoder bis zum Keyframe nichts."""
+        encoder = TelemetryEncoder(keyframe_interval=1.0)
+        decoder = TelemetryDecoder()
+        self._sync(encoder, decoder, snapshot(), 0.0)
+        encoder.encode(snapshot(x=2.0), 0.1)  # verloren
+
+        _, state = self._sync(encoder, decoder, snapshot(x=3.0), 0.2)
+        self.assertIsNone(state)
+        _, state = self._sync(encoder, decoder, snapshot(x=4.0), 1.5)
+        self.assertEqual(state['position']['x'], 4.0)
+
+class TestTelemetryPublisher(unittest.TestCase):
+    """Tests für Rate-Limits und Statistik."""
+
+    def test_rate_limit_and_stats(self):
+        """Rate-Limits werden eingehalten, die Ersparnis wird gemeldet."""
+        mqtt = FakeMQTT()
+        publisher = TelemetryPublisher(mqtt, rate_limits={'t': 0.1})
+
+        sent = [publisher.publish('t', snapshot(x=i * 0.01), now=i * 0.05) for i in range(20)]
+        self.assertEqual(sum(sent), 10)
+        self.assertIn('t/schema', mqtt.retained)
+
+        stats = publisher.get_statistics()['t']
+        self.assertEqual(stats['messages'], 10)
+        self.assertGreater(stats['bytes_saved'], 0)
+        self.assertLess(stats['compression_ratio'], 0.5)
+
+if __name__ == '__main__':
+    unittest.main()
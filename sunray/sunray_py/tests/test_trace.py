@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+"""
+Tests für die Trace-Aufzeichnung (utils/trace.py).
+"""
+
+import unittest
+import json
+import os
+import sys
+import shutil
+import tempfile
+import threading
+import time
+
+# Pfad zum Hauptverzeichnis hinzufügen
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from utils.trace import TraceRecorder, export_seconds, valid_reason
+
+class TestTraceRecorder(unittest.TestCase):
+    def setUp(self):
+        self.directory = tempfile.mkdtemp()
+        self.recorder = TraceRecorder({'directory': self.directory, 'tick_deadline': 0.01,
+                                       'min_dump_interval': 60.0, 'buffer_size': 100})
+
+    def tearDown(self):
+        shutil.rmtree(self.directory, ignore_errors=True)
+
+    def spans(self, trace):
+        return [e for e in trace['traceEvents'] if e['ph'] == 'X']
+
+    def test_spans_per_thread(self):
+        """Jeder Thread schreibt in seinen eigenen Puffer und erhält einen Namen im Trace."""
+        def worker():
+            with self.recorder.span('worker.step', 'test', {'n': 1}):
+                time.sleep(0.001)
+
+        thread = threading.Thread(target=worker, name='worker')
+        thread.start()
+        thread.join()
+        with self.recorder.span('main.step', 'test'):
+            pass
+
+        trace = self.recorder.export()
+        names = {e['args']['name'] for e in trace['traceEvents'] if e['name'] == 'thread_name'}
+        self.assertIn('worker', names)
+        spans = {e['name']: e for e in self.spans(trace)}
+        self.assertNotEqual(spans['worker.step']['tid'], spans['main.step']['tid'])
+        self.assertGreaterEqual(spans['worker.step']['dur'], 1000)
+        self.assertEqual(spans['worker.step']['args'], {'n': 1})
+        json.dumps(trace)
+
+    def test_tick_stages(self):
+        """Abschnitte liegen lückenlos innerhalb des Zyklus."""
+        tick = self.recorder.begin_tick('control_loop')
+        tick.stage('sensors')
+        time.sleep(0.002)
+        tick.stage('operation')
+        duration = tick.end({'operation': 'mow'})
+        spans = {e['name']: e for e in self.spans(self.recorder.export())}
+        loop = spans['control_loop']
+        self.assertAlmostEqual(loop['dur'] / 1e6, duration, places=4)
+        self.assertEqual(loop['args'], {'operation': 'mow'})
+        self.assertGreaterEqual(spans['sensors']['ts'], loop['ts'])
+        self.assertLessEqual(spans['operation']['ts'] + spans['operation']['dur'],
+                             loop['ts'] + loop['dur'] + 1)
+
+    def test_ring_buffer_and_window(self):
+        """Der Puffer ist begrenzt, der Export enthält nur das Zeitfenster."""
+        for i in range(250):
+            self.recorder.instant(f'event{i}')
+        events = [e for e in self.recorder.export()['traceEvents'] if e['ph'] == 'i']
+        self.assertEqual(len(events), 100)
+        self.assertEqual(events[-1]['name'], 'event249')
+        time.sleep(0.05)
+        self.recorder.instant('recent')
+        recent = [e['name'] for e in self.recorder.export(0.02)['traceEvents'] if e['ph'] == 'i']
+        self.assertEqual(recent, ['recent'])
+
+    def test_deadline_dump(self):
+        """Eine Deadline-Überschreitung schreibt einen Trace, weitere nur nach min_dump_interval."""
+        tick = self.recorder.begin_tick()
+        tick.stage('slow')
+        time.sleep(0.02)
+        self.assertTrue(self.recorder.check_deadline(tick.end()))
+        self.assertFalse(self.recorder.check_deadline(0.001))
+        for _ in range(100):
+            if self.recorder.stats['dumps']:
+                break
+            time.sleep(0.01)
+        self.assertTrue(self.recorder.check_deadline(0.5))
+        self.assertEqual(self.recorder.stats['deadline_misses'], 2)
+        self.assertEqual(self.recorder.stats['skipped_dumps'], 1)
+        files = self.recorder.list_files()
+        self.assertEqual(len(files), 1)
+        with open(os.path.join(self.directory, files[0]['name'])) as f:
+            trace = json.load(f)
+        self.assertEqual(trace['otherData']['reason'], 'deadline')
+        names = [e['name'] for e in trace['traceEvents']]
+        self.assertIn('slow', names)
+        self.assertIn('deadline_miss', names)
+
+    def test_finished_thread_buffers_dropped(self):
+        """Puffer beendeter Threads bleiben nur, solange ihre Ereignisse im Zeitfenster liegen."""
+        recorder = TraceRecorder({'directory': self.directory, 'window': 0.05})
+        def request():
+            recorder.instant('request')
+        for _ in range(20):
+            thread = threading.Thread(target=request)
+            thread.start()
+            thread.join()
+        recorder.instant('main')
+        self.assertEqual(len(recorder.get_status()['threads']), 21)
+        time.sleep(0.1)
+        recorder.instant('main')
+        trace = recorder.export()
+        self.assertEqual([e['name'] for e in trace['traceEvents'] if e['ph'] == 'i'], ['main'])
+        self.assertEqual(len(recorder.get_status()['threads']), 1)
+
+    def test_dump_arguments(self):
+        """Der Grund wird Teil des Dateinamens, der Zeitraum ist begrenzt."""
+        self.assertTrue(valid_reason('deadline_2-b'))
+        for reason in ('../../etc/x', 'a b', '', None, 'x' * 41):
+            self.assertFalse(valid_reason(reason))
+        self.assertIsNone(export_seconds(None))
+        self.assertEqual(export_seconds('2.5'), 2.5)
+        self.assertEqual(export_seconds(1e9), 3600.0)
+        for seconds in ('nan', 'inf', -1, 0, 'abc', [1]):
+            with self.assertRaises(ValueError):
+                export_seconds(seconds)
+        path = self.recorder.dump('../escape')
+        self.assertEqual(os.path.dirname(path), self.directory)
+        self.assertIn('___escape', os.path.basename(path))
+
+    def test_disabled(self):
+        """Abgeschaltet wird nichts aufgezeichnet und nichts gedumpt."""
+        recorder = TraceRecorder({'enabled': False, 'directory': self.directory})
+        with recorder.span('ignored'):
+            pass
+        self.assertFalse(recorder.check_deadline(recorder.begin_tick().end() + 10.0))
+        self.assertEqual(self.spans(recorder.export()), [])
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""
+Tests für das kompakte Missions-Track-Archiv.
+"""
+
+import unittest
+import tempfile
+import math
+import os
+import sys
+
+# Pfad zum Hauptverzeichnis hinzufügen
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from track_archive import TrackArchive, TrackReader
+
+class TestTrackArchive(unittest.TestCase):
+    """Tests für TrackRecorder/TrackReader."""
+
+    def setUp(self):
+        """Setup für jeden Test."""
+        self.temp_dir = tempfile.TemporaryDirectory()
+        self.archive = TrackArchive(self.temp_dir.name)
+        self.t0 = 1700000000.0
+
+    def tearDown(self):
+        """Cleanup nach jedem Test."""
+        self.temp_dir.cleanup()
+
+    def _record(self, count, block_size=64):
+        recorder = self.archive.start_mission(52.5, 13.4, 'mission', block_size=block_size)
+        for i in range(count):
+            recorder.append(self.t0 + i * 0.1, i * 0.03, math.sin(i / 50.0),
+                            -0.5 + i * 0.001, 4 if i % 100 else 5, 0.014)
+        return recorder
+
+    def test_roundtrip_millimetre_precision(self):
+        """Alle Punkte werden mit Millimeter-/Millisekundenauflösung gelesen."""
+        self._record(1000).close()
+        points = list(self.archive.open('mission').points())
+
+        self.assertEqual(len(points), 1000)
+        self.assertAlmostEqual(points[500].t, self.t0 + 50.0, places=3)
+        self.assertAlmostEqual(points[500].x, 15.0, places=3)
+        self.assertAlmostEqual(points[500].y, math.sin(10.0), places=3)
+        self.assertEqual(points[100].fix_type, 5)
+        self.assertAlmostEqual(points[999].heading, 0.499, places=3)
+
+    def test_seek_by_time(self):
+        """seek() springt über den Blockindex zum richtigen Punkt."""
+        self._record(1000).close()
+        reader = self.archive.open('mission')
+
+        point = reader.seek(self.t0 + 73.25)
+        self.assertAlmostEqual(point.t, self.t0 + 73.3, places=3)
+        window = list(reader.points(self.t0 + 10.0, self.t0 + 19.95))
+        self.assertEqual(len(window), 100)
+        self.assertIsNone(reader.seek(self.t0 + 1000.0))
+
+    def test_recovers_without_index(self):
+        """Fehlt der Index (Absturz), wird er aus den Blöcken neu aufgebaut."""
+        recorder = self._record(200)
+        recorder.flush()
+        os.remove(recorder.index_filename)
+
+        reader = TrackReader(recorder.filename)
+        self.assertEqual(reader.point_count, 200)
+        recorder.close()
+
+    def test_compact_size(self):
+        """Gleichmäßige Fahrt benötigt nur wenige Bytes pro Punkt."""
+        self._record(10000, block_size=512).close()
+        size = os.path.getsize(os.path.join(self.temp_dir.name, 'mission.trk'))
+        self.assertLess(size / 10000, 2.0)
+
+    def test_exports(self):
+        """GeoJSON- und GPX-Export enthalten alle (ausgedünnten) Punkte."""
+        self._record(100).close()
+        reader = self.archive.open('mission')
+
+        geojson = reader.to_geojson(step=10)
+        self.assertEqual(geojson['geometry']['type'], 'LineString')
+        self.assertEqual(len(geojson['geometry']['coordinates']), 10)
+        lon, lat = geojson['geometry']['coordinates'][0]
+        self.assertAlmostEqual(lat, 52.5, places=5)
+        self.assertAlmostEqual(lon, 13.4, places=5)
+
+        gpx = reader.to_gpx()
+        self.assertEqual(gpx.count('<trkpt'), 100)
+
+    def test_list_missions(self):
+        """list_missions() meldet Zeitbereich und Punktanzahl."""
+        self._record(50).close()
+        missions = self.archive.list_missions()
+
+        self.assertEqual(len(missions), 1)
+        self.assertEqual(missions[0]['points'], 50)
+        with self.assertRaises(ValueError):
+            self.archive.open('../etc/passwd')
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+"""
+Tests für Antwort-Cache, ETags und vorkomprimierte statische Dateien.
+"""
+
+import unittest
+import tempfile
+import gzip
+import time
+import os
+import sys
+
+# Pfad zum Hauptverzeichnis hinzufügen
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from web_serving import ContentVersions, ResponseCache, WorkerSlots, etag_matches, accepts_gzip, precompress_static
+
+class TestResponseCache(unittest.TestCase):
+    """Tests für ResponseCache."""
+
+    def setUp(self):
+        """Setup für jeden Test."""
+        self.versions = ContentVersions()
+        self.cache = ResponseCache(self.versions, min_compress=16)
+
+    def test_entry_valid_until_version_changes(self):
+        """Ein Eintrag gilt bis zur nächsten Änderung der Inhaltsversion."""
+        version = self.versions.token(['plan'])
+        self.cache.store('/api/plan', b'{"a": 1}', 'application/json', version)
+        self.assertIsNotNone(self.cache.lookup('/api/plan', self.versions.token(['plan'])))
+        self.versions.bump('plan')
+        self.assertIsNone(self.cache.lookup('/api/plan', self.versions.token(['plan'])))
+
+    def test_ttl_expires(self):
+        """Einträge ohne Version laufen nach der TTL ab."""
+        self.cache.store('/api/stats', b'{}', 'application/json', ())
+        self.assertIsNotNone(self.cache.lookup('/api/stats', (), ttl=10.0))
+        time.sleep(0.02)
+        self.assertIsNone(self.cache.lookup('/api/stats', (), ttl=0.01))
+
+    def test_conditional_and_gzip(self):
+        """Passender ETag ergibt 304, gzip-fähige Clients erhalten den komprimierten Body."""
+        body = b'{"zones": [' + b'{"x": 1, "y": 2},' * 50 + b'{}]}'
+        entry = self.cache.store('/api/zones', body, 'application/json', (1,))
+
+        status, headers, data = self.cache.select(entry, None, 'gzip, deflate')
+        self.assertEqual(status, 200)
+        self.assertEqual(headers['Content-Encoding'], 'gzip')
+        self.assertEqual(gzip.decompress(data), body)
+        self.assertLess(len(data), len(body))
+
+        status, headers, data = self.cache.select(entry, entry.etag, 'gzip')
+        self.assertEqual((status, data), (304, b''))
+        self.assertEqual(self.cache.not_modified, 1)
+
+        status, headers, data = self.cache.select(entry, None, None)
+        self.assertEqual(data, body)
+        self.assertNotIn('Content-Encoding', headers)
+
+    def test_etag_changes_with_version(self):
+        """Gleicher Inhalt unter neuer Version erhält einen neuen ETag."""
+        first = self.cache.store('/a', b'{}', 'application/json', (1,))
+        second = self.cache.store('/a', b'{}', 'application/json', (2,))
+        self.assertNotEqual(first.etag, second.etag)
+
+    def test_lru_limit(self):
+        """Der Cache hält höchstens max_entries Einträge."""
+        cache = ResponseCache(self.versions, max_entries=2)
+        for i in range(3):
+            cache.store(f'/p{i}', b'x', 'text/plain', ())
+        self.assertIsNone(cache.lookup('/p0', ()))
+        self.assertIsNotNone(cache.lookup('/p2', ()))
+
+class TestHeaders(unittest.TestCase):
+    """Tests für die Header-Auswertung."""
+
+    def test_etag_matches(self):
+        self.assertTrue(etag_matches('"a", "b"', '"b"'))
+        self.assertTrue(etag_matches('W/"b"', '"b"'))
+        self.assertTrue(etag_matches('*', '"b"'))
+        self.assertFalse(etag_matches('"a"', '"b"'))
+        self.assertFalse(etag_matches(None, '"b"'))
+
+    def test_accepts_gzip(self):
+        self.assertTrue(accepts_gzip('gzip, deflate, br'))
+        self.assertTrue(accepts_gzip('gzip;q=0.5'))
+        self.assertFalse(accepts_gzip('gzip;q=0'))
+        self.assertFalse(accepts_gzip('br'))
+        self.assertFalse(accepts_gzip(None))
+
+class TestPrecompressStatic(unittest.TestCase):
+    """Tests für precompress_static."""
+
+    def test_precompress_once(self):
+        """Große Textdateien werden einmal komprimiert, kleine und Bilder nicht."""
+        with tempfile.TemporaryDirectory() as folder:
+            with open(os.path.join(folder, 'page.html'), 'w') as f:
+                f.write('<p>Sunray</p>' * 200)
+            with open(os.path.join(folder, 'tiny.css'), 'w') as f:
+                f.write('a{}')
+            with open(os.path.join(folder, 'logo.png'), 'wb') as f:
+                f.write(b'\x89PNG' * 500)
+
+            self.assertEqual(precompress_static(folder), 1)
+            with gzip.open(os.path.join(folder, 'page.html.gz'), 'rt') as f:
+                self.assertEqual(f.read(), '<p>Sunray</p>' * 200)
+            self.assertEqual(precompress_static(folder), 0)
+
+class FakeResponse:
+    def __init__(self):
+        self.on_close = []
+
+    def call_on_close(self, fn):
+        self.on_close.append(fn)
+
+    def close(self):
+        for fn in self.on_close:
+            fn()
+
+class TestWorkerSlots(unittest.TestCase):
+    """Kontingent für SSE-Streams und Long-Polls."""
+
+    def test_limit_below_pool(self):
+        """Standardmäßig bleibt die Hälfte des Pools für normale Anfragen frei."""
+        slots = WorkerSlots()
+        slots.configure(12)
+        self.assertEqual(slots.limit, 6)
+        self.assertTrue(all(slots.try_acquire() for _ in range(6)))
+        self.assertFalse(slots.try_acquire())
+        self.assertEqual(slots.get_statistics(), {'limit': 6, 'in_use': 6, 'rejected': 1})
+        slots.release()
+        self.assertTrue(slots.try_acquire())
+        slots.configure(12, limit=2)
+        self.assertEqual(slots.limit, 2)
+
+    def test_hold_releases_once_on_close(self):
+        """Ein Stream gibt seinen Platz beim Schließen der Antwort genau einmal frei."""
+        slots = WorkerSlots(2)
+        self.assertTrue(slots.try_acquire())
+        self.assertTrue(slots.try_acquire())
+        response = slots.hold(FakeResponse())
+        response.close()
+        response.close()
+        self.assertEqual(slots.in_use, 1)
+
+if __name__ == '__main__':
+    unittest.main()
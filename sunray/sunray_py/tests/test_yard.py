@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""
+Tests für den Generator synthetischer Gärten.
+"""
+
+import unittest
+import json
+import os
+import sys
+import tempfile
+
+# Pfad zum Hauptverzeichnis hinzufügen (navigation/ für die flachen Importe der Planer)
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.insert(0, ROOT)
+sys.path.insert(0, os.path.join(ROOT, 'navigation'))
+
+from simulation.yard import YardGenerator, generate_yard, zone_count
+from simulation.world import SimWorld, distance_to_ring, point_in_ring
+from simulation.mission import MissionMap, DEFAULT_PARAMS, segment_hits_ring
+from simulation.simulator import Simulator
+
+def is_convex(ring):
+    signs = set()
+    for i in range(len(ring)):
+        (ax, ay), (bx, by), (cx, cy) = ring[i - 2], ring[i - 1], ring[i]
+        cross = (bx - ax) * (cy - by) - (by - ay) * (cx - bx)
+        if abs(cross) > 1e-9:
+            signs.add(cross > 0)
+    return len(signs) == 1
+
+class TestYardGenerator(unittest.TestCase):
+    def test_deterministic(self):
+        """Gleicher Seed, gleiche Welt; anderer Seed, andere Welt."""
+        first = generate_yard(1500, seed=4).to_dict()
+        self.assertEqual(first, generate_yard(1500, seed=4).to_dict())
+        self.assertNotEqual(first, generate_yard(1500, seed=5).to_dict())
+
+    def test_area_scales(self):
+        """Mähbare Fläche folgt dem Regler von 100 m² bis 2 ha, Hindernisse wachsen mit."""
+        previous = None
+        for area in (100, 1000, 20000):
+            world = generate_yard(area, seed=1)
+            self.assertAlmostEqual(world.mowable_area() / area, 1.0, delta=0.06)
+            if previous is not None:
+                self.assertGreater(len(world.obstacles), len(previous.obstacles))
+            previous = world
+        self.assertEqual(zone_count(100), 1)
+        self.assertEqual(zone_count(20000), 8)
+
+    def test_structure(self):
+        """Konkave Rasenstücke, Durchgänge zwischen je zwei, Beete und Bäume frei vom Rand, gemischte RTK-Zonen."""
+        generator = YardGenerator(5000, seed=2)
+        world = generator.generate()
+        self.assertEqual(len(generator.passages), len(generator.zones) - 1)
+        self.assertTrue(all(not is_convex(zone) for zone in generator.zones))
+        for passage in generator.passages:
+            joined = [zone for zone in generator.zones if any(point_in_ring(x, y, zone) for x, y in passage)]
+            self.assertEqual(len(joined), 2)
+        for obstacle in world.obstacles:
+            x, y = obstacle.ring[0]
+            zone = next(z for z in generator.zones if point_in_ring(x, y, z))
+            self.assertTrue(all(distance_to_ring(px, py, zone) >= 0.8 for px, py in obstacle.ring))
+        self.assertEqual({fix for _, fix, _ in world.rtk_zones}, {'float', '3d', 'none'})
+        self.assertTrue(world.in_mow_zone(0.0, 0.0))
+        self.assertFalse(world.collides(0.0, 0.0, 0.3))
+
+    def test_project_formats(self):
+        """JSON-Rundweg über SimWorld, zones.json und map.json für die Geofence."""
+        world = generate_yard(800, seed=3)
+        again = SimWorld.from_dict(json.loads(json.dumps(world.to_dict())))
+        self.assertEqual(again.to_dict(), world.to_dict())
+
+        from map import Map
+        directory = tempfile.mkdtemp()
+        with open(os.path.join(directory, 'zones.json'), 'w') as f:
+            json.dump(world.zones_file(), f)
+        with open(os.path.join(directory, 'map.json'), 'w') as f:
+            json.dump(world.map_file(), f)
+        loaded = Map()
+        self.assertTrue(loaded.load_zones(os.path.join(directory, 'zones.json')))
+        self.assertTrue(loaded.load(os.path.join(directory, 'map.json')))
+        self.assertEqual(len(loaded.mow_zones), len(world.mow_zones))
+        self.assertEqual(len(loaded.exclusions.to_list()), len(world.obstacles))
+        self.assertEqual(len(loaded.perimeter.to_list()), 4)
+
+    def test_planner_and_simulator(self):
+        """Abdeckungsplan umfährt alle Beete und Bäume; der Simulator fährt in der Welt."""
+        world = generate_yard(150, seed=6)
+        plan = MissionMap(world).plan(DEFAULT_PARAMS['planner'], 0.35, seed=0)
+        self.assertGreater(len(plan), 20)
+        for a, b in zip(plan, plan[1:]):
+            for obstacle in world.obstacles:
+                self.assertFalse(segment_hits_ring(a, b, obstacle.ring), (a, b))
+
+        sim = Simulator(world, seed=1)
+        sim.run(2.0, controller=lambda s: s.send('AT+MOTOR,80,80,0'), control_interval=0.1)
+        self.assertGreater(sim.get_statistics()['distance'], 0.1)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""
+HTTP-Lasttest für die Web-Server (läuft direkt auf dem Pi, nur Standardbibliothek).
+
+Mehrere Threads fragen die angegebenen Pfade reihum ab und messen die Latenz
+je Anfrage. Ausgegeben werden Anfragen/s sowie p50/p99/max-Latenz je Pfad,
+jeweils mit übertragenen Bytes. Mit --etag werden bedingte Anfragen
+(If-None-Match) gesendet, wie es ein Browser mit gefülltem Cache tut.
+
+Beispiele:
+  python tools/http_load_test.py
+  python tools/http_load_test.py --base http://localhost:5000 --clients 16 --duration 30
+  python tools/http_load_test.py --paths /api/zones /api/map/current --etag --gzip
+"""
+
+import argparse
+import sys
+import threading
+import time
+import urllib.error
+import urllib.request
+from collections import defaultdict
+
+DEFAULT_PATHS = ['/api/zones', '/api/map/current', '/api/system/stats',
+                 '/api/status', '/static/dashboard_modular.html']
+
+def percentile(values, p):
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(len(ordered) * p / 100.0))]
+
+def worker(base, paths, offset, end, use_gzip, use_etag, results, lock):
+    latencies = defaultdict(list)
+    sizes = defaultdict(int)
+    statuses = defaultdict(lambda: defaultdict(int))
+    etags = {}
+    i = offset
+    while time.monotonic() < end:
+        path = paths[i % len(paths)]
+        i += 1
+        headers = {}
+        if use_gzip:
+            headers['Accept-Encoding'] = 'gzip'
+        if use_etag and path in etags:
+            headers['If-None-Match'] = etags[path]
+        request = urllib.request.Request(base + path, headers=headers)
+        start = time.perf_counter()
+        try:
+            with urllib.request.urlopen(request, timeout=10.0) as response:
+                body = response.read()
+                status = response.status
+                if response.headers.get('ETag'):
+                    etags[path] = response.headers['ETag']
+        except urllib.error.HTTPError as e:
+            body = b''
+            status = e.code
+        except OSError:
+            body = b''
+            status = 'error'
+        latencies[path].append(time.perf_counter() - start)
+        sizes[path] += len(body)
+        statuses[path][status] += 1
+    with lock:
+        for path in latencies:
+            results['latencies'][path].extend(latencies[path])
+            results['bytes'][path] += sizes[path]
+            for status, count in statuses[path].items():
+                results['statuses'][path][status] += count
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--base', default='http://localhost:5000', help='Basis-URL des Servers')
+    parser.add_argument('--paths', nargs='+', default=DEFAULT_PATHS, help='abzufragende Pfade')
+    parser.add_argument('--clients', type=int, default=8, help='gleichzeitige Clients')
+    parser.add_argument('--duration', type=float, default=15.0, help='Dauer in Sekunden')
+    parser.add_argument('--gzip', action='store_true', help='Accept-Encoding: gzip senden')
+    parser.add_argument('--etag', action='store_true', help='bedingte Anfragen mit If-None-Match')
+    args = parser.parse_args()
+
+    results = {'latencies': defaultdict(list), 'bytes': defaultdict(int),
+               'statuses': defaultdict(lambda: defaultdict(int))}
+    lock = threading.Lock()
+    start = time.monotonic()
+    end = start + args.duration
+    threads = [threading.Thread(target=worker, args=(args.base.rstrip('/'), args.paths, n, end,
+                                                     args.gzip, args.etag, results, lock))
+               for n in range(args.clients)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    elapsed = time.monotonic() - start
+
+    print(f"{args.base}: {args.clients} Clients, {elapsed:.1f}s, gzip={args.gzip}, etag={args.etag}")
+    print(f"{'Pfad':<36} {'Anfr.':>7} {'req/s':>8} {'p50 ms':>8} {'p99 ms':>8} {'max ms':>8} {'KB':>9}  Status")
+    all_latencies = []
+    for path in args.paths:
+        latencies = results['latencies'][path]
+        all_latencies.extend(latencies)
+        statuses = ' '.join(f"{s}:{c}" for s, c in sorted(results['statuses'][path].items(), key=str))
+        print(f"{path:<36} {len(latencies):>7} {len(latencies) / elapsed:>8.1f} "
+              f"{1000 * percentile(latencies, 50):>8.1f} {1000 * percentile(latencies, 99):>8.1f} "
+              f"{1000 * max(latencies or [0.0]):>8.1f} {results['bytes'][path] / 1024:>9.1f}  {statuses}")
+    print(f"Gesamt: {len(all_latencies) / elapsed:.1f} req/s, p99 {1000 * percentile(all_latencies, 99):.1f} ms")
+    errors = sum(c for path in args.paths for s, c in results['statuses'][path].items()
+                 if s == 'error' or (isinstance(s, int) and s >= 500))
+    return 1 if errors else 0
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,455 @@
+#!/usr/bin/env python3
+"""
+Microbenchmarks der Funktionen, die je Sensorwert oder je Regelzyklus laufen.
+
+Gemessen werden ns/op (Median aus mehreren Durchläufen) und der Speicherbedarf
+je Aufruf:
+  B/op       vorübergehend belegte Bytes je Aufruf (tracemalloc-Spitze über dem
+             Stand vor dem Aufruf, gemittelt)
+  Blöcke/op  bleibend belegte Speicherblöcke je Aufruf (sys.getallocatedblocks()
+             vor/nach vielen Aufrufen); > 0 heißt, der Aufruf lässt etwas liegen
+CPython zählt Allokationen nicht insgesamt, daher diese beiden Größen.
+
+Varianten: 'python' ist der Code im Projekt. 'stdlib' ist, wo es ein
+Gegenstück gibt, dieselbe Aufgabe mit C-Bausteinen der Standardbibliothek
+(sorted, map/int, bytes.find, memoryview) als Richtwert, was ohne eigenes
+Erweiterungsmodul möglich ist. 'legacy' ist ein abgelöstes Verfahren des
+Projekts zum Vergleich. 'native' bleibt echtem Erweiterungscode vorbehalten.
+
+Baselines liegen je Rechner in tools/microbench_baselines/<rechner>.json
+(Rechnername, Architektur, Python-Version). Ohne --save wird mit der Baseline
+dieses Rechners verglichen; ist ein Fall um mehr als --threshold langsamer
+oder lässt sich ein Fall nicht aufbauen (z.B. nach geänderten Importen),
+endet das Skript mit Exit-Code 1 und --save schreibt keine Baseline.
+
+Beispiele:
+  python tools/microbench.py --save          # Baseline für diesen Rechner anlegen
+  python tools/microbench.py                 # messen und vergleichen
+  python tools/microbench.py --filter pico --time 0.5
+"""
+
+import argparse
+import bisect
+import gc
+import json
+import os
+import platform
+import re
+import statistics
+import sys
+import time
+import tracemalloc
+import types
+from collections import deque
+from typing import Callable, Dict, List, Optional
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.insert(0, ROOT)
+sys.path.insert(0, os.path.join(ROOT, 'communication'))
+
+BASELINE_DIR = os.path.join(ROOT, 'tools', 'microbench_baselines')
+
+def _stub_missing_modules() -> None:
+    """
+    Seriell- und GNSS-Bibliotheken werden beim Import von rtk_gps/pico_comm
+    gebraucht, von den gemessenen Methoden aber nicht. Fehlen sie (Entwickler-
+    rechner), werden leere Module eingesetzt.
+    """
+    stubs = {'serial': (), 'pynmea2': (), 'pyubx2': ('UBXReader', 'UBXMessage', 'UBXWriter', 'SET', 'POLL')}
+    for name, attributes in stubs.items():
+        try:
+            __import__(name)
+        except ImportError:
+            module = types.ModuleType(name)
+            for attribute in attributes:
+                setattr(module, attribute, type(attribute, (), {}))
+            sys.modules[name] = module
+
+# -- Eingangsdaten ------------------------------------------------------------
+
+PICO_LINES = [
+    'AT+S:1523,1519,80211,0.00,,0,0,0',
+    'AT+S:1548,1544,80263,0.00,,1,0,0',
+    'S,26.41,0.00,0.00,0,0,0,0,1.21,0.42,0.45,24.5,0',
+    'AT+S:1573,1570,80315,0.00,,0,0,0',
+]
+
+def rtcm_stream(messages: int = 40) -> bytes:
+    """RTCM3-Rahmen typischer Größe (1005, MSM7) mit etwas Datenmüll dazwischen."""
+    out = bytearray()
+    for i in range(messages):
+        length = (19, 160, 220, 90)[i % 4]
+        out += bytes((0xD3, (length >> 8) & 0x03, length & 0xFF))
+        out += bytes((i * 7 + j) & 0xFF for j in range(length))
+        out += b'\x00\x00\x00'
+        if i % 10 == 9:
+            out += b'\x01\x02'
+    return bytes(out)
+
+def gps_samples(count: int = 64) -> List[Dict]:
+    samples = []
+    for i in range(count):
+        samples.append({'lat': 52.52 + i * 1e-7, 'lon': 13.405 + i * 1.5e-7, 'alt': 35.0,
+                        'fix_type': 3, 'hdop': 0.02, 'satellites': 24, 'speed': 0.3, 'course': 45.0})
+    return samples
+
+# -- Fälle ----------------------------------------------------------------------
+# Jede Fabrik liefert eine Funktion ohne Argumente, die genau eine Operation ausführt.
+
+def case_running_median_python() -> Callable[[], float]:
+    from utils.running_median import RunningMedian
+    rm = RunningMedian(15)
+    values = [26.0 + ((i * 37) % 100) / 100.0 for i in range(100)]
+    state = {'i': 0}
+
+    def op():
+        i = state['i'] = (state['i'] + 1) % 100
+        rm.add(values[i])
+        return rm.median()
+    return op
+
+def case_running_median_stdlib() -> Callable[[], float]:
+    window = deque(maxlen=15)
+    values = [26.0 + ((i * 37) % 100) / 100.0 for i in range(100)]
+    state = {'i': 0}
+
+    def op():
+        i = state['i'] = (state['i'] + 1) % 100
+        window.append(values[i])
+        ordered = sorted(window)
+        n = len(ordered)
+        return ordered[n // 2] if n % 2 else 0.5 * (ordered[n // 2 - 1] + ordered[n // 2])
+    return op
+
+def case_running_median_large_python() -> Callable[[], float]:
+    from utils.running_median import RunningMedian
+    rm = RunningMedian(10001)
+    values = [26.0 + ((i * 7919) % 10007) / 10007.0 for i in range(20000)]
+    for value in values[:10001]:
+        rm.add(value)
+    state = {'i': 0}
+
+    def op():
+        i = state['i'] = (state['i'] + 1) % 20000
+        rm.add(values[i])
+        return rm.median()
+    return op
+
+def case_running_median_large_legacy() -> Callable[[], float]:
+    # Bisheriges Verfahren: Liste mit pop(0) und bisect.insort
+    buffer, ordered = [], []
+    values = [26.0 + ((i * 7919) % 10007) / 10007.0 for i in range(20000)]
+    state = {'i': 0}
+
+    def op():
+        i = state['i'] = (state['i'] + 1) % 20000
+        if len(buffer) == 10001:
+            del ordered[bisect.bisect_left(ordered, buffer.pop(0))]
+        buffer.append(values[i])
+        bisect.insort(ordered, values[i])
+        return ordered[len(ordered) // 2]
+    return op
+
+def case_running_quantiles_python() -> Callable[[], Dict]:
+    from utils.running_median import RunningQuantiles
+    rq = RunningQuantiles(('battery_v', 'charge_v', 'charge_i'), 5)
+    values = [(26.0 + ((i * 37) % 100) / 100.0, 29.0, 1.0 + (i % 7) / 10.0) for i in range(100)]
+    state = {'i': 0}
+
+    def op():
+        i = state['i'] = (state['i'] + 1) % 100
+        return rq.update(values[i])
+    return op
+
+def case_lowpass_python() -> Callable[[], float]:
+    from utils.lowpass_filter import LowPassFilter
+    lp = LowPassFilter(0.5)
+    return lambda: lp(1.25)
+
+def case_pid_python() -> Callable[[], float]:
+    from utils.pid import PID
+    pid = PID(1.2, 0.3, 0.05)
+    return lambda: pid.compute(0.1, 0.02)
+
+def case_process_pico_data_python() -> Callable[[], Dict]:
+    from main import process_pico_data
+    lines = PICO_LINES
+    state = {'i': 0}
+
+    def op():
+        i = state['i'] = (state['i'] + 1) & 3
+        return process_pico_data(lines[i])
+    return op
+
+ODOMETRY_KEYS = ('odom_right', 'odom_left', 'odom_mow')
+SUMMARY_KEYS = ('bat_voltage', 'chg_voltage', 'chg_current', 'lift', 'bumper', 'raining',
+                'motor_overload', 'mow_current', 'motor_left_current', 'motor_right_current', 'battery_temp')
+
+def case_process_pico_data_stdlib() -> Callable[[], Dict]:
+    """Wohlgeformte Zeilen: Zerlegen und Umwandeln in einem map()-Aufruf."""
+    lines = PICO_LINES
+    state = {'i': 0}
+
+    def op():
+        i = state['i'] = (state['i'] + 1) & 3
+        line = lines[i]
+        if line[0] == 'A':
+            parts = line[5:].split(',')
+            data = dict(zip(ODOMETRY_KEYS, map(int, parts[:3])))
+            data['chg_voltage'] = float(parts[3])
+            data['bumper'] = int(parts[5])
+            data['lift'] = int(parts[6])
+            return data
+        parts = line[2:].split(',')
+        return dict(zip(SUMMARY_KEYS, map(float, parts[:11])))
+    return op
+
+def case_hardware_manager_pico_python() -> Callable[[], Dict]:
+    _stub_missing_modules()
+    from hardware.hardware_manager import HardwareManager
+    manager = HardwareManager.__new__(HardwareManager)
+    lines = PICO_LINES
+    state = {'i': 0}
+
+    def op():
+        i = state['i'] = (state['i'] + 1) & 3
+        return manager._process_pico_data(lines[i])
+    return op
+
+def case_rtcm_buffer_python() -> Callable[[], bytes]:
+    from ntrip_client import NTRIPClient
+    client = NTRIPClient.__new__(NTRIPClient)
+    client.rtcm_callback = lambda message: None
+    stream = rtcm_stream()
+    return lambda: client._process_rtcm_buffer(stream)
+
+def case_rtcm_buffer_stdlib() -> Callable[[], bytes]:
+    """Gleiche Rahmung mit bytes.find() und memoryview (keine Kopie je Nachricht)."""
+    callback = lambda message: None
+    stream = rtcm_stream()
+
+    def op():
+        view = memoryview(stream)
+        size = len(stream)
+        pos = 0
+        while size - pos >= 3:
+            if stream[pos] != 0xD3:
+                pos = stream.find(b'\xd3', pos)
+                if pos < 0:
+                    return b''
+                continue
+            total = (((stream[pos + 1] & 0x03) << 8) | stream[pos + 2]) + 6
+            if size - pos < total:
+                break
+            callback(view[pos:pos + total])
+            pos += total
+        return stream[pos:]
+    return op
+
+def case_rtk_gps_process_python() -> Callable[[], Dict]:
+    _stub_missing_modules()
+    from rtk_gps import RTKGPS
+    gps = RTKGPS.__new__(RTKGPS)
+    # Nur die Felder aus __init__, die _process_gps_data liest
+    gps.origin_lat = gps.origin_lon = None
+    gps.origin_set = False
+    gps.last_fix_time = 0
+    gps.fix_type = 0
+    gps.last_position = {'lat': 0, 'lon': 0}
+    gps.max_history = 10
+    gps.position_history = deque(maxlen=gps.max_history)  # wie in RTKGPS.__init__
+    gps.current_waypoint = None
+    gps.kidnap_threshold = 10.0
+    gps.last_valid_position = None
+    samples = gps_samples()
+    state = {'i': 0}
+
+    def op():
+        i = state['i'] = (state['i'] + 1) & 63
+        return gps._process_gps_data(samples[i])
+    return op
+
+CASES = [
+    ('RunningMedian.add+median (15)', 'python', case_running_median_python),
+    ('RunningMedian.add+median (15)', 'stdlib', case_running_median_stdlib),
+    ('RunningMedian.add+median (10001)', 'python', case_running_median_large_python),
+    ('RunningMedian.add+median (10001)', 'legacy', case_running_median_large_legacy),
+    ('RunningQuantiles.update (3 Kanäle, 5)', 'python', case_running_quantiles_python),
+    ('LowPassFilter.__call__', 'python', case_lowpass_python),
+    ('PID.compute', 'python', case_pid_python),
+    ('process_pico_data', 'python', case_process_pico_data_python),
+    ('process_pico_data', 'stdlib', case_process_pico_data_stdlib),
+    ('HardwareManager._process_pico_data', 'python', case_hardware_manager_pico_python),
+    ('NTRIPClient._process_rtcm_buffer (40 Nachr.)', 'python', case_rtcm_buffer_python),
+    ('NTRIPClient._process_rtcm_buffer (40 Nachr.)', 'stdlib', case_rtcm_buffer_stdlib),
+    ('RTKGPS._process_gps_data', 'python', case_rtk_gps_process_python),
+]
+
+# -- Messung --------------------------------------------------------------------
+
+def measure_time(op: Callable, min_time: float, repeat: int) -> float:
+    """ns/op als Median aus repeat Durchläufen von je mindestens min_time Sekunden."""
+    loops = 1
+    while True:
+        start = time.perf_counter_ns()
+        for _ in range(loops):
+            op()
+        elapsed = time.perf_counter_ns() - start
+        if elapsed >= min_time * 1e9 / 4 or loops >= 1 << 24:
+            break
+        loops *= 4
+    loops = max(1, int(loops * min_time * 1e9 / max(elapsed, 1)))
+    results = []
+    gc_was_enabled = gc.isenabled()
+    gc.disable()
+    try:
+        for _ in range(repeat):
+            start = time.perf_counter_ns()
+            for _ in range(loops):
+                op()
+            results.append((time.perf_counter_ns() - start) / loops)
+    finally:
+        if gc_was_enabled:
+            gc.enable()
+    return statistics.median(results)
+
+def measure_memory(op: Callable, calls: int = 2000) -> Dict[str, float]:
+    """Vorübergehende Bytes je Aufruf (tracemalloc) und bleibende Blöcke je Aufruf."""
+    for _ in range(100):
+        op()
+    gc.collect()
+    blocks = sys.getallocatedblocks()
+    for _ in range(calls):
+        op()
+    gc.collect()
+    retained = (sys.getallocatedblocks() - blocks) / calls
+
+    tracemalloc.start()
+    try:
+        transient = 0
+        samples = 200
+        for _ in range(samples):
+            before = tracemalloc.get_traced_memory()[0]
+            tracemalloc.reset_peak()
+            op()
+            transient += tracemalloc.get_traced_memory()[1] - before
+    finally:
+        tracemalloc.stop()
+    return {'bytes_per_op': transient / samples, 'blocks_per_op': retained}
+
+def machine_tag() -> str:
+    tag = f"{platform.node() or 'rechner'}-{platform.machine()}-py{sys.version_info[0]}{sys.version_info[1]}"
+    return re.sub(r'[^A-Za-z0-9_.-]', '_', tag)
+
+def run_cases(pattern: Optional[str], min_time: float, repeat: int,
+              skipped: Optional[List[str]] = None) -> List[Dict]:
+    results = []
+    for name, variant, factory in CASES:
+        if pattern and pattern.lower() not in name.lower():
+            continue
+        try:
+            op = factory()
+        except Exception as e:
+            if skipped is not None:
+                skipped.append(f"{name} [{variant}]: nicht verfügbar ({e})")
+            continue
+        ns = measure_time(op, min_time, repeat)
+        memory = measure_memory(op)
+        results.append({'case': name, 'variant': variant, 'ns_per_op': ns, **memory})
+    return results
+
+def load_baseline(tag: str) -> Dict[str, Dict]:
+    path = os.path.join(BASELINE_DIR, f'{tag}.json')
+    if not os.path.exists(path):
+        return {}
+    try:
+        with open(path, 'r') as f:
+            data = json.load(f)
+    except (OSError, ValueError) as e:
+        print(f"Baseline {path} nicht lesbar: {e}")
+        return {}
+    return {f"{r['case']}|{r['variant']}": r for r in data.get('results', [])}
+
+def save_baseline(tag: str, results: List[Dict]) -> str:
+    os.makedirs(BASELINE_DIR, exist_ok=True)
+    path = os.path.join(BASELINE_DIR, f'{tag}.json')
+    previous = load_baseline(tag)
+    # Mit --filter gemessene Teilmengen ergänzen die vorhandene Baseline
+    merged = dict(previous)
+    merged.update({f"{r['case']}|{r['variant']}": r for r in results})
+    data = {'machine': tag, 'python': platform.python_version(), 'processor': platform.processor(),
+            'saved': time.strftime('%Y-%m-%dT%H:%M:%S'), 'results': list(merged.values())}
+    with open(path, 'w') as f:
+        json.dump(data, f, indent=2, ensure_ascii=False)
+    return path
+
+def compare(results: List[Dict], baseline: Dict[str, Dict], threshold: float) -> List[Dict]:
+    """Trägt die Abweichung zur Baseline ein und gibt die Verschlechterungen zurück."""
+    regressions = []
+    for result in results:
+        base = baseline.get(f"{result['case']}|{result['variant']}")
+        if not base:
+            continue
+        result['baseline_ns'] = base['ns_per_op']
+        result['change'] = result['ns_per_op'] / base['ns_per_op'] - 1.0
+        grew = result['blocks_per_op'] > max(0.01, base.get('blocks_per_op', 0.0) + 0.01)
+        if result['change'] > threshold or grew:
+            regressions.append(result)
+    return regressions
+
+def format_results(results: List[Dict]) -> str:
+    lines = [f"{'Fall':<46} {'Variante':<8} {'ns/op':>10} {'B/op':>8} {'Blöcke/op':>10} {'Basis':>10} {'Δ':>7}"]
+    for r in results:
+        base = f"{r['baseline_ns']:.0f}" if 'baseline_ns' in r else '-'
+        change = f"{100 * r['change']:+.0f}%" if 'change' in r else '-'
+        lines.append(f"{r['case']:<46} {r['variant']:<8} {r['ns_per_op']:>10.0f} {r['bytes_per_op']:>8.0f} "
+                     f"{r['blocks_per_op']:>10.3f} {base:>10} {change:>7}")
+    return '\n'.join(lines)
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--filter', help='nur Fälle, deren Name diesen Text enthält')
+    parser.add_argument('--time', type=float, default=0.2, help='Sekunden je Durchlauf')
+    parser.add_argument('--repeat', type=int, default=5, help='Durchläufe je Fall (Median)')
+    parser.add_argument('--save', action='store_true', help='Ergebnis als Baseline dieses Rechners speichern')
+    parser.add_argument('--threshold', type=float, default=0.25,
+                        help='erlaubte Verlangsamung gegenüber der Baseline (0.25 = 25 %%)')
+    parser.add_argument('--json', help='Ergebnisse zusätzlich als JSON schreiben')
+    args = parser.parse_args()
+
+    tag = machine_tag()
+    # Meldungen der gemessenen Module (z.B. "GPS Origin gesetzt") nicht in die Tabelle mischen
+    skipped: List[str] = []
+    stdout = sys.stdout
+    sys.stdout = open(os.devnull, 'w')
+    try:
+        results = run_cases(args.filter, args.time, args.repeat, skipped)
+    finally:
+        sys.stdout.close()
+        sys.stdout = stdout
+
+    regressions = [] if args.save else compare(results, load_baseline(tag), args.threshold)
+    print(f"Rechner: {tag}")
+    print(format_results(results))
+    for line in skipped:
+        print(line)
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump({'machine': tag, 'results': results}, f, indent=2, ensure_ascii=False)
+    if skipped:
+        # Ein fehlender Fall fiele sonst still aus Vergleich und Baseline heraus
+        print(f"{len(skipped)} Fälle nicht verfügbar" + ("; Baseline nicht gespeichert" if args.save else ""))
+        return 1
+    if args.save:
+        print(f"Baseline gespeichert: {save_baseline(tag, results)}")
+        return 0
+    if regressions:
+        print(f"{len(regressions)} Fälle langsamer als die Baseline (> {100 * args.threshold:.0f} %) "
+              f"oder mit wachsendem Speicher:")
+        for r in regressions:
+            print(f"  {r['case']} [{r['variant']}]")
+        return 1
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+"""
+Benchmark: Planübertragung als JSON ({x, y}-Objekte) gegenüber dem Binärformat
+aus navigation/plan_codec.py.
+
+Gemessen werden je Plangröße die Größe (roh und gzip), die Kodierzeit auf dem
+Server sowie die Parse-Zeit beim Empfänger (json.loads gegenüber dem Lesen
+des Float32-Puffers). Die Parse-Zeit im Browser misst static/plan_benchmark.html.
+
+Beispiele:
+  python tools/plan_transfer_benchmark.py
+  python tools/plan_transfer_benchmark.py --points 10000 100000 500000
+"""
+
+import argparse
+import gzip
+import json
+import os
+import sys
+import time
+from array import array
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from navigation.plan_codec import encode_plan, plan_size, HEADER, SEGMENT
+
+def make_plan(point_count, points_per_lane=200):
+    """Linienmuster mit Transitsegmenten zwischen den Bahnen."""
+    segments = []
+    lanes = max(1, point_count // points_per_lane)
+    for lane in range(lanes):
+        y = lane * 0.3
+        xs = [i * 0.05 for i in range(points_per_lane)]
+        if lane % 2:
+            xs.reverse()
+        segments.append({'type': 'mowing', 'points': [(x, y) for x in xs]})
+        if lane + 1 < lanes:
+            segments.append({'type': 'transit', 'points': [(xs[-1], y), (xs[-1], y + 0.3)]})
+    return segments
+
+def best_of(func, repeat):
+    best = float('inf')
+    result = None
+    for _ in range(repeat):
+        start = time.perf_counter()
+        result = func()
+        best = min(best, time.perf_counter() - start)
+    return best, result
+
+def to_json(segments):
+    return json.dumps({'segments': [
+        {'type': s['type'], 'points': [{'x': round(x, 3), 'y': round(y, 3)} for x, y in s['points']]}
+        for s in segments
+    ]}, separators=(',', ':')).encode('utf-8')
+
+def parse_binary(data):
+    _, _, _, _, segment_count, point_count, *_ = HEADER.unpack_from(data, 0)
+    points = array('f')
+    points.frombytes(memoryview(data)[plan_size(segment_count, 0):])
+    table = [SEGMENT.unpack_from(data, HEADER.size + i * SEGMENT.size) for i in range(segment_count)]
+    return table, points
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--points', type=int, nargs='+', default=[10000, 100000, 300000])
+    parser.add_argument('--repeat', type=int, default=3)
+    args = parser.parse_args()
+
+    print(f"{'Punkte':>8} {'Format':>7} {'KB':>9} {'KB gzip':>9} {'kodieren ms':>12} {'parsen ms':>10}")
+    for count in args.points:
+        segments = make_plan(count)
+        json_encode, json_data = best_of(lambda: to_json(segments), args.repeat)
+        json_parse, _ = best_of(lambda: json.loads(json_data), args.repeat)
+        bin_encode, bin_data = best_of(lambda: encode_plan(segments), args.repeat)
+        bin_parse, _ = best_of(lambda: parse_binary(bin_data), args.repeat)
+        for name, data, encode, parse in (('json', json_data, json_encode, json_parse),
+                                          ('binary', bin_data, bin_encode, bin_parse)):
+            print(f"{count:>8} {name:>7} {len(data) / 1024:>9.1f} {len(gzip.compress(data, 6)) / 1024:>9.1f} "
+                  f"{1000 * encode:>12.1f} {1000 * parse:>10.2f}")
+        print(f"{'':>8} Faktor: Größe {len(json_data) / len(bin_data):.1f}x, "
+              f"Parsen {json_parse / max(bin_parse, 1e-9):.0f}x schneller")
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+"""
+Werkzeug für Sensor-Logs (.slg, siehe sensor_log.py).
+
+Befehle:
+  pico    Pico-ASCII-Zeilen (optional mit vorangestelltem Zeitstempel) umwandeln
+  ubx     UBX-Aufzeichnung (NAV-PVT, NAV-RELPOSNED) umwandeln
+  info    Streams, Zeitbereiche, Chunks und Kompression anzeigen
+  export  Zeitfenster eines Streams als CSV ausgeben
+  bench   Tageslog erzeugen und Öffnen/Lesen eines 30-Minuten-Fensters messen
+
+Beispiele:
+  python tools/sensor_log_tool.py pico pico.txt pico.slg --rate 20
+  python tools/sensor_log_tool.py ubx gnss.ubx gnss.slg
+  python tools/sensor_log_tool.py export pico.slg summary --start 1700000000 --end 1700001800
+  python tools/sensor_log_tool.py bench --hours 24 --compression lz4
+"""
+
+import argparse
+import csv
+import importlib.util
+import math
+import os
+import sys
+import tempfile
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from sensor_log import (CODEC_NONE, SensorLogReader, SensorLogWriter, convert_pico_lines,
+                        convert_ubx_file)
+
+def open_writer(args) -> SensorLogWriter:
+    compression = None if args.compression == 'none' else args.compression
+    return SensorLogWriter(args.output, compression=compression, chunk_seconds=args.chunk_seconds)
+
+def cmd_pico(args) -> int:
+    with open_writer(args) as writer, open(args.input, 'r', errors='ignore') as f:
+        stats = convert_pico_lines(f, writer, rate=args.rate, t0=args.t0)
+    print(f"{stats['records']} Datensätze aus {stats['lines']} Zeilen, {stats['skipped']} übergangen")
+    return 0
+
+def cmd_ubx(args) -> int:
+    with open_writer(args) as writer:
+        stats = convert_ubx_file(args.input, writer)
+    print(f"NAV-PVT {stats['nav_pvt']}, NAV-RELPOSNED {stats['relposned']}, andere {stats['other']}, "
+          f"Prüfsummenfehler {stats['bad_checksum']}")
+    return 0
+
+def cmd_info(args) -> int:
+    started = time.perf_counter()
+    with SensorLogReader(args.log) as log:
+        opened = (time.perf_counter() - started) * 1000
+        print(f"{args.log}: {os.path.getsize(args.log)} Bytes, geöffnet in {opened:.2f} ms"
+              f"{' (Index aus Chunks neu aufgebaut)' if log.recovered else ''}")
+        for stream in log.streams:
+            chunks = log.index[stream]
+            if not chunks:
+                continue
+            start, end = log.time_range(stream)
+            raw = sum(c[5] for c in chunks)
+            stored = sum(c[6] for c in chunks)
+            compressed = sum(1 for c in chunks if c[4] != CODEC_NONE)
+            print(f"  {stream:10s} {log.record_count(stream):9d} Datensätze  {len(chunks):6d} Chunks "
+                  f"({compressed} komprimiert, {stored / max(1, raw):.0%})  {start:.3f} .. {end:.3f}")
+    return 0
+
+def cmd_export(args) -> int:
+    with SensorLogReader(args.log) as log:
+        if args.stream not in log.streams:
+            print(f"Unbekannter Stream '{args.stream}' (vorhanden: {', '.join(log.streams)})", file=sys.stderr)
+            return 1
+        out = csv.writer(sys.stdout)
+        out.writerow(log.fields(args.stream))
+        for record in log.records(args.stream, args.start, args.end):
+            out.writerow(record)
+    return 0
+
+def cmd_bench(args) -> int:
+    """Tageslog mit Odometrie (20 Hz), Summary (1 Hz) und GNSS (10 Hz)."""
+    compression = None if args.compression == 'none' else args.compression
+    t0 = 1700000000.0
+    duration = args.hours * 3600.0
+    with tempfile.TemporaryDirectory() as directory:
+        path = os.path.join(directory, 'bench.slg')
+        started = time.perf_counter()
+        with SensorLogWriter(path, compression=compression) as writer:
+            ticks = 0
+            for i in range(int(duration * 20)):
+                t = t0 + i / 20.0
+                ticks += 25
+                writer.append('odometry', t, ticks, ticks - 3, ticks * 40, 0.0, 0, 0, 0)
+                if i % 2 == 0:
+                    writer.append('gnss', t, 52.5 + math.sin(i / 1e5) * 1e-4, 13.4, 40.0, 3, 2, 24,
+                                  0.014, 0.02, 0.3, 0.1, 0.0, 0.32, 45.0)
+                if i % 20 == 0:
+                    writer.append('summary', t, 25.2 - i / 1e6, 0.0, 0.0, 0, 0, 0, 0, 1.1, 0.4, 0.4,
+                                  24.0, 0)
+        written = time.perf_counter() - started
+        size = os.path.getsize(path)
+        print(f"{args.hours:.0f} h geschrieben: {writer.records_written} Datensätze, "
+              f"{size / 1e6:.1f} MB ({size / writer.bytes_raw:.0%}) in {written:.1f} s")
+
+        middle = t0 + duration / 2
+        for label, stream in (('Odometrie', 'odometry'), ('GNSS', 'gnss')):
+            started = time.perf_counter()
+            with SensorLogReader(path) as log:
+                opened = time.perf_counter() - started
+                count = sum(1 for _ in log.records(stream, middle, middle + 1800.0))
+            total = time.perf_counter() - started
+            print(f"{label}: Öffnen {opened * 1000:.2f} ms, 30 min ({count} Datensätze) "
+                  f"{total * 1000:.1f} ms")
+        if importlib.util.find_spec('numpy') is None:
+            print("numpy nicht installiert, array() nicht gemessen")
+            return 0
+        started = time.perf_counter()
+        with SensorLogReader(path) as log:
+            data = log.array('gnss', middle, middle + 1800.0)
+            lat = float(data['lat'].mean())
+        print(f"GNSS als numpy-Array: {len(data)} Zeilen in {(time.perf_counter() - started) * 1000:.1f} ms "
+              f"(Mittel lat {lat:.6f})")
+    return 0
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description='Sensor-Logs umwandeln, prüfen und messen')
+    sub = parser.add_subparsers(dest='command', required=True)
+
+    def add_output(p):
+        p.add_argument('output', help='Ziel (.slg)')
+        p.add_argument('--compression', choices=('lz4', 'zlib', 'none'), default='lz4')
+        p.add_argument('--chunk-seconds', type=float, default=60.0, help='Zeitspanne je Chunk')
+
+    pico = sub.add_parser('pico', help='Pico-ASCII-Zeilen umwandeln')
+    pico.add_argument('input')
+    add_output(pico)
+    pico.add_argument('--rate', type=float, default=20.0, help='Zeilenrate ohne Zeitstempel (Hz)')
+    pico.add_argument('--t0', type=float, default=0.0, help='Startzeit ohne Zeitstempel (s)')
+
+    ubx = sub.add_parser('ubx', help='UBX-Aufzeichnung umwandeln')
+    ubx.add_argument('input')
+    add_output(ubx)
+
+    info = sub.add_parser('info', help='Inhalt anzeigen')
+    info.add_argument('log')
+
+    export = sub.add_parser('export', help='Zeitfenster als CSV ausgeben')
+    export.add_argument('log')
+    export.add_argument('stream')
+    export.add_argument('--start', type=float)
+    export.add_argument('--end', type=float)
+
+    bench = sub.add_parser('bench', help='Öffnen und Zeitfenster eines Tageslogs messen')
+    bench.add_argument('--hours', type=float, default=24.0)
+    bench.add_argument('--compression', choices=('lz4', 'zlib', 'none'), default='lz4')
+
+    args = parser.parse_args()
+    commands = {'pico': cmd_pico, 'ubx': cmd_ubx, 'info': cmd_info, 'export': cmd_export, 'bench': cmd_bench}
+    try:
+        return commands[args.command](args)
+    except (OSError, ValueError) as e:
+        print(f"Fehler: {e}", file=sys.stderr)
+        return 1
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""
+Lasttest: Einfluss von Web-Lesern auf die Sensorerfassung.
+
+Eine simulierte Regelschleife (Standard 10 Hz) erfasst Sensordaten und
+veröffentlicht einen Snapshot pro Tick. Parallel lesen N Threads so schnell
+wie möglich - entweder direkt aus dem SnapshotBuffer (wie die Flask-Handler)
+oder per HTTP gegen einen laufenden Server (--url).
+
+Gemessen werden Tick-Periode und Erfassungsdauer der Schleife ohne und mit
+Last sowie der Lesedurchsatz. Jeder Snapshot enthält eine Prüfsumme, damit
+inkonsistente ("zerrissene") Stände erkannt werden.
+
+Beispiele:
+  python tools/snapshot_load_test.py
+  python tools/snapshot_load_test.py --readers 16 --duration 20
+  python tools/snapshot_load_test.py --url http://localhost:5000/sensors
+
+Hinweis: Mit --io-wait 0 rechnen alle Leser ununterbrochen in Python. Dann
+verzögert allein der GIL die Regelschleife; das ist ein Worst Case, den reale
+HTTP-Anfragen (die beim Senden den GIL freigeben) nicht erreichen.
+"""
+
+import argparse
+import json
+import os
+import sys
+import threading
+import time
+import urllib.request
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from utils.snapshot import SnapshotBuffer, thaw
+
+def percentile(values, p):
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(len(ordered) * p / 100.0))]
+
+def acquire(tick):
+    """Simulierte Sensorerfassung (I2C/UART-Lesen und Aufbereitung)."""
+    start = time.perf_counter()
+    values = [((tick * 31 + i) % 997) / 10.0 for i in range(64)]
+    imu = {'roll': values[0], 'pitch': values[1], 'yaw': values[2]}
+    gps = {'lat': 52.0 + values[3] / 1e5, 'lon': 13.0 + values[4] / 1e5, 'fix_type': 4, 'nsat': 18}
+    return {'tick': tick, 'check': tick * 2, 'imu': imu, 'gps': gps, 'raw': values}, time.perf_counter() - start
+
+def control_loop(buffer, duration, rate):
+    """Regelschleife mit festem Takt; gibt Perioden und Erfassungsdauern zurück."""
+    period = 1.0 / rate
+    periods, acquisitions = [], []
+    tick = 0
+    next_tick = time.monotonic()
+    last = None
+    end = next_tick + duration
+    while time.monotonic() < end:
+        now = time.monotonic()
+        if last is not None:
+            periods.append(now - last)
+        last = now
+        data, acq = acquire(tick)
+        acquisitions.append(acq)
+        buffer.publish(data)
+        tick += 1
+        next_tick += period
+        time.sleep(max(0.0, next_tick - time.monotonic()))
+    return periods, acquisitions
+
+def buffer_reader(buffer, stop, stats, io_wait):
+    """
+    Liest wie ein Flask-Handler: Snapshot holen, auftauen, als JSON kodieren.
+    io_wait bildet das Senden der Antwort nach (der Handler gibt dabei den GIL frei).
+    """
+    reads = torn = 0
+    while not stop.is_set():
+        snapshot = buffer.read()
+        data = snapshot.data
+        if data and data['check'] != data['tick'] * 2:
+            torn += 1
+        json.dumps(thaw(data))
+        reads += 1
+        if io_wait:
+            time.sleep(io_wait)
+    stats.append((reads, torn, 0))
+
+def http_reader(url, stop, stats):
+    reads = errors = 0
+    while not stop.is_set():
+        try:
+            with urllib.request.urlopen(url, timeout=2.0) as response:
+                response.read()
+            reads += 1
+        except OSError:
+            errors += 1
+    stats.append((reads, 0, errors))
+
+def run(readers, duration, rate, url=None, io_wait=0.001):
+    buffer = SnapshotBuffer()
+    stop = threading.Event()
+    stats = []
+    threads = []
+    for _ in range(readers):
+        target = (lambda: http_reader(url, stop, stats)) if url else (lambda: buffer_reader(buffer, stop, stats, io_wait))
+        thread = threading.Thread(target=target, daemon=True)
+        thread.start()
+        threads.append(thread)
+    periods, acquisitions = control_loop(buffer, duration, rate)
+    stop.set()
+    for thread in threads:
+        thread.join(timeout=5.0)
+    reads = sum(s[0] for s in stats)
+    return {
+        'readers': readers,
+        'period_mean_ms': 1000 * sum(periods) / max(len(periods), 1),
+        'period_p99_ms': 1000 * percentile(periods, 99),
+        'period_max_ms': 1000 * max(periods or [0.0]),
+        'acquire_p99_us': 1e6 * percentile(acquisitions, 99),
+        'missed_ticks': sum(1 for p in periods if p > 1.5 / rate),
+        'reads_per_sec': reads / duration,
+        'torn_reads': sum(s[1] for s in stats),
+        'errors': sum(s[2] for s in stats)
+    }
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--readers', type=int, default=8, help='Anzahl Lese-Threads')
+    parser.add_argument('--duration', type=float, default=10.0, help='Dauer je Durchlauf in Sekunden')
+    parser.add_argument('--rate', type=float, default=10.0, help='Takt der Regelschleife in Hz')
+    parser.add_argument('--url', help='HTTP-Endpunkt statt direktem Pufferzugriff')
+    parser.add_argument('--io-wait', type=float, default=0.001,
+                        help='simulierte Sendezeit je Antwort in Sekunden (0 = Dauerlast ohne I/O)')
+    args = parser.parse_args()
+
+    print(f"Regelschleife {args.rate:.0f} Hz, {args.duration:.0f}s je Durchlauf")
+    results = [run(0, args.duration, args.rate), run(args.readers, args.duration, args.rate, args.url, args.io_wait)]
+    columns = list(results[0].keys())
+    print(' '.join(f"{c:>15}" for c in columns))
+    for result in results:
+        print(' '.join(f"{result[c]:>15.2f}" if isinstance(result[c], float) else f"{result[c]:>15}"
+                       for c in columns))
+    base, loaded = results
+    print(f"Periode p99: {base['period_p99_ms']:.2f} ms ohne Last, "
+          f"{loaded['period_p99_ms']:.2f} ms mit {args.readers} Lesern; "
+          f"verpasste Ticks: {loaded['missed_ticks']}; inkonsistente Lesezugriffe: {loaded['torn_reads']}")
+    return 0 if loaded['torn_reads'] == 0 else 1
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,390 @@
+import bisect
+import math
+import os
+import struct
+import time
+import zlib
+from dataclasses import dataclass
+from typing import Dict, Iterator, List, Optional
+
+# Dateiformat (.trk), alle Werte little-endian:
+#   Header:  MAGIC, Version (u8), Ursprung lat/lon (f64), Blockgröße (u16)
+#   Blöcke:  BLOCK_MAGIC, Anzahl (u16), Länge (u32), t_first/t_last (i64, ms)
+#            gefolgt von zlib-komprimierten Spalten (zigzag-varint Deltas)
+# Zu jeder .trk-Datei gehört ein Index (.idx) mit einem Eintrag pro Block
+# (t_first, t_last, Offset, Anzahl). Fehlt er oder ist er unvollständig,
+# wird er aus den Block-Headern neu aufgebaut.
+
+MAGIC = b'SRTK'
+VERSION = 1
+HEADER = struct.Struct('<4sBddH')
+BLOCK_MAGIC = b'TB'
+BLOCK_HEADER = struct.Struct('<2sHIqq')
+INDEX_ENTRY = struct.Struct('<qqQH')
+
+ROW_FIELDS = ('t_ms', 'x_mm', 'y_mm', 'heading_mrad', 'fix_type', 'accuracy_mm')
+
+EARTH_RADIUS = 6371000  # Erdradius in Metern (wie RTKGPS)
+
+@dataclass
+class TrackPoint:
+    """Ein Trackpunkt in lokalen Koordinaten (Meter, Radiant, Sekunden)."""
+    t: float
+    x: float
+    y: float
+    heading: float
+    fix_type: int
+    accuracy: float
+
+def _zigzag(n: int) -> int:
+    return (n << 1) ^ (n >> 63)
+
+def _unzigzag(n: int) -> int:
+    return (n >> 1) ^ -(n & 1)
+
+def _write_varint(out: bytearray, n: int) -> None:
+    n = _zigzag(n)
+    while n >= 0x80:
+        out.append((n & 0x7F) | 0x80)
+        n >>= 7
+    out.append(n)
+
+def _read_varints(data: bytes, count: int, pos: int):
+    values = []
+    for _ in range(count):
+        shift = 0
+        n = 0
+        while True:
+            b = data[pos]
+            pos += 1
+            n |= (b & 0x7F) << shift
+            if b < 0x80:
+                break
+            shift += 7
+        values.append(_unzigzag(n))
+    return values, pos
+
+def _encode_column(values: List[int], order: int) -> bytearray:
+    out = bytearray()
+    prev = 0
+    prev_delta = 0
+    for v in values:
+        delta = v - prev
+        _write_varint(out, delta - prev_delta if order == 2 else delta)
+        if order == 2:
+            prev_delta = delta
+        prev = v
+    return out
+
+def _encode_block(rows: List[tuple]) -> bytes:
+    """
+    Kodiert Zeilen (t_ms, x_mm, y_mm, heading_mrad, fix, acc_mm) spaltenweise.
+    Pro Spalte wird das kürzere von Delta erster Ordnung (verrauschte Werte) und
+    zweiter Ordnung (konstante Geschwindigkeit -> 0) gewählt; das erste Byte
+    enthält die Auswahl als Bitmaske.
+    """
+    columns = list(zip(*rows))
+    orders = 0
+    encoded = bytearray()
+    for i, values in enumerate(columns):
+        first = _encode_column(values, 1)
+        second = _encode_column(values, 2)
+        if len(second) < len(first):
+            orders |= 1 << i
+            encoded += second
+        else:
+            encoded += first
+    return zlib.compress(bytes([orders]) + bytes(encoded), 6)
+
+def _decode_block(payload: bytes, count: int) -> List[tuple]:
+    data = zlib.decompress(payload)
+    orders = data[0]
+    columns = []
+    pos = 1
+    for i in range(len(ROW_FIELDS)):
+        values, pos = _read_varints(data, count, pos)
+        col = []
+        prev = 0
+        delta = 0
+        for v in values:
+            if orders & (1 << i):
+                delta += v
+                prev += delta
+            else:
+                prev += v
+            col.append(prev)
+        columns.append(col)
+    return list(zip(*columns))
+
+class TrackRecorder:
+    """
+    Zeichnet den Track einer Mission auf (Streaming, blockweise).
+    Punkte werden gepuffert und als Block geschrieben, sobald block_size erreicht ist.
+    Verwendung:
+      recorder = TrackRecorder('tracks/2024-05-01_1000.trk', origin_lat, origin_lon)
+      recorder.append(time.time(), x, y, heading, fix_type, accuracy)
+      recorder.close()
+    """
+    def __init__(self, filename: str, origin_lat: float = 0.0, origin_lon: float = 0.0,
+                 block_size: int = 512):
+        self.filename = filename
+        self.index_filename = os.path.splitext(filename)[0] + '.idx'
+        self.block_size = block_size
+        self._rows: List[tuple] = []
+        self._last_t = None
+        self.points_written = 0
+
+        directory = os.path.dirname(filename)
+        if directory:
+            os.makedirs(directory, exist_ok=True)
+        self._file = open(filename, 'wb')
+        self._file.write(HEADER.pack(MAGIC, VERSION, origin_lat, origin_lon, block_size))
+        self._index = open(self.index_filename, 'wb')
+
+    def append(self, t: float, x: float, y: float, heading: float = 0.0,
+               fix_type: int = 0, accuracy: float = 0.0) -> None:
+        """Fügt einen Punkt hinzu (t in Sekunden, x/y/accuracy in Metern)."""
+        t_ms = int(round(t * 1000))
+        if self._last_t is not None and t_ms < self._last_t:
+            return  # Zeit muss monoton sein, sonst ist die Suche nach Zeit nicht möglich
+        self._last_t = t_ms
+        self._rows.append((
+            t_ms,
+            int(round(x * 1000)),
+            int(round(y * 1000)),
+            int(round(heading * 1000)),
+            int(fix_type),
+            int(round(accuracy * 1000))
+        ))
+        if len(self._rows) >= self.block_size:
+            self.flush()
+
+    def flush(self) -> None:
+        """Schreibt gepufferte Punkte als Block (auch unvollständige Blöcke)."""
+        if not self._rows or self._file is None:
+            return
+        payload = _encode_block(self._rows)
+        offset = self._file.tell()
+        t_first = self._rows[0][0]
+        t_last = self._rows[-1][0]
+        self._file.write(BLOCK_HEADER.pack(BLOCK_MAGIC, len(self._rows), len(payload),
+                                           t_first, t_last))
+        self._file.write(payload)
+        self._file.flush()
+        self._index.write(INDEX_ENTRY.pack(t_first, t_last, offset, len(self._rows)))
+        self._index.flush()
+        self.points_written += len(self._rows)
+        self._rows = []
+
+    def close(self) -> None:
+        if self._file is None:
+            return
+        self.flush()
+        self._file.close()
+        self._index.close()
+        self._file = None
+        self._index = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+class TrackReader:
+    """
+    Liest eine Track-Datei mit wahlfreiem Zugriff über den Blockindex.
+    Verwendung:
+      reader = TrackReader('tracks/2024-05-01_1000.trk')
+      for p in reader.points(t_start, t_end): ...
+      geojson = reader.to_geojson()
+    """
+    def __init__(self, filename: str):
+        self.filename = filename
+        self.index_filename = os.path.splitext(filename)[0] + '.idx'
+        with open(filename, 'rb') as f:
+            header = f.read(HEADER.size)
+        if len(header) < HEADER.size:
+            raise ValueError(f"Ungültige Track-Datei: {filename}")
+        magic, version, self.origin_lat, self.origin_lon, self.block_size = HEADER.unpack(header)
+        if magic != MAGIC or version != VERSION:
+            raise ValueError(f"Ungültige Track-Datei: {filename}")
+        self.blocks = self._load_index()
+        self._block_ends = [b[1] for b in self.blocks]
+
+    def _load_index(self) -> List[tuple]:
+        blocks = []
+        if os.path.exists(self.index_filename):
+            with open(self.index_filename, 'rb') as f:
+                data = f.read()
+            usable = len(data) - len(data) % INDEX_ENTRY.size
+            blocks = [INDEX_ENTRY.unpack_from(data, i) for i in range(0, usable, INDEX_ENTRY.size)]
+        # Index gegen Datei prüfen; nach einem Absturz können Einträge fehlen
+        file_size = os.path.getsize(self.filename)
+        next_offset = HEADER.size
+        if blocks:
+            _, _, offset, _ = blocks[-1]
+            if offset + BLOCK_HEADER.size <= file_size:
+                next_offset = offset + BLOCK_HEADER.size + self._payload_length(offset)
+            else:
+                next_offset = -1
+        if next_offset != file_size:
+            blocks = self._scan_blocks(file_size)
+        return blocks
+
+    def _payload_length(self, offset: int) -> int:
+        with open(self.filename, 'rb') as f:
+            f.seek(offset)
+            return BLOCK_HEADER.unpack(f.read(BLOCK_HEADER.size))[2]
+
+    def _scan_blocks(self, file_size: int) -> List[tuple]:
+        """Baut den Index aus den Block-Headern neu auf (abgeschnittene Blöcke werden ignoriert)."""
+        blocks = []
+        with open(self.filename, 'rb') as f:
+            offset = HEADER.size
+            while offset + BLOCK_HEADER.size <= file_size:
+                f.seek(offset)
+                magic, count, length, t_first, t_last = BLOCK_HEADER.unpack(f.read(BLOCK_HEADER.size))
+                if magic != BLOCK_MAGIC or offset + BLOCK_HEADER.size + length > file_size:
+                    break
+                blocks.append((t_first, t_last, offset, count))
+                offset += BLOCK_HEADER.size + length
+        return blocks
+
+    def _read_block(self, f, entry: tuple) -> List[tuple]:
+        _, _, offset, count = entry
+        f.seek(offset)
+        _, _, length, _, _ = BLOCK_HEADER.unpack(f.read(BLOCK_HEADER.size))
+        return _decode_block(f.read(length), count)
+
+    @property
+    def point_count(self) -> int:
+        return sum(b[3] for b in self.blocks)
+
+    @property
+    def time_range(self) -> tuple:
+        if not self.blocks:
+            return (0.0, 0.0)
+        return (self.blocks[0][0] / 1000.0, self.blocks[-1][1] / 1000.0)
+
+    def points(self, t_start: Optional[float] = None,
+               t_end: Optional[float] = None) -> Iterator[TrackPoint]:
+        """Liefert alle Punkte im Zeitbereich; springt über den Index direkt zum ersten Block."""
+        start_ms = int(t_start * 1000) if t_start is not None else None
+        end_ms = int(t_end * 1000) if t_end is not None else None
+        first = bisect.bisect_left(self._block_ends, start_ms) if start_ms is not None else 0
+        with open(self.filename, 'rb') as f:
+            for entry in self.blocks[first:]:
+                if end_ms is not None and entry[0] > end_ms:
+                    return
+                for row in self._read_block(f, entry):
+                    if start_ms is not None and row[0] < start_ms:
+                        continue
+                    if end_ms is not None and row[0] > end_ms:
+                        return
+                    yield TrackPoint(row[0] / 1000.0, row[1] / 1000.0, row[2] / 1000.0,
+                                     row[3] / 1000.0, row[4], row[5] / 1000.0)
+
+    def seek(self, t: float) -> Optional[TrackPoint]:
+        """Gibt den ersten Punkt zum Zeitpunkt t oder danach zurück."""
+        return next(self.points(t_start=t), None)
+
+    def to_lat_lon(self, x: float, y: float) -> tuple:
+        """Lokale Koordinaten in GPS-Koordinaten (gleiche Projektion wie RTKGPS)."""
+        dlat = y / EARTH_RADIUS
+        dlon = x / (EARTH_RADIUS * math.cos(math.radians(self.origin_lat)))
+        return self.origin_lat + math.degrees(dlat), self.origin_lon + math.degrees(dlon)
+
+    def _export_points(self, t_start, t_end, step):
+        for i, p in enumerate(self.points(t_start, t_end)):
+            if i % step == 0:
+                yield p
+
+    def to_geojson(self, t_start: Optional[float] = None, t_end: Optional[float] = None,
+                   step: int = 1) -> Dict:
+        """
+        Exportiert den Track als GeoJSON-Feature (LineString).
+        step: nur jeden n-ten Punkt ausgeben (für die Kartenansicht).
+        """
+        coords = []
+        times = []
+        fix = []
+        for p in self._export_points(t_start, t_end, max(1, step)):
+            lat, lon = self.to_lat_lon(p.x, p.y)
+            coords.append([round(lon, 8), round(lat, 8)])
+            times.append(p.t)
+            fix.append(p.fix_type)
+        return {
+            'type': 'Feature',
+            'geometry': {'type': 'LineString', 'coordinates': coords},
+            'properties': {
+                'name': os.path.splitext(os.path.basename(self.filename))[0],
+                'times': times,
+                'fix_types': fix
+            }
+        }
+
+    def to_gpx(self, t_start: Optional[float] = None, t_end: Optional[float] = None,
+               step: int = 1) -> str:
+        """Exportiert den Track als GPX 1.1."""
+        name = os.path.splitext(os.path.basename(self.filename))[0]
+        lines = [
+            '<?xml version="1.0" encoding="UTF-8"?>',
+            '<gpx version="1.1" creator="sunray-mower" xmlns="http://www.topografix.com/GPX/1/1">',
+            f'  <trk><name>{name}</name><trkseg>'
+        ]
+        for p in self._export_points(t_start, t_end, max(1, step)):
+            lat, lon = self.to_lat_lon(p.x, p.y)
+            stamp = time.strftime('%Y-%m-%dT%H:%M:%S', time.gmtime(p.t))
+            lines.append(
+                f'    <trkpt lat="{lat:.8f}" lon="{lon:.8f}"><time>{stamp}Z</time>'
+                f'<fix>{"dgps" if p.fix_type >= 4 else "3d"}</fix></trkpt>'
+            )
+        lines.append('  </trkseg></trk>')
+        lines.append('</gpx>')
+        return '\n'.join(lines)
+
+class TrackArchive:
+    """
+    Verwaltet die Track-Dateien aller Missionen in einem Verzeichnis.
+    """
+    def __init__(self, directory: str = 'tracks'):
+        self.directory = directory
+
+    def start_mission(self, origin_lat: float = 0.0, origin_lon: float = 0.0,
+                      mission_id: Optional[str] = None, block_size: int = 512) -> TrackRecorder:
+        """Legt eine neue Mission an und gibt deren Recorder zurück."""
+        if mission_id is None:
+            mission_id = time.strftime('%Y-%m-%d_%H%M%S')
+        return TrackRecorder(self._path(mission_id), origin_lat, origin_lon, block_size)
+
+    def list_missions(self) -> List[Dict]:
+        """Listet alle Missionen mit Zeitbereich, Punktanzahl und Dateigröße."""
+        if not os.path.isdir(self.directory):
+            return []
+        missions = []
+        for name in sorted(os.listdir(self.directory)):
+            if not name.endswith('.trk'):
+                continue
+            mission_id = name[:-4]
+            try:
+                reader = self.open(mission_id)
+            except (OSError, ValueError):
+                continue
+            start, end = reader.time_range
+            missions.append({
+                'id': mission_id,
+                'start': start,
+                'end': end,
+                'points': reader.point_count,
+                'bytes': os.path.getsize(reader.filename)
+            })
+        return missions
+
+    def open(self, mission_id: str) -> TrackReader:
+        return TrackReader(self._path(mission_id))
+
+    def _path(self, mission_id: str) -> str:
+        if os.path.basename(mission_id) != mission_id or not mission_id:
+            raise ValueError(f"Ungültige Missions-ID: {mission_id}")
+        return os.path.join(self.directory, mission_id + '.trk')
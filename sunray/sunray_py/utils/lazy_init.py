@@ -0,0 +1,110 @@
+import threading
+from typing import Any, Callable, Dict, List, Optional
+
+from utils.startup_profiler import get_startup_timeline
+
+class LazySubsystem:
+    """
+    Subsystem, das im Hintergrund initialisiert wird.
+    Die Fabrikfunktion läuft in einem eigenen Thread, sobald alle
+    Abhängigkeiten bereit sind. Bis dahin liefert value_or_none() None,
+    sodass die Regelschleife das Subsystem einfach überspringen kann.
+    """
+    def __init__(self, name: str, factory: Callable[..., Any],
+                 depends_on: Optional[List['LazySubsystem']] = None):
+        self.name = name
+        self.factory = factory
+        self.depends_on = depends_on or []
+        self._value = None
+        self._error: Optional[str] = None
+        self._done = threading.Event()
+        self._thread: Optional[threading.Thread] = None
+        self._lock = threading.Lock()
+
+    def start(self) -> 'LazySubsystem':
+        """Startet die Initialisierung im Hintergrund (idempotent)."""
+        with self._lock:
+            if self._thread is None:
+                self._thread = threading.Thread(target=self._run,
+                                                name=f"init-{self.name}",
+                                                daemon=True)
+                self._thread.start()
+        return self
+
+    def _run(self) -> None:
+        timeline = get_startup_timeline()
+        try:
+            deps = []
+            for dep in self.depends_on:
+                dep.start()
+                deps.append(dep.get())
+                if dep.failed():
+                    raise RuntimeError(f"Abhängigkeit '{dep.name}' nicht verfügbar")
+            with timeline.phase(self.name):
+                self._value = self.factory(*deps)
+        except Exception as e:
+            self._error = str(e)
+            print(f"Fehler bei Initialisierung von {self.name}: {e}")
+        finally:
+            self._done.set()
+
+    def get(self, timeout: Optional[float] = None) -> Any:
+        """Wartet auf die Initialisierung und gibt das Subsystem zurück (oder None)."""
+        self.start()
+        self._done.wait(timeout)
+        return self._value
+
+    def value_or_none(self) -> Any:
+        """Gibt das Subsystem zurück, falls bereits initialisiert, sonst None."""
+        return self._value if self._done.is_set() else None
+
+    def ready(self) -> bool:
+        return self._done.is_set() and self._error is None
+
+    def failed(self) -> bool:
+        return self._done.is_set() and self._error is not None
+
+    def get_status(self) -> Dict:
+        if not self._done.is_set():
+            state = 'pending' if self._thread is None else 'loading'
+        else:
+            state = 'failed' if self._error else 'ready'
+        return {'state': state, 'error': self._error}
+
+class LazyInitializer:
+    """
+    Registry für im Hintergrund geladene Subsysteme.
+    """
+    def __init__(self):
+        self.subsystems: Dict[str, LazySubsystem] = {}
+
+    def register(self, name: str, factory: Callable[..., Any],
+                 depends_on: Optional[List[str]] = None) -> LazySubsystem:
+        """Registriert ein Subsystem. Abhängigkeiten werden per Name angegeben."""
+        deps = [self.subsystems[d] for d in (depends_on or [])]
+        subsystem = LazySubsystem(name, factory, deps)
+        self.subsystems[name] = subsystem
+        return subsystem
+
+    def start_all(self) -> None:
+        for subsystem in self.subsystems.values():
+            subsystem.start()
+
+    def get(self, name: str) -> Any:
+        """Nicht blockierender Zugriff; None, solange das Subsystem lädt."""
+        subsystem = self.subsystems.get(name)
+        return subsystem.value_or_none() if subsystem else None
+
+    def all_done(self) -> bool:
+        """True, sobald kein Subsystem mehr lädt."""
+        return all(s.get_status()['state'] in ('ready', 'failed')
+                   for s in self.subsystems.values())
+
+    def wait_all(self, timeout: Optional[float] = None) -> bool:
+        """Wartet, bis alle Subsysteme fertig sind. True, wenn keines mehr lädt."""
+        for subsystem in self.subsystems.values():
+            subsystem.get(timeout)
+        return self.all_done()
+
+    def get_status(self) -> Dict[str, Dict]:
+        return {name: s.get_status() for name, s in self.subsystems.items()}
@@ -0,0 +1,330 @@
+"""
+Metriken für den gesamten Stack im OpenMetrics-Textformat (/metrics, Prometheus-kompatibel).
+
+Zähler, Messwerte und Histogramme werden von den Subsystemen beim Start registriert
+und in der Regelschleife, im Pico-Leser usw. ohne Lock aktualisiert:
+
+- Counter/Histogram schreiben in eine Zelle je Thread (threading.local). Jeder Thread
+  verändert nur seine eigene Liste, Aktualisierungen gehen daher nicht verloren;
+  erst beim Abfragen werden die Zellen aller Threads summiert. Zellen beendeter
+  Threads (z.B. je Anfrage beim Flask-Entwicklungsserver) gehen dabei in eine
+  Summenzelle über, die Zahl der Zellen wächst nicht mit jedem Thread.
+- Gauge.set() ist eine einfache Zuweisung; alternativ liest ein Gauge beim Abfragen
+  eine Funktion aus (fn=lambda: motor.overload_count).
+- Für sehr heiße Pfade liefert bind() die Zelle des aktuellen Threads direkt:
+  cell = counter.bind(); cell[0] += 1
+
+Registrieren ist idempotent: derselbe Name liefert dieselbe Metrik zurück.
+
+Verwendung:
+  metrics = get_metrics()
+  errors = metrics.counter('sunray_pico_errors', 'Kommunikationsfehler zum Pico')
+  errors.inc()
+  requests = metrics.counter('sunray_http_requests', 'HTTP-Anfragen', ('endpoint', 'code'))
+  requests.labels('/api/status', '200').inc()
+  tick = metrics.histogram('sunray_loop_tick_seconds', 'Dauer eines Regelzyklus')
+  tick.observe(0.012)
+"""
+
+import math
+import threading
+import time
+import weakref
+from bisect import bisect_left
+from typing import Callable, Dict, List, Optional, Sequence, Tuple
+
+OPENMETRICS_CONTENT_TYPE = 'application/openmetrics-text; version=1.0.0; charset=utf-8'
+
+# Sekunden, passend für Regelzyklen (100 ms Takt) und HTTP-Antworten
+DEFAULT_BUCKETS = (0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0)
+
+class _Sharded:
+    """Basis für Metriken mit einer Zelle (Liste) je schreibendem Thread."""
+    _width = 1
+
+    def __init__(self):
+        self._local = threading.local()
+        self._cells: List[Tuple[weakref.ref, List[float]]] = []
+        self._retired = [0] * self._width
+        self._cells_lock = threading.Lock()
+
+    def bind(self) -> List[float]:
+        """Zelle des aktuellen Threads (wird beim ersten Zugriff angelegt)."""
+        try:
+            return self._local.cell
+        except AttributeError:
+            cell = [0] * self._width
+            self._local.cell = cell
+            with self._cells_lock:
+                self._retire_dead()
+                self._cells.append((weakref.ref(threading.current_thread()), cell))
+            return cell
+
+    def _retire_dead(self) -> None:
+        """Zellen beendeter Threads in die Summenzelle übernehmen (mit _cells_lock)."""
+        alive = []
+        for ref, cell in self._cells:
+            thread = ref()
+            if thread is not None and thread.is_alive():
+                alive.append((ref, cell))
+            else:
+                # Der Thread schreibt nicht mehr, seine Werte zählen in _retired weiter
+                for i, value in enumerate(cell):
+                    self._retired[i] += value
+        self._cells = alive
+
+    def _sum(self) -> List[float]:
+        with self._cells_lock:
+            self._retire_dead()
+            cells = [cell for _, cell in self._cells]
+            cells.append(list(self._retired))
+        totals = [0] * self._width
+        for cell in cells:
+            for i, value in enumerate(cell):
+                totals[i] += value
+        return totals
+
+class Counter(_Sharded):
+    """Monoton steigender Zähler."""
+    def inc(self, amount: float = 1) -> None:
+        try:
+            self._local.cell[0] += amount
+        except AttributeError:
+            self.bind()[0] += amount
+
+    @property
+    def value(self) -> float:
+        return self._sum()[0]
+
+    def _samples(self, name: str, labels: str) -> List[str]:
+        return [f'{name}_total{labels} {_format(self.value)}']
+
+class Gauge:
+    """Momentanwert; entweder gesetzt oder beim Abfragen aus fn gelesen."""
+    def __init__(self, fn: Optional[Callable[[], float]] = None):
+        self._value = 0.0
+        self._fn = fn
+        self._lock = threading.Lock()
+
+    def set(self, value: float) -> None:
+        self._value = value
+
+    def inc(self, amount: float = 1) -> None:
+        with self._lock:
+            self._value += amount
+
+    def dec(self, amount: float = 1) -> None:
+        self.inc(-amount)
+
+    def set_function(self, fn: Callable[[], float]) -> None:
+        self._fn = fn
+
+    @property
+    def value(self) -> float:
+        return float(self._fn()) if self._fn else self._value
+
+    def _samples(self, name: str, labels: str) -> List[str]:
+        try:
+            value = self.value
+        except Exception:
+            # Quelle (z.B. ein beendetes Subsystem) nicht lesbar: Wert auslassen
+            return []
+        return [f'{name}{labels} {_format(value)}']
+
+class Histogram(_Sharded):
+    """Verteilung mit festen Bucket-Grenzen; Zelle: Buckets, +Inf, Summe."""
+    def __init__(self, buckets: Sequence[float] = DEFAULT_BUCKETS):
+        self.buckets = tuple(sorted(float(b) for b in buckets))
+        self._width = len(self.buckets) + 2
+        super().__init__()
+
+    def observe(self, value: float) -> None:
+        try:
+            cell = self._local.cell
+        except AttributeError:
+            cell = self.bind()
+        cell[bisect_left(self.buckets, value)] += 1
+        cell[-1] += value
+
+    def time(self) -> '_Timer':
+        """Kontextmanager: with histogram.time(): ..."""
+        return _Timer(self)
+
+    @property
+    def count(self) -> int:
+        return int(sum(self._sum()[:-1]))
+
+    @property
+    def sum(self) -> float:
+        return self._sum()[-1]
+
+    def _samples(self, name: str, labels: str) -> List[str]:
+        totals = self._sum()
+        lines = []
+        cumulative = 0
+        for bound, count in zip(self.buckets + (math.inf,), totals[:-1]):
+            cumulative += count
+            le = '+Inf' if bound == math.inf else _format(bound)
+            lines.append(f'{name}_bucket{_merge_labels(labels, "le", le)} {int(cumulative)}')
+        lines.append(f'{name}_count{labels} {int(cumulative)}')
+        lines.append(f'{name}_sum{labels} {_format(totals[-1])}')
+        return lines
+
+class _Timer:
+    def __init__(self, histogram: Histogram):
+        self._histogram = histogram
+
+    def __enter__(self):
+        self._start = time.perf_counter()
+        return self
+
+    def __exit__(self, *exc):
+        self._histogram.observe(time.perf_counter() - self._start)
+        return False
+
+class MetricFamily:
+    """Metrik mit Labels; jede Label-Kombination ist eine eigene Zeitreihe."""
+    def __init__(self, name: str, kind: str, help_text: str,
+                 labelnames: Tuple[str, ...], factory: Callable[[], object]):
+        self.name = name
+        self.kind = kind
+        self.help = help_text
+        self.labelnames = labelnames
+        self._factory = factory
+        self._children: Dict[Tuple[str, ...], object] = {}
+        self._lock = threading.Lock()
+
+    def labels(self, *values, **kwargs):
+        """Zeitreihe zu den Label-Werten (positional oder per Name)."""
+        if kwargs:
+            values = tuple(kwargs[name] for name in self.labelnames)
+        key = tuple(str(v) for v in values)
+        child = self._children.get(key)
+        if child is None:
+            if len(key) != len(self.labelnames):
+                raise ValueError(f"{self.name}: erwartet Labels {self.labelnames}")
+            with self._lock:
+                child = self._children.setdefault(key, self._factory())
+        return child
+
+    def expose(self) -> List[str]:
+        lines = [f'# TYPE {self.name} {self.kind}']
+        if self.help:
+            lines.append(f'# HELP {self.name} {_escape_help(self.help)}')
+        for key, child in sorted(self._children.items()):
+            labels = ','.join(f'{n}="{_escape_label(v)}"' for n, v in zip(self.labelnames, key))
+            lines.extend(child._samples(self.name, '{' + labels + '}' if labels else ''))
+        return lines
+
+class MetricsRegistry:
+    """Sammlung aller Metriken; erzeugt die OpenMetrics-Ausgabe."""
+    def __init__(self, prefix: str = ''):
+        self.prefix = prefix
+        self._families: Dict[str, MetricFamily] = {}
+        self._lock = threading.Lock()
+
+    def _register(self, name: str, kind: str, help_text: str,
+                  labelnames: Sequence[str], factory: Callable[[], object]):
+        if kind == 'counter' and name.endswith('_total'):
+            name = name[:-len('_total')]
+        name = self.prefix + name
+        with self._lock:
+            family = self._families.get(name)
+            if family is None:
+                family = MetricFamily(name, kind, help_text, tuple(labelnames), factory)
+                self._families[name] = family
+            elif family.kind != kind:
+                raise ValueError(f"Metrik {name} ist bereits als {family.kind} registriert")
+        return family if family.labelnames else family.labels()
+
+    def counter(self, name: str, help_text: str = '', labelnames: Sequence[str] = ()):
+        return self._register(name, 'counter', help_text, labelnames, Counter)
+
+    def gauge(self, name: str, help_text: str = '', labelnames: Sequence[str] = (),
+              fn: Optional[Callable[[], float]] = None):
+        gauge = self._register(name, 'gauge', help_text, labelnames, Gauge)
+        if fn is not None and not labelnames:
+            # Neu gestartete Subsysteme ersetzen die Quelle ihres Vorgängers
+            gauge.set_function(fn)
+        return gauge
+
+    def histogram(self, name: str, help_text: str = '', labelnames: Sequence[str] = (),
+                  buckets: Sequence[float] = DEFAULT_BUCKETS):
+        return self._register(name, 'histogram', help_text, labelnames,
+                              lambda: Histogram(buckets))
+
+    def get(self, name: str) -> Optional[MetricFamily]:
+        return self._families.get(self.prefix + name)
+
+    def names(self) -> List[str]:
+        return sorted(self._families)
+
+    def expose(self) -> str:
+        """Alle Metriken im OpenMetrics-Textformat (endet mit '# EOF')."""
+        with self._lock:
+            families = sorted(self._families.values(), key=lambda f: f.name)
+        lines = []
+        for family in families:
+            lines.extend(family.expose())
+        lines.append('# EOF')
+        return '\n'.join(lines) + '\n'
+
+def _format(value: float) -> str:
+    if value == math.inf:
+        return '+Inf'
+    if value == -math.inf:
+        return '-Inf'
+    if isinstance(value, float) and value.is_integer() and abs(value) < 1e15:
+        return str(int(value)) + '.0'
+    return repr(value)
+
+def _escape_label(value: str) -> str:
+    return value.replace('\\', '\\\\').replace('"', '\\"').replace('\n', '\\n')
+
+def _escape_help(value: str) -> str:
+    return value.replace('\\', '\\\\').replace('\n', '\\n')
+
+def _merge_labels(labels: str, name: str, value: str) -> str:
+    extra = f'{name}="{value}"'
+    return '{' + (labels[1:-1] + ',' if labels else '') + extra + '}'
+
+def install_metrics_routes(app, registry: 'MetricsRegistry') -> None:
+    """
+    Registriert GET /metrics an einer Flask-App und misst alle Anfragen
+    (sunray_http_requests, sunray_http_request_seconds je Route und Statuscode).
+    """
+    from flask import Response, request, g
+
+    requests_total = registry.counter('sunray_http_requests', 'HTTP-Anfragen',
+                                      ('endpoint', 'code'))
+    durations = registry.histogram('sunray_http_request_seconds', 'Bearbeitungszeit der HTTP-Anfragen',
+                                   ('endpoint',))
+
+    @app.before_request
+    def _metrics_start():
+        g.metrics_start = time.perf_counter()
+
+    @app.after_request
+    def _metrics_record(response):
+        start = g.pop('metrics_start', None)
+        # Routenmuster statt URL, damit die Zahl der Zeitreihen begrenzt bleibt
+        endpoint = request.url_rule.rule if request.url_rule else 'unmatched'
+        requests_total.labels(endpoint, str(response.status_code)).inc()
+        if start is not None:
+            durations.labels(endpoint).observe(time.perf_counter() - start)
+        return response
+
+    def metrics_endpoint():
+        return Response(registry.expose(), content_type=OPENMETRICS_CONTENT_TYPE)
+
+    app.add_url_rule('/metrics', 'metrics', metrics_endpoint)
+
+# Globale Registry
+_metrics: Optional[MetricsRegistry] = None
+
+def get_metrics() -> MetricsRegistry:
+    """Gibt die globale Metrik-Registry zurück."""
+    global _metrics
+    if _metrics is None:
+        _metrics = MetricsRegistry()
+    return _metrics
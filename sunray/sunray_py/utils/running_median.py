@@ -1,38 +1,199 @@
 import bisect
-from typing import List
+from typing import Dict, Iterable, List, Sequence, Union
 
 class RunningMedian:
     """
-    Einfacher gleitender Median-Filter.
-    Puffer mit fester Größe, neue Werte schieben, Median berechnen.
+    Gleitender Median-/Quantil-Filter über ein Fenster fester Größe.
+    Die Werte liegen in einem Ringpuffer (ältester Wert wird ohne Verschieben
+    überschrieben), die Sortierung in einer blockweise sortierten Liste:
+    Einfügen/Entfernen suchen per bisect in O(log n) und verschieben nur
+    innerhalb eines Blocks mit höchstens 2 * BLOCK_SIZE Einträgen.
     """
+    BLOCK_SIZE = 512
+
     def __init__(self, size: int):
-        self.size = size
-        self.buffer: List[float] = []
-        self.sorted: List[float] = []
+        self.size = max(1, int(size))
+        self._ring: List[float] = [0.0] * self.size
+        self._head = 0   # Index des ältesten Werts
+        self._count = 0
+        self._blocks: List[List[float]] = []
+        self._maxes: List[float] = []
+
+    def __len__(self) -> int:
+        return self._count
+
+    @property
+    def buffer(self) -> List[float]:
+        """Werte im Fenster, vom ältesten zum neuesten."""
+        return [self._ring[(self._head + i) % self.size] for i in range(self._count)]
+
+    @property
+    def sorted(self) -> List[float]:
+        """Werte im Fenster, aufsteigend sortiert."""
+        return [value for block in self._blocks for value in block]
 
     def add(self, value: float) -> None:
         """
         Fügt neuen Wert hinzu. Entfernt ältesten, wenn Puffer voll.
+        NaN wird verworfen, da es die Sortierung zerstören würde.
         """
-        if len(self.buffer) == self.size:
-            old = self.buffer.pop(0)
-            # alten Wert aus sortierter Liste entfernen
-            idx = bisect.bisect_left(self.sorted, old)
-            if 0 <= idx < len(self.sorted):
-                self.sorted.pop(idx)
-        # neuen Wert in Puffer und sortierte Liste einfügen
-        self.buffer.append(value)
-        bisect.insort(self.sorted, value)
+        if value != value:
+            return
+        ring = self._ring
+        if self._count == self.size:
+            old = ring[self._head]
+            ring[self._head] = value
+            self._head = (self._head + 1) % self.size
+            if len(self._blocks) == 1 and self.size <= 2 * self.BLOCK_SIZE:
+                # Kleines Fenster: nur ein Block, direkt darin ersetzen
+                block = self._blocks[0]
+                del block[bisect.bisect_left(block, old)]
+                bisect.insort(block, value)
+                return
+            self._remove(old)
+        else:
+            ring[(self._head + self._count) % self.size] = value
+            self._count += 1
+        self._insert(value)
+
+    def clear(self) -> None:
+        """Leert das Fenster."""
+        self._head = 0
+        self._count = 0
+        self._blocks = []
+        self._maxes = []
 
     def median(self) -> float:
         """
         Gibt Median des aktuellen Puffers zurück.
         """
-        n = len(self.sorted)
+        n = self._count
         if n == 0:
             return 0.0
+        if len(self._blocks) == 1:
+            block = self._blocks[0]
+            if n % 2 == 1:
+                return block[n // 2]
+            return 0.5 * (block[n // 2 - 1] + block[n // 2])
         if n % 2 == 1:
-            return self.sorted[n // 2]
+            return self._select(n // 2)
+        else:
+            return 0.5 * (self._select(n // 2 - 1) + self._select(n // 2))
+
+    def quantile(self, q: float) -> float:
+        """
+        Quantil q (0..1) des aktuellen Puffers, linear zwischen den
+        benachbarten Rängen interpoliert (wie numpy.quantile).
+        """
+        n = self._count
+        if n == 0:
+            return 0.0
+        pos = min(1.0, max(0.0, q)) * (n - 1)
+        lower = int(pos)
+        value = self._select(lower)
+        fraction = pos - lower
+        if fraction == 0.0 or lower + 1 >= n:
+            return value
+        return value + (self._select(lower + 1) - value) * fraction
+
+    def _insert(self, value: float) -> None:
+        blocks, maxes = self._blocks, self._maxes
+        if not blocks:
+            blocks.append([value])
+            maxes.append(value)
+            return
+        i = bisect.bisect_left(maxes, value)
+        if i == len(blocks):
+            i -= 1
+            blocks[i].append(value)
+            maxes[i] = value
+        else:
+            bisect.insort(blocks[i], value)
+        block = blocks[i]
+        if len(block) > 2 * self.BLOCK_SIZE:
+            # Block halbieren, damit das Verschieben beim Einfügen kurz bleibt
+            upper = block[self.BLOCK_SIZE:]
+            del block[self.BLOCK_SIZE:]
+            blocks.insert(i + 1, upper)
+            maxes[i] = block[-1]
+            maxes.insert(i + 1, upper[-1])
+
+    def _remove(self, value: float) -> None:
+        blocks, maxes = self._blocks, self._maxes
+        i = bisect.bisect_left(maxes, value)
+        block = blocks[i]
+        del block[bisect.bisect_left(block, value)]
+        if block:
+            maxes[i] = block[-1]
         else:
-            return 0.5 * (self.sorted[n // 2 - 1] + self.sorted[n // 2])
+            del blocks[i]
+            del maxes[i]
+
+    def _select(self, k: int) -> float:
+        """k-kleinster Wert (0-basiert)."""
+        blocks = self._blocks
+        if len(blocks) == 1:
+            return blocks[0][k]
+        for block in blocks:
+            if k < len(block):
+                return block[k]
+            k -= len(block)
+        raise IndexError(k)
+
+class RunningQuantiles:
+    """
+    Mehrkanaliger gleitender Median-/Quantil-Filter, z.B. für alle Strom-
+    und Spannungskanäle der Batterie: update() nimmt die Messwerte aller
+    Kanäle in einem Aufruf und liefert das gewünschte Quantil je Kanal.
+    """
+    def __init__(self, channels: Sequence[str], size: int):
+        self.channels = tuple(channels)
+        self.size = max(1, int(size))
+        self._filters: Dict[str, RunningMedian] = {name: RunningMedian(self.size) for name in self.channels}
+        self._ordered = tuple(self._filters[name] for name in self.channels)
+
+    def channel(self, name: str) -> RunningMedian:
+        """Filter eines einzelnen Kanals."""
+        return self._filters[name]
+
+    def update(self, values: Union[Dict[str, float], Sequence[float]], q: float = 0.5) -> Dict[str, float]:
+        """
+        Fügt die Messwerte hinzu (Dict nach Kanalname oder Folge in
+        Kanalreihenfolge; fehlende Kanäle bleiben unverändert) und gibt das
+        Quantil q je Kanal zurück.
+        """
+        if isinstance(values, dict):
+            for name, value in values.items():
+                if name in self._filters:
+                    self._filters[name].add(value)
+        else:
+            for f, value in zip(self._ordered, values):
+                f.add(value)
+        return self.quantiles(q)
+
+    def median(self, name: str) -> float:
+        return self._filters[name].median()
+
+    def quantile(self, name: str, q: float) -> float:
+        return self._filters[name].quantile(q)
+
+    def quantiles(self, q: float = 0.5) -> Dict[str, float]:
+        """Quantil q aller Kanäle; q=0.5 liefert den Median."""
+        if q == 0.5:
+            return {name: f.median() for name, f in self._filters.items()}
+        return {name: f.quantile(q) for name, f in self._filters.items()}
+
+    def clear(self) -> None:
+        for f in self._filters.values():
+            f.clear()
+
+    def state(self) -> Dict[str, List[float]]:
+        """Fensterinhalt je Kanal (ältester zuerst), z.B. für den Checkpoint."""
+        return {name: f.buffer for name, f in self._filters.items()}
+
+    def restore(self, state: Dict[str, Iterable[float]]) -> None:
+        """Füllt die Fenster aus state() wieder auf."""
+        for name, values in state.items():
+            if name in self._filters:
+                for value in values:
+                    self._filters[name].add(value)
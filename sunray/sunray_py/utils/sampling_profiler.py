@@ -0,0 +1,328 @@
+"""
+Sampling-Profiler für den Betrieb im Garten (ohne Debugger oder py-spy am Gerät).
+
+Ein Hintergrund-Thread liest mit fester Rate die Stacks aller Python-Threads
+(sys._current_frames()) und zählt sie als gefaltete Stacks
+("thread;äußere Funktion;...;innere Funktion" -> Anzahl). Der zu messende Code
+wird nicht verändert; Kosten entstehen nur im Abtast-Thread, der dabei den GIL
+hält. Diese Zeit wird gemessen: überschreitet sie max_overhead (Anteil der
+Wanduhrzeit), halbiert der Profiler seine Rate.
+
+Ausgabe im Format von flamegraph.pl/speedscope/inferno (eine Zeile je Stack),
+per API:
+  POST /api/profile/start {"rate": 100, "duration": 60}
+  GET  /api/profile/folded            gefaltete Stacks (text/plain)
+  GET  /api/profile/top?limit=20      Funktionen nach Eigen-/Gesamtanteil
+
+Native Frames (C-Erweiterungen) sieht sys._current_frames() nicht; ein Thread
+in einer C-Funktion (auch time.sleep, serielles Lesen) erscheint mit dem
+aufrufenden Python-Frame als Blatt.
+
+Verwendung:
+  profiler = get_profiler(config.get('profiler', {}))
+  profiler.start(rate=100, duration=60)
+  print(profiler.folded())
+"""
+
+import os
+import sys
+import threading
+import time
+from typing import Any, Dict, List, Optional
+
+TRUNCATED = '[weitere Stacks]'
+
+class SamplingProfiler:
+    """
+    Konfiguration (Abschnitt 'profiler' in config.json):
+      enabled: beim Start von main.py sofort abtasten
+      rate: Abtastrate in Hz
+      duration: automatisch stoppen nach Sekunden (0 = unbegrenzt)
+      max_depth: maximale Stacktiefe (äußere Frames werden abgeschnitten)
+      max_stacks: maximale Anzahl verschiedener Stacks (weitere zählen unter TRUNCATED)
+      max_overhead: Anteil der Wanduhrzeit, den das Abtasten höchstens kosten darf
+      include_idle: auch Threads zählen, die in threading/queue/selectors/socket warten
+    """
+    # Wartestellen der Standardbibliothek: ein Thread mit diesem Blatt rechnet nicht
+    IDLE_FUNCTIONS = {
+        'threading.py': ('wait', 'join', '_wait_for_tstate_lock'),
+        'queue.py': ('get',),
+        'selectors.py': ('select',),
+        'socketserver.py': ('serve_forever',),
+        'socket.py': ('accept', 'readinto'),
+        'ssl.py': ('read', 'recv_into'),
+    }
+
+    def __init__(self, config: Optional[Dict] = None):
+        config = config or {}
+        self.enabled = config.get('enabled', False)
+        self.rate = float(config.get('rate', 100.0))
+        self.duration = float(config.get('duration', 0.0))
+        self.max_depth = int(config.get('max_depth', 64))
+        self.max_stacks = int(config.get('max_stacks', 20000))
+        self.max_overhead = float(config.get('max_overhead', 0.02))
+        self.include_idle = config.get('include_idle', False)
+        self._lock = threading.Lock()
+        self._stacks: Dict[tuple, int] = {}
+        self._labels: Dict[int, str] = {}
+        self._codes: Dict[int, Any] = {}
+        self._idle_codes = set()
+        self._thread_names: Dict[int, str] = {}
+        self._thread: Optional[threading.Thread] = None
+        self._stop = threading.Event()
+        self._reset_stats()
+
+    def _reset_stats(self) -> None:
+        self.stats = {'samples': 0, 'stacks_recorded': 0, 'idle_skipped': 0, 'truncated': 0,
+                      'rate_reductions': 0, 'sample_time': 0.0, 'elapsed': 0.0,
+                      'started_at': None, 'stopped_at': None}
+        self.current_rate = self.rate
+
+    # Steuerung
+
+    @property
+    def running(self) -> bool:
+        return self._thread is not None and self._thread.is_alive()
+
+    def start(self, rate: Optional[float] = None, duration: Optional[float] = None,
+              reset: bool = True) -> bool:
+        """Startet das Abtasten; False, wenn es schon läuft."""
+        if self.running:
+            return False
+        if rate is not None:
+            self.rate = max(1.0, min(1000.0, float(rate)))
+        if duration is not None:
+            self.duration = max(0.0, float(duration))
+        if reset:
+            self.reset()
+        self.current_rate = self.rate
+        self.stats['started_at'] = time.time()
+        self.stats['stopped_at'] = None
+        self._stop.clear()
+        self._thread = threading.Thread(target=self._run, name='sampling-profiler', daemon=True)
+        self._thread.start()
+        print(f"Profiler: Abtastung mit {self.rate:.0f} Hz gestartet"
+              f"{f' für {self.duration:g} s' if self.duration else ''}")
+        return True
+
+    def stop(self) -> bool:
+        """Beendet das Abtasten; die gesammelten Stacks bleiben erhalten."""
+        if not self.running:
+            return False
+        self._stop.set()
+        if self._thread is not threading.current_thread():
+            self._thread.join(timeout=2.0)
+        return True
+
+    def reset(self) -> None:
+        with self._lock:
+            self._stacks = {}
+            self._reset_stats()
+
+    # Abtasten
+
+    def _run(self) -> None:
+        own = threading.get_ident()
+        began = time.perf_counter()
+        next_sample = began
+        window_start, window_cost = began, 0.0
+        try:
+            while not self._stop.is_set():
+                now = time.perf_counter()
+                if self.duration and now - began >= self.duration:
+                    break
+                if next_sample > now:
+                    self._stop.wait(next_sample - now)
+                    continue
+                cost = self._sample(own)
+                window_cost += cost
+                self.stats['sample_time'] += cost
+                self.stats['elapsed'] = time.perf_counter() - began
+                next_sample = max(next_sample + 1.0 / self.current_rate, time.perf_counter())
+                # Anteil über die letzte Sekunde prüfen; zu teuer -> Rate halbieren
+                if now - window_start >= 1.0:
+                    if window_cost / (now - window_start) > self.max_overhead and self.current_rate > 1.0:
+                        self.current_rate = max(1.0, self.current_rate / 2)
+                        self.stats['rate_reductions'] += 1
+                        print(f"Profiler: Abtastung zu teuer, Rate auf {self.current_rate:.0f} Hz gesenkt")
+                    window_start, window_cost = now, 0.0
+        finally:
+            self.stats['elapsed'] = time.perf_counter() - began
+            self.stats['stopped_at'] = time.time()
+            print(f"Profiler: Abtastung beendet ({self.stats['samples']} Abtastungen, "
+                  f"Aufwand {self.overhead():.2%})")
+
+    def _sample(self, own: int) -> float:
+        # Rechenzeit des Abtast-Threads; Warten auf den GIL kostet die anderen Threads nichts
+        start = time.thread_time()
+        frames = sys._current_frames()
+        names = self._thread_names
+        if any(ident not in names for ident in frames):
+            names = self._thread_names = {thread.ident: thread.name for thread in threading.enumerate()}
+        labels = self._labels
+        idle = self._idle_codes
+        max_depth = self.max_depth
+        collected = []
+        for ident, frame in frames.items():
+            if ident == own:
+                continue
+            codes = []
+            while frame is not None and len(codes) < max_depth:
+                code = frame.f_code
+                key = id(code)
+                if key not in labels:
+                    # Hash eines Codeobjekts ist teuer (Inhalt), deshalb Schlüssel id(code);
+                    # _codes hält die Objekte am Leben, damit keine id doppelt vergeben wird
+                    filename = os.path.basename(code.co_filename)
+                    labels[key] = f'{code.co_name} ({filename}:{code.co_firstlineno})'
+                    self._codes[key] = code
+                    if code.co_name in self.IDLE_FUNCTIONS.get(filename, ()):
+                        idle.add(key)
+                codes.append(key)
+                frame = frame.f_back
+            if not self.include_idle and codes and codes[0] in idle:
+                self.stats['idle_skipped'] += 1
+                continue
+            codes.append(names.get(ident, f'thread-{ident}'))
+            codes.reverse()
+            collected.append(tuple(codes))
+        del frames
+        with self._lock:
+            stacks = self._stacks
+            for key in collected:
+                if key in stacks:
+                    stacks[key] += 1
+                elif len(stacks) < self.max_stacks:
+                    stacks[key] = 1
+                else:
+                    overflow = (key[0], TRUNCATED)
+                    stacks[overflow] = stacks.get(overflow, 0) + 1
+                    self.stats['truncated'] += 1
+            self.stats['samples'] += 1
+            self.stats['stacks_recorded'] += len(collected)
+        return time.thread_time() - start
+
+    # Ausgabe
+
+    def _label(self, item) -> str:
+        return item if isinstance(item, str) else self._labels.get(item, '?')
+
+    def _snapshot(self) -> List[tuple]:
+        with self._lock:
+            return list(self._stacks.items())
+
+    def folded(self, thread: Optional[str] = None) -> str:
+        """Gefaltete Stacks, eine Zeile 'thread;f1;f2;... Anzahl' je Stack."""
+        lines = []
+        for key, count in self._snapshot():
+            if thread is not None and key[0] != thread:
+                continue
+            frames = ';'.join(self._label(item).replace(';', ',') for item in key[1:])
+            lines.append(f'{key[0]};{frames} {count}')
+        lines.sort()
+        return '\n'.join(lines) + ('\n' if lines else '')
+
+    def top(self, limit: int = 20, thread: Optional[str] = None) -> List[Dict[str, Any]]:
+        """Funktionen nach Eigenanteil (Blatt des Stacks) mit Gesamtanteil (irgendwo im Stack)."""
+        own: Dict[str, int] = {}
+        total: Dict[str, int] = {}
+        samples = 0
+        for key, count in self._snapshot():
+            if thread is not None and key[0] != thread:
+                continue
+            samples += count
+            frames = [self._label(item) for item in key[1:]]
+            if frames:
+                own[frames[-1]] = own.get(frames[-1], 0) + count
+            for label in set(frames):
+                total[label] = total.get(label, 0) + count
+        ranked = sorted(total, key=lambda label: (own.get(label, 0), total[label]), reverse=True)
+        return [{'function': label, 'self': own.get(label, 0), 'total': total[label],
+                 'self_share': round(own.get(label, 0) / samples, 4) if samples else 0.0,
+                 'total_share': round(total[label] / samples, 4) if samples else 0.0}
+                for label in ranked[:limit]]
+
+    def overhead(self) -> float:
+        """Anteil der Wanduhrzeit, in der der Abtast-Thread gerechnet hat."""
+        elapsed = self.stats['elapsed']
+        return self.stats['sample_time'] / elapsed if elapsed > 0 else 0.0
+
+    def get_status(self) -> Dict[str, Any]:
+        with self._lock:
+            stacks = len(self._stacks)
+            threads = sorted({key[0] for key in self._stacks})
+        stats = dict(self.stats)
+        stats['sample_time'] = round(stats['sample_time'], 4)
+        stats['elapsed'] = round(stats['elapsed'], 3)
+        return {
+            'running': self.running,
+            'rate': self.rate,
+            'current_rate': self.current_rate,
+            'duration': self.duration,
+            'max_overhead': self.max_overhead,
+            'overhead': round(self.overhead(), 5),
+            'stacks': stacks,
+            'threads': threads,
+            **stats
+        }
+
+def install_profiler_routes(app, profiler: SamplingProfiler) -> None:
+    """
+    Registriert die Profiler-Endpunkte an einer Flask-App:
+      POST /api/profile/start             {"rate": 100, "duration": 60, "reset": true}
+      POST /api/profile/stop
+      POST /api/profile/reset
+      GET  /api/profile/status            Rate, Aufwand, Abtastungen, Threads
+      GET  /api/profile/folded?thread=    gefaltete Stacks (flamegraph.pl, speedscope)
+      GET  /api/profile/top?limit=20      Funktionen nach Eigen-/Gesamtanteil
+    """
+    from flask import request, jsonify, Response
+
+    def profile_start():
+        data = request.get_json(silent=True) or {}
+        try:
+            rate = float(data['rate']) if 'rate' in data else None
+            duration = float(data['duration']) if 'duration' in data else None
+        except (TypeError, ValueError):
+            return jsonify({'error': 'rate und duration müssen Zahlen sein'}), 400
+        if not profiler.start(rate, duration, reset=data.get('reset', True)):
+            return jsonify({'error': 'Profiler läuft bereits'}), 409
+        return jsonify(profiler.get_status())
+
+    def profile_stop():
+        profiler.stop()
+        return jsonify(profiler.get_status())
+
+    def profile_reset():
+        profiler.reset()
+        return jsonify(profiler.get_status())
+
+    def profile_status():
+        return jsonify(profiler.get_status())
+
+    def profile_folded():
+        body = profiler.folded(request.args.get('thread'))
+        return Response(body, mimetype='text/plain', headers={
+            'Content-Disposition': f'attachment; filename=profile-{time.strftime("%Y%m%d-%H%M%S")}.folded'})
+
+    def profile_top():
+        limit = request.args.get('limit', default=20, type=int)
+        return jsonify({'samples': profiler.stats['samples'],
+                        'functions': profiler.top(limit, request.args.get('thread'))})
+
+    app.add_url_rule('/api/profile/start', 'profile_start', profile_start, methods=['POST'])
+    app.add_url_rule('/api/profile/stop', 'profile_stop', profile_stop, methods=['POST'])
+    app.add_url_rule('/api/profile/reset', 'profile_reset', profile_reset, methods=['POST'])
+    app.add_url_rule('/api/profile/status', 'profile_status', profile_status)
+    app.add_url_rule('/api/profile/folded', 'profile_folded', profile_folded)
+    app.add_url_rule('/api/profile/top', 'profile_top', profile_top)
+
+# Globaler Profiler
+_profiler: Optional[SamplingProfiler] = None
+
+def get_profiler(config: Optional[Dict] = None) -> SamplingProfiler:
+    """Gibt den globalen SamplingProfiler zurück (Konfiguration nur beim ersten Aufruf)."""
+    global _profiler
+    if _profiler is None:
+        _profiler = SamplingProfiler(config)
+    return _profiler
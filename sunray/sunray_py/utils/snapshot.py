@@ -0,0 +1,100 @@
+import threading
+import time
+from types import MappingProxyType
+from typing import Any, Dict, Mapping, NamedTuple, Optional
+
+class Snapshot(NamedTuple):
+    """Unveränderlicher Zustand eines Regelzyklus."""
+    version: int
+    timestamp: float
+    data: Mapping[str, Any]
+
+    def age(self) -> float:
+        """Sekunden seit der Veröffentlichung (monotone Uhr)."""
+        return time.monotonic() - self.timestamp
+
+def _freeze(value: Any) -> Any:
+    """Kopiert Dictionaries und Listen in schreibgeschützte Gegenstücke."""
+    if isinstance(value, dict):
+        return MappingProxyType({k: _freeze(v) for k, v in value.items()})
+    if isinstance(value, list):
+        return tuple(_freeze(v) for v in value)
+    return value
+
+def thaw(value: Any) -> Any:
+    """Wandelt einen eingefrorenen Snapshot wieder in dict/list (z.B. für jsonify)."""
+    if isinstance(value, Mapping):
+        return {k: thaw(v) for k, v in value.items()}
+    if isinstance(value, tuple):
+        return [thaw(v) for v in value]
+    return value
+
+class SnapshotBuffer:
+    """
+    Versionierter Telemetrie-Snapshot: die Regelschleife veröffentlicht einmal pro
+    Tick, HTTP- und MQTT-Leser lesen ohne Lock.
+
+    Funktioniert wie ein Doppelpuffer: publish() baut einen vollständig neuen,
+    eingefrorenen Snapshot und tauscht anschließend nur die Referenz aus (unter
+    CPython atomar). Leser erhalten damit immer einen konsistenten Stand und
+    greifen nie auf I2C oder die serielle GPS-Schnittstelle zu.
+    Verwendung:
+      snapshots = get_telemetry_snapshot()
+      snapshots.publish({'imu': imu_data, 'gps': gps_data})   # Regelschleife
+      snap = snapshots.read(); snap.data['gps']                # beliebiger Thread
+    """
+    def __init__(self):
+        self._current = Snapshot(0, time.monotonic(), MappingProxyType({}))
+        self._cond = threading.Condition()
+        self._waiters = 0
+
+    def publish(self, data: Dict[str, Any], timestamp: Optional[float] = None) -> int:
+        """Veröffentlicht einen neuen Snapshot und gibt dessen Version zurück."""
+        snapshot = Snapshot(self._current.version + 1,
+                            time.monotonic() if timestamp is None else timestamp,
+                            _freeze(data))
+        self._current = snapshot
+        # Der Schreiber nimmt das Lock nur, wenn tatsächlich jemand wartet
+        if self._waiters:
+            with self._cond:
+                self._cond.notify_all()
+        return snapshot.version
+
+    def read(self) -> Snapshot:
+        """Aktueller Snapshot (lock-frei)."""
+        return self._current
+
+    @property
+    def version(self) -> int:
+        return self._current.version
+
+    def get(self, key: str, default: Any = None) -> Any:
+        """Abschnitt des aktuellen Snapshots, z.B. get('gps', {})."""
+        return self._current.data.get(key, default)
+
+    def wait_newer(self, version: int, timeout: float) -> Snapshot:
+        """Wartet höchstens timeout Sekunden auf einen Snapshot neuer als version."""
+        snapshot = self._current
+        if snapshot.version > version:
+            return snapshot
+        deadline = time.monotonic() + timeout
+        with self._cond:
+            self._waiters += 1
+            try:
+                while self._current.version <= version:
+                    remaining = deadline - time.monotonic()
+                    if remaining <= 0:
+                        break
+                    self._cond.wait(remaining)
+            finally:
+                self._waiters -= 1
+        return self._current
+
+_telemetry_snapshot: Optional[SnapshotBuffer] = None
+
+def get_telemetry_snapshot() -> SnapshotBuffer:
+    """Gibt den globalen Telemetrie-Snapshot zurück."""
+    global _telemetry_snapshot
+    if _telemetry_snapshot is None:
+        _telemetry_snapshot = SnapshotBuffer()
+    return _telemetry_snapshot
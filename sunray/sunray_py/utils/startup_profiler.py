@@ -0,0 +1,113 @@
+import os
+import threading
+import time
+from contextlib import contextmanager
+from typing import Dict, List, Optional
+
+def _process_start_monotonic() -> float:
+    """
+    Schätzt den Prozessstart auf der monotonen Uhr (Linux: /proc/self/stat).
+    Fällt auf den Import-Zeitpunkt dieses Moduls zurück.
+    """
+    try:
+        with open('/proc/self/stat', 'r') as f:
+            fields = f.read().rsplit(')', 1)[1].split()
+        start_ticks = int(fields[19])  # Feld 22 (starttime), ab Feld 3 gezählt
+        with open('/proc/uptime', 'r') as f:
+            uptime = float(f.read().split()[0])
+        age = uptime - start_ticks / os.sysconf('SC_CLK_TCK')
+        return time.monotonic() - max(0.0, age)
+    except (OSError, ValueError, IndexError):
+        return time.monotonic()
+
+class StartupTimeline:
+    """
+    Zeitleiste des Systemstarts.
+    Erfasst Phasen (Start/Ende, Thread) und Meilensteine relativ zum Prozessstart.
+    Verwendung:
+      timeline = get_startup_timeline()
+      with timeline.phase('hardware'):
+          hw = get_hardware_manager()
+      timeline.mark('mowing_ready')
+      print(timeline.report())
+    """
+    def __init__(self, origin: Optional[float] = None):
+        self.origin = origin if origin is not None else _process_start_monotonic()
+        self._lock = threading.Lock()
+        self._phases: List[Dict] = []
+        self._marks: Dict[str, float] = {}
+
+    def now(self) -> float:
+        """Sekunden seit Prozessstart."""
+        return time.monotonic() - self.origin
+
+    @contextmanager
+    def phase(self, name: str):
+        """Misst einen Startabschnitt. Fehler werden vermerkt und weitergereicht."""
+        start = self.now()
+        error = None
+        try:
+            yield
+        except Exception as e:
+            error = str(e)
+            raise
+        finally:
+            self.record(name, start, self.now(), error)
+
+    def record(self, name: str, start: float, end: float, error: Optional[str] = None) -> None:
+        """Trägt eine bereits gemessene Phase ein."""
+        entry = {
+            'name': name,
+            'start': start,
+            'end': end,
+            'duration': end - start,
+            'thread': threading.current_thread().name,
+            'error': error
+        }
+        with self._lock:
+            self._phases.append(entry)
+
+    def mark(self, name: str) -> float:
+        """Setzt einen Meilenstein (nur der erste Aufruf zählt)."""
+        t = self.now()
+        with self._lock:
+            self._marks.setdefault(name, t)
+            return self._marks[name]
+
+    def get_mark(self, name: str) -> Optional[float]:
+        with self._lock:
+            return self._marks.get(name)
+
+    def to_dict(self) -> Dict:
+        """Zeitleiste als serialisierbares Dictionary (z.B. für die Web-API)."""
+        with self._lock:
+            phases = sorted(self._phases, key=lambda p: p['start'])
+            return {
+                'phases': [dict(p) for p in phases],
+                'marks': dict(self._marks),
+                'elapsed': self.now()
+            }
+
+    def report(self) -> str:
+        """Formatierte Zeitleiste für die Konsole."""
+        data = self.to_dict()
+        lines = ["Startzeitleiste (Sekunden seit Prozessstart):"]
+        for p in data['phases']:
+            status = f"  FEHLER: {p['error']}" if p['error'] else ""
+            lines.append(
+                f"  {p['start']:7.3f} - {p['end']:7.3f}  ({p['duration']:6.3f}s)  "
+                f"{p['name']:<28} [{p['thread']}]{status}"
+            )
+        for name, t in sorted(data['marks'].items(), key=lambda kv: kv[1]):
+            lines.append(f"  {t:7.3f}  * {name}")
+        return "\n".join(lines)
+
+# Globale Zeitleiste
+_timeline = None
+
+def get_startup_timeline() -> StartupTimeline:
+    """Gibt die globale Startzeitleiste zurück."""
+    global _timeline
+    if _timeline is None:
+        _timeline = StartupTimeline()
+    return _timeline
@@ -0,0 +1,394 @@
+"""
+Trace-Aufzeichnung im Chrome-Trace-Format (chrome://tracing, https://ui.perfetto.dev).
+
+Histogramme (utils/metrics.py) zeigen, wie oft ein Regelzyklus zu lang war, aber nicht
+warum. Der TraceRecorder schreibt dauerhaft Spans (Name, Beginn, Dauer) in einen
+Ringpuffer je Thread; ausgegeben wird nur auf Anforderung:
+- per API (GET /api/trace, POST /api/trace/dump)
+- automatisch, wenn ein Regelzyklus seine Deadline überschreitet (höchstens alle
+  min_dump_interval Sekunden, Schreiben im Hintergrund)
+Die Ausgabe enthält die letzten `window` Sekunden aller Threads.
+
+Jeder Span wird beim Beenden als ein vollständiges Ereignis ('ph': 'X') abgelegt;
+der Thread schreibt nur in seine eigene deque, ein Lock ist nicht nötig. Puffer
+beendeter Threads (z.B. je Anfrage beim Flask-Entwicklungsserver) werden beim
+Export verworfen, sobald ihr letztes Ereignis außerhalb des Zeitfensters liegt.
+
+Verwendung:
+  tracer = get_tracer(config.get('trace', {}))
+  with tracer.span('planner.plan', 'planner'): ...
+  @traced('pico.read', 'io')
+  def read_sensor_data(self): ...
+
+  tick = tracer.begin_tick()               # Regelschleife
+  tick.stage('sensors'); ...; tick.stage('operation'); ...
+  tracer.check_deadline(tick.end())        # Dump bei Deadline-Überschreitung
+"""
+
+import functools
+import json
+import math
+import os
+import re
+import threading
+import time
+import weakref
+from collections import deque
+from typing import Any, Dict, List, Optional
+
+# Längster exportierbarer Zeitraum in Sekunden (API-Parameter seconds)
+MAX_EXPORT_SECONDS = 3600.0
+_REASON_PATTERN = re.compile(r'[A-Za-z0-9_-]{1,40}')
+
+def export_seconds(value: Any) -> Optional[float]:
+    """
+    Prüft den Zeitraum eines Exports (z.B. aus der API): None bleibt None (Standardfenster),
+    sonst eine endliche Zahl > 0, begrenzt auf MAX_EXPORT_SECONDS. Ungültig: ValueError.
+    """
+    if value is None:
+        return None
+    try:
+        seconds = float(value)
+    except (TypeError, ValueError):
+        raise ValueError(f"ungültiger Zeitraum: {value}")
+    if not math.isfinite(seconds) or seconds <= 0:
+        raise ValueError(f"ungültiger Zeitraum: {value}")
+    return min(seconds, MAX_EXPORT_SECONDS)
+
+def valid_reason(reason: Any) -> bool:
+    """Grund eines Dumps wird Teil des Dateinamens: nur [A-Za-z0-9_-], höchstens 40 Zeichen."""
+    return isinstance(reason, str) and _REASON_PATTERN.fullmatch(reason) is not None
+
+class _NullSpan:
+    """Span-Ersatz bei abgeschalteter Aufzeichnung."""
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        return False
+
+_NULL_SPAN = _NullSpan()
+
+class _Span:
+    __slots__ = ('recorder', 'name', 'category', 'args', 'start')
+
+    def __init__(self, recorder: 'TraceRecorder', name: str, category: str, args: Optional[Dict]):
+        self.recorder = recorder
+        self.name = name
+        self.category = category
+        self.args = args
+
+    def __enter__(self):
+        self.start = time.perf_counter()
+        return self
+
+    def __exit__(self, exc_type, exc, tb):
+        if exc_type is not None:
+            self.args = dict(self.args or {}, error=exc_type.__name__)
+        self.recorder.complete(self.name, self.category, self.start, time.perf_counter(), self.args)
+        return False
+
+class Tick:
+    """
+    Ein Regelzyklus mit aufeinanderfolgenden Abschnitten. stage() beendet den
+    vorherigen Abschnitt und beginnt den nächsten, ohne den Code einzurücken.
+    """
+    def __init__(self, recorder: Optional['TraceRecorder'], name: str):
+        self.recorder = recorder
+        self.name = name
+        self.start = time.perf_counter()
+        self._stage: Optional[str] = None
+        self._stage_start = self.start
+
+    def stage(self, name: str) -> None:
+        now = time.perf_counter()
+        if self.recorder is not None and self._stage is not None:
+            self.recorder.complete(self._stage, 'loop', self._stage_start, now)
+        self._stage = name
+        self._stage_start = now
+
+    def end(self, args: Optional[Dict] = None) -> float:
+        """Beendet den Zyklus und gibt seine Dauer in Sekunden zurück."""
+        now = time.perf_counter()
+        if self.recorder is not None:
+            if self._stage is not None:
+                self.recorder.complete(self._stage, 'loop', self._stage_start, now)
+            self.recorder.complete(self.name, 'loop', self.start, now, args)
+        self._stage = None
+        return now - self.start
+
+class TraceRecorder:
+    """
+    Ringpuffer-Aufzeichnung von Spans aller Threads.
+
+    Konfiguration (Abschnitt 'trace' in config.json):
+      enabled: Aufzeichnung aktiv
+      window: Sekunden, die ein Dump umfasst
+      buffer_size: maximale Ereignisse je Thread (ältere werden überschrieben)
+      tick_deadline: Dauer eines Regelzyklus, ab der automatisch gedumpt wird (0 = aus)
+      min_dump_interval: Mindestabstand automatischer Dumps in Sekunden
+      directory: Zielverzeichnis der Trace-Dateien
+      keep_files: Anzahl aufbewahrter Trace-Dateien
+    """
+    def __init__(self, config: Optional[Dict] = None):
+        config = config or {}
+        self.enabled = config.get('enabled', True)
+        self.window = float(config.get('window', 10.0))
+        self.buffer_size = int(config.get('buffer_size', 20000))
+        self.tick_deadline = float(config.get('tick_deadline', 0.25))
+        self.min_dump_interval = float(config.get('min_dump_interval', 60.0))
+        self.directory = config.get('directory', 'traces')
+        self.keep_files = int(config.get('keep_files', 10))
+        self._local = threading.local()
+        self._buffers: List[tuple] = []
+        self._buffers_lock = threading.Lock()
+        self._epoch = time.perf_counter()
+        self._wall_epoch = time.time()
+        self._last_dump = 0.0
+        self._dumping = False
+        self.stats = {'deadline_misses': 0, 'dumps': 0, 'skipped_dumps': 0}
+
+    # Aufzeichnung
+
+    def _buffer(self) -> deque:
+        try:
+            return self._local.buffer
+        except AttributeError:
+            buffer = deque(maxlen=self.buffer_size)
+            self._local.buffer = buffer
+            thread = threading.current_thread()
+            with self._buffers_lock:
+                self._buffers.append((weakref.ref(thread), thread.ident, thread.name, buffer))
+            return buffer
+
+    def _live_buffers(self, since: float) -> list:
+        """Alle Puffer; Puffer beendeter Threads ohne Ereignisse seit `since` werden verworfen."""
+        with self._buffers_lock:
+            kept = []
+            for entry in self._buffers:
+                thread = entry[0]()
+                if thread is None or not thread.is_alive():
+                    records = self._copy(entry[3])
+                    if not records or records[-1][2] + (records[-1][3] or 0.0) < since:
+                        continue
+                kept.append(entry)
+            self._buffers = kept
+            return list(kept)
+
+    def complete(self, name: str, category: str, start: float, end: float,
+                 args: Optional[Dict] = None) -> None:
+        """Legt einen abgeschlossenen Span ab (Zeiten von time.perf_counter())."""
+        if self.enabled:
+            self._buffer().append((name, category, start, end - start, args))
+
+    def instant(self, name: str, category: str = 'event', args: Optional[Dict] = None) -> None:
+        """Zeitpunkt ohne Dauer (z.B. Operationswechsel)."""
+        if self.enabled:
+            self._buffer().append((name, category, time.perf_counter(), None, args))
+
+    def span(self, name: str, category: str = 'app', args: Optional[Dict] = None):
+        """Kontextmanager für einen Span."""
+        if not self.enabled:
+            return _NULL_SPAN
+        return _Span(self, name, category, args)
+
+    def begin_tick(self, name: str = 'tick') -> Tick:
+        return Tick(self if self.enabled else None, name)
+
+    # Ausgabe
+
+    def export(self, seconds: Optional[float] = None) -> Dict[str, Any]:
+        """Die letzten `seconds` (Standard: window) als Chrome-Trace-Dictionary."""
+        since = time.perf_counter() - (seconds if seconds is not None else self.window)
+        pid = os.getpid()
+        # Verworfen wird nur, was auch im Standardfenster nicht mehr liegt
+        buffers = self._live_buffers(min(since, time.perf_counter() - self.window))
+        events: List[Dict[str, Any]] = [
+            {'ph': 'M', 'name': 'process_name', 'pid': pid, 'tid': 0, 'args': {'name': 'sunray'}}
+        ]
+        for _, tid, thread_name, buffer in buffers:
+            records = self._copy(buffer)
+            if not records:
+                continue
+            events.append({'ph': 'M', 'name': 'thread_name', 'pid': pid, 'tid': tid,
+                           'args': {'name': thread_name}})
+            for name, category, start, duration, args in records:
+                if (start + (duration or 0.0)) < since:
+                    continue
+                event = {'name': name, 'cat': category, 'pid': pid, 'tid': tid,
+                         'ts': round((start - self._epoch) * 1e6, 1)}
+                if duration is None:
+                    event.update(ph='i', s='t')
+                else:
+                    event.update(ph='X', dur=round(duration * 1e6, 1))
+                if args:
+                    event['args'] = args
+                events.append(event)
+        return {
+            'traceEvents': events,
+            'displayTimeUnit': 'ms',
+            'otherData': {'start_time': self._wall_epoch, 'exported_at': time.time(),
+                          'window': seconds if seconds is not None else self.window}
+        }
+
+    @staticmethod
+    def _copy(buffer: deque) -> list:
+        # Der schreibende Thread kann während des Kopierens anhängen
+        for _ in range(5):
+            try:
+                return list(buffer)
+            except RuntimeError:
+                continue
+        return []
+
+    def dump(self, reason: str = 'manual', seconds: Optional[float] = None) -> Optional[str]:
+        """Schreibt den Trace als JSON-Datei und gibt den Pfad zurück (None bei Fehler)."""
+        if not valid_reason(reason):
+            reason = re.sub(r'[^A-Za-z0-9_-]', '_', str(reason))[:40] or 'manual'
+        trace = self.export(seconds)
+        trace['otherData']['reason'] = reason
+        try:
+            os.makedirs(self.directory, exist_ok=True)
+            stamp = time.strftime('%Y%m%d-%H%M%S')
+            path = os.path.join(self.directory, f'trace-{stamp}-{reason}.json')
+            with open(path, 'w') as f:
+                json.dump(trace, f, separators=(',', ':'))
+            self.stats['dumps'] += 1
+            self._prune_files()
+            print(f"Trace: {path} geschrieben ({len(trace['traceEvents'])} Ereignisse, Grund: {reason})")
+            return path
+        except OSError as e:
+            print(f"Trace: Schreiben fehlgeschlagen: {e}")
+            return None
+
+    def check_deadline(self, duration: float, args: Optional[Dict] = None) -> bool:
+        """
+        Prüft die Dauer eines Regelzyklus. Bei Überschreitung wird im Hintergrund
+        gedumpt (Rate-begrenzt); gibt True bei Deadline-Überschreitung zurück.
+        """
+        if not self.enabled or self.tick_deadline <= 0 or duration <= self.tick_deadline:
+            return False
+        self.stats['deadline_misses'] += 1
+        now = time.monotonic()
+        if self._dumping or now - self._last_dump < self.min_dump_interval:
+            self.stats['skipped_dumps'] += 1
+            return True
+        self._last_dump = now
+        self._dumping = True
+        self.instant('deadline_miss', 'loop', dict(args or {}, duration_ms=round(duration * 1000, 1)))
+
+        def write():
+            try:
+                self.dump('deadline')
+            finally:
+                self._dumping = False
+
+        threading.Thread(target=write, name='trace-dump', daemon=True).start()
+        return True
+
+    def list_files(self) -> List[Dict[str, Any]]:
+        try:
+            names = sorted(n for n in os.listdir(self.directory)
+                           if n.startswith('trace-') and n.endswith('.json'))
+        except OSError:
+            return []
+        return [{'name': n, 'size': os.path.getsize(os.path.join(self.directory, n))} for n in names]
+
+    def _prune_files(self) -> None:
+        files = self.list_files()
+        for entry in files[:max(0, len(files) - self.keep_files)]:
+            try:
+                os.remove(os.path.join(self.directory, entry['name']))
+            except OSError:
+                pass
+
+    def get_status(self) -> Dict[str, Any]:
+        threads = [{'tid': tid, 'name': name, 'events': len(buffer)}
+                   for _, tid, name, buffer in self._live_buffers(time.perf_counter() - self.window)]
+        return {
+            'enabled': self.enabled,
+            'window': self.window,
+            'buffer_size': self.buffer_size,
+            'tick_deadline': self.tick_deadline,
+            'threads': threads,
+            'files': self.list_files(),
+            **self.stats
+        }
+
+def traced(name: str, category: str = 'app'):
+    """Dekorator: zeichnet jeden Aufruf als Span des globalen Recorders auf."""
+    def decorator(function):
+        @functools.wraps(function)
+        def wrapper(*args, **kwargs):
+            with get_tracer().span(name, category):
+                return function(*args, **kwargs)
+        return wrapper
+    return decorator
+
+def install_trace_routes(app, recorder: TraceRecorder) -> None:
+    """
+    Registriert die Trace-Endpunkte an einer Flask-App und zeichnet jede Anfrage als Span auf:
+      GET  /api/trace?seconds=10          Trace der letzten Sekunden herunterladen
+      POST /api/trace/dump                Trace als Datei im Trace-Verzeichnis ablegen
+      GET  /api/trace/status              Puffer, Deadline-Überschreitungen, Dateien
+      GET  /api/trace/files/<name>        gespeicherte Trace-Datei herunterladen
+    """
+    from flask import request, jsonify, g, send_from_directory, Response
+
+    @app.before_request
+    def _trace_start():
+        g.trace_start = time.perf_counter()
+
+    @app.after_request
+    def _trace_record(response):
+        start = g.pop('trace_start', None)
+        if start is not None:
+            rule = request.url_rule.rule if request.url_rule else request.path
+            recorder.complete(f'{request.method} {rule}', 'http', start, time.perf_counter(),
+                              {'status': response.status_code})
+        return response
+
+    def trace_download():
+        try:
+            seconds = export_seconds(request.args.get('seconds'))
+        except ValueError as e:
+            return jsonify({'error': str(e)}), 400
+        body = json.dumps(recorder.export(seconds), separators=(',', ':'))
+        return Response(body, mimetype='application/json', headers={
+            'Content-Disposition': f'attachment; filename=trace-{time.strftime("%Y%m%d-%H%M%S")}.json'})
+
+    def trace_dump():
+        data = request.get_json(silent=True) or {}
+        reason = data.get('reason', 'api')
+        if not valid_reason(reason):
+            return jsonify({'error': 'reason: nur A-Z, a-z, 0-9, _ und -, höchstens 40 Zeichen'}), 400
+        try:
+            seconds = export_seconds(data.get('seconds'))
+        except ValueError as e:
+            return jsonify({'error': f'seconds: {e}'}), 400
+        path = recorder.dump(reason, seconds)
+        if path is None:
+            return jsonify({'error': 'Trace konnte nicht geschrieben werden'}), 500
+        return jsonify({'file': os.path.basename(path),
+                        'url': f'/api/trace/files/{os.path.basename(path)}'})
+
+    def trace_status():
+        return jsonify(recorder.get_status())
+
+    def trace_file(name):
+        return send_from_directory(os.path.abspath(recorder.directory), name, as_attachment=True)
+
+    app.add_url_rule('/api/trace', 'trace_download', trace_download)
+    app.add_url_rule('/api/trace/dump', 'trace_dump', trace_dump, methods=['POST'])
+    app.add_url_rule('/api/trace/status', 'trace_status', trace_status)
+    app.add_url_rule('/api/trace/files/<path:name>', 'trace_file', trace_file)
+
+# Globaler Recorder
+_tracer: Optional[TraceRecorder] = None
+
+def get_tracer(config: Optional[Dict] = None) -> TraceRecorder:
+    """Gibt den globalen TraceRecorder zurück (Konfiguration nur beim ersten Aufruf)."""
+    global _tracer
+    if _tracer is None:
+        _tracer = TraceRecorder(config)
+    return _tracer
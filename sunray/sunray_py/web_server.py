@@ -15,9 +15,10 @@ Author: [Ihr Name]
 Project: https://github.com/Starsurfer78/sunray-mower
 """
 
-from flask import Flask, request, jsonify, send_from_directory
+from flask import Flask, request, jsonify, send_from_directory, Response
 from flask_cors import CORS
 import os
+import sys
 import psutil
 import json
 import time
@@ -25,6 +26,14 @@ from datetime import datetime
 import random
 import threading
 from typing import Dict, List, Any
+from communication.event_stream import get_event_hub, subscribe_from_args, SSE_HEADERS
+from communication.map_changes import get_map_changes, install_change_routes
+from web_serving import ResponseCache, get_content_versions, get_worker_slots, file_version, serve
+from navigation.plan_codec import iter_plan_chunks, plan_size
+from navigation.planning_jobs import get_planning_jobs, simulate_planning
+from heatmap_tiles import get_heatmap_tiles, install_heatmap_routes
+from utils.metrics import get_metrics, install_metrics_routes
+from utils.trace import get_tracer, install_trace_routes
 
 app = Flask(__name__, static_folder='static', static_url_path='/static')
 CORS(app)  # Enable CORS for all routes
@@ -53,6 +62,44 @@ current_planning_status = {
 
 planning_lock = threading.Lock()
 
+# Zuletzt erzeugter Plan (AdvancedPathPlanner.export_plan()-Format) für /api/advanced_planning/plan.*
+current_plan_segments: List[Dict[str, Any]] = []
+# Simulierte dynamische Hindernisse (Quadrate als Punktlisten wie Polygon.to_list())
+mock_obstacles: List[List[Dict[str, float]]] = []
+
+# Planung läuft als Auftrag in einem eigenen Prozess (simulierte Planungsfunktion)
+planning_jobs = get_planning_jobs({'default_deadline': 30.0}, simulate_planning)
+
+# Push-Kanal für die Web-Oberfläche (ersetzt das Polling der Seiten)
+event_hub = get_event_hub()
+# SSE-Streams und Long-Polls teilen sich ein Kontingent des Worker-Pools
+worker_slots = get_worker_slots()
+_mock_publisher_started = False
+
+# Inhaltsversionen für ETags und den Antwort-Cache teurer Endpunkte
+content_versions = get_content_versions()
+response_cache = ResponseCache(content_versions)
+
+def notify_change(kind: str, data: Dict[str, Any]) -> None:
+    """Erhöht die Inhaltsversion (invalidiert Cache/ETags) und meldet die Änderung per Push-Kanal."""
+    content_versions.bump(kind)
+    event_hub.publish(kind, data)
+
+def _load_zones_file() -> List[Dict[str, Any]]:
+    try:
+        with open('zones.json', 'r') as f:
+            return json.load(f)
+    except (FileNotFoundError, json.JSONDecodeError):
+        return []
+
+# Versionierte Zonen-, Hindernis- und Plan-Diffs für verbundene Clients (/api/changes)
+map_changes = get_map_changes()
+map_changes.track('zones')
+map_changes.track('obstacles')
+map_changes.track('plan', mode='sequence')
+map_changes.update('zones', _load_zones_file())
+install_change_routes(app, map_changes)
+
 # Mock data for demonstration
 mock_sensor_data = {
     'battery': {'level': 85, 'voltage': 12.6, 'charging': False},
@@ -66,6 +113,15 @@ mock_robot_status = {
     'position': {'x': 125, 'y': 75, 'heading': 90}
 }
 
+# Metriken im OpenMetrics-Format (/metrics), Messwerte aus den Mock-Sensordaten
+metrics = get_metrics()
+install_metrics_routes(app, metrics)
+metrics.gauge('sunray_battery_voltage', 'Batteriespannung', fn=lambda: mock_sensor_data['battery']['voltage'])
+metrics.gauge('sunray_gps_satellites', 'Sichtbare Satelliten', fn=lambda: mock_sensor_data['gps']['satellites'])
+# Trace-Aufzeichnung der Anfragen und der simulierten Abläufe (/api/trace)
+tracer = get_tracer()
+install_trace_routes(app, tracer)
+
 # Web Interface Routes
 @app.route('/')
 def index():
@@ -82,6 +138,91 @@ def path_planning():
     """Pfadplanungsseite."""
     return send_from_directory('static', 'path_planning.html')
 
+def _mock_telemetry_snapshot() -> Dict[str, Any]:
+    """Simulierter Telemetrie-Snapshot im Format der MQTT-Telemetrie."""
+    mock_sensor_data['battery']['level'] = max(20, min(100, mock_sensor_data['battery']['level'] + random.randint(-1, 1)))
+    mock_sensor_data['imu']['heading'] = (mock_sensor_data['imu']['heading'] + random.randint(-5, 5)) % 360
+    mock_robot_status['position']['heading'] = mock_sensor_data['imu']['heading']
+    return {
+        **mock_sensor_data,
+        'gps': {
+            **mock_sensor_data['gps'],
+            'latitude': mock_sensor_data['gps']['latitude'] + random.uniform(-0.0005, 0.0005),
+            'longitude': mock_sensor_data['gps']['longitude'] + random.uniform(-0.0005, 0.0005),
+            'accuracy': random.uniform(0.02, 0.05)
+        },
+        'robot': mock_robot_status,
+        'timestamp': datetime.now().isoformat()
+    }
+
+# Heatmap-Kacheln, gefüllt von einer simulierten Mähfahrt (Bahnen über 20 x 12 m)
+heatmap = get_heatmap_tiles({'max_zoom': 5})
+heatmap.set_origin(mock_sensor_data['gps']['latitude'], mock_sensor_data['gps']['longitude'])
+install_heatmap_routes(app, heatmap)
+_mock_mower = {'x': 0.0, 'lane': 0}
+
+def _mock_mowing_step(steps: int = 10, step: float = 0.05, lane_width: float = 0.25) -> None:
+    """Fährt die simulierte Mähbahn weiter; schlechter GPS-Empfang und dichtes Gras unter einem Baum."""
+    for _ in range(steps):
+        lane = _mock_mower['lane']
+        _mock_mower['x'] += step
+        if _mock_mower['x'] > 20.0:
+            _mock_mower['x'] = 0.0
+            _mock_mower['lane'] = (lane + 1) % 48
+        x = _mock_mower['x'] if lane % 2 == 0 else 20.0 - _mock_mower['x']
+        y = lane * lane_width
+        under_tree = (x - 14.0) ** 2 + (y - 6.0) ** 2 < 9.0
+        heatmap.add_sample(
+            x, y, mowing=True,
+            gps_accuracy=random.uniform(0.12, 0.3) if under_tree else random.uniform(0.01, 0.04),
+            mow_current=random.uniform(2.0, 2.8) if under_tree else random.uniform(0.8, 1.4)
+        )
+
+def _mock_telemetry_loop():
+    """Veröffentlicht Telemetrie, solange mindestens ein Client verbunden ist."""
+    while True:
+        tick = tracer.begin_tick('mock_loop')
+        tick.stage('telemetry')
+        if event_hub.has_subscribers('telemetry'):
+            event_hub.publish('telemetry', _mock_telemetry_snapshot(), coalesce=True)
+        tick.stage('heatmap')
+        if event_hub.has_subscribers('heatmap'):
+            version = heatmap.version
+            _mock_mowing_step()
+            if heatmap.version != version:
+                event_hub.publish('heatmap', {'version': heatmap.version}, coalesce=True)
+        tracer.check_deadline(tick.end())
+        time.sleep(0.5)
+
+@app.route('/api/stream')
+def api_stream():
+    """Server-Sent Events: Telemetrie sowie Plan-, Zonen- und Kartierungsänderungen."""
+    global _mock_publisher_started
+    if not _mock_publisher_started:
+        _mock_publisher_started = True
+        threading.Thread(target=_mock_telemetry_loop, daemon=True).start()
+    if not worker_slots.try_acquire():
+        return jsonify({'error': 'Keine freien Worker für Streams'}), 503, {'Retry-After': '5'}
+    client = subscribe_from_args(event_hub, request.args)
+    if client is None:
+        worker_slots.release()
+        return jsonify({'error': 'Zu viele Stream-Clients'}), 503
+    return worker_slots.hold(Response(event_hub.stream(client), mimetype='text/event-stream',
+                                      headers=SSE_HEADERS))
+
+@app.route('/api/stream/stats')
+def api_stream_stats():
+    """Statistik des Push-Kanals (Clients, gesendete und verworfene Nachrichten)."""
+    return jsonify({**event_hub.get_statistics(), 'worker_slots': worker_slots.get_statistics()})
+
+@app.route('/api/cache/stats')
+def api_cache_stats():
+    """Trefferquote des Antwort-Caches und aktuelle Inhaltsversionen."""
+    return jsonify({
+        **response_cache.get_statistics(),
+        'versions': {kind: content_versions.get(kind) for kind in ('plan', 'zones', 'mapping')}
+    })
+
 @app.route('/api/status')
 def api_status():
     """API Status für Verbindungscheck."""
@@ -188,6 +329,7 @@ def get_current_map():
         return jsonify({'error': str(e)}), 500
 
 @app.route('/api/system/stats')
+@response_cache.cached(ttl=2.0)
 def get_system_stats():
     """Gibt System-Statistiken zurück."""
     try:
@@ -301,6 +443,7 @@ def camera_stream():
     })
 
 @app.route('/api/zones', methods=['GET', 'POST', 'DELETE'])
+@response_cache.cached('zones', extra_version=lambda: file_version('zones.json'))
 def manage_zones():
     """Verwaltet Mähzonen."""
     zones_file = 'zones.json'
@@ -348,6 +491,8 @@ def manage_zones():
             with open(zones_file, 'w') as f:
                 json.dump(zones, f, indent=2)
             
+            notify_change('zones', {'action': 'created', 'zone': zone})
+            map_changes.update('zones', zones)
             return jsonify({'status': 'created', 'zone': zone})
         except Exception as e:
             return jsonify({'error': str(e)}), 500
@@ -370,6 +515,8 @@ def manage_zones():
             with open(zones_file, 'w') as f:
                 json.dump(zones, f, indent=2)
             
+            notify_change('zones', {'action': 'deleted', 'zone_id': zone_id})
+            map_changes.update('zones', zones)
             return jsonify({'status': 'deleted', 'zone_id': zone_id})
         except Exception as e:
             return jsonify({'error': str(e)}), 500
@@ -377,55 +524,112 @@ def manage_zones():
 # Advanced Path Planning API Endpoints
 @app.route('/api/advanced_planning/start', methods=['POST'])
 def start_advanced_planning():
-    """Startet die erweiterte Pfadplanung."""
+    """
+    Startet die erweiterte Pfadplanung als Auftrag (navigation/planning_jobs.py).
+    Antwortet sofort mit der Auftrags-ID; Fortschritt kommt über /api/stream
+    ('planning_progress'), der fertige Plan als 'plan'-Ereignis.
+    """
     try:
         data = request.get_json() or {}
         strategy = data.get('strategy', 'hybrid')
         pattern = data.get('pattern', 'lines')
-        max_segment_length = data.get('max_segment_length', 10.0)
-        obstacle_detection_radius = data.get('obstacle_detection_radius', 1.0)
-        heuristic_weight = data.get('heuristic_weight', 1.0)
+        job_request = {
+            'strategy': strategy,
+            'pattern': pattern,
+            'total_segments': data.get('total_segments') or random.randint(15, 50),
+            'points_per_segment': data.get('points_per_segment', 50),
+            # Simuliere Planungszeit
+            'duration': data.get('duration', random.uniform(0.5, 2.0))
+        }
+        job_id = planning_jobs.submit(job_request, deadline=data.get('deadline'), replace=True)
+        if job_id is None:
+            return jsonify({'success': False, 'error': 'Warteschlange voll'}), 429
         
         with planning_lock:
-            start_time = time.time()
-            
-            # Simuliere Planungszeit
-            planning_time = random.uniform(0.5, 2.0)
-            time.sleep(planning_time)
-            
-            # Update planning status
             current_planning_status.update({
                 'strategy': strategy,
+                'pattern': pattern,
+                'status': 'planning',
+                'progress': 0.0,
+                'job_id': job_id
+            })
+            status = current_planning_status.copy()
+        
+        return jsonify({
+            'success': True,
+            'job_id': job_id,
+            'status': status,
+            'status_url': f'/api/planning/jobs/{job_id}',
+            'message': f'Planung mit {strategy} Strategie gestartet'
+        }), 202
+    except Exception as e:
+        return jsonify({'success': False, 'error': str(e)}), 500
+
+def _on_planning_job(job: Dict[str, Any]) -> None:
+    """
+    Leitet den Auftragsfortschritt an den Push-Kanal weiter und übernimmt fertige Pläne
+    (der Demo-Server hat keine Regelschleife, der Dienst-Thread ist die sichere Stelle).
+    """
+    state = job['state']
+    event_hub.publish('planning_progress' if state == 'running' else 'planning', job,
+                      coalesce=state == 'running')
+    if state in ('queued', 'running'):
+        with planning_lock:
+            if current_planning_status.get('job_id') == job['job_id']:
+                current_planning_status['progress'] = job['progress']
+        return
+    
+    finished = planning_jobs.take_finished_plan() if state == 'completed' else None
+    with planning_lock:
+        if current_planning_status.get('job_id') != job['job_id']:
+            return
+        planning_time = job['runtime'] or 0.0
+        planning_stats['total_plans'] += 1
+        if finished:
+            current_plan_segments[:] = finished.result['plan']
+            current_planning_status.update({
                 'status': 'completed',
                 'progress': 1.0,
-                'total_segments': random.randint(15, 50),
+                'total_segments': len(current_plan_segments),
                 'current_segment': 0,
-                'total_planned_distance': random.uniform(100, 500),
+                'total_planned_distance': finished.result.get('total_planned_distance', 0.0),
                 'last_planning_time': planning_time
             })
-            
-            # Update statistics
-            planning_stats['total_plans'] += 1
             planning_stats['total_time'] += planning_time
             planning_stats['successful_plans'] += 1
             planning_stats['last_planning_time'] = planning_time
-            
-            # Generate mock path
-            path = generate_mock_path(pattern, current_planning_status['total_segments'])
-            
-            return jsonify({
-                'success': True,
-                'status': current_planning_status.copy(),
-                'path': path,
-                'planning_time': planning_time,
-                'message': f'Planung mit {strategy} Strategie erfolgreich'
-            })
-            
-    except Exception as e:
-        with planning_lock:
-            current_planning_status['status'] = 'error'
-            planning_stats['total_plans'] += 1
-        return jsonify({'success': False, 'error': str(e)}), 500
+        else:
+            current_planning_status['status'] = 'stopped' if state == 'cancelled' else 'error'
+        status = current_planning_status.copy()
+        segments = list(current_plan_segments)
+    
+    if finished:
+        map_changes.update('plan', segments)
+        path = generate_mock_path(status.get('pattern', 'lines'), status['total_segments'])
+        notify_change('plan', {'action': 'planned', 'status': status, 'job_id': job['job_id'],
+                               'path': path, 'plan_url': '/api/advanced_planning/plan.bin'})
+    else:
+        notify_change('plan', {'action': state, 'status': status, 'job_id': job['job_id'],
+                               'error': job['error']})
+
+planning_jobs.add_listener(_on_planning_job)
+
+@app.route('/api/planning/jobs', methods=['GET'])
+def list_planning_jobs():
+    """Planungsaufträge und Statistik."""
+    return jsonify({'jobs': planning_jobs.list_jobs(), 'statistics': planning_jobs.get_statistics()})
+
+@app.route('/api/planning/jobs/<job_id>', methods=['GET', 'DELETE'])
+def planning_job_api(job_id):
+    """Status eines Planungsauftrags abfragen (GET) oder abbrechen (DELETE)."""
+    if request.method == 'DELETE':
+        if not planning_jobs.cancel(job_id):
+            return jsonify({'error': 'Auftrag nicht gefunden oder bereits beendet'}), 404
+        return jsonify({'job_id': job_id, 'cancelled': True})
+    status = planning_jobs.get(job_id)
+    if status is None:
+        return jsonify({'error': 'Auftrag nicht gefunden'}), 404
+    return jsonify(status)
 
 @app.route('/api/advanced_planning/reset', methods=['POST'])
 def reset_advanced_planning():
@@ -439,6 +643,12 @@ def reset_advanced_planning():
                 'total_segments': 0,
                 'total_planned_distance': 0.0
             })
+            status = current_planning_status.copy()
+            current_plan_segments.clear()
+            mock_obstacles.clear()
+        map_changes.update('plan', [])
+        map_changes.update('obstacles', [])
+        notify_change('plan', {'action': 'reset', 'status': status})
             
         return jsonify({
             'success': True,
@@ -454,6 +664,12 @@ def stop_advanced_planning():
     try:
         with planning_lock:
             current_planning_status['status'] = 'stopped'
+            job_id = current_planning_status.get('job_id')
+            status = current_planning_status.copy()
+        # Laufenden Planungsauftrag abbrechen
+        if job_id:
+            planning_jobs.cancel(job_id)
+        notify_change('plan', {'action': 'stopped', 'status': status})
             
         return jsonify({
             'success': True,
@@ -489,8 +705,12 @@ def add_dynamic_obstacle():
         y = data.get('y', 0.0)
         size = data.get('size', 1.0)
         
+        half = size / 2
         with planning_lock:
             planning_stats['dynamic_obstacles'] += 1
+            mock_obstacles.append([{'x': x - half, 'y': y - half}, {'x': x + half, 'y': y - half},
+                                   {'x': x + half, 'y': y + half}, {'x': x - half, 'y': y + half}])
+            obstacles = list(mock_obstacles)
             
             # Simuliere Neuplanung bei 30% Wahrscheinlichkeit
             replanning_triggered = random.random() < 0.3
@@ -498,6 +718,11 @@ def add_dynamic_obstacle():
             if replanning_triggered:
                 planning_stats['replanning_count'] += 1
                 current_planning_status['replanning_count'] += 1
+            status = current_planning_status.copy()
+        map_changes.update('obstacles', obstacles)
+        notify_change('plan', {'action': 'obstacle', 'status': status,
+                                   'obstacle': {'x': x, 'y': y, 'size': size},
+                                   'replanning_triggered': replanning_triggered})
                 
         return jsonify({
             'success': True,
@@ -536,6 +761,8 @@ def simulate_navigation():
                 current_planning_status['total_segments']
             )
             current_planning_status['progress'] = min(1.0, max_waypoints / max(1, current_planning_status['total_segments']))
+            status = current_planning_status.copy()
+        notify_change('plan', {'action': 'progress', 'status': status})
         
         return jsonify({
             'success': True,
@@ -548,6 +775,35 @@ def simulate_navigation():
     except Exception as e:
         return jsonify({'success': False, 'error': str(e)}), 500
 
+@app.route('/api/advanced_planning/plan.bin', methods=['GET'])
+def get_plan_binary():
+    """
+    Aktueller Plan im Binärformat (navigation/plan_codec.py), blockweise gestreamt.
+    Der Browser zeichnet direkt aus Float32Arrays, während der Plan noch übertragen wird.
+    """
+    # Plan mit seiner Diff-Version, der Client patcht ab dieser Version
+    version, segments = map_changes.current('plan')
+    chunk_points = min(max(request.args.get('chunk', 4096, type=int), 256), 65536)
+    point_count = sum(len(segment['points']) for segment in segments)
+    return Response(iter_plan_chunks(segments, chunk_points),
+                    mimetype='application/octet-stream',
+                    headers={'Content-Length': str(plan_size(len(segments), point_count)),
+                             'X-Plan-Version': str(content_versions.get('plan')),
+                             'X-Map-Epoch': map_changes.epoch,
+                             'X-Map-Version': str(version),
+                             'Cache-Control': 'no-cache'})
+
+@app.route('/api/advanced_planning/plan.json', methods=['GET'])
+@response_cache.cached('plan')
+def get_plan_json():
+    """Aktueller Plan als JSON ({x, y}-Objekte; Vergleichsformat für den Benchmark)."""
+    with planning_lock:
+        segments = list(current_plan_segments)
+    return jsonify({'segments': [
+        {'type': segment['path_type'], 'points': segment['points']}
+        for segment in segments
+    ]})
+
 def generate_mock_path(pattern: str, num_segments: int) -> List[Dict[str, float]]:
     """Generiert einen Mock-Pfad basierend auf dem gewählten Muster."""
     path = []
@@ -593,6 +849,7 @@ def generate_mock_path(pattern: str, num_segments: int) -> List[Dict[str, float]
 
 # Mapping API Endpoints
 @app.route('/api/mapping/maps', methods=['GET'])
+@response_cache.cached('mapping')
 def get_mapping_maps():
     """Gibt verfügbare Karten zurück."""
     try:
@@ -650,6 +907,7 @@ def get_mapping_data():
 def start_mapping():
     """Startet die Kartierung."""
     try:
+        notify_change('mapping', {'action': 'started', 'status': 'active'})
         return jsonify({
             'success': True,
             'message': 'Kartierung gestartet',
@@ -662,6 +920,7 @@ def start_mapping():
 def stop_mapping():
     """Stoppt die Kartierung."""
     try:
+        notify_change('mapping', {'action': 'stopped', 'status': 'stopped'})
         return jsonify({
             'success': True,
             'message': 'Kartierung gestoppt',
@@ -769,6 +1028,7 @@ def manage_single_task(task_id):
 
 # Dashboard API Endpoints
 @app.route('/api/dashboard/stats', methods=['GET'])
+@response_cache.cached(ttl=5.0)
 def get_dashboard_stats():
     """Gibt Dashboard-Statistiken zurück."""
     try:
@@ -800,4 +1060,8 @@ if __name__ == '__main__':
     print("Starte Server auf http://localhost:5000")
     print("Erweiterte Pfadplanung verfügbar unter /static/advanced_planning.html")
     print("Drücke Ctrl+C zum Beenden")
-    app.run(host='0.0.0.0', port=5000, debug=True)
\ No newline at end of file
+    if '--production' in sys.argv:
+        # waitress mit Worker-Pool, vorkomprimierten statischen Dateien und Cache
+        serve(app, {'mode': 'production', 'port': 5000, 'threads': 12})
+    else:
+        app.run(host='0.0.0.0', port=5000, debug=True)
\ No newline at end of file
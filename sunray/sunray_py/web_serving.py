@@ -0,0 +1,338 @@
+"""
+Produktivbetrieb der Web-Server (http_server.py, web_server.py).
+
+- serve(): waitress (asynchrones I/O mit begrenztem Worker-Pool), sonst Flask-Entwicklungsserver
+- ResponseCache: zwischengespeicherte, vorkomprimierte Antworten teurer Endpunkte mit
+  ETag/If-None-Match; gültig bis sich die zugehörige Inhaltsversion (Karte, Plan,
+  Zonen) ändert oder die TTL abläuft
+- precompress_static()/install_static_handler(): statische Dateien als .gz ausliefern
+- WorkerSlots: gemeinsames Kontingent für Anfragen, die einen Worker lange belegen
+  (SSE-Streams, Long-Polls), damit der Pool für normale API-Anfragen frei bleibt
+
+Verwendung:
+  versions = get_content_versions()
+  cache = ResponseCache(versions)
+
+  @app.route('/api/zones', methods=['GET', 'POST'])
+  @cache.cached('zones')              # GET wird gecacht, POST erhöht die Version
+  def manage_zones(): ...
+
+  versions.bump('plan')               # nach Änderungen außerhalb gecachter Routen
+"""
+
+import functools
+import gzip
+import mimetypes
+import os
+import threading
+import time
+import zlib
+from collections import OrderedDict
+from typing import Callable, Dict, Iterable, Optional, Tuple
+
+COMPRESSIBLE_EXTENSIONS = ('.html', '.css', '.js', '.json', '.svg', '.txt', '.geojson')
+
+class ContentVersions:
+    """Versionszähler je Inhaltsart ('map', 'plan', 'zones', ...)."""
+    def __init__(self):
+        self._versions: Dict[str, int] = {}
+        self._lock = threading.Lock()
+
+    def bump(self, *names: str) -> None:
+        with self._lock:
+            for name in names:
+                self._versions[name] = self._versions.get(name, 0) + 1
+
+    def get(self, name: str) -> int:
+        return self._versions.get(name, 0)
+
+    def token(self, names: Iterable[str]) -> Tuple[int, ...]:
+        return tuple(self.get(name) for name in names)
+
+class CachedResponse:
+    """Fertig kodierte Antwort (roh und gzip) mit ETag."""
+    __slots__ = ('body', 'gzip_body', 'mimetype', 'etag', 'version', 'created')
+
+    def __init__(self, body: bytes, mimetype: str, version, min_compress: int, level: int):
+        self.body = body
+        self.mimetype = mimetype
+        self.version = version
+        self.created = time.monotonic()
+        self.etag = f'"{zlib.crc32(repr(version).encode()):08x}-{zlib.crc32(body):08x}"'
+        self.gzip_body = gzip.compress(body, level) if len(body) >= min_compress else None
+
+def etag_matches(if_none_match: Optional[str], etag: str) -> bool:
+    """Prüft einen If-None-Match-Header (auch Listen, '*' und schwache ETags)."""
+    if not if_none_match:
+        return False
+    if if_none_match.strip() == '*':
+        return True
+    candidates = [tag.strip() for tag in if_none_match.split(',')]
+    return etag in candidates or f"W/{etag}" in candidates
+
+def accepts_gzip(accept_encoding: Optional[str]) -> bool:
+    if not accept_encoding:
+        return False
+    for part in accept_encoding.split(','):
+        name, _, params = part.strip().partition(';')
+        if name.strip().lower() in ('gzip', '*'):
+            return params.replace(' ', '') not in ('q=0', 'q=0.0')
+    return False
+
+class ResponseCache:
+    """
+    LRU-Cache für GET-Antworten teurer Endpunkte.
+    Ein Eintrag ist gültig, solange die Versionen seiner Inhaltsarten (und ggf.
+    extra_version, z.B. eine Datei-mtime) unverändert sind und die TTL nicht
+    abgelaufen ist. Bedingte Anfragen mit passendem ETag erhalten 304 ohne Body.
+    """
+    def __init__(self, versions: Optional[ContentVersions] = None, max_entries: int = 128,
+                 min_compress: int = 512, compress_level: int = 6):
+        self.versions = versions or get_content_versions()
+        self.max_entries = max_entries
+        self.min_compress = min_compress
+        self.compress_level = compress_level
+        self._entries: 'OrderedDict[str, CachedResponse]' = OrderedDict()
+        self._lock = threading.Lock()
+        self.hits = 0
+        self.misses = 0
+        self.not_modified = 0
+
+    def lookup(self, key: str, version, ttl: Optional[float] = None) -> Optional[CachedResponse]:
+        with self._lock:
+            entry = self._entries.get(key)
+            if entry is None or entry.version != version or \
+                    (ttl is not None and time.monotonic() - entry.created > ttl):
+                return None
+            self._entries.move_to_end(key)
+            return entry
+
+    def store(self, key: str, body: bytes, mimetype: str, version) -> CachedResponse:
+        entry = CachedResponse(body, mimetype, version, self.min_compress, self.compress_level)
+        with self._lock:
+            self._entries[key] = entry
+            self._entries.move_to_end(key)
+            while len(self._entries) > self.max_entries:
+                self._entries.popitem(last=False)
+        return entry
+
+    def select(self, entry: CachedResponse, if_none_match: Optional[str],
+               accept_encoding: Optional[str]) -> Tuple[int, Dict[str, str], bytes]:
+        """Wählt Status, Header und Body für eine Anfrage (304, gzip oder roh)."""
+        headers = {'ETag': entry.etag, 'Vary': 'Accept-Encoding', 'Cache-Control': 'no-cache'}
+        if etag_matches(if_none_match, entry.etag):
+            self.not_modified += 1
+            return 304, headers, b''
+        headers['Content-Type'] = entry.mimetype
+        if entry.gzip_body is not None and accepts_gzip(accept_encoding):
+            headers['Content-Encoding'] = 'gzip'
+            return 200, headers, entry.gzip_body
+        return 200, headers, entry.body
+
+    def invalidate(self, prefix: str = '') -> None:
+        with self._lock:
+            for key in [k for k in self._entries if k.startswith(prefix)]:
+                del self._entries[key]
+
+    def cached(self, *version_keys: str, ttl: Optional[float] = None,
+               extra_version: Optional[Callable[..., object]] = None):
+        """
+        Dekorator für Flask-Views (unterhalb von @app.route).
+        GET-Antworten mit Status 200 werden gecacht; erfolgreiche andere Methoden
+        (POST, DELETE, ...) erhöhen die Versionen version_keys.
+        """
+        def decorator(view):
+            @functools.wraps(view)
+            def wrapper(*args, **kwargs):
+                from flask import request, make_response
+                if request.method != 'GET':
+                    response = make_response(view(*args, **kwargs))
+                    if response.status_code < 400:
+                        self.versions.bump(*version_keys)
+                    return response
+
+                version = self.versions.token(version_keys)
+                if extra_version is not None:
+                    version = version + (extra_version(*args, **kwargs),)
+                key = request.full_path
+                entry = self.lookup(key, version, ttl)
+                if entry is None:
+                    self.misses += 1
+                    response = make_response(view(*args, **kwargs))
+                    if response.status_code != 200 or response.is_streamed:
+                        return response
+                    entry = self.store(key, response.get_data(), response.mimetype, version)
+                else:
+                    self.hits += 1
+                status, headers, body = self.select(entry, request.headers.get('If-None-Match'),
+                                                    request.headers.get('Accept-Encoding'))
+                response = make_response(body, status)
+                response.headers.update(headers)
+                return response
+            return wrapper
+        return decorator
+
+    def get_statistics(self) -> Dict:
+        total = self.hits + self.misses
+        return {
+            'entries': len(self._entries),
+            'hits': self.hits,
+            'misses': self.misses,
+            'not_modified': self.not_modified,
+            'hit_rate': self.hits / total if total else 0.0
+        }
+
+def file_version(path: str) -> float:
+    """mtime einer Datei als Zusatzversion (0, wenn sie nicht existiert)."""
+    try:
+        return os.path.getmtime(path)
+    except OSError:
+        return 0.0
+
+def precompress_static(folder: str, min_size: int = 1024,
+                       extensions: Tuple[str, ...] = COMPRESSIBLE_EXTENSIONS) -> int:
+    """
+    Legt neben jeder komprimierbaren statischen Datei eine .gz-Version an
+    (nur wenn sie fehlt oder älter ist). Gibt die Anzahl neu geschriebener Dateien zurück.
+    """
+    written = 0
+    for root, _, files in os.walk(folder):
+        for name in files:
+            if not name.endswith(extensions):
+                continue
+            path = os.path.join(root, name)
+            target = path + '.gz'
+            try:
+                if os.path.getsize(path) < min_size:
+                    continue
+                if os.path.exists(target) and os.path.getmtime(target) >= os.path.getmtime(path):
+                    continue
+                with open(path, 'rb') as f:
+                    data = f.read()
+                tmp = target + '.tmp'
+                with open(tmp, 'wb') as f:
+                    # mtime=0: identische Bytes bei gleichem Inhalt
+                    f.write(gzip.compress(data, 9, mtime=0))
+                os.replace(tmp, target)
+                written += 1
+            except OSError as e:
+                print(f"Static: Vorkomprimieren von {path} fehlgeschlagen: {e}")
+    return written
+
+def install_static_handler(app, max_age: int = 3600) -> None:
+    """
+    Ersetzt den Static-Handler von Flask: liefert vorhandene .gz-Dateien an
+    Clients mit gzip-Unterstützung; ETag/Last-Modified übernimmt Flask.
+    """
+    from flask import request, send_from_directory
+    folder = app.static_folder
+
+    def static(filename):
+        mimetype = mimetypes.guess_type(filename)[0] or 'application/octet-stream'
+        if accepts_gzip(request.headers.get('Accept-Encoding')) and \
+                os.path.isfile(os.path.join(folder, filename + '.gz')):
+            response = send_from_directory(folder, filename + '.gz', mimetype=mimetype,
+                                           max_age=max_age)
+            response.headers['Content-Encoding'] = 'gzip'
+        else:
+            response = send_from_directory(folder, filename, mimetype=mimetype, max_age=max_age)
+        response.headers['Vary'] = 'Accept-Encoding'
+        return response
+
+    app.view_functions['static'] = static
+
+def serve(app, config: Optional[Dict] = None) -> None:
+    """
+    Startet die Flask-App blockierend.
+    config (Abschnitt 'web_server' in config.json):
+      mode: 'production' (waitress) oder 'development' (Flask-Server)
+      host, port, threads (Worker-Pool), connection_limit, channel_timeout,
+      long_request_slots (SSE + Long-Polls, Standard threads // 2),
+      precompress_static, static_max_age
+    """
+    config = config or {}
+    get_worker_slots().configure(config.get('threads', 8), config.get('long_request_slots'))
+    host = config.get('host', '0.0.0.0')
+    port = config.get('port', 5000)
+    if config.get('precompress_static', True) and app.static_folder:
+        count = precompress_static(app.static_folder)
+        if count:
+            print(f"Web-Server: {count} statische Dateien vorkomprimiert")
+        install_static_handler(app, config.get('static_max_age', 3600))
+
+    if config.get('mode', 'production') == 'production':
+        try:
+            from waitress import serve as waitress_serve
+        except ImportError:
+            print("Web-Server: waitress nicht installiert, verwende Flask-Entwicklungsserver")
+        else:
+            print(f"Web-Server: waitress auf {host}:{port} "
+                  f"({config.get('threads', 8)} Worker, max. {config.get('connection_limit', 64)} Verbindungen)")
+            waitress_serve(app, host=host, port=port,
+                           threads=config.get('threads', 8),
+                           connection_limit=config.get('connection_limit', 64),
+                           channel_timeout=config.get('channel_timeout', 120),
+                           ident='sunray')
+            return
+    app.run(host=host, port=port, threaded=True)
+
+class WorkerSlots:
+    """
+    Begrenzt gleichzeitige lang laufende Anfragen (SSE-Streams, Long-Polls).
+    waitress bedient jede Anfrage bis zum Ende mit einem Worker aus dem
+    Pool; ohne Grenze könnten Streams und Long-Polls alle Worker belegen.
+    Voreinstellung: die Hälfte des Pools.
+    """
+    def __init__(self, limit: int = 4):
+        self.limit = max(1, int(limit))
+        self.in_use = 0
+        self.rejected = 0
+        self._lock = threading.Lock()
+
+    def configure(self, threads: int, limit: Optional[int] = None) -> None:
+        """Setzt die Grenze aus der Poolgröße (threads) oder ausdrücklich (limit)."""
+        self.limit = max(1, int(limit if limit is not None else threads // 2))
+
+    def try_acquire(self) -> bool:
+        """Belegt einen Platz ohne zu warten; False, wenn alle vergeben sind."""
+        with self._lock:
+            if self.in_use >= self.limit:
+                self.rejected += 1
+                return False
+            self.in_use += 1
+            return True
+
+    def release(self) -> None:
+        with self._lock:
+            self.in_use = max(0, self.in_use - 1)
+
+    def hold(self, response):
+        """Gibt den Platz frei, sobald der Server die Antwort schließt (Stream-Ende, Abbruch)."""
+        released = []
+
+        def release_once():
+            if not released:
+                released.append(True)
+                self.release()
+        response.call_on_close(release_once)
+        return response
+
+    def get_statistics(self) -> Dict:
+        return {'limit': self.limit, 'in_use': self.in_use, 'rejected': self.rejected}
+
+_content_versions: Optional[ContentVersions] = None
+_worker_slots: Optional[WorkerSlots] = None
+
+def get_content_versions() -> ContentVersions:
+    """Gibt die globalen Inhaltsversionen zurück."""
+    global _content_versions
+    if _content_versions is None:
+        _content_versions = ContentVersions()
+    return _content_versions
+
+def get_worker_slots() -> WorkerSlots:
+    """Gibt das globale Kontingent für lang laufende Anfragen zurück (Grenze setzt serve())."""
+    global _worker_slots
+    if _worker_slots is None:
+        _worker_slots = WorkerSlots()
+    return _worker_slots